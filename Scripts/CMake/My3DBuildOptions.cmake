@@ -12,5 +12,23 @@ if (MY3D_LOGGING)
     add_definitions(-DMY3D_LOGGING)
 endif()
 
+# setup profiling
+set(MY3D_PROFILING ON CACHE BOOL "Enable the CPU profiler and its instrumentation.")
+if (MY3D_PROFILING)
+    add_definitions(-DMY3D_PROFILING)
+endif()
+
+# setup string hash debugging
+set(MY3D_HASH_DEBUG OFF CACHE BOOL "Register hashed strings for reverse lookup and collision detection.")
+if (MY3D_HASH_DEBUG)
+    add_definitions(-DMY3D_HASH_DEBUG)
+endif()
+
+# setup scene ID registries
+set(MY3D_SCENE_SLOTMAP OFF CACHE BOOL "Store scene node and component IDs in slot maps instead of hash maps.")
+if (MY3D_SCENE_SLOTMAP)
+    add_definitions(-DMY3D_SCENE_SLOTMAP)
+endif()
+
 # setup testing
 set(MY3D_TESTING ON CACHE BOOL "Enable testing.")
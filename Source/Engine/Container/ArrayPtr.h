@@ -118,9 +118,9 @@ template <typename T> class SharedArrayPtr
         /// Return the raw pointer.
         T* Get() const { return ptr_; }
         /// Return the array's reference count, or 0 if the pointer is null.
-        int Refs() const { return refCount_ ? refCount_->refs_ : 0; }
+        int Refs() const { return refCount_ ? refCount_->refs_.load() : 0; }
         /// Return the array's weak reference count, or 0 if the pointer is null.
-        int WeakRefs() const { return refCount_ ? refCount_->weakRefs_ : 0; }
+        int WeakRefs() const { return refCount_ ? refCount_->weakRefs_.load() : 0; }
         /// Return pointer to the RefCount structure.
         RefCount* RefCountPtr() const { return refCount_; }
         /// Return hash value for HashSet & HashMap.
@@ -308,9 +308,9 @@ public:
     /// Check if the pointer is not null.
     bool NotNull() const { return refCount_ != 0; }
     /// Return the array's reference count, or 0 if null pointer or if array has expired.
-    int Refs() const { return (refCount_ && refCount_->refs_ >= 0) ? refCount_->refs_ : 0; }
+    int Refs() const { return (refCount_ && refCount_->refs_ >= 0) ? refCount_->refs_.load() : 0; }
     /// Return the array's weak reference count.
-    int WeakRefs() const { return refCount_ ? refCount_->weakRefs_ : 0; }
+    int WeakRefs() const { return refCount_ ? refCount_->weakRefs_.load() : 0; }
     /// Return whether the array has expired. If null pointer, always return true.
     bool Expired() const { return refCount_ == nullptr || refCount_->refs_ < 0; }
     /// Return pointer to RefCount structure.
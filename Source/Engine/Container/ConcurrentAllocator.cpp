@@ -0,0 +1,508 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Container/ConcurrentAllocator.h"
+#include "Container/Sort.h"
+#include "Container/Vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+
+
+namespace My3D
+{
+    /// Header kept in the first node of a magazine while it is in the global free list.
+    struct ConcurrentMagazine
+    {
+        /// Next free node in this magazine.
+        AllocatorNode node_;
+        /// First node of the next magazine.
+        AllocatorNode* nextMagazine_;
+        /// Number of nodes in this magazine.
+        unsigned count_;
+    };
+
+    /// Per-thread cache of free nodes. Only the owner thread touches the magazines while the allocator is in use.
+    struct ConcurrentAllocatorCache
+    {
+        /// Owner thread.
+        std::thread::id owner_;
+        /// Magazine that nodes are reserved from and freed to.
+        AllocatorNode* loaded_{};
+        /// Number of nodes in the loaded magazine.
+        unsigned loadedCount_{};
+        /// Full or empty magazine kept to absorb alternating reserve and free.
+        AllocatorNode* previous_{};
+        /// Number of nodes in the previous magazine.
+        unsigned previousCount_{};
+        /// Reserved minus freed nodes on this thread. Written only by the owner, read by statistics queries.
+        std::atomic<int> reserved_{};
+        /// Next cache of the same allocator.
+        ConcurrentAllocatorCache* next_{};
+    };
+
+    struct ConcurrentAllocatorState
+    {
+        /// Distance between nodes.
+        unsigned nodeSize_{};
+        /// Maximum number of nodes in a magazine.
+        unsigned magazineSize_{};
+        /// Unique id, used to find the per-thread caches.
+        unsigned long long id_{};
+        /// Global free list of magazines as a tagged pointer to the first node of the first magazine.
+        std::atomic<unsigned long long> depot_{};
+        /// Allocated blocks.
+        std::atomic<AllocatorBlock*> blocks_{};
+        /// Per-thread caches.
+        std::atomic<ConcurrentAllocatorCache*> caches_{};
+        /// Total number of nodes.
+        std::atomic<unsigned> capacity_{};
+        /// Number of blocks.
+        std::atomic<unsigned> numBlocks_{};
+        /// Number of nodes outside the global free list.
+        std::atomic<unsigned> outstanding_{};
+        /// Peak of outstanding nodes.
+        std::atomic<unsigned> peak_{};
+    };
+
+    /// Thread cache lookup entry.
+    struct ConcurrentAllocatorCacheSlot
+    {
+        /// Allocator id.
+        unsigned long long allocatorId_;
+        /// Cache of the calling thread.
+        ConcurrentAllocatorCache* cache_;
+    };
+
+    static const unsigned NUM_CACHE_SLOTS = 4;
+    static thread_local ConcurrentAllocatorCacheSlot cacheSlots[NUM_CACHE_SLOTS];
+    static thread_local unsigned nextCacheSlot = 0;
+    static std::atomic<unsigned long long> nextAllocatorId(1);
+
+    /// Size of the block header, rounded up so that the first node is maximally aligned.
+    static const unsigned BLOCK_HEADER_SIZE = (unsigned)((sizeof(AllocatorBlock) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1));
+    /// The depot pointer carries a modification tag in its high bits to defeat ABA on pop. User space pointers fit in 48 bits on 64-bit platforms.
+    static const unsigned TAG_SHIFT = sizeof(void*) == 8 ? 48 : 32;
+    static const unsigned long long POINTER_MASK = (1ULL << TAG_SHIFT) - 1;
+
+    static inline AllocatorNode* UntagNode(unsigned long long tagged)
+    {
+        return reinterpret_cast<AllocatorNode*>((size_t)(tagged & POINTER_MASK));
+    }
+
+    static inline unsigned long long TagNode(AllocatorNode* node, unsigned long long previous)
+    {
+        return (unsigned long long)(size_t)node | (((previous >> TAG_SHIFT) + 1) << TAG_SHIFT);
+    }
+
+    static void PushMagazine(ConcurrentAllocatorState* allocator, AllocatorNode* first, unsigned count)
+    {
+        auto* magazine = reinterpret_cast<ConcurrentMagazine*>(first);
+        magazine->count_ = count;
+
+        unsigned long long head = allocator->depot_.load(std::memory_order_relaxed);
+        do
+        {
+            magazine->nextMagazine_ = UntagNode(head);
+        } while (!allocator->depot_.compare_exchange_weak(head, TagNode(first, head), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    static AllocatorNode* PopMagazine(ConcurrentAllocatorState* allocator, unsigned& count)
+    {
+        unsigned long long head = allocator->depot_.load(std::memory_order_acquire);
+        for (;;)
+        {
+            AllocatorNode* first = UntagNode(head);
+            if (!first)
+                return nullptr;
+
+            // The magazine may have been popped and reused by another thread already, in which case the read is stale
+            // but the tag has changed and the exchange fails. Blocks are never freed while other threads are active
+            auto* magazine = reinterpret_cast<ConcurrentMagazine*>(first);
+            AllocatorNode* next = magazine->nextMagazine_;
+            if (allocator->depot_.compare_exchange_weak(head, TagNode(next, head), std::memory_order_acquire, std::memory_order_acquire))
+            {
+                count = magazine->count_;
+                return first;
+            }
+        }
+    }
+
+    static void AddOutstanding(ConcurrentAllocatorState* allocator, unsigned count)
+    {
+        unsigned outstanding = allocator->outstanding_.fetch_add(count, std::memory_order_relaxed) + count;
+        unsigned peak = allocator->peak_.load(std::memory_order_relaxed);
+        while (outstanding > peak && !allocator->peak_.compare_exchange_weak(peak, outstanding, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// Allocate a new block. Return the first magazine of its nodes and push the rest to the depot.
+    static AllocatorNode* ConcurrentAllocatorReserveBlock(ConcurrentAllocatorState* allocator, unsigned capacity, unsigned& count)
+    {
+        unsigned nodeSize = allocator->nodeSize_;
+        unsigned magazineSize = allocator->magazineSize_;
+        auto* blockPtr = new unsigned char[BLOCK_HEADER_SIZE + (size_t)capacity * nodeSize];
+        auto* newBlock = reinterpret_cast<AllocatorBlock*>(blockPtr);
+        newBlock->nodeSize_ = nodeSize;
+        newBlock->capacity_ = capacity;
+        newBlock->free_ = nullptr;
+
+        // Chain the nodes into magazines
+        AllocatorNode* firstMagazine = nullptr;
+        unsigned char* nodePtr = blockPtr + BLOCK_HEADER_SIZE;
+        for (unsigned i = 0; i < capacity; i += magazineSize)
+        {
+            unsigned magazineCount = capacity - i < magazineSize ? capacity - i : magazineSize;
+            auto* first = reinterpret_cast<AllocatorNode*>(nodePtr);
+            for (unsigned j = 0; j < magazineCount - 1; ++j)
+            {
+                reinterpret_cast<AllocatorNode*>(nodePtr)->next_ = reinterpret_cast<AllocatorNode*>(nodePtr + nodeSize);
+                nodePtr += nodeSize;
+            }
+            reinterpret_cast<AllocatorNode*>(nodePtr)->next_ = nullptr;
+            nodePtr += nodeSize;
+
+            if (!firstMagazine)
+            {
+                firstMagazine = first;
+                count = magazineCount;
+            }
+            else
+                PushMagazine(allocator, first, magazineCount);
+        }
+
+        AllocatorBlock* head = allocator->blocks_.load(std::memory_order_relaxed);
+        do
+        {
+            newBlock->next_ = head;
+        } while (!allocator->blocks_.compare_exchange_weak(head, newBlock, std::memory_order_release, std::memory_order_relaxed));
+
+        allocator->capacity_.fetch_add(capacity, std::memory_order_relaxed);
+        allocator->numBlocks_.fetch_add(1, std::memory_order_relaxed);
+        return firstMagazine;
+    }
+
+    static ConcurrentAllocatorCache* FindThreadCache(ConcurrentAllocatorState* allocator, bool create)
+    {
+        for (unsigned i = 0; i < NUM_CACHE_SLOTS; ++i)
+        {
+            if (cacheSlots[i].allocatorId_ == allocator->id_)
+                return cacheSlots[i].cache_;
+        }
+
+        // Slow path: search the allocator's cache list, which is only ever prepended to while the allocator is in use
+        std::thread::id threadId = std::this_thread::get_id();
+        ConcurrentAllocatorCache* cache = allocator->caches_.load(std::memory_order_acquire);
+        while (cache && cache->owner_ != threadId)
+            cache = cache->next_;
+
+        if (!cache)
+        {
+            if (!create)
+                return nullptr;
+
+            cache = new ConcurrentAllocatorCache();
+            cache->owner_ = threadId;
+            ConcurrentAllocatorCache* head = allocator->caches_.load(std::memory_order_relaxed);
+            do
+            {
+                cache->next_ = head;
+            } while (!allocator->caches_.compare_exchange_weak(head, cache, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        ConcurrentAllocatorCacheSlot& slot = cacheSlots[nextCacheSlot];
+        nextCacheSlot = (nextCacheSlot + 1) % NUM_CACHE_SLOTS;
+        slot.allocatorId_ = allocator->id_;
+        slot.cache_ = cache;
+        return cache;
+    }
+
+    ConcurrentAllocatorState* ConcurrentAllocatorInitialize(unsigned nodeSize, unsigned nodeAlignment, unsigned initialCapacity, unsigned magazineSize)
+    {
+        // Free nodes hold the magazine header, so round the node size up to fit it and keep the alignment
+        unsigned alignment = nodeAlignment > sizeof(void*) ? nodeAlignment : (unsigned)sizeof(void*);
+        assert(!(alignment & (alignment - 1)) && alignment <= alignof(std::max_align_t));
+        if (nodeSize < sizeof(ConcurrentMagazine))
+            nodeSize = (unsigned)sizeof(ConcurrentMagazine);
+        nodeSize = (nodeSize + alignment - 1) & ~(alignment - 1);
+
+        auto* allocator = new ConcurrentAllocatorState();
+        allocator->nodeSize_ = nodeSize;
+        allocator->magazineSize_ = magazineSize ? magazineSize : 1;
+        allocator->id_ = nextAllocatorId.fetch_add(1, std::memory_order_relaxed);
+
+        if (initialCapacity)
+        {
+            unsigned count;
+            AllocatorNode* first = ConcurrentAllocatorReserveBlock(allocator, initialCapacity, count);
+            PushMagazine(allocator, first, count);
+        }
+
+        return allocator;
+    }
+
+    void ConcurrentAllocatorUninitialize(ConcurrentAllocatorState* allocator)
+    {
+        if (!allocator)
+            return;
+
+        ConcurrentAllocatorCache* cache = allocator->caches_.load(std::memory_order_acquire);
+        while (cache)
+        {
+            ConcurrentAllocatorCache* next = cache->next_;
+            delete cache;
+            cache = next;
+        }
+
+        AllocatorBlock* block = allocator->blocks_.load(std::memory_order_acquire);
+        while (block)
+        {
+            AllocatorBlock* next = block->next_;
+            delete[] reinterpret_cast<unsigned char*>(block);
+            block = next;
+        }
+
+        delete allocator;
+    }
+
+    void* ConcurrentAllocatorReserve(ConcurrentAllocatorState* allocator)
+    {
+        if (!allocator)
+            return nullptr;
+
+        ConcurrentAllocatorCache* cache = FindThreadCache(allocator, true);
+        if (!cache->loaded_)
+        {
+            if (cache->previous_)
+            {
+                // Previous magazine is full, switch to it
+                cache->loaded_ = cache->previous_;
+                cache->loadedCount_ = cache->previousCount_;
+                cache->previous_ = nullptr;
+                cache->previousCount_ = 0;
+            }
+            else
+            {
+                unsigned count;
+                AllocatorNode* first = PopMagazine(allocator, count);
+                if (!first)
+                {
+                    // Free nodes have been exhausted. Allocate a new block, half the size of existing capacity
+                    unsigned magazineSize = allocator->magazineSize_;
+                    unsigned newCapacity = (allocator->capacity_.load(std::memory_order_relaxed) + 1) >> 1u;
+                    newCapacity = newCapacity > magazineSize ? (newCapacity + magazineSize - 1) / magazineSize * magazineSize : magazineSize;
+                    first = ConcurrentAllocatorReserveBlock(allocator, newCapacity, count);
+                }
+
+                cache->loaded_ = first;
+                cache->loadedCount_ = count;
+                AddOutstanding(allocator, count);
+            }
+        }
+
+        AllocatorNode* node = cache->loaded_;
+        cache->loaded_ = node->next_;
+        --cache->loadedCount_;
+        cache->reserved_.store(cache->reserved_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        return node;
+    }
+
+    void ConcurrentAllocatorFree(ConcurrentAllocatorState* allocator, void* ptr)
+    {
+        if (!allocator || !ptr)
+            return;
+
+        ConcurrentAllocatorCache* cache = FindThreadCache(allocator, true);
+        if (cache->loadedCount_ >= allocator->magazineSize_)
+        {
+            // Loaded magazine is full. Return the previous one to the depot if it is also full, then start a new magazine
+            if (cache->previous_)
+            {
+                PushMagazine(allocator, cache->previous_, cache->previousCount_);
+                allocator->outstanding_.fetch_sub(cache->previousCount_, std::memory_order_relaxed);
+            }
+            cache->previous_ = cache->loaded_;
+            cache->previousCount_ = cache->loadedCount_;
+            cache->loaded_ = nullptr;
+            cache->loadedCount_ = 0;
+        }
+
+        auto* node = static_cast<AllocatorNode*>(ptr);
+        node->next_ = cache->loaded_;
+        cache->loaded_ = node;
+        ++cache->loadedCount_;
+        cache->reserved_.store(cache->reserved_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    void ConcurrentAllocatorReserveCapacity(ConcurrentAllocatorState* allocator, unsigned capacity)
+    {
+        if (!allocator)
+            return;
+
+        unsigned currentCapacity = allocator->capacity_.load(std::memory_order_relaxed);
+        if (capacity <= currentCapacity)
+            return;
+
+        unsigned count;
+        AllocatorNode* first = ConcurrentAllocatorReserveBlock(allocator, capacity - currentCapacity, count);
+        PushMagazine(allocator, first, count);
+    }
+
+    void ConcurrentAllocatorFlushThread(ConcurrentAllocatorState* allocator)
+    {
+        if (!allocator)
+            return;
+
+        ConcurrentAllocatorCache* cache = FindThreadCache(allocator, false);
+        if (!cache)
+            return;
+
+        if (cache->loaded_)
+        {
+            PushMagazine(allocator, cache->loaded_, cache->loadedCount_);
+            allocator->outstanding_.fetch_sub(cache->loadedCount_, std::memory_order_relaxed);
+        }
+        if (cache->previous_)
+        {
+            PushMagazine(allocator, cache->previous_, cache->previousCount_);
+            allocator->outstanding_.fetch_sub(cache->previousCount_, std::memory_order_relaxed);
+        }
+
+        cache->loaded_ = nullptr;
+        cache->loadedCount_ = 0;
+        cache->previous_ = nullptr;
+        cache->previousCount_ = 0;
+    }
+
+    unsigned ConcurrentAllocatorReclaim(ConcurrentAllocatorState* allocator)
+    {
+        if (!allocator)
+            return 0;
+
+        PODVector<AllocatorBlock*> blocks;
+        for (AllocatorBlock* block = allocator->blocks_.load(std::memory_order_acquire); block; block = block->next_)
+        {
+            block->free_ = nullptr;
+            blocks.Push(block);
+        }
+        if (blocks.Empty())
+            return 0;
+
+        Sort(blocks.Begin(), blocks.End());
+        PODVector<unsigned> freeCounts(blocks.Size());
+        for (unsigned i = 0; i < freeCounts.Size(); ++i)
+            freeCounts[i] = 0;
+
+        // Sort all free nodes, from the depot and from the thread caches, into their owning blocks
+        auto gatherNodes = [&](AllocatorNode* node)
+        {
+            while (node)
+            {
+                AllocatorNode* next = node->next_;
+                unsigned low = 0;
+                unsigned high = blocks.Size();
+                while (high - low > 1)
+                {
+                    unsigned mid = (low + high) >> 1u;
+                    if (reinterpret_cast<unsigned char*>(blocks[mid]) <= reinterpret_cast<unsigned char*>(node))
+                        low = mid;
+                    else
+                        high = mid;
+                }
+
+                AllocatorBlock* block = blocks[low];
+                node->next_ = block->free_;
+                block->free_ = node;
+                ++freeCounts[low];
+                node = next;
+            }
+        };
+
+        AllocatorNode* magazine = UntagNode(allocator->depot_.load(std::memory_order_acquire));
+        while (magazine)
+        {
+            AllocatorNode* nextMagazine = reinterpret_cast<ConcurrentMagazine*>(magazine)->nextMagazine_;
+            gatherNodes(magazine);
+            magazine = nextMagazine;
+        }
+        allocator->depot_.store(TagNode(nullptr, allocator->depot_.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+
+        for (ConcurrentAllocatorCache* cache = allocator->caches_.load(std::memory_order_acquire); cache; cache = cache->next_)
+        {
+            gatherNodes(cache->loaded_);
+            gatherNodes(cache->previous_);
+            cache->loaded_ = nullptr;
+            cache->loadedCount_ = 0;
+            cache->previous_ = nullptr;
+            cache->previousCount_ = 0;
+        }
+
+        // Free the blocks that have no live nodes, and rebuild the depot from the rest
+        unsigned magazineSize = allocator->magazineSize_;
+        unsigned freedBlocks = 0;
+        unsigned capacity = 0;
+        unsigned freeNodes = 0;
+        AllocatorBlock* keptBlocks = nullptr;
+
+        for (unsigned i = 0; i < blocks.Size(); ++i)
+        {
+            AllocatorBlock* block = blocks[i];
+            if (freeCounts[i] == block->capacity_)
+            {
+                delete[] reinterpret_cast<unsigned char*>(block);
+                ++freedBlocks;
+                continue;
+            }
+
+            AllocatorNode* node = block->free_;
+            while (node)
+            {
+                AllocatorNode* first = node;
+                unsigned count = 1;
+                while (count < magazineSize && node->next_)
+                {
+                    node = node->next_;
+                    ++count;
+                }
+                AllocatorNode* next = node->next_;
+                node->next_ = nullptr;
+                PushMagazine(allocator, first, count);
+                node = next;
+            }
+
+            block->free_ = nullptr;
+            block->next_ = keptBlocks;
+            keptBlocks = block;
+            capacity += block->capacity_;
+            freeNodes += freeCounts[i];
+        }
+
+        allocator->blocks_.store(keptBlocks, std::memory_order_release);
+        allocator->capacity_.store(capacity, std::memory_order_relaxed);
+        allocator->numBlocks_.store(blocks.Size() - freedBlocks, std::memory_order_relaxed);
+        allocator->outstanding_.store(capacity - freeNodes, std::memory_order_relaxed);
+        return freedBlocks;
+    }
+
+    ConcurrentAllocatorStats ConcurrentAllocatorGetStats(const ConcurrentAllocatorState* allocator)
+    {
+        ConcurrentAllocatorStats stats{};
+        if (!allocator)
+            return stats;
+
+        int live = 0;
+        for (ConcurrentAllocatorCache* cache = allocator->caches_.load(std::memory_order_acquire); cache; cache = cache->next_)
+            live += cache->reserved_.load(std::memory_order_relaxed);
+
+        stats.liveNodes_ = live > 0 ? (unsigned)live : 0;
+        stats.peakNodes_ = allocator->peak_.load(std::memory_order_relaxed);
+        stats.capacity_ = allocator->capacity_.load(std::memory_order_relaxed);
+        stats.blocks_ = allocator->numBlocks_.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
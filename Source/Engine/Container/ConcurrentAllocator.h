@@ -0,0 +1,93 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Allocator.h"
+
+#include <new>
+#include <utility>
+
+
+namespace My3D
+{
+    struct ConcurrentAllocatorState;
+
+    /// Concurrent allocator statistics.
+    struct ConcurrentAllocatorStats
+    {
+        /// Nodes reserved and not yet freed.
+        unsigned liveNodes_;
+        /// Highest number of nodes held outside the global free list. Sampled when thread caches exchange magazines, so can exceed the true live peak by up to two magazines per thread.
+        unsigned peakNodes_;
+        /// Total number of nodes in all blocks.
+        unsigned capacity_;
+        /// Number of blocks.
+        unsigned blocks_;
+    };
+
+    /// Initialize a thread-safe fixed-size allocator. Each thread keeps up to two magazines of free nodes and exchanges full or empty magazines with a lock-free global free list.
+    MY3D_API ConcurrentAllocatorState* ConcurrentAllocatorInitialize(unsigned nodeSize, unsigned nodeAlignment, unsigned initialCapacity = 0, unsigned magazineSize = 32);
+    /// Uninitialize a thread-safe fixed-size allocator. Frees all blocks. No other thread may be using the allocator.
+    MY3D_API void ConcurrentAllocatorUninitialize(ConcurrentAllocatorState* allocator);
+    /// Reserve a node. Can be called from any thread.
+    MY3D_API void* ConcurrentAllocatorReserve(ConcurrentAllocatorState* allocator);
+    /// Free a node. Can be called from any thread, not necessarily the one that reserved the node.
+    MY3D_API void ConcurrentAllocatorFree(ConcurrentAllocatorState* allocator, void* ptr);
+    /// Allocate a block for the missing nodes if the total capacity is less than the given. Can be called from any thread.
+    MY3D_API void ConcurrentAllocatorReserveCapacity(ConcurrentAllocatorState* allocator, unsigned capacity);
+    /// Return the calling thread's cached free nodes to the global free list.
+    MY3D_API void ConcurrentAllocatorFlushThread(ConcurrentAllocatorState* allocator);
+    /// Free blocks whose nodes are all unused. No other thread may be using the allocator. Return number of blocks freed.
+    MY3D_API unsigned ConcurrentAllocatorReclaim(ConcurrentAllocatorState* allocator);
+    /// Return allocator statistics. Live node count is exact only when no other thread is using the allocator.
+    MY3D_API ConcurrentAllocatorStats ConcurrentAllocatorGetStats(const ConcurrentAllocatorState* allocator);
+
+    /// Thread-safe fixed-size allocator template class. Reserve and Free can be called concurrently from the main and worker threads.
+    template <typename T> class ConcurrentAllocator
+    {
+    public:
+        /// Construct.
+        explicit ConcurrentAllocator(unsigned initialCapacity = 0, unsigned magazineSize = 32)
+            : allocator_(ConcurrentAllocatorInitialize((unsigned)sizeof(T), (unsigned)alignof(T), initialCapacity, magazineSize))
+        {
+        }
+        /// Destruct. All objects must have been freed.
+        ~ConcurrentAllocator()
+        {
+            ConcurrentAllocatorUninitialize(allocator_);
+        }
+        /// Prevent copy construction.
+        ConcurrentAllocator(const ConcurrentAllocator<T>& rhs) = delete;
+        /// Prevent assignment.
+        ConcurrentAllocator<T>& operator =(const ConcurrentAllocator<T>& rhs) = delete;
+
+        /// Reserve and construct an object.
+        template <typename... Args> T* Reserve(Args&&... args)
+        {
+            auto* newObject = static_cast<T*>(ConcurrentAllocatorReserve(allocator_));
+            new (newObject) T(std::forward<Args>(args)...);
+
+            return newObject;
+        }
+        /// Destruct and free an object.
+        void Free(T* object)
+        {
+            object->~T();
+            ConcurrentAllocatorFree(allocator_, object);
+        }
+        /// Allocate nodes up to a total capacity, so that a known burst of objects can be reserved without allocating.
+        void ReserveCapacity(unsigned capacity) { ConcurrentAllocatorReserveCapacity(allocator_, capacity); }
+        /// Return the calling thread's cached free nodes to the global free list. Call before a worker thread exits.
+        void FlushThread() { ConcurrentAllocatorFlushThread(allocator_); }
+        /// Free unused blocks. No other thread may be using the allocator. Return number of blocks freed.
+        unsigned Reclaim() { return ConcurrentAllocatorReclaim(allocator_); }
+        /// Return statistics.
+        ConcurrentAllocatorStats GetStats() const { return ConcurrentAllocatorGetStats(allocator_); }
+
+    private:
+        /// Allocator state.
+        ConcurrentAllocatorState* allocator_;
+    };
+}
@@ -0,0 +1,80 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Container/FlatHashBase.h"
+
+#include <cassert>
+#include <cstring>
+
+
+namespace My3D
+{
+    unsigned FlatHashBase::CapacityForSize(unsigned size)
+    {
+        unsigned capacity = MIN_CAPACITY;
+        while (MaxLoad(capacity) < size)
+            capacity <<= 1;
+        return capacity;
+    }
+
+    void FlatHashBase::AllocateTable(unsigned capacity, unsigned slotSize)
+    {
+        assert(capacity >= MIN_CAPACITY && !(capacity & (capacity - 1)));
+
+        // Control bytes come first. The capacity is a multiple of 16, so the slots start suitably aligned
+        auto* block = new unsigned char[capacity + (size_t)capacity * slotSize];
+        ctrl_ = reinterpret_cast<signed char*>(block);
+        slots_ = block + capacity;
+        capacity_ = capacity;
+        ResetCtrl();
+    }
+
+    void FlatHashBase::FreeTable()
+    {
+        delete[] reinterpret_cast<unsigned char*>(ctrl_);
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = 0;
+        growthLeft_ = 0;
+    }
+
+    void FlatHashBase::ResetCtrl()
+    {
+        if (!ctrl_)
+            return;
+
+        memset(ctrl_, (unsigned char)FLATHASH_EMPTY, capacity_);
+        growthLeft_ = MaxLoad(capacity_) - size_;
+    }
+
+    unsigned FlatHashBase::FindInsertSlot(unsigned mixedHash) const
+    {
+        unsigned groupMask = NumGroups() - 1;
+        unsigned group = H1(mixedHash);
+
+        // Triangular probing visits every group once when the group count is a power of two
+        for (unsigned step = 1; ; ++step)
+        {
+            FlatHashMask mask = FlatHashGroup(ctrl_ + group * FlatHashGroup::WIDTH).MatchEmptyOrDeleted();
+            if (mask)
+                return group * FlatHashGroup::WIDTH + mask.LowestIndex();
+            group = (group + step) & groupMask;
+        }
+    }
+
+    void FlatHashBase::EraseCtrl(unsigned index)
+    {
+        // A group that still has an empty slot has never been full, so no probe sequence continues past it
+        unsigned groupStart = index & ~(FlatHashGroup::WIDTH - 1);
+        if (FlatHashGroup(ctrl_ + groupStart).MatchEmpty())
+        {
+            ctrl_[index] = FLATHASH_EMPTY;
+            ++growthLeft_;
+        }
+        else
+            ctrl_[index] = FLATHASH_DELETED;
+
+        --size_;
+    }
+}
@@ -0,0 +1,217 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "My3D.h"
+#include "Container/Swap.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MY3D_FLATHASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+namespace My3D
+{
+    /// Control byte of an empty slot.
+    static const signed char FLATHASH_EMPTY = -128;
+    /// Control byte of an erased slot. Lookups must probe past it.
+    static const signed char FLATHASH_DELETED = -2;
+
+    /// Return index of the lowest set bit. The value must not be zero.
+    inline unsigned FlatHashTrailingZeros(unsigned value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return (unsigned)index;
+#else
+        return (unsigned)__builtin_ctz(value);
+#endif
+    }
+
+    /// Bit mask of matching slots within a group. Iterate with operator bool, LowestIndex() and ClearLowest().
+    struct FlatHashMask
+    {
+        /// Construct.
+        explicit FlatHashMask(unsigned mask) : mask_(mask) { }
+        /// Return whether any slot matched.
+        explicit operator bool() const { return mask_ != 0; }
+        /// Return index of the lowest matching slot.
+        unsigned LowestIndex() const { return FlatHashTrailingZeros(mask_); }
+        /// Clear the lowest matching slot.
+        void ClearLowest() { mask_ &= mask_ - 1; }
+        /// Mask bits, one per slot.
+        unsigned mask_;
+    };
+
+#ifdef MY3D_FLATHASH_SSE2
+    /// A group of control bytes that is probed at once using SSE2.
+    struct FlatHashGroup
+    {
+        /// Number of slots in a group.
+        static const unsigned WIDTH = 16;
+        /// Load a group of control bytes.
+        explicit FlatHashGroup(const signed char* ctrl) : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) { }
+        /// Return slots whose control byte equals the 7-bit hash.
+        FlatHashMask Match(signed char h2) const { return FlatHashMask((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))); }
+        /// Return empty slots.
+        FlatHashMask MatchEmpty() const { return Match(FLATHASH_EMPTY); }
+        /// Return empty or erased slots.
+        FlatHashMask MatchEmptyOrDeleted() const { return FlatHashMask((unsigned)_mm_movemask_epi8(ctrl_)); }
+        /// Return occupied slots.
+        FlatHashMask MatchFull() const { return FlatHashMask((unsigned)_mm_movemask_epi8(ctrl_) ^ 0xffffu); }
+        /// Control bytes.
+        __m128i ctrl_;
+    };
+#else
+    /// A group of control bytes that is probed at once using 64-bit integer operations.
+    struct FlatHashGroup
+    {
+        /// Number of slots in a group.
+        static const unsigned WIDTH = 8;
+        /// Load a group of control bytes.
+        explicit FlatHashGroup(const signed char* ctrl) { memcpy(&ctrl_, ctrl, sizeof ctrl_); }
+        /// Return slots whose control byte equals the 7-bit hash.
+        FlatHashMask Match(signed char h2) const
+        {
+            // Exact per-byte zero test so that no false positives are reported
+            unsigned long long x = ctrl_ ^ (LSBS * (unsigned char)h2);
+            return Compress(~(((x & ~MSBS) + ~MSBS) | x) & MSBS);
+        }
+        /// Return empty slots.
+        FlatHashMask MatchEmpty() const { return Match(FLATHASH_EMPTY); }
+        /// Return empty or erased slots.
+        FlatHashMask MatchEmptyOrDeleted() const { return Compress(ctrl_ & MSBS); }
+        /// Return occupied slots.
+        FlatHashMask MatchFull() const { return Compress(~ctrl_ & MSBS); }
+
+        /// Lowest bit of every byte.
+        static const unsigned long long LSBS = 0x0101010101010101ULL;
+        /// Highest bit of every byte.
+        static const unsigned long long MSBS = 0x8080808080808080ULL;
+        /// Control bytes.
+        unsigned long long ctrl_{};
+
+    private:
+        /// Gather the high bit of each byte into one bit per slot.
+        static FlatHashMask Compress(unsigned long long bits)
+        {
+            return FlatHashMask((unsigned)(((bits >> 7) * 0x0102040810204080ULL) >> 56));
+        }
+    };
+#endif
+
+    /// Open-addressing hash table base class. Keeps one control byte per slot, which stores either the empty or deleted
+    /// marker or the low 7 bits of the element hash, and probes them one group at a time.
+    class MY3D_API FlatHashBase
+    {
+    public:
+        /// Minimum number of slots once the table has been allocated.
+        static const unsigned MIN_CAPACITY = FlatHashGroup::WIDTH;
+        /// Index returned when a key or slot is not found.
+        static const unsigned NPOS = 0xffffffff;
+
+        /// Construct.
+        FlatHashBase()
+            : ctrl_(nullptr)
+            , slots_(nullptr)
+            , size_(0)
+            , capacity_(0)
+            , growthLeft_(0)
+        {
+        }
+        /// Swap with another flat hash set or map.
+        void Swap(FlatHashBase& rhs)
+        {
+            My3D::Swap(ctrl_, rhs.ctrl_);
+            My3D::Swap(slots_, rhs.slots_);
+            My3D::Swap(size_, rhs.size_);
+            My3D::Swap(capacity_, rhs.capacity_);
+            My3D::Swap(growthLeft_, rhs.growthLeft_);
+        }
+        /// Return number of elements.
+        unsigned Size() const { return size_; }
+        /// Return number of slots.
+        unsigned Capacity() const { return capacity_; }
+        /// Return whether has no elements.
+        bool Empty() const { return size_ == 0; }
+
+    protected:
+        /// Return the number of slots needed to hold a number of elements within the maximum load factor.
+        static unsigned CapacityForSize(unsigned size);
+        /// Return maximum number of elements for a slot count. The load factor is 7/8.
+        static unsigned MaxLoad(unsigned capacity) { return capacity - capacity / 8; }
+        /// Split an element hash. Low 7 bits go into the control byte, the rest selects the first group to probe.
+        static unsigned MixHash(unsigned hash)
+        {
+            // Spread the entropy of weak hashes (pointers, small integers) to all bits
+            unsigned long long product = (unsigned long long)hash * 0x9e3779b97f4a7c15ULL;
+            return (unsigned)(product >> 32) ^ (unsigned)product;
+        }
+        /// Return the 7-bit control byte value of a mixed hash.
+        static signed char H2(unsigned mixedHash) { return (signed char)(mixedHash & 0x7f); }
+        /// Return the first group index of a mixed hash.
+        unsigned H1(unsigned mixedHash) const { return (mixedHash >> 7) & (NumGroups() - 1); }
+        /// Return number of groups.
+        unsigned NumGroups() const { return capacity_ / FlatHashGroup::WIDTH; }
+        /// Allocate control bytes and slot storage for a capacity, which must be a power of two multiple of the group width. The old storage is not freed.
+        void AllocateTable(unsigned capacity, unsigned slotSize);
+        /// Free the control bytes and slot storage.
+        void FreeTable();
+        /// Mark all slots empty.
+        void ResetCtrl();
+        /// Find an empty or deleted slot for a mixed hash. The table must have been allocated.
+        unsigned FindInsertSlot(unsigned mixedHash) const;
+        /// Set a control byte.
+        void SetCtrl(unsigned index, signed char value) { ctrl_[index] = value; }
+        /// Mark a slot free after its element has been destroyed. Use the empty marker if no probe can have passed the slot's group.
+        void EraseCtrl(unsigned index);
+        /// Return whether a slot holds an element.
+        bool IsFull(unsigned index) const { return ctrl_[index] >= 0; }
+        /// Return the index of the first occupied slot at or after index, or capacity if none.
+        unsigned NextFull(unsigned index) const
+        {
+            while (index < capacity_)
+            {
+                unsigned groupStart = index & ~(FlatHashGroup::WIDTH - 1);
+                FlatHashMask mask = FlatHashGroup(ctrl_ + groupStart).MatchFull();
+                mask.mask_ &= ~0u << (index - groupStart);
+                if (mask)
+                    return groupStart + mask.LowestIndex();
+                index = groupStart + FlatHashGroup::WIDTH;
+            }
+            return capacity_;
+        }
+        /// Return the index of the last occupied slot before index, or NPOS if none.
+        unsigned PrevFull(unsigned index) const
+        {
+            while (index > 0)
+            {
+                --index;
+                if (IsFull(index))
+                    return index;
+            }
+            return NPOS;
+        }
+
+        /// Control bytes, one per slot.
+        signed char* ctrl_;
+        /// Slot storage, allocated together with the control bytes.
+        unsigned char* slots_;
+        /// Number of elements.
+        unsigned size_;
+        /// Number of slots.
+        unsigned capacity_;
+        /// Number of empty slots that can still be filled before rehashing.
+        unsigned growthLeft_;
+    };
+}
@@ -0,0 +1,505 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/FlatHashBase.h"
+#include "Container/Pair.h"
+#include "Container/Vector.h"
+#include "Container/Hash.h"
+
+#include <cassert>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+
+namespace My3D
+{
+    /// Open-addressing hash map template class. Keys and values are stored inline in the slot array, so a lookup
+    /// touches one group of control bytes and then the matching slot. Iteration order is unspecified, and inserting
+    /// or erasing invalidates iterators and element pointers.
+    template <typename T, typename U> class FlatHashMap : public FlatHashBase
+    {
+    public:
+        using KeyType = T;
+        using ValueType = U;
+
+        /// Hash map key-value pair with const key.
+        class KeyValue
+        {
+        public:
+            /// Construct with default key.
+            KeyValue() : first_(T()) { }
+            /// Construct with key and value.
+            KeyValue(const T& first, const U& second)
+                : first_(first)
+                , second_(second)
+            {
+            }
+            /// Construct by moving key and value.
+            KeyValue(T&& first, U&& second)
+                : first_(std::move(first))
+                , second_(std::move(second))
+            {
+            }
+            /// Copy-construct.
+            KeyValue(const KeyValue& value) = default;
+            /// Prevent assignment.
+            KeyValue& operator =(const KeyValue& rhs) = delete;
+            /// Test for equality with another pair.
+            bool operator ==(const KeyValue& rhs) const { return first_ == rhs.first_ && second_ == rhs.second_; }
+            /// Test for inequality with another pair.
+            bool operator !=(const KeyValue& rhs) const { return first_ != rhs.first_ || second_ != rhs.second_; }
+            /// Key.
+            const T first_;
+            /// Value.
+            U second_;
+        };
+
+        /// Flat hash map iterator.
+        struct Iterator
+        {
+            /// Construct.
+            Iterator() = default;
+            /// Construct with a map and slot index.
+            Iterator(FlatHashMap* map, unsigned index)
+                : map_(map)
+                , index_(index)
+            {
+            }
+            /// Test for equality with another iterator.
+            bool operator ==(const Iterator& rhs) const { return index_ == rhs.index_ && map_ == rhs.map_; }
+            /// Test for inequality with another iterator.
+            bool operator !=(const Iterator& rhs) const { return index_ != rhs.index_ || map_ != rhs.map_; }
+            /// Preincrement.
+            Iterator& operator ++()
+            {
+                index_ = map_->NextFull(index_ + 1);
+                return *this;
+            }
+            /// Postincrement.
+            Iterator operator ++(int)
+            {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+            /// Predecrement.
+            Iterator& operator --()
+            {
+                index_ = map_->PrevFull(index_);
+                return *this;
+            }
+            /// Postdecrement.
+            Iterator operator --(int)
+            {
+                Iterator it = *this;
+                --*this;
+                return it;
+            }
+            /// Point to the pair.
+            KeyValue* operator ->() const { return map_->Slots() + index_; }
+            /// Dereference the pair.
+            KeyValue& operator *() const { return map_->Slots()[index_]; }
+
+            /// Map.
+            FlatHashMap* map_{};
+            /// Slot index.
+            unsigned index_{};
+        };
+
+        /// Flat hash map const iterator.
+        struct ConstIterator
+        {
+            /// Construct.
+            ConstIterator() = default;
+            /// Construct with a map and slot index.
+            ConstIterator(const FlatHashMap* map, unsigned index)
+                : map_(map)
+                , index_(index)
+            {
+            }
+            /// Construct from a non-const iterator.
+            ConstIterator(const Iterator& rhs)
+                : map_(rhs.map_)
+                , index_(rhs.index_)
+            {
+            }
+            /// Test for equality with another iterator.
+            bool operator ==(const ConstIterator& rhs) const { return index_ == rhs.index_ && map_ == rhs.map_; }
+            /// Test for inequality with another iterator.
+            bool operator !=(const ConstIterator& rhs) const { return index_ != rhs.index_ || map_ != rhs.map_; }
+            /// Preincrement.
+            ConstIterator& operator ++()
+            {
+                index_ = map_->NextFull(index_ + 1);
+                return *this;
+            }
+            /// Postincrement.
+            ConstIterator operator ++(int)
+            {
+                ConstIterator it = *this;
+                ++*this;
+                return it;
+            }
+            /// Predecrement.
+            ConstIterator& operator --()
+            {
+                index_ = map_->PrevFull(index_);
+                return *this;
+            }
+            /// Postdecrement.
+            ConstIterator operator --(int)
+            {
+                ConstIterator it = *this;
+                --*this;
+                return it;
+            }
+            /// Point to the pair.
+            const KeyValue* operator ->() const { return map_->Slots() + index_; }
+            /// Dereference the pair.
+            const KeyValue& operator *() const { return map_->Slots()[index_]; }
+
+            /// Map.
+            const FlatHashMap* map_{};
+            /// Slot index.
+            unsigned index_{};
+        };
+
+        /// Construct empty. Does not allocate.
+        FlatHashMap() = default;
+        /// Copy-construct from another flat hash map.
+        FlatHashMap(const FlatHashMap<T, U>& map)
+        {
+            Reserve(map.Size());
+            Insert(map);
+        }
+        /// Move-construct from another flat hash map.
+        FlatHashMap(FlatHashMap<T, U>&& map) noexcept
+        {
+            Swap(map);
+        }
+        /// Aggregate initialization constructor.
+        FlatHashMap(const std::initializer_list<Pair<T, U> >& list)
+        {
+            Reserve((unsigned)list.size());
+            for (auto it = list.begin(); it != list.end(); ++it)
+                Insert(*it);
+        }
+        /// Destruct.
+        ~FlatHashMap()
+        {
+            DestructElements();
+            FreeTable();
+        }
+        /// Assign a flat hash map.
+        FlatHashMap& operator =(const FlatHashMap<T, U>& rhs)
+        {
+            if (&rhs != this)
+            {
+                Clear();
+                Reserve(rhs.Size());
+                Insert(rhs);
+            }
+            return *this;
+        }
+        /// Move-assign a flat hash map.
+        FlatHashMap& operator =(FlatHashMap<T, U>&& rhs) noexcept
+        {
+            Swap(rhs);
+            return *this;
+        }
+        /// Add-assign a flat hash map.
+        FlatHashMap& operator +=(const FlatHashMap<T, U>& rhs)
+        {
+            Insert(rhs);
+            return *this;
+        }
+        /// Test for equality with another flat hash map.
+        bool operator ==(const FlatHashMap<T, U>& rhs) const
+        {
+            if (rhs.Size() != Size())
+                return false;
+
+            for (ConstIterator i = Begin(); i != End(); ++i)
+            {
+                ConstIterator j = rhs.Find(i->first_);
+                if (j == rhs.End() || j->second_ != i->second_)
+                    return false;
+            }
+
+            return true;
+        }
+        /// Test for inequality with another flat hash map.
+        bool operator !=(const FlatHashMap<T, U>& rhs) const { return !(*this == rhs); }
+        /// Index the map. Create a new pair if key not found.
+        U& operator [](const T& key)
+        {
+            unsigned mixedHash = MixHash(MakeHash(key));
+            unsigned index = FindSlot(key, mixedHash);
+            if (index == NPOS)
+                index = InsertSlot(mixedHash, key, U());
+            return Slots()[index].second_;
+        }
+        /// Index the map. Return null if key is not found, does not create a new pair.
+        U* operator [](const T& key) const
+        {
+            unsigned index = FindSlot(key, MixHash(MakeHash(key)));
+            return index != NPOS ? &Slots()[index].second_ : nullptr;
+        }
+        /// Populate the map.
+        FlatHashMap& Populate(const T& key, const U& value)
+        {
+            this->operator [](key) = value;
+            return *this;
+        }
+        /// Populate the map using variadic template.
+        template <typename... Args>
+        FlatHashMap& Populate(const T& key, const U& value, const Args&... args)
+        {
+            this->operator [](key) = value;
+            return Populate(args...);
+        }
+        /// Insert a pair. Return an iterator to it.
+        Iterator Insert(const Pair<T, U>& pair)
+        {
+            bool exists;
+            return Insert(pair, exists);
+        }
+        /// Insert a pair. Return iterator and set exists flag according to whether the key already existed.
+        Iterator Insert(const Pair<T, U>& pair, bool& exists)
+        {
+            return Iterator(this, InsertOrAssign(pair.first_, pair.second_, exists));
+        }
+        /// Insert a map.
+        void Insert(const FlatHashMap<T, U>& map)
+        {
+            bool exists;
+            for (ConstIterator it = map.Begin(); it != map.End(); ++it)
+                InsertOrAssign(it->first_, it->second_, exists);
+        }
+        /// Insert a pair by iterator. Return iterator to the value.
+        Iterator Insert(const ConstIterator& it)
+        {
+            bool exists;
+            return Iterator(this, InsertOrAssign(it->first_, it->second_, exists));
+        }
+        /// Insert a range by iterators.
+        void Insert(const ConstIterator& start, const ConstIterator& end)
+        {
+            for (ConstIterator it = start; it != end; ++it)
+                Insert(it);
+        }
+        /// Erase a pair by key. Return true if was found.
+        bool Erase(const T& key)
+        {
+            unsigned index = FindSlot(key, MixHash(MakeHash(key)));
+            if (index == NPOS)
+                return false;
+
+            EraseSlot(index);
+            return true;
+        }
+        /// Erase a pair by iterator. Return iterator to the next pair.
+        Iterator Erase(const Iterator& it)
+        {
+            if (it.map_ != this || it.index_ >= capacity_ || !IsFull(it.index_))
+                return End();
+
+            EraseSlot(it.index_);
+            return Iterator(this, NextFull(it.index_ + 1));
+        }
+        /// Clear the map. Keeps the allocated slots.
+        void Clear()
+        {
+            DestructElements();
+            size_ = 0;
+            ResetCtrl();
+        }
+        /// Reserve slots for at least the specified number of elements without rehashing.
+        void Reserve(unsigned numElements)
+        {
+            unsigned capacity = CapacityForSize(numElements > size_ ? numElements : size_);
+            if (capacity > capacity_)
+                Resize(capacity);
+        }
+        /// Rehash to a specific slot count, which must be a power of two multiple of the group width and hold the current elements. Return true if successful.
+        bool Rehash(unsigned capacity)
+        {
+            if (capacity == capacity_)
+                return true;
+            if (capacity < MIN_CAPACITY || (capacity & (capacity - 1)) || MaxLoad(capacity) < size_)
+                return false;
+
+            Resize(capacity);
+            return true;
+        }
+        /// Return iterator to the pair with key, or end iterator if not found.
+        Iterator Find(const T& key)
+        {
+            unsigned index = FindSlot(key, MixHash(MakeHash(key)));
+            return index != NPOS ? Iterator(this, index) : End();
+        }
+        /// Return const iterator to the pair with key, or end iterator if not found.
+        ConstIterator Find(const T& key) const
+        {
+            unsigned index = FindSlot(key, MixHash(MakeHash(key)));
+            return index != NPOS ? ConstIterator(this, index) : End();
+        }
+        /// Return whether contains a pair with key.
+        bool Contains(const T& key) const { return FindSlot(key, MixHash(MakeHash(key))) != NPOS; }
+        /// Try to copy value to output. Return true if found.
+        bool TryGetValue(const T& key, U& value) const
+        {
+            unsigned index = FindSlot(key, MixHash(MakeHash(key)));
+            if (index == NPOS)
+                return false;
+
+            value = Slots()[index].second_;
+            return true;
+        }
+        /// Return all the keys.
+        Vector<T> Keys() const
+        {
+            Vector<T> result;
+            result.Reserve(Size());
+            for (ConstIterator i = Begin(); i != End(); ++i)
+                result.Push(i->first_);
+            return result;
+        }
+        /// Return all the values.
+        Vector<U> Values() const
+        {
+            Vector<U> result;
+            result.Reserve(Size());
+            for (ConstIterator i = Begin(); i != End(); ++i)
+                result.Push(i->second_);
+            return result;
+        }
+        /// Return iterator to the beginning.
+        Iterator Begin() { return Iterator(this, NextFull(0)); }
+        /// Return const iterator to the beginning.
+        ConstIterator Begin() const { return ConstIterator(this, NextFull(0)); }
+        /// Return iterator to the end.
+        Iterator End() { return Iterator(this, capacity_); }
+        /// Return const iterator to the end.
+        ConstIterator End() const { return ConstIterator(this, capacity_); }
+        /// Return the first pair.
+        const KeyValue& Front() const { return *Begin(); }
+        /// Return the last pair.
+        const KeyValue& Back() const { return *(--End()); }
+
+    private:
+        static_assert(alignof(KeyValue) <= 16, "FlatHashMap slots must not need more than 16-byte alignment");
+
+        /// Return the slot array.
+        KeyValue* Slots() const { return reinterpret_cast<KeyValue*>(slots_); }
+        /// Find the slot holding a key. Return NPOS if not found.
+        unsigned FindSlot(const T& key, unsigned mixedHash) const
+        {
+            if (!size_)
+                return NPOS;
+
+            signed char h2 = H2(mixedHash);
+            unsigned groupMask = NumGroups() - 1;
+            unsigned group = H1(mixedHash);
+            KeyValue* slots = Slots();
+
+            for (unsigned step = 1; ; ++step)
+            {
+                FlatHashGroup g(ctrl_ + group * FlatHashGroup::WIDTH);
+                for (FlatHashMask mask = g.Match(h2); mask; mask.ClearLowest())
+                {
+                    unsigned index = group * FlatHashGroup::WIDTH + mask.LowestIndex();
+                    if (slots[index].first_ == key)
+                        return index;
+                }
+                // An empty slot terminates the probe sequence
+                if (g.MatchEmpty())
+                    return NPOS;
+                group = (group + step) & groupMask;
+            }
+        }
+        /// Insert a pair or assign the value if the key exists. Return the slot index.
+        unsigned InsertOrAssign(const T& key, const U& value, bool& exists)
+        {
+            unsigned mixedHash = MixHash(MakeHash(key));
+            unsigned index = FindSlot(key, mixedHash);
+            exists = index != NPOS;
+            if (exists)
+                Slots()[index].second_ = value;
+            else
+                index = InsertSlot(mixedHash, key, value);
+            return index;
+        }
+        /// Insert a key that is known not to exist. Return the slot index.
+        template <typename K, typename V> unsigned InsertSlot(unsigned mixedHash, K&& key, V&& value)
+        {
+            if (!capacity_)
+                Resize(MIN_CAPACITY);
+
+            unsigned index = FindInsertSlot(mixedHash);
+            if (!growthLeft_ && ctrl_[index] == FLATHASH_EMPTY)
+            {
+                // Out of empty slots. If many slots hold erased markers, rehash in place to clean them up, else grow
+                Resize(size_ * 2 < MaxLoad(capacity_) ? capacity_ : capacity_ << 1);
+                index = FindInsertSlot(mixedHash);
+            }
+
+            if (ctrl_[index] == FLATHASH_EMPTY)
+                --growthLeft_;
+            new (Slots() + index) KeyValue(std::forward<K>(key), std::forward<V>(value));
+            SetCtrl(index, H2(mixedHash));
+            ++size_;
+            return index;
+        }
+        /// Destruct the element in a slot and mark it free.
+        void EraseSlot(unsigned index)
+        {
+            (Slots() + index)->~KeyValue();
+            EraseCtrl(index);
+        }
+        /// Move the elements into newly allocated slots.
+        void Resize(unsigned capacity)
+        {
+            signed char* oldCtrl = ctrl_;
+            KeyValue* oldSlots = Slots();
+            unsigned oldCapacity = capacity_;
+
+            AllocateTable(capacity, (unsigned)sizeof(KeyValue));
+
+            for (unsigned i = 0; i < oldCapacity; ++i)
+            {
+                if (oldCtrl[i] < 0)
+                    continue;
+
+                KeyValue& src = oldSlots[i];
+                unsigned mixedHash = MixHash(MakeHash(src.first_));
+                unsigned index = FindInsertSlot(mixedHash);
+                // The source is destroyed right after, so moving out of the const key is safe
+                new (Slots() + index) KeyValue(std::move(const_cast<T&>(src.first_)), std::move(src.second_));
+                SetCtrl(index, H2(mixedHash));
+                src.~KeyValue();
+            }
+
+            delete[] reinterpret_cast<unsigned char*>(oldCtrl);
+        }
+        /// Call the destructors of all elements.
+        void DestructElements()
+        {
+            if (!size_)
+                return;
+
+            KeyValue* slots = Slots();
+            for (unsigned i = NextFull(0); i < capacity_; i = NextFull(i + 1))
+                (slots + i)->~KeyValue();
+        }
+    };
+
+    template <class T, class U> typename My3D::FlatHashMap<T, U>::ConstIterator begin(const My3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+    template <class T, class U> typename My3D::FlatHashMap<T, U>::ConstIterator end(const My3D::FlatHashMap<T, U>& v) { return v.End(); }
+    template <class T, class U> typename My3D::FlatHashMap<T, U>::Iterator begin(My3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+    template <class T, class U> typename My3D::FlatHashMap<T, U>::Iterator end(My3D::FlatHashMap<T, U>& v) { return v.End(); }
+}
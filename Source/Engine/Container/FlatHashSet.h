@@ -0,0 +1,338 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/FlatHashBase.h"
+#include "Container/Vector.h"
+#include "Container/Hash.h"
+
+#include <cassert>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+
+namespace My3D
+{
+    /// Open-addressing hash set template class. Keys are stored inline in the slot array. Iteration order is
+    /// unspecified, and inserting or erasing invalidates iterators and element pointers.
+    template <typename T> class FlatHashSet : public FlatHashBase
+    {
+    public:
+        /// Flat hash set iterator. Keys can not be modified through it.
+        struct Iterator
+        {
+            /// Construct.
+            Iterator() = default;
+            /// Construct with a set and slot index.
+            Iterator(const FlatHashSet* set, unsigned index)
+                : set_(set)
+                , index_(index)
+            {
+            }
+            /// Test for equality with another iterator.
+            bool operator ==(const Iterator& rhs) const { return index_ == rhs.index_ && set_ == rhs.set_; }
+            /// Test for inequality with another iterator.
+            bool operator !=(const Iterator& rhs) const { return index_ != rhs.index_ || set_ != rhs.set_; }
+            /// Preincrement.
+            Iterator& operator ++()
+            {
+                index_ = set_->NextFull(index_ + 1);
+                return *this;
+            }
+            /// Postincrement.
+            Iterator operator ++(int)
+            {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+            /// Predecrement.
+            Iterator& operator --()
+            {
+                index_ = set_->PrevFull(index_);
+                return *this;
+            }
+            /// Postdecrement.
+            Iterator operator --(int)
+            {
+                Iterator it = *this;
+                --*this;
+                return it;
+            }
+            /// Point to the key.
+            const T* operator ->() const { return set_->Slots() + index_; }
+            /// Dereference the key.
+            const T& operator *() const { return set_->Slots()[index_]; }
+
+            /// Set.
+            const FlatHashSet* set_{};
+            /// Slot index.
+            unsigned index_{};
+        };
+
+        /// Keys are immutable, so the const iterator is the same type.
+        using ConstIterator = Iterator;
+
+        /// Construct empty. Does not allocate.
+        FlatHashSet() = default;
+        /// Copy-construct from another flat hash set.
+        FlatHashSet(const FlatHashSet<T>& set)
+        {
+            Reserve(set.Size());
+            Insert(set);
+        }
+        /// Move-construct from another flat hash set.
+        FlatHashSet(FlatHashSet<T>&& set) noexcept
+        {
+            Swap(set);
+        }
+        /// Aggregate initialization constructor.
+        FlatHashSet(const std::initializer_list<T>& list)
+        {
+            Reserve((unsigned)list.size());
+            for (auto it = list.begin(); it != list.end(); ++it)
+                Insert(*it);
+        }
+        /// Destruct.
+        ~FlatHashSet()
+        {
+            DestructElements();
+            FreeTable();
+        }
+        /// Assign a flat hash set.
+        FlatHashSet& operator =(const FlatHashSet<T>& rhs)
+        {
+            if (&rhs != this)
+            {
+                Clear();
+                Reserve(rhs.Size());
+                Insert(rhs);
+            }
+            return *this;
+        }
+        /// Move-assign a flat hash set.
+        FlatHashSet& operator =(FlatHashSet<T>&& rhs) noexcept
+        {
+            Swap(rhs);
+            return *this;
+        }
+        /// Add-assign a value.
+        FlatHashSet& operator +=(const T& rhs)
+        {
+            Insert(rhs);
+            return *this;
+        }
+        /// Add-assign a flat hash set.
+        FlatHashSet& operator +=(const FlatHashSet<T>& rhs)
+        {
+            Insert(rhs);
+            return *this;
+        }
+        /// Test for equality with another flat hash set.
+        bool operator ==(const FlatHashSet<T>& rhs) const
+        {
+            if (rhs.Size() != Size())
+                return false;
+
+            for (Iterator it = Begin(); it != End(); ++it)
+            {
+                if (!rhs.Contains(*it))
+                    return false;
+            }
+
+            return true;
+        }
+        /// Test for inequality with another flat hash set.
+        bool operator !=(const FlatHashSet<T>& rhs) const { return !(*this == rhs); }
+        /// Insert a key. Return an iterator to it.
+        Iterator Insert(const T& key)
+        {
+            bool exists;
+            return Insert(key, exists);
+        }
+        /// Insert a key. Return an iterator and set exists flag according to whether the key already existed.
+        Iterator Insert(const T& key, bool& exists)
+        {
+            unsigned mixedHash = MixHash(MakeHash(key));
+            unsigned index = FindSlot(key, mixedHash);
+            exists = index != NPOS;
+            if (!exists)
+                index = InsertSlot(mixedHash, key);
+            return Iterator(this, index);
+        }
+        /// Insert a set.
+        void Insert(const FlatHashSet<T>& set)
+        {
+            for (Iterator it = set.Begin(); it != set.End(); ++it)
+                Insert(*it);
+        }
+        /// Erase a key. Return true if was found.
+        bool Erase(const T& key)
+        {
+            unsigned index = FindSlot(key, MixHash(MakeHash(key)));
+            if (index == NPOS)
+                return false;
+
+            EraseSlot(index);
+            return true;
+        }
+        /// Erase a key by iterator. Return iterator to the next key.
+        Iterator Erase(const Iterator& it)
+        {
+            if (it.set_ != this || it.index_ >= capacity_ || !IsFull(it.index_))
+                return End();
+
+            EraseSlot(it.index_);
+            return Iterator(this, NextFull(it.index_ + 1));
+        }
+        /// Clear the set. Keeps the allocated slots.
+        void Clear()
+        {
+            DestructElements();
+            size_ = 0;
+            ResetCtrl();
+        }
+        /// Reserve slots for at least the specified number of keys without rehashing.
+        void Reserve(unsigned numElements)
+        {
+            unsigned capacity = CapacityForSize(numElements > size_ ? numElements : size_);
+            if (capacity > capacity_)
+                Resize(capacity);
+        }
+        /// Rehash to a specific slot count, which must be a power of two multiple of the group width and hold the current keys. Return true if successful.
+        bool Rehash(unsigned capacity)
+        {
+            if (capacity == capacity_)
+                return true;
+            if (capacity < MIN_CAPACITY || (capacity & (capacity - 1)) || MaxLoad(capacity) < size_)
+                return false;
+
+            Resize(capacity);
+            return true;
+        }
+        /// Return iterator to the key, or end iterator if not found.
+        Iterator Find(const T& key) const
+        {
+            unsigned index = FindSlot(key, MixHash(MakeHash(key)));
+            return index != NPOS ? Iterator(this, index) : End();
+        }
+        /// Return whether contains a key.
+        bool Contains(const T& key) const { return FindSlot(key, MixHash(MakeHash(key))) != NPOS; }
+        /// Return all the keys.
+        Vector<T> Keys() const
+        {
+            Vector<T> result;
+            result.Reserve(Size());
+            for (Iterator i = Begin(); i != End(); ++i)
+                result.Push(*i);
+            return result;
+        }
+        /// Return iterator to the beginning.
+        Iterator Begin() const { return Iterator(this, NextFull(0)); }
+        /// Return iterator to the end.
+        Iterator End() const { return Iterator(this, capacity_); }
+        /// Return first key.
+        const T& Front() const { return *Begin(); }
+        /// Return last key.
+        const T& Back() const { return *(--End()); }
+
+    private:
+        static_assert(alignof(T) <= 16, "FlatHashSet slots must not need more than 16-byte alignment");
+
+        /// Return the slot array.
+        T* Slots() const { return reinterpret_cast<T*>(slots_); }
+        /// Find the slot holding a key. Return NPOS if not found.
+        unsigned FindSlot(const T& key, unsigned mixedHash) const
+        {
+            if (!size_)
+                return NPOS;
+
+            signed char h2 = H2(mixedHash);
+            unsigned groupMask = NumGroups() - 1;
+            unsigned group = H1(mixedHash);
+            T* slots = Slots();
+
+            for (unsigned step = 1; ; ++step)
+            {
+                FlatHashGroup g(ctrl_ + group * FlatHashGroup::WIDTH);
+                for (FlatHashMask mask = g.Match(h2); mask; mask.ClearLowest())
+                {
+                    unsigned index = group * FlatHashGroup::WIDTH + mask.LowestIndex();
+                    if (slots[index] == key)
+                        return index;
+                }
+                // An empty slot terminates the probe sequence
+                if (g.MatchEmpty())
+                    return NPOS;
+                group = (group + step) & groupMask;
+            }
+        }
+        /// Insert a key that is known not to exist. Return the slot index.
+        unsigned InsertSlot(unsigned mixedHash, const T& key)
+        {
+            if (!capacity_)
+                Resize(MIN_CAPACITY);
+
+            unsigned index = FindInsertSlot(mixedHash);
+            if (!growthLeft_ && ctrl_[index] == FLATHASH_EMPTY)
+            {
+                // Out of empty slots. If many slots hold erased markers, rehash in place to clean them up, else grow
+                Resize(size_ * 2 < MaxLoad(capacity_) ? capacity_ : capacity_ << 1);
+                index = FindInsertSlot(mixedHash);
+            }
+
+            if (ctrl_[index] == FLATHASH_EMPTY)
+                --growthLeft_;
+            new (Slots() + index) T(key);
+            SetCtrl(index, H2(mixedHash));
+            ++size_;
+            return index;
+        }
+        /// Destruct the key in a slot and mark it free.
+        void EraseSlot(unsigned index)
+        {
+            (Slots() + index)->~T();
+            EraseCtrl(index);
+        }
+        /// Move the keys into newly allocated slots.
+        void Resize(unsigned capacity)
+        {
+            signed char* oldCtrl = ctrl_;
+            T* oldSlots = Slots();
+            unsigned oldCapacity = capacity_;
+
+            AllocateTable(capacity, (unsigned)sizeof(T));
+
+            for (unsigned i = 0; i < oldCapacity; ++i)
+            {
+                if (oldCtrl[i] < 0)
+                    continue;
+
+                T& src = oldSlots[i];
+                unsigned mixedHash = MixHash(MakeHash(src));
+                unsigned index = FindInsertSlot(mixedHash);
+                new (Slots() + index) T(std::move(src));
+                SetCtrl(index, H2(mixedHash));
+                src.~T();
+            }
+
+            delete[] reinterpret_cast<unsigned char*>(oldCtrl);
+        }
+        /// Call the destructors of all keys.
+        void DestructElements()
+        {
+            if (!size_)
+                return;
+
+            T* slots = Slots();
+            for (unsigned i = NextFull(0); i < capacity_; i = NextFull(i + 1))
+                (slots + i)->~T();
+        }
+    };
+
+    template <class T> typename My3D::FlatHashSet<T>::ConstIterator begin(const My3D::FlatHashSet<T>& v) { return v.Begin(); }
+    template <class T> typename My3D::FlatHashSet<T>::ConstIterator end(const My3D::FlatHashSet<T>& v) { return v.End(); }
+}
@@ -0,0 +1,430 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Hash.h"
+#include "Container/Iter.h"
+#include "Container/Pair.h"
+#include "Container/Vector.h"
+#include "Container/VectorBase.h"
+
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace My3D
+{
+    /// Map template class that keeps the pairs in insertion order in one contiguous array, followed in the same allocation by
+    /// a small open-addressing table of pair indices. Meant for small maps such as event parameters and attribute values:
+    /// a map of a few keys is one allocation, a lookup probes the table and compares one key, and iteration walks the array.
+    /// The table is kept at most a quarter full. Inserting or erasing invalidates iterators and element pointers, and erasing
+    /// moves the following pairs and rebuilds the table.
+    template <typename T, typename U> class FlatMap : public VectorBase
+    {
+    public:
+        using KeyType = T;
+        using ValueType = U;
+
+        /// Map key-value pair with const key.
+        class KeyValue
+        {
+        public:
+            /// Construct with default key.
+            KeyValue() : first_(T()) { }
+            /// Construct with key and value.
+            KeyValue(const T& first, const U& second)
+                : first_(first)
+                , second_(second)
+            {
+            }
+            /// Construct with key, forwarding the remaining arguments to the value constructor.
+            template <class K, class... Args, class = typename std::enable_if<std::is_constructible<T, K&&>::value>::type>
+            explicit KeyValue(K&& first, Args&&... args)
+                : first_(std::forward<K>(first))
+                , second_(std::forward<Args>(args)...)
+            {
+            }
+            /// Copy-construct.
+            KeyValue(const KeyValue& value) = default;
+            /// Prevent assignment.
+            KeyValue& operator =(const KeyValue& rhs) = delete;
+            /// Test for equality with another pair.
+            bool operator ==(const KeyValue& rhs) const { return first_ == rhs.first_ && second_ == rhs.second_; }
+            /// Test for inequality with another pair.
+            bool operator !=(const KeyValue& rhs) const { return first_ != rhs.first_ || second_ != rhs.second_; }
+            /// Key.
+            const T first_;
+            /// Value.
+            U second_;
+        };
+
+        using Iterator = RandomAccessIterator<KeyValue>;
+        using ConstIterator = RandomAccessConstIterator<KeyValue>;
+
+        /// Capacity allocated on the first insert. Capacities are powers of two.
+        static const unsigned MIN_CAPACITY = 4;
+
+        /// Construct empty. Does not allocate.
+        FlatMap() noexcept = default;
+        /// Copy-construct from another map.
+        FlatMap(const FlatMap<T, U>& map)
+        {
+            CopyElements(map);
+        }
+        /// Move-construct from another map.
+        FlatMap(FlatMap<T, U>&& map) noexcept
+        {
+            Swap(map);
+        }
+        /// Aggregate initialization constructor.
+        FlatMap(const std::initializer_list<Pair<T, U> >& list)
+        {
+            Reserve((unsigned)list.size());
+            for (auto it = list.begin(); it != list.end(); ++it)
+                Insert(*it);
+        }
+        /// Destruct.
+        ~FlatMap()
+        {
+            DestructElements(0, size_);
+            delete[] buffer_;
+        }
+        /// Assign a map.
+        FlatMap& operator =(const FlatMap<T, U>& rhs)
+        {
+            if (&rhs != this)
+            {
+                Clear();
+                CopyElements(rhs);
+            }
+            return *this;
+        }
+        /// Move-assign a map.
+        FlatMap& operator =(FlatMap<T, U>&& rhs) noexcept
+        {
+            Swap(rhs);
+            return *this;
+        }
+        /// Add-assign a map.
+        FlatMap& operator +=(const FlatMap<T, U>& rhs)
+        {
+            Insert(rhs);
+            return *this;
+        }
+        /// Test for equality with another map.
+        bool operator ==(const FlatMap<T, U>& rhs) const
+        {
+            if (rhs.size_ != size_)
+                return false;
+
+            for (ConstIterator i = Begin(); i != End(); ++i)
+            {
+                ConstIterator j = rhs.Find(i->first_);
+                if (j == rhs.End() || j->second_ != i->second_)
+                    return false;
+            }
+
+            return true;
+        }
+        /// Test for inequality with another map.
+        bool operator !=(const FlatMap<T, U>& rhs) const { return !(*this == rhs); }
+        /// Index the map. Create a new pair if key not found.
+        U& operator [](const T& key)
+        {
+            unsigned index = FindIndex(key);
+            return index != size_ ? Pairs()[index].second_ : InsertElement(key).second_;
+        }
+        /// Index the map. Return null if key is not found, does not create a new pair.
+        U* operator [](const T& key) const
+        {
+            unsigned index = FindIndex(key);
+            return index != size_ ? &Pairs()[index].second_ : nullptr;
+        }
+        /// Populate the map.
+        FlatMap& Populate(const T& key, const U& value)
+        {
+            this->operator [](key) = value;
+            return *this;
+        }
+        /// Populate the map using variadic template.
+        template <typename... Args>
+        FlatMap& Populate(const T& key, const U& value, const Args&... args)
+        {
+            this->operator [](key) = value;
+            return Populate(args...);
+        }
+        /// Insert a pair. Return an iterator to it.
+        Iterator Insert(const Pair<T, U>& pair)
+        {
+            bool exists;
+            return Insert(pair, exists);
+        }
+        /// Insert a pair. Return iterator and set exists flag according to whether the key already existed.
+        Iterator Insert(const Pair<T, U>& pair, bool& exists)
+        {
+            return Iterator(Pairs() + InsertOrAssign(pair.first_, pair.second_, exists));
+        }
+        /// Insert a map.
+        void Insert(const FlatMap<T, U>& map)
+        {
+            if (!size_)
+            {
+                if (&map != this)
+                    CopyElements(map);
+                return;
+            }
+
+            bool exists;
+            for (ConstIterator it = map.Begin(); it != map.End(); ++it)
+                InsertOrAssign(it->first_, it->second_, exists);
+        }
+        /// Insert a pair by iterator. Return iterator to the value.
+        Iterator Insert(const ConstIterator& it)
+        {
+            bool exists;
+            return Iterator(Pairs() + InsertOrAssign(it->first_, it->second_, exists));
+        }
+        /// Insert a range by iterators.
+        void Insert(const ConstIterator& start, const ConstIterator& end)
+        {
+            for (ConstIterator it = start; it != end; ++it)
+                Insert(it);
+        }
+        /// Construct the value in place from the arguments, replacing an existing value. Return iterator to the pair.
+        template <typename... Args> Iterator Emplace(const T& key, Args&&... args)
+        {
+            unsigned index = FindIndex(key);
+            if (index != size_)
+                Pairs()[index].second_ = U(std::forward<Args>(args)...);
+            else
+                InsertElement(key, std::forward<Args>(args)...);
+            return Iterator(Pairs() + index);
+        }
+        /// Erase a pair by key. Return true if was found.
+        bool Erase(const T& key)
+        {
+            unsigned index = FindIndex(key);
+            if (index == size_)
+                return false;
+
+            EraseElement(index);
+            return true;
+        }
+        /// Erase a pair by iterator. Return iterator to the next pair.
+        Iterator Erase(const Iterator& it)
+        {
+            auto index = (unsigned)(it.ptr_ - Pairs());
+            if (index >= size_)
+                return End();
+
+            EraseElement(index);
+            return Iterator(Pairs() + index);
+        }
+        /// Clear the map. Keeps the allocated buffer.
+        void Clear()
+        {
+            DestructElements(0, size_);
+            size_ = 0;
+            if (capacity_)
+                memset(Table(), 0, TableSize(capacity_) * sizeof(unsigned));
+        }
+        /// Reserve space for at least the specified number of pairs.
+        void Reserve(unsigned numElements)
+        {
+            if (numElements > capacity_)
+                Reallocate(NextCapacity(numElements));
+        }
+        /// Return iterator to the pair with key, or end iterator if not found.
+        Iterator Find(const T& key) { return Iterator(Pairs() + FindIndex(key)); }
+        /// Return const iterator to the pair with key, or end iterator if not found.
+        ConstIterator Find(const T& key) const { return ConstIterator(Pairs() + FindIndex(key)); }
+        /// Return whether contains a pair with key.
+        bool Contains(const T& key) const { return FindIndex(key) != size_; }
+        /// Try to copy value to output. Return true if found.
+        bool TryGetValue(const T& key, U& value) const
+        {
+            unsigned index = FindIndex(key);
+            if (index == size_)
+                return false;
+
+            value = Pairs()[index].second_;
+            return true;
+        }
+        /// Return all the keys.
+        Vector<T> Keys() const
+        {
+            Vector<T> result;
+            result.Reserve(size_);
+            for (ConstIterator i = Begin(); i != End(); ++i)
+                result.Push(i->first_);
+            return result;
+        }
+        /// Return all the values.
+        Vector<U> Values() const
+        {
+            Vector<U> result;
+            result.Reserve(size_);
+            for (ConstIterator i = Begin(); i != End(); ++i)
+                result.Push(i->second_);
+            return result;
+        }
+        /// Return iterator to the beginning.
+        Iterator Begin() { return Iterator(Pairs()); }
+        /// Return const iterator to the beginning.
+        ConstIterator Begin() const { return ConstIterator(Pairs()); }
+        /// Return iterator to the end.
+        Iterator End() { return Iterator(Pairs() + size_); }
+        /// Return const iterator to the end.
+        ConstIterator End() const { return ConstIterator(Pairs() + size_); }
+        /// Return the first pair.
+        const KeyValue& Front() const { return Pairs()[0]; }
+        /// Return the last pair.
+        const KeyValue& Back() const { return Pairs()[size_ - 1]; }
+        /// Return number of pairs.
+        unsigned Size() const { return size_; }
+        /// Return number of pairs that fit without reallocating.
+        unsigned Capacity() const { return capacity_; }
+        /// Return whether the map is empty.
+        bool Empty() const { return size_ == 0; }
+
+    private:
+        /// Return the pair array.
+        KeyValue* Pairs() const { return reinterpret_cast<KeyValue*>(buffer_); }
+        /// Return the index table, which holds the pair index plus one for used slots and zero for free ones.
+        unsigned* Table() const { return reinterpret_cast<unsigned*>(buffer_ + capacity_ * sizeof(KeyValue)); }
+        /// Return index table size for a capacity.
+        static unsigned TableSize(unsigned capacity) { return capacity << 2; }
+        /// Return the smallest power of two capacity that holds the number of pairs.
+        static unsigned NextCapacity(unsigned numElements)
+        {
+            unsigned capacity = MIN_CAPACITY;
+            while (capacity < numElements)
+                capacity <<= 1;
+            return capacity;
+        }
+        /// Return the first table slot to probe for a key.
+        static unsigned FirstSlot(const T& key, unsigned mask) { return MakeHash(key) & mask; }
+        /// Return index of the pair with key, or size if not found.
+        unsigned FindIndex(const T& key) const
+        {
+            if (!size_)
+                return size_;
+
+            const KeyValue* pairs = Pairs();
+            const unsigned* table = Table();
+            unsigned mask = TableSize(capacity_) - 1;
+            for (unsigned slot = FirstSlot(key, mask); table[slot]; slot = (slot + 1) & mask)
+            {
+                if (pairs[table[slot] - 1].first_ == key)
+                    return table[slot] - 1;
+            }
+            return size_;
+        }
+        /// Insert a pair or assign the value if the key exists. Return the index.
+        unsigned InsertOrAssign(const T& key, const U& value, bool& exists)
+        {
+            unsigned index = FindIndex(key);
+            exists = index != size_;
+            if (exists)
+                Pairs()[index].second_ = value;
+            else
+                InsertElement(key, value);
+            return index;
+        }
+        /// Append a pair whose key is known not to exist. Return the pair.
+        template <typename... Args> KeyValue& InsertElement(const T& key, Args&&... args)
+        {
+            if (size_ == capacity_)
+                Reallocate(capacity_ ? capacity_ << 1 : MIN_CAPACITY);
+
+            KeyValue* pair = new (Pairs() + size_) KeyValue(key, std::forward<Args>(args)...);
+            AddToTable(key, size_++);
+            return *pair;
+        }
+        /// Erase the pair at index, moving the following pairs down and rebuilding the table.
+        void EraseElement(unsigned index)
+        {
+            KeyValue* pairs = Pairs();
+            (pairs + index)->~KeyValue();
+            for (unsigned i = index + 1; i < size_; ++i)
+                MoveElement(pairs + i - 1, pairs + i);
+            --size_;
+            RebuildTable();
+        }
+        /// Enter a pair index into the first free slot of its key's probe sequence.
+        void AddToTable(const T& key, unsigned index)
+        {
+            unsigned* table = Table();
+            unsigned mask = TableSize(capacity_) - 1;
+            unsigned slot = FirstSlot(key, mask);
+            while (table[slot])
+                slot = (slot + 1) & mask;
+            table[slot] = index + 1;
+        }
+        /// Clear the table and enter all pairs.
+        void RebuildTable();
+        /// Move the pairs to a new buffer of the capacity and rebuild the table.
+        void Reallocate(unsigned capacity);
+        /// Copy the pairs of another map into this empty one.
+        void CopyElements(const FlatMap<T, U>& map)
+        {
+            if (!map.size_)
+                return;
+
+            Reserve(map.size_);
+            KeyValue* pairs = Pairs();
+            for (unsigned i = 0; i < map.size_; ++i)
+                new (pairs + i) KeyValue(map.Pairs()[i]);
+            size_ = map.size_;
+            RebuildTable();
+        }
+        /// Call the destructors of a range of pairs.
+        void DestructElements(unsigned start, unsigned end)
+        {
+            KeyValue* pairs = Pairs();
+            for (unsigned i = start; i < end; ++i)
+                (pairs + i)->~KeyValue();
+        }
+        /// Move-construct a pair to uninitialized memory and destruct the source.
+        static void MoveElement(KeyValue* dest, KeyValue* src)
+        {
+            // The source is destroyed right after, so moving out of the const key is safe
+            new (dest) KeyValue(std::move(const_cast<T&>(src->first_)), std::move(src->second_));
+            src->~KeyValue();
+        }
+    };
+
+    // The rebuild and reallocation paths are defined outside the class so that they are not implicitly inline, which keeps
+    // them out of operator [] and lets the lookup fast path inline into callers.
+    template <typename T, typename U> void FlatMap<T, U>::RebuildTable()
+    {
+        memset(Table(), 0, TableSize(capacity_) * sizeof(unsigned));
+        KeyValue* pairs = Pairs();
+        for (unsigned i = 0; i < size_; ++i)
+            AddToTable(pairs[i].first_, i);
+    }
+
+    template <typename T, typename U> void FlatMap<T, U>::Reallocate(unsigned capacity)
+    {
+        KeyValue* oldPairs = Pairs();
+        unsigned char* newBuffer = AllocateBuffer((unsigned)(capacity * sizeof(KeyValue) + TableSize(capacity) * sizeof(unsigned)));
+        auto* newPairs = reinterpret_cast<KeyValue*>(newBuffer);
+        for (unsigned i = 0; i < size_; ++i)
+            MoveElement(newPairs + i, oldPairs + i);
+
+        delete[] buffer_;
+        buffer_ = newBuffer;
+        capacity_ = capacity;
+        RebuildTable();
+    }
+
+    template <class T, class U> typename My3D::FlatMap<T, U>::ConstIterator begin(const My3D::FlatMap<T, U>& v) { return v.Begin(); }
+    template <class T, class U> typename My3D::FlatMap<T, U>::ConstIterator end(const My3D::FlatMap<T, U>& v) { return v.End(); }
+    template <class T, class U> typename My3D::FlatMap<T, U>::Iterator begin(My3D::FlatMap<T, U>& v) { return v.Begin(); }
+    template <class T, class U> typename My3D::FlatMap<T, U>::Iterator end(My3D::FlatMap<T, U>& v) { return v.End(); }
+}
@@ -9,6 +9,9 @@
 #include "Container/Vector.h"
 #include "Container/Hash.h"
 
+#include <type_traits>
+#include <utility>
+
 
 namespace My3D
 {
@@ -31,6 +34,13 @@ namespace My3D
                 , second_(second)
             {
             }
+            /// Construct with key, forwarding the remaining arguments to the value constructor
+            template <class K, class... Args, class = typename std::enable_if<std::is_constructible<T, K&&>::value>::type>
+            KeyValue(K&& first, Args&&... args)
+                : first_(std::forward<K>(first))
+                , second_(std::forward<Args>(args)...)
+            {
+            }
             /// Copy-construct
             KeyValue(const KeyValue& value)
                 : first_(value.first_)
@@ -54,9 +64,9 @@ namespace My3D
         {
             /// Construct default
             Node() = default;
-            /// Construct with key and value
-            Node(const T& key, const U& value)
-                : pair_(key, value)
+            /// Construct with key and value constructor arguments
+            template <class K, class... Args> explicit Node(K&& key, Args&&... args)
+                : pair_(std::forward<K>(key), std::forward<Args>(args)...)
             {
             }
             /// Key-value pair
@@ -260,11 +270,21 @@ namespace My3D
         U& operator[](const T& key)
         {
             if (!ptrs_)
-                return InsertNode(key, U(), false)->pair_.second_;
+                return EmplaceNode(key)->pair_.second_;
 
             unsigned hashKey = Hash(key);
             Node* node = FindNode(key, hashKey);
-            return node ? node->pair_.second_ : InsertNode(key, U(), false)->pair_.second_;
+            return node ? node->pair_.second_ : EmplaceNode(key)->pair_.second_;
+        }
+        /// Index the map. Create a new pair by moving the key if key not found
+        U& operator[](T&& key)
+        {
+            if (!ptrs_)
+                return EmplaceNode(std::move(key))->pair_.second_;
+
+            unsigned hashKey = Hash(key);
+            Node* node = FindNode(key, hashKey);
+            return node ? node->pair_.second_ : EmplaceNode(std::move(key))->pair_.second_;
         }
         /// Index the map. Return null if key is not found, dose not creat a new pair.
         U* operator [](const T& key) const
@@ -295,6 +315,11 @@ namespace My3D
         {
             return Iterator(InsertNode(pair.first_, pair.second_));
         }
+        /// Insert a pair by moving the key and value. Return an iterator to it
+        Iterator Insert(Pair<T, U>&& pair)
+        {
+            return Iterator(InsertNode(std::move(pair.first_), std::move(pair.second_)));
+        }
         /// Insert a pair. Return iterator and set exists flag according to whether the key already existed.
         Iterator Insert(const Pair<T, U>& pair, bool& exists)
         {
@@ -303,6 +328,30 @@ namespace My3D
             exists = (Size() == oldSize);
             return ret;
         }
+        /// Insert a pair by moving the key and value. Return iterator and set exists flag according to whether the key already existed.
+        Iterator Insert(Pair<T, U>&& pair, bool& exists)
+        {
+            unsigned oldSize = Size();
+            Iterator ret(InsertNode(std::move(pair.first_), std::move(pair.second_)));
+            exists = (Size() == oldSize);
+            return ret;
+        }
+        /// Construct the value in place from arguments. An existing value is replaced. Return an iterator to the pair.
+        template <class... Args> Iterator Emplace(const T& key, Args&&... args) { return Iterator(EmplaceOrAssign(key, std::forward<Args>(args)...)); }
+        /// Construct the value in place from arguments, moving the key. An existing value is replaced. Return an iterator to the pair.
+        template <class... Args> Iterator Emplace(T&& key, Args&&... args) { return Iterator(EmplaceOrAssign(std::move(key), std::forward<Args>(args)...)); }
+        /// Construct the value in place from arguments only if the key does not exist. The arguments are left untouched otherwise.
+        /// Return an iterator to the pair and whether it was inserted.
+        template <class... Args> Pair<Iterator, bool> TryEmplace(const T& key, Args&&... args)
+        {
+            return TryEmplaceNode(key, std::forward<Args>(args)...);
+        }
+        /// Construct the value in place from arguments, moving the key, only if the key does not exist. The arguments are left
+        /// untouched otherwise. Return an iterator to the pair and whether it was inserted.
+        template <class... Args> Pair<Iterator, bool> TryEmplace(T&& key, Args&&... args)
+        {
+            return TryEmplaceNode(std::move(key), std::forward<Args>(args)...);
+        }
         /// Insert a map
         void Insert(const HashMap<T, U>& map)
         {
@@ -324,7 +373,10 @@ namespace My3D
         {
             ConstIterator it = start;
             while (it != end)
+            {
                 InsertNode(it->first_, it->second_);
+                ++it;
+            }
         }
         /// Erase a pair by key. Return true if was found.
         bool Erase(const T& key)
@@ -521,25 +573,57 @@ namespace My3D
             }
             return nullptr;
         }
-        /// Insert a key and value and return either the new or existing node
-        Node* InsertNode(const T& key, const U& value, bool findExisting = true)
+        /// Insert a key and value and return either the new or existing node. The value of an existing node is assigned.
+        template <class K, class V> Node* InsertNode(K&& key, V&& value)
         {
-            if (!ptrs_)
-                AllocateBuckets(Size(), MIN_BUCKETS);
-
-            unsigned hashKey = Hash(key);
+            if (ptrs_)
+            {
+                Node* existing = FindNode(key, Hash(key));
+                if (existing)
+                {
+                    existing->pair_.second_ = std::forward<V>(value);
+                    return existing;
+                }
+            }
 
-            if (findExisting)
+            return EmplaceNode(std::forward<K>(key), std::forward<V>(value));
+        }
+        /// Insert a key and a value constructed from arguments, or assign a value constructed from them to an existing node.
+        template <class K, class... Args> Node* EmplaceOrAssign(K&& key, Args&&... args)
+        {
+            if (ptrs_)
             {
-                Node* existing = FindNode(key, hashKey);
+                Node* existing = FindNode(key, Hash(key));
                 if (existing)
                 {
-                    existing->pair_.second_ = value;
+                    existing->pair_.second_ = U(std::forward<Args>(args)...);
                     return existing;
                 }
             }
 
-            Node* newNode = InsertNode(Tail(), key, value);
+            return EmplaceNode(std::forward<K>(key), std::forward<Args>(args)...);
+        }
+        /// Insert a key and a value constructed from arguments unless the key exists. Return the node and whether it was inserted.
+        template <class K, class... Args> Pair<Iterator, bool> TryEmplaceNode(K&& key, Args&&... args)
+        {
+            if (ptrs_)
+            {
+                Node* existing = FindNode(key, Hash(key));
+                if (existing)
+                    return Pair<Iterator, bool>(Iterator(existing), false);
+            }
+
+            return Pair<Iterator, bool>(Iterator(EmplaceNode(std::forward<K>(key), std::forward<Args>(args)...)), true);
+        }
+        /// Insert a new node with the key and a value constructed from arguments. The key must not exist yet.
+        template <class K, class... Args> Node* EmplaceNode(K&& key, Args&&... args)
+        {
+            if (!ptrs_)
+                AllocateBuckets(Size(), MIN_BUCKETS);
+
+            unsigned hashKey = Hash(key);
+
+            Node* newNode = InsertNodeAt(Tail(), std::forward<K>(key), std::forward<Args>(args)...);
             newNode->down_ = Ptrs()[hashKey];
             Ptrs()[hashKey] = newNode;
 
@@ -553,11 +637,11 @@ namespace My3D
             return newNode;
         }
         /// Insert a node into the list. Return the new node.
-        Node* InsertNode(Node* dest, const T& key, const U& value)
+        template <class K, class... Args> Node* InsertNodeAt(Node* dest, K&& key, Args&&... args)
         {
             if (!dest)
                 return nullptr;
-            Node* newNode = ReserveNode(key, value);
+            Node* newNode = ReserveNode(std::forward<K>(key), std::forward<Args>(args)...);
             Node* prev = dest->Prev();
             newNode->next_ = dest;
             newNode->prev_ = prev;
@@ -600,11 +684,11 @@ namespace My3D
             new (newNode) Node();
             return newNode;
         }
-        /// Reserve a node with specified key and value
-        Node* ReserveNode(const T& key, const U& value)
+        /// Reserve a node with specified key and value constructor arguments
+        template <class K, class... Args> Node* ReserveNode(K&& key, Args&&... args)
         {
             auto* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
-            new (newNode) Node(key, value);
+            new (newNode) Node(std::forward<K>(key), std::forward<Args>(args)...);
             return newNode;
         }
         /// Free a node
@@ -7,6 +7,7 @@
 #include "Container/HashBase.h"
 
 #include <cassert>
+#include <utility>
 
 
 namespace My3D
@@ -22,6 +23,8 @@ namespace My3D
             Node() = default;
             /// Construct with key
             explicit Node(const T& key) : key_(key) { }
+            /// Construct by moving the key
+            explicit Node(T&& key) : key_(std::move(key)) { }
             /// Key
             T key_;
             /// Return next node
@@ -227,34 +230,9 @@ namespace My3D
             return false;
         }
         /// Insert a key. Return an iterator to it.
-        Iterator Insert(const T& key)
-        {
-            // If no pointers yet, allocate with minimum bucket count
-            if (!ptrs_)
-            {
-                AllocateBuckets(Size(), MIN_BUCKETS);
-                Rehash();
-            }
-
-            unsigned hashKey = Hash(key);
-
-            Node* existing = FindNode(key, hashKey);
-            if (existing)
-                return Iterator(existing);
-
-            Node* newNode = InsertNode(Tail(), key);
-            newNode->down_ = Ptrs()[hashKey];
-            Ptrs()[hashKey] = newNode;
-
-            // Rehash if the maximum load factor has been exceeded
-            if (Size() > NumBuckets() * MAX_LOAD_FACTOR)
-            {
-                AllocateBuckets(Size(), NumBuckets() << 1);
-                Rehash();
-            }
-
-            return Iterator(newNode);
-        }
+        Iterator Insert(const T& key) { return InsertKey(key); }
+        /// Insert a key by moving it. The key is left untouched if it already existed. Return an iterator to it.
+        Iterator Insert(T&& key) { return InsertKey(std::move(key)); }
         /// Insert a key. Return an iterator and set exists flag according to whether the key already existed.
         Iterator Insert(const T& key, bool& exists)
         {
@@ -263,6 +241,19 @@ namespace My3D
             exists = (Size() == oldSize);
             return ret;
         }
+        /// Insert a key by moving it. Return an iterator and set exists flag according to whether the key already existed.
+        Iterator Insert(T&& key, bool& exists)
+        {
+            unsigned oldSize = Size();
+            Iterator ret = Insert(std::move(key));
+            exists = (Size() == oldSize);
+            return ret;
+        }
+        /// Construct a key from arguments and move it into the set. Return an iterator to the new or existing key.
+        template <class... Args> Iterator Emplace(Args&&... args)
+        {
+            return InsertKey(T(std::forward<Args>(args)...));
+        }
         /// Insert a set.
         void Insert(const HashSet<T>& set)
         {
@@ -274,7 +265,7 @@ namespace My3D
         /// Insert a key by iterator. Return iterator to the value.
         Iterator Insert(const ConstIterator& it)
         {
-            return Iterator(InsertNode(*it));
+            return Insert(*it);
         }
         /// Erase a key. Return true if was found.
         bool Erase(const T& key)
@@ -448,13 +439,42 @@ namespace My3D
 
             return 0;
         }
+        /// Insert a key unless it already exists. Return an iterator to it.
+        template <class K> Iterator InsertKey(K&& key)
+        {
+            // If no pointers yet, allocate with minimum bucket count
+            if (!ptrs_)
+            {
+                AllocateBuckets(Size(), MIN_BUCKETS);
+                Rehash();
+            }
+
+            unsigned hashKey = Hash(key);
+
+            Node* existing = FindNode(key, hashKey);
+            if (existing)
+                return Iterator(existing);
+
+            Node* newNode = InsertNode(Tail(), std::forward<K>(key));
+            newNode->down_ = Ptrs()[hashKey];
+            Ptrs()[hashKey] = newNode;
+
+            // Rehash if the maximum load factor has been exceeded
+            if (Size() > NumBuckets() * MAX_LOAD_FACTOR)
+            {
+                AllocateBuckets(Size(), NumBuckets() << 1);
+                Rehash();
+            }
+
+            return Iterator(newNode);
+        }
         /// Insert a node into the list. Return the new node.
-        Node* InsertNode(Node* dest, const T& key)
+        template <class K> Node* InsertNode(Node* dest, K&& key)
         {
             if (!dest)
                 return 0;
 
-            Node* newNode = ReserveNode(key);
+            Node* newNode = ReserveNode(std::forward<K>(key));
             Node* prev = dest->Prev();
             newNode->next_ = dest;
             newNode->prev_ = prev;
@@ -500,10 +520,10 @@ namespace My3D
             return newNode;
         }
         /// Reserve a node with specified key.
-        Node* ReserveNode(const T& key)
+        template <class K> Node* ReserveNode(K&& key)
         {
             auto* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
-            new(newNode) Node(key);
+            new(newNode) Node(std::forward<K>(key));
             return newNode;
         }
         /// Free a node.
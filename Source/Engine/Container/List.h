@@ -6,6 +6,7 @@
 
 #include "Container/ListBase.h"
 #include <initializer_list>
+#include <utility>
 
 
 namespace My3D
@@ -17,10 +18,10 @@ template <typename T> class List : public ListBase
         /// List node
         struct Node : public ListNodeBase
         {
-            /// Construct undefined
-            Node() = default;
-            /// Construct with value
-            explicit Node(const T& value) : value_(value) { }
+            /// Construct with a value-initialized value
+            Node() : value_() { }
+            /// Construct the value from arguments
+            template <class... Args> explicit Node(Args&&... args) : value_(std::forward<Args>(args)...) { }
 
             /// Node value
             T value_;
@@ -150,9 +151,13 @@ template <typename T> class List : public ListBase
         /// Destruct.
         ~List()
         {
-            Clear();
-            FreeNode(Tail());
-            AllocatorUninitialize(allocator_);
+            // A moved-from list has no allocator and no tail node
+            if (allocator_)
+            {
+                Clear();
+                FreeNode(Tail());
+                AllocatorUninitialize(allocator_);
+            }
         }
         /// Assign from another list.
         List& operator =(const List<T>& rhs)
@@ -222,10 +227,31 @@ template <typename T> class List : public ListBase
         }
         /// Insert an element to the end.
         void Push(const T& value) { InsertNode(Tail(), value); }
+        /// Move an element to the end.
+        void Push(T&& value) { InsertNode(Tail(), std::move(value)); }
         /// Insert an element to the beginning.
         void PushFront(const T& value) { InsertNode(Head(), value); }
+        /// Move an element to the beginning.
+        void PushFront(T&& value) { InsertNode(Head(), std::move(value)); }
         /// Insert an element at position.
         void Insert(const Iterator& dest, const T& value) { InsertNode(static_cast<Node*>(dest.ptr_), value); }
+        /// Move an element to position.
+        void Insert(const Iterator& dest, T&& value) { InsertNode(static_cast<Node*>(dest.ptr_), std::move(value)); }
+        /// Construct an element in place at the end. Return a reference to it.
+        template <class... Args> T& EmplaceBack(Args&&... args)
+        {
+            return InsertNode(Tail(), std::forward<Args>(args)...)->value_;
+        }
+        /// Construct an element in place at the beginning. Return a reference to it.
+        template <class... Args> T& EmplaceFront(Args&&... args)
+        {
+            return InsertNode(Head(), std::forward<Args>(args)...)->value_;
+        }
+        /// Construct an element in place at position. Return an iterator to it.
+        template <class... Args> Iterator Emplace(const Iterator& dest, Args&&... args)
+        {
+            return Iterator(InsertNode(static_cast<Node*>(dest.ptr_), std::forward<Args>(args)...));
+        }
         /// Insert a list at position.
         void Insert(const Iterator& dest, const List<T>& list)
         {
@@ -347,13 +373,13 @@ template <typename T> class List : public ListBase
         Node* Head() const { return static_cast<Node*>(head_); }
         /// return the tail node
         Node* Tail() const { return static_cast<Node*>(tail_); }
-        /// Allocate and insert a node into the list.
-        void InsertNode(Node* dest, const T& value)
+        /// Allocate and insert a node into the list, constructing the value from the arguments. Return the new node.
+        template <class... Args> Node* InsertNode(Node* dest, Args&&... args)
         {
             if (!dest)
-                return;
+                return nullptr;
 
-            Node* newNode = ReserveNode(value);
+            Node* newNode = ReserveNode(std::forward<Args>(args)...);
             Node* prev = dest->Prev();
             newNode->next_ = dest;
             newNode->prev_ = prev;
@@ -366,6 +392,7 @@ template <typename T> class List : public ListBase
                 head_ = newNode;
 
             ++size_;
+            return newNode;
         }
         /// Erase and free a node. Return pointer to the next node, or to the end if could not erase.
         Node* EraseNode(Node* node)
@@ -396,11 +423,11 @@ template <typename T> class List : public ListBase
             new (newNode) Node();
             return newNode;
         }
-        /// Reserve a node with initial node
-        Node* ReserveNode(const T& value)
+        /// Reserve a node and construct its value from the arguments
+        template <class A, class... Args> Node* ReserveNode(A&& a, Args&&... args)
         {
             auto* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
-            new (newNode) Node(value);
+            new (newNode) Node(std::forward<A>(a), std::forward<Args>(args)...);
             return newNode;
         }
         /// Free a node
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <utility>
+
 namespace My3D
 {
 
@@ -18,6 +20,12 @@ public:
             , second_(second)
     {
     }
+    /// Construct by moving values
+    Pair(T&& first, U&& second)
+            : first_(std::move(first))
+            , second_(std::move(second))
+    {
+    }
     /// Test for equality with another pair.
     bool operator ==(const Pair<T, U>& rhs) const { return first_ == rhs.first_ && second_ == rhs.second_; }
     /// Test for inequality with another pair.
@@ -115,10 +115,8 @@ public:
         T* ptr = ptr_;
         if (ptr)
         {
-            RefCount* refCount = RefCountPtr();
-            ++refCount->refs_;
-            Reset();
-            --refCount->refs_;
+            ptr_ = nullptr;
+            ptr->refs_.fetch_sub(1, std::memory_order_acq_rel);
         }
 
         return ptr;
@@ -145,7 +143,7 @@ public:
     int Refs() const { return ptr_ ? ptr_->Refs() : 0; }
     /// Return the object weak reference count
     int WeakRefs() const { return ptr_ ? ptr_->WeakRefs() : 0; }
-    /// Return pointer to the RefCount
+    /// Return pointer to the RefCount. Allocates it if the object had no weak references yet
     RefCount* RefCountPtr() const { return ptr_ ? ptr_->RefCountPtr() : nullptr; }
     /// Return pointer to the HashSet & HashMap
     unsigned ToHash() const { return (unsigned)((size_t)ptr_) / sizeof(T);}
@@ -341,14 +339,14 @@ public:
     /// Check if the pointer it not null
     bool NotNull() const { return refCount_ != nullptr; }
     /// Return the object's reference count, or 0 if null pointer or if object has expired.
-    bool Refs() const { return (refCount_ && refCount_->refs_ >= 0) ? refCount_->refs_ : 0; }
+    int Refs() const { return Expired() ? 0 : ptr_->Refs(); }
     /// Return the object's weak reference count
     int WeakRefs() const
     {
         if (!Expired())
             return ptr_->WeakRefs();
         else
-            return refCount_ ? refCount_->weakRefs_ : 0;
+            return refCount_ ? refCount_->weakRefs_.load() : 0;
     }
     /// Return whether the object has expired. If null pointer, always return true.
     bool Expired() const { return refCount_ ? refCount_->refs_ < 0 : true; }
@@ -374,9 +372,9 @@ private:
         if (refCount_)
         {
             assert(refCount_->weakRefs_ > 0);
-            --(refCount_->weakRefs_);
 
-            if (Expired() && !refCount_->weakRefs_)
+            // A live object holds a weak reference of its own, so the last one means the object has expired
+            if (refCount_->weakRefs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
                 delete refCount_;
         }
 
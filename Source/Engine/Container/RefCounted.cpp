@@ -6,48 +6,48 @@ namespace My3D
 {
 
 RefCounted::RefCounted()
-    : refCount_(new RefCount())
+    : refs_(0)
+    , refCount_(nullptr)
 {
-    (refCount_->weakRefs_)++;
 }
 
 RefCounted::~RefCounted()
 {
-    assert(refCount_);
-    assert(refCount_->refs_ == 0);
-    assert(refCount_->weakRefs_ > 0);
-
-    refCount_->refs_ = -1;
-    (refCount_->weakRefs_)--;
-    if (!refCount_->weakRefs_)
-        delete refCount_;
-
+    assert(refs_.load(std::memory_order_relaxed) == 0);
+
+    // Mark the object expired for weak pointers and drop its own weak reference
+    RefCount* refCount = refCount_.load(std::memory_order_acquire);
+    if (refCount)
+    {
+        refCount->refs_ = -1;
+        if (refCount->weakRefs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete refCount;
+    }
+
+    refs_ = -1;
     refCount_ = nullptr;
 }
 
-void RefCounted::AddRef()
-{
-    assert(refCount_->refs_ >= 0);
-    (refCount_->refs_)++;
-}
-
-void RefCounted::ReleaseRef()
+int RefCounted::WeakRefs() const
 {
-    assert(refCount_->refs_ > 0);
-    (refCount_->refs_)--;
-    if (!refCount_->refs_)
-        delete this;
+    RefCount* refCount = refCount_.load(std::memory_order_acquire);
+    return refCount ? refCount->weakRefs_.load(std::memory_order_relaxed) - 1 : 0;
 }
 
-int RefCounted::Refs() const
+RefCount* RefCounted::RefCountPtr()
 {
-    return refCount_->refs_;
+    RefCount* refCount = refCount_.load(std::memory_order_acquire);
+    if (refCount)
+        return refCount;
+
+    // Several threads may race to create the block; the loser deletes its own
+    auto* newRefCount = new RefCount();
+    newRefCount->weakRefs_ = 1;
+    if (refCount_.compare_exchange_strong(refCount, newRefCount, std::memory_order_acq_rel))
+        return newRefCount;
+
+    delete newRefCount;
+    return refCount;
 }
 
-int RefCounted::WeakRefs() const
-{
-    return refCount_->weakRefs_ - 1;
 }
-
-
-}
\ No newline at end of file
@@ -5,19 +5,28 @@
 
 #include "My3D.h"
 
+#include <atomic>
+#include <cassert>
+
 
 namespace My3D
 {
 
+/// Weak reference count block. Outlives the object while weak pointers to it exist.
 struct RefCount
 {
     RefCount() : refs_(0), weakRefs_(0) { }
     ~RefCount() { refs_ = -1; weakRefs_ = -1; }
 
-    int refs_;
-    int weakRefs_;
+    /// Strong reference count for ArrayPtr. For a RefCounted object only tells whether it is alive (0) or expired (-1).
+    std::atomic<int> refs_;
+    /// Weak reference count. A live RefCounted object holds one weak reference to its own block.
+    std::atomic<int> weakRefs_;
 };
 
+/// Base class for intrusively reference-counted objects. The strong reference count lives in the object and is atomic,
+/// so shared pointers can be handed between threads. The weak reference count block is allocated only when the first
+/// weak pointer to the object is created.
 class MY3D_API RefCounted
 {
 public:
@@ -27,16 +36,35 @@ public:
     RefCounted(const RefCounted& rhs) = delete;
     RefCounted& operator=(const RefCounted& rhs) = delete;
 
-    void AddRef();
-    void ReleaseRef();
+    /// Increment reference count. Can be called from any thread.
+    void AddRef()
+    {
+        assert(refs_.load(std::memory_order_relaxed) >= 0);
+        refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    /// Decrement reference count and delete self if no more references. Can be called from any thread.
+    void ReleaseRef()
+    {
+        assert(refs_.load(std::memory_order_relaxed) > 0);
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
 
-    int Refs() const;
+    /// Return reference count.
+    int Refs() const { return refs_.load(std::memory_order_relaxed); }
+    /// Return weak reference count.
     int WeakRefs() const;
 
-    RefCount* RefCountPtr() { return refCount_; }
+    /// Return pointer to the weak reference count block, allocating it on first use.
+    RefCount* RefCountPtr();
 
 private:
-    RefCount* refCount_;
+    template <typename T> friend class SharedPtr;
+
+    /// Strong reference count.
+    std::atomic<int> refs_;
+    /// Weak reference count block, null until a weak pointer is created.
+    std::atomic<RefCount*> refCount_;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,240 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Vector.h"
+
+#include <utility>
+
+
+namespace My3D
+{
+    /// Index value that marks no slot.
+    static const unsigned SLOTMAP_NO_INDEX = 0xffffffff;
+
+    /// Versioned handle to a slot map value. Stays invalid after the value is erased, even if the slot is reused.
+    struct SlotHandle
+    {
+        /// Test for equality with another handle.
+        bool operator ==(const SlotHandle& rhs) const { return index_ == rhs.index_ && version_ == rhs.version_; }
+        /// Test for inequality with another handle.
+        bool operator !=(const SlotHandle& rhs) const { return !(*this == rhs); }
+        /// Return hash value for HashSet & HashMap.
+        unsigned ToHash() const { return index_ * 31 + version_; }
+
+        /// Slot index.
+        unsigned index_{SLOTMAP_NO_INDEX};
+        /// Slot version. Zero is never used by an occupied slot.
+        unsigned version_{};
+    };
+
+    /// Generational slot map. Values are stored densely for fast iteration, and addressed through a slot array either by
+    /// versioned handle or directly by slot index. Freed slots are reused in first-in first-out order, and erasing moves the last
+    /// value into the hole, so the iteration order is not stable.
+    template <class T> class SlotMap
+    {
+    public:
+        using ValueType = T;
+        using Iterator = typename Vector<T>::Iterator;
+        using ConstIterator = typename Vector<T>::ConstIterator;
+
+        /// Insert a value into a free slot and return its handle.
+        SlotHandle Insert(const T& value) { return Emplace(value); }
+        /// Insert a value into a free slot by moving and return its handle.
+        SlotHandle Insert(T&& value) { return Emplace(std::move(value)); }
+        /// Construct a value in a free slot and return its handle.
+        template <class... Args> SlotHandle Emplace(Args&&... args)
+        {
+            if (freeHead_ == SLOTMAP_NO_INDEX)
+                AddFreeSlots(slots_.Size() + 1);
+            unsigned index = freeHead_;
+            Unlink(index);
+            return Occupy(index, std::forward<Args>(args)...);
+        }
+        /// Construct a value in the slot at index, growing the slot array if needed. An existing value in the slot is replaced
+        /// and keeps its handle.
+        template <class... Args> SlotHandle EmplaceAt(unsigned index, Args&&... args)
+        {
+            if (index < slots_.Size() && slots_[index].value_ != SLOTMAP_NO_INDEX)
+            {
+                values_[slots_[index].value_] = T(std::forward<Args>(args)...);
+                return {index, slots_[index].version_};
+            }
+
+            if (index >= slots_.Size())
+                AddFreeSlots(index + 1);
+            Unlink(index);
+            return Occupy(index, std::forward<Args>(args)...);
+        }
+        /// Erase a value by handle. Return true if was found and erased.
+        bool Erase(const SlotHandle& handle) { return Contains(handle) && EraseAt(handle.index_); }
+        /// Erase the value in the slot at index. Return true if the slot was occupied.
+        bool EraseAt(unsigned index)
+        {
+            if (!ContainsAt(index))
+                return false;
+
+            Slot& slot = slots_[index];
+            unsigned last = values_.Size() - 1;
+            if (slot.value_ != last)
+            {
+                values_[slot.value_] = std::move(values_[last]);
+                valueSlots_[slot.value_] = valueSlots_[last];
+                slots_[valueSlots_[last]].value_ = slot.value_;
+            }
+            values_.Pop();
+            valueSlots_.Pop();
+
+            slot.value_ = SLOTMAP_NO_INDEX;
+            if (!++slot.version_)
+                slot.version_ = 1;
+            LinkBack(index);
+            return true;
+        }
+        /// Erase all values. Slot versions are kept, so handles to erased values stay invalid.
+        void Clear()
+        {
+            for (unsigned i = 0; i < valueSlots_.Size(); ++i)
+            {
+                Slot& slot = slots_[valueSlots_[i]];
+                slot.value_ = SLOTMAP_NO_INDEX;
+                if (!++slot.version_)
+                    slot.version_ = 1;
+            }
+            values_.Clear();
+            valueSlots_.Clear();
+            ResetFreeList();
+        }
+        /// Relink the free slots in ascending index order, so that the next insertions reuse the lowest indices first.
+        void ResetFreeList()
+        {
+            freeHead_ = freeTail_ = SLOTMAP_NO_INDEX;
+            for (unsigned i = 0; i < slots_.Size(); ++i)
+            {
+                if (slots_[i].value_ == SLOTMAP_NO_INDEX)
+                    LinkBack(i);
+            }
+        }
+        /// Reserve value and slot storage.
+        void Reserve(unsigned capacity)
+        {
+            values_.Reserve(capacity);
+            valueSlots_.Reserve(capacity);
+            slots_.Reserve(capacity);
+        }
+
+        /// Return value by handle, or null if the handle is no longer valid.
+        T* Get(const SlotHandle& handle) { return Contains(handle) ? &values_[slots_[handle.index_].value_] : nullptr; }
+        /// Return const value by handle, or null if the handle is no longer valid.
+        const T* Get(const SlotHandle& handle) const { return Contains(handle) ? &values_[slots_[handle.index_].value_] : nullptr; }
+        /// Return value in the slot at index, or null if the slot is free.
+        T* GetAt(unsigned index) { return ContainsAt(index) ? &values_[slots_[index].value_] : nullptr; }
+        /// Return const value in the slot at index, or null if the slot is free.
+        const T* GetAt(unsigned index) const { return ContainsAt(index) ? &values_[slots_[index].value_] : nullptr; }
+        /// Return whether the handle refers to an existing value.
+        bool Contains(const SlotHandle& handle) const { return ContainsAt(handle.index_) && slots_[handle.index_].version_ == handle.version_; }
+        /// Return whether the slot at index is occupied.
+        bool ContainsAt(unsigned index) const { return index < slots_.Size() && slots_[index].value_ != SLOTMAP_NO_INDEX; }
+        /// Return handle to the value in the slot at index, or an invalid handle if the slot is free.
+        SlotHandle GetHandle(unsigned index) const { return ContainsAt(index) ? SlotHandle{index, slots_[index].version_} : SlotHandle(); }
+        /// Return slot index of the value at a dense position, for use while iterating the values.
+        unsigned GetSlotIndex(unsigned valueIndex) const { return valueSlots_[valueIndex]; }
+        /// Return index of the slot the next Insert would use.
+        unsigned GetFreeIndex() const { return freeHead_ != SLOTMAP_NO_INDEX ? freeHead_ : slots_.Size(); }
+
+        /// Return the densely stored values.
+        const Vector<T>& GetValues() const { return values_; }
+        /// Return iterator to the first value.
+        Iterator Begin() { return values_.Begin(); }
+        /// Return const iterator to the first value.
+        ConstIterator Begin() const { return values_.Begin(); }
+        /// Return iterator to the end.
+        Iterator End() { return values_.End(); }
+        /// Return const iterator to the end.
+        ConstIterator End() const { return values_.End(); }
+        /// Return number of values.
+        unsigned Size() const { return values_.Size(); }
+        /// Return number of slots, both occupied and free.
+        unsigned NumSlots() const { return slots_.Size(); }
+        /// Return whether has no values.
+        bool Empty() const { return values_.Empty(); }
+
+    private:
+        /// Slot of the indirection array.
+        struct Slot
+        {
+            /// Index of the value, or SLOTMAP_NO_INDEX if the slot is free.
+            unsigned value_;
+            /// Version, incremented when the value is erased.
+            unsigned version_;
+            /// Previous free slot.
+            unsigned prevFree_;
+            /// Next free slot.
+            unsigned nextFree_;
+        };
+
+        /// Grow the slot array to the specified size, adding the new slots to the end of the free list.
+        void AddFreeSlots(unsigned size)
+        {
+            unsigned oldSize = slots_.Size();
+            slots_.Resize(size);
+            for (unsigned i = oldSize; i < size; ++i)
+            {
+                slots_[i].value_ = SLOTMAP_NO_INDEX;
+                slots_[i].version_ = 1;
+                LinkBack(i);
+            }
+        }
+        /// Add a free slot to the end of the free list.
+        void LinkBack(unsigned index)
+        {
+            Slot& slot = slots_[index];
+            slot.prevFree_ = freeTail_;
+            slot.nextFree_ = SLOTMAP_NO_INDEX;
+            if (freeTail_ != SLOTMAP_NO_INDEX)
+                slots_[freeTail_].nextFree_ = index;
+            else
+                freeHead_ = index;
+            freeTail_ = index;
+        }
+        /// Remove a free slot from the free list.
+        void Unlink(unsigned index)
+        {
+            Slot& slot = slots_[index];
+            if (slot.prevFree_ != SLOTMAP_NO_INDEX)
+                slots_[slot.prevFree_].nextFree_ = slot.nextFree_;
+            else
+                freeHead_ = slot.nextFree_;
+            if (slot.nextFree_ != SLOTMAP_NO_INDEX)
+                slots_[slot.nextFree_].prevFree_ = slot.prevFree_;
+            else
+                freeTail_ = slot.prevFree_;
+        }
+        /// Construct a value for an unlinked free slot.
+        template <class... Args> SlotHandle Occupy(unsigned index, Args&&... args)
+        {
+            slots_[index].value_ = values_.Size();
+            values_.EmplaceBack(std::forward<Args>(args)...);
+            valueSlots_.Push(index);
+            return {index, slots_[index].version_};
+        }
+
+        /// Densely stored values.
+        Vector<T> values_;
+        /// Slot index of each value.
+        PODVector<unsigned> valueSlots_;
+        /// Slots.
+        PODVector<Slot> slots_;
+        /// First free slot.
+        unsigned freeHead_{SLOTMAP_NO_INDEX};
+        /// Last free slot.
+        unsigned freeTail_{SLOTMAP_NO_INDEX};
+    };
+
+    template <class T> typename SlotMap<T>::ConstIterator begin(const SlotMap<T>& v) { return v.Begin(); }
+    template <class T> typename SlotMap<T>::ConstIterator end(const SlotMap<T>& v) { return v.End(); }
+    template <class T> typename SlotMap<T>::Iterator begin(SlotMap<T>& v) { return v.Begin(); }
+    template <class T> typename SlotMap<T>::Iterator end(SlotMap<T>& v) { return v.End(); }
+}
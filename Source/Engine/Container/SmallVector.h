@@ -0,0 +1,369 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Vector.h"
+
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+
+
+namespace My3D
+{
+    /// %Vector of POD elements that stores up to N elements inline and only allocates from the heap when it grows beyond that.
+    /// Uses the same iterator types as PODVector, so the Sort helpers and iterator-based algorithms work unchanged.
+    template <typename T, unsigned N> class SmallVector
+    {
+        static_assert(N > 0, "SmallVector needs a nonzero inline capacity");
+
+    public:
+        using ValueType = T;
+        using Iterator = RandomAccessIterator<T>;
+        using ConstIterator = RandomAccessConstIterator<T>;
+
+        /// Construct empty.
+        SmallVector() noexcept
+            : buffer_(InlineBuffer())
+        {
+        }
+        /// Construct with initial size.
+        explicit SmallVector(unsigned size)
+            : SmallVector()
+        {
+            Resize(size);
+        }
+        /// Construct with initial data.
+        SmallVector(const T* data, unsigned size)
+            : SmallVector()
+        {
+            Resize(size);
+            CopyElements(buffer_, data, size);
+        }
+        /// Construct from a PODVector.
+        explicit SmallVector(const PODVector<T>& vector)
+            : SmallVector(vector.Buffer(), vector.Size())
+        {
+        }
+        /// Copy-construct from another vector.
+        SmallVector(const SmallVector<T, N>& vector)
+            : SmallVector(vector.buffer_, vector.size_)
+        {
+        }
+        /// Move-construct from another vector.
+        SmallVector(SmallVector<T, N>&& vector) noexcept
+            : SmallVector()
+        {
+            *this = std::move(vector);
+        }
+        /// Aggregate initialization constructor.
+        SmallVector(const std::initializer_list<T>& list)
+            : SmallVector()
+        {
+            Reserve((unsigned)list.size());
+            for (const T& element : list)
+                Push(element);
+        }
+        /// Destruct.
+        ~SmallVector()
+        {
+            if (!IsInline())
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+        }
+        /// Assign from another vector.
+        SmallVector<T, N>& operator =(const SmallVector<T, N>& rhs)
+        {
+            if (&rhs != this)
+            {
+                Resize(rhs.size_);
+                CopyElements(buffer_, rhs.buffer_, rhs.size_);
+            }
+            return *this;
+        }
+        /// Move-assign from another vector. A heap buffer is taken over, inline elements are copied.
+        SmallVector<T, N>& operator =(SmallVector<T, N>&& rhs) noexcept
+        {
+            if (&rhs == this)
+                return *this;
+
+            if (!rhs.IsInline())
+            {
+                if (!IsInline())
+                    delete[] reinterpret_cast<unsigned char*>(buffer_);
+                buffer_ = rhs.buffer_;
+                capacity_ = rhs.capacity_;
+                rhs.buffer_ = rhs.InlineBuffer();
+                rhs.capacity_ = N;
+            }
+            else
+            {
+                // Fits in either buffer, so no allocation can happen
+                CopyElements(buffer_, rhs.buffer_, rhs.size_);
+            }
+
+            size_ = rhs.size_;
+            rhs.size_ = 0;
+            return *this;
+        }
+        /// Test for equality with another vector.
+        bool operator ==(const SmallVector<T, N>& rhs) const
+        {
+            if (rhs.size_ != size_)
+                return false;
+
+            for (unsigned i = 0; i < size_; ++i)
+            {
+                if (buffer_[i] != rhs.buffer_[i])
+                    return false;
+            }
+
+            return true;
+        }
+        /// Test for inequality with another vector.
+        bool operator !=(const SmallVector<T, N>& rhs) const { return !(*this == rhs); }
+        /// Return element at index.
+        T& operator [](unsigned index)
+        {
+            assert(index < size_);
+            return buffer_[index];
+        }
+        /// Return const element at index.
+        const T& operator [](unsigned index) const
+        {
+            assert(index < size_);
+            return buffer_[index];
+        }
+        /// Return element at index.
+        T& At(unsigned index)
+        {
+            assert(index < size_);
+            return buffer_[index];
+        }
+        /// Return const element at index.
+        const T& At(unsigned index) const
+        {
+            assert(index < size_);
+            return buffer_[index];
+        }
+
+        /// Add an element at the end.
+        void Push(const T& value)
+        {
+            if (size_ == capacity_)
+            {
+                // The value may live in the buffer that is about to move
+                T copy = value;
+                Grow(size_ + 1);
+                buffer_[size_++] = copy;
+            }
+            else
+                buffer_[size_++] = value;
+        }
+        /// Add elements at the end.
+        void Push(const T* data, unsigned count)
+        {
+            Insert(End(), data, data + count);
+        }
+        /// Remove the last element.
+        void Pop()
+        {
+            if (size_)
+                --size_;
+        }
+        /// Insert an element at position.
+        void Insert(unsigned pos, const T& value)
+        {
+            if (pos > size_)
+                pos = size_;
+
+            T copy = value;
+            unsigned oldSize = size_;
+            Resize(size_ + 1);
+            MoveRange(pos + 1, pos, oldSize - pos);
+            buffer_[pos] = copy;
+        }
+        /// Insert elements by iterators.
+        Iterator Insert(const Iterator& dest, const ConstIterator& start, const ConstIterator& end)
+        {
+            return Insert(dest, start.ptr_, end.ptr_);
+        }
+        /// Insert elements. The source range must not be in this vector.
+        Iterator Insert(const Iterator& dest, const T* start, const T* end)
+        {
+            auto pos = (unsigned)(dest - Begin());
+            if (pos > size_)
+                pos = size_;
+
+            auto length = (unsigned)(end - start);
+            Resize(size_ + length);
+            MoveRange(pos + length, pos, size_ - pos - length);
+            CopyElements(buffer_ + pos, start, length);
+
+            return Begin() + pos;
+        }
+        /// Erase a range of elements.
+        void Erase(unsigned pos, unsigned length = 1)
+        {
+            if (!length || pos + length > size_)
+                return;
+
+            MoveRange(pos, pos + length, size_ - pos - length);
+            size_ -= length;
+        }
+        /// Erase an element by iterator. Return iterator to the next element.
+        Iterator Erase(const Iterator& it)
+        {
+            auto pos = (unsigned)(it - Begin());
+            if (pos >= size_)
+                return End();
+
+            Erase(pos);
+            return Begin() + pos;
+        }
+        /// Erase an element by swapping the last element into its place.
+        void EraseSwap(unsigned pos)
+        {
+            if (pos >= size_)
+                return;
+
+            buffer_[pos] = buffer_[size_ - 1];
+            --size_;
+        }
+        /// Erase an element by value. Return true if was found and erased.
+        bool Remove(const T& value)
+        {
+            Iterator it = Find(value);
+            if (it == End())
+                return false;
+
+            Erase(it);
+            return true;
+        }
+        /// Clear the vector. Keeps the buffer.
+        void Clear() { size_ = 0; }
+        /// Resize the vector. New elements are left uninitialized.
+        void Resize(unsigned newSize)
+        {
+            if (newSize > capacity_)
+                Grow(newSize);
+            size_ = newSize;
+        }
+        /// Set new capacity. Never shrinks below the inline capacity.
+        void Reserve(unsigned newCapacity)
+        {
+            if (newCapacity > capacity_)
+                Reallocate(newCapacity);
+        }
+        /// Swap with another vector.
+        void Swap(SmallVector<T, N>& vector)
+        {
+            SmallVector<T, N> temp(std::move(vector));
+            vector = std::move(*this);
+            *this = std::move(temp);
+        }
+
+        /// Return iterator to value, or to the end if not found.
+        Iterator Find(const T& value)
+        {
+            Iterator it = Begin();
+            while (it != End() && *it != value)
+                ++it;
+            return it;
+        }
+        /// Return const iterator to value, or to the end if not found.
+        ConstIterator Find(const T& value) const
+        {
+            ConstIterator it = Begin();
+            while (it != End() && *it != value)
+                ++it;
+            return it;
+        }
+        /// Return index of value in vector, or size if not found.
+        unsigned IndexOf(const T& value) const { return (unsigned)(Find(value) - Begin()); }
+        /// Return whether contains a specific value.
+        bool Contains(const T& value) const { return Find(value) != End(); }
+
+        /// Return iterator to the beginning.
+        Iterator Begin() { return Iterator(buffer_); }
+        /// Return const iterator to the beginning.
+        ConstIterator Begin() const { return ConstIterator(buffer_); }
+        /// Return iterator to the end.
+        Iterator End() { return Iterator(buffer_ + size_); }
+        /// Return const iterator to the end.
+        ConstIterator End() const { return ConstIterator(buffer_ + size_); }
+        /// Return first element.
+        T& Front() { assert(size_); return buffer_[0]; }
+        /// Return const first element.
+        const T& Front() const { assert(size_); return buffer_[0]; }
+        /// Return last element.
+        T& Back() { assert(size_); return buffer_[size_ - 1]; }
+        /// Return const last element.
+        const T& Back() const { assert(size_); return buffer_[size_ - 1]; }
+        /// Return the buffer.
+        T* Buffer() const { return buffer_; }
+        /// Return number of elements.
+        unsigned Size() const { return size_; }
+        /// Return capacity of vector.
+        unsigned Capacity() const { return capacity_; }
+        /// Return whether vector is empty.
+        bool Empty() const { return size_ == 0; }
+        /// Return whether the elements are stored inline.
+        bool IsInline() const { return buffer_ == InlineBuffer(); }
+
+        /// Inline capacity.
+        static const unsigned INLINE_CAPACITY = N;
+
+    private:
+        /// Return the inline buffer.
+        T* InlineBuffer() const { return const_cast<T*>(reinterpret_cast<const T*>(inlineBuffer_)); }
+        /// Grow the capacity to hold at least the specified number of elements.
+        void Grow(unsigned minCapacity)
+        {
+            unsigned newCapacity = capacity_;
+            while (newCapacity < minCapacity)
+                newCapacity += (newCapacity + 1) >> 1u;
+            Reallocate(newCapacity);
+        }
+        /// Move the elements to a new heap buffer.
+        void Reallocate(unsigned newCapacity)
+        {
+            auto* newBuffer = reinterpret_cast<T*>(new unsigned char[newCapacity * sizeof(T)]);
+            CopyElements(newBuffer, buffer_, size_);
+            if (!IsInline())
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+            buffer_ = newBuffer;
+            capacity_ = newCapacity;
+        }
+        /// Move a range of elements within the vector.
+        void MoveRange(unsigned dest, unsigned src, unsigned count)
+        {
+            if (count)
+                memmove(buffer_ + dest, buffer_ + src, count * sizeof(T));
+        }
+        /// Copy elements from one buffer to another.
+        static void CopyElements(T* dest, const T* src, unsigned count)
+        {
+            if (count)
+                memcpy(dest, src, count * sizeof(T));
+        }
+
+        /// Buffer, points to the inline buffer until the vector grows beyond it.
+        T* buffer_;
+        /// Size of vector.
+        unsigned size_{};
+        /// Buffer capacity.
+        unsigned capacity_{N};
+        /// Inline buffer.
+        alignas(T) unsigned char inlineBuffer_[N * sizeof(T)];
+    };
+
+    template <typename T, unsigned N> const unsigned SmallVector<T, N>::INLINE_CAPACITY;
+
+    template <typename T, unsigned N> typename SmallVector<T, N>::ConstIterator begin(const SmallVector<T, N>& v) { return v.Begin(); }
+    template <typename T, unsigned N> typename SmallVector<T, N>::ConstIterator end(const SmallVector<T, N>& v) { return v.End(); }
+    template <typename T, unsigned N> typename SmallVector<T, N>::Iterator begin(SmallVector<T, N>& v) { return v.Begin(); }
+    template <typename T, unsigned N> typename SmallVector<T, N>::Iterator end(SmallVector<T, N>& v) { return v.End(); }
+}
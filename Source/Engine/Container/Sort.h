@@ -6,12 +6,16 @@
 
 #include "Container/Swap.h"
 #include "Container/Iter.h"
-#include "Container/VectorBase.h"
+#include "Container/Vector.h"
+
+#include <cstring>
+#include <type_traits>
 
 
 namespace My3D
 {
     static const int QUICKSORT_THRESHOLD = 16;
+    static const int RADIXSORT_THRESHOLD = 64;
 
     /// Perform insertion sort on an array.
     template <typename T> void InsertionSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end)
@@ -120,4 +124,106 @@ namespace My3D
         InitialQuickSort(begin, end, compare);
         InsertionSort(begin, end, compare);
     }
+
+    /// Return radix sort key of an unsigned integer.
+    inline unsigned RadixKey(unsigned value) { return value; }
+    /// Return radix sort key of a signed integer. Flips the sign bit so that negative values sort first.
+    inline unsigned RadixKey(int value) { return (unsigned)value ^ 0x80000000u; }
+    /// Return radix sort key of an unsigned long integer.
+    inline unsigned long long RadixKey(unsigned long value) { return value; }
+    /// Return radix sort key of a long integer.
+    inline unsigned long long RadixKey(long value) { return (unsigned long long)(long long)value ^ 0x8000000000000000ull; }
+    /// Return radix sort key of an unsigned long long integer.
+    inline unsigned long long RadixKey(unsigned long long value) { return value; }
+    /// Return radix sort key of a long long integer.
+    inline unsigned long long RadixKey(long long value) { return (unsigned long long)value ^ 0x8000000000000000ull; }
+    /// Return radix sort key of a float. Negative values have all bits flipped, positive values the sign bit only.
+    inline unsigned RadixKey(float value)
+    {
+        unsigned bits;
+        memcpy(&bits, &value, sizeof bits);
+        return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+    /// Return radix sort key of a double.
+    inline unsigned long long RadixKey(double value)
+    {
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof bits);
+        return (bits & 0x8000000000000000ull) ? ~bits : bits | 0x8000000000000000ull;
+    }
+
+    /// Sort stably in ascending order of a key using LSD radix sort, one byte of the key per pass. The key function returns an
+    /// integer or floating point key for an element. Bytes that are equal in all keys are skipped. The scratch buffer is resized
+    /// as needed; keep it between calls to avoid allocating every frame. Small arrays are insertion sorted.
+    template <class T, class U> void RadixSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U getKey,
+        PODVector<unsigned char>& scratch)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "RadixSort requires trivially copyable elements");
+        using KeyType = decltype(RadixKey(getKey(*begin)));
+        static const unsigned NUM_PASSES = sizeof(KeyType);
+
+        auto count = (unsigned)(end - begin);
+        if (count < 2)
+            return;
+        if (count < RADIXSORT_THRESHOLD)
+        {
+            InsertionSort(begin, end, [&getKey](const T& lhs, const T& rhs) { return RadixKey(getKey(lhs)) < RadixKey(getKey(rhs)); });
+            return;
+        }
+
+        // Scratch holds two key arrays followed by the temporary element array
+        auto valueOffset = (unsigned)((2 * count * sizeof(KeyType) + alignof(T) - 1) & ~(alignof(T) - 1));
+        scratch.Resize(valueOffset + count * (unsigned)sizeof(T));
+        auto* keys = reinterpret_cast<KeyType*>(scratch.Buffer());
+        KeyType* tempKeys = keys + count;
+        T* values = begin.ptr_;
+        auto* tempValues = reinterpret_cast<T*>(scratch.Buffer() + valueOffset);
+
+        // Extract keys once and count the digits of all passes
+        unsigned histogram[NUM_PASSES][256] = {};
+        for (unsigned i = 0; i < count; ++i)
+        {
+            KeyType key = RadixKey(getKey(values[i]));
+            keys[i] = key;
+            for (unsigned pass = 0; pass < NUM_PASSES; ++pass)
+                ++histogram[pass][(key >> (pass * 8u)) & 0xffu];
+        }
+
+        for (unsigned pass = 0; pass < NUM_PASSES; ++pass)
+        {
+            unsigned* counts = histogram[pass];
+            unsigned shift = pass * 8u;
+            if (counts[(keys[0] >> shift) & 0xffu] == count)
+                continue;
+
+            unsigned offset = 0;
+            for (unsigned digit = 0; digit < 256; ++digit)
+            {
+                unsigned digitCount = counts[digit];
+                counts[digit] = offset;
+                offset += digitCount;
+            }
+
+            for (unsigned i = 0; i < count; ++i)
+            {
+                unsigned index = counts[(keys[i] >> shift) & 0xffu]++;
+                tempKeys[index] = keys[i];
+                tempValues[index] = values[i];
+            }
+
+            Swap(keys, tempKeys);
+            Swap(values, tempValues);
+        }
+
+        // Copy back if the last pass left the elements in scratch
+        if (values != begin.ptr_)
+            memcpy(begin.ptr_, values, count * sizeof(T));
+    }
+
+    /// Sort stably in ascending order of a key using LSD radix sort. Allocates a temporary scratch buffer.
+    template <class T, class U> void RadixSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U getKey)
+    {
+        PODVector<unsigned char> scratch;
+        RadixSort(begin, end, getKey, scratch);
+    }
 }
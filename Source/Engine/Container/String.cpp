@@ -12,10 +12,10 @@
 namespace My3D
 {
 
-char String::endZero = '\0';
 const String String::EMPTY;
 const unsigned String::NPOS;
 const unsigned String::MIN_CAPACITY;
+const unsigned String::INLINE_CAPACITY;
 
 
 int String::Compare(const char *lhs, const char *rhs, bool casSensitive)
@@ -46,7 +46,11 @@ void String::Swap(String &str)
 {
     My3D::Swap(length_, str.length_);
     My3D::Swap(capacity_, str.capacity_);
-    My3D::Swap(buffer_, str.buffer_);
+    // Swap the whole inline buffer, which also covers the heap buffer pointer
+    char temp[INLINE_CAPACITY];
+    memcpy(temp, inlineBuffer_, INLINE_CAPACITY);
+    memcpy(inlineBuffer_, str.inlineBuffer_, INLINE_CAPACITY);
+    memcpy(str.inlineBuffer_, temp, INLINE_CAPACITY);
 }
 
 void String::Clear()
@@ -58,17 +62,29 @@ void String::Reserve(unsigned newCapacity)
 {
     if (newCapacity < length_ + 1)
         newCapacity = length_ + 1;
+    if (newCapacity <= INLINE_CAPACITY)
+    {
+        // Move back to the inline buffer if the data fits
+        if (capacity_)
+        {
+            char* oldBuffer = heapBuffer_;
+            CopyChars(inlineBuffer_, oldBuffer, length_ + 1);
+            delete[] oldBuffer;
+            capacity_ = 0;
+        }
+        return;
+    }
     if (newCapacity == capacity_)
         return;
 
     auto* newBuffer = new char[newCapacity];
     // Move the existing data to the new buffer, then delete the old buffer
-    CopyChars(newBuffer, buffer_, length_ + 1);
+    CopyChars(newBuffer, Buffer(), length_ + 1);
     if (capacity_)
-        delete[] buffer_;
+        delete[] heapBuffer_;
 
     capacity_ = newCapacity;
-    buffer_ = newBuffer;
+    heapBuffer_ = newBuffer;
 }
 
 void String::Compact()
@@ -81,13 +97,17 @@ void String::Resize(unsigned int newLength)
 {
     if (!capacity_)
     {
-        if (!newLength)
-            return;
-
-        capacity_ = newLength + 1;
-        if (capacity_ < MIN_CAPACITY)
-            capacity_ = MIN_CAPACITY;
-        buffer_ = new char[capacity_];
+        if (newLength >= INLINE_CAPACITY)
+        {
+            unsigned newCapacity = newLength + 1;
+            if (newCapacity < MIN_CAPACITY)
+                newCapacity = MIN_CAPACITY;
+
+            auto* newBuffer = new char[newCapacity];
+            CopyChars(newBuffer, inlineBuffer_, length_);
+            capacity_ = newCapacity;
+            heapBuffer_ = newBuffer;
+        }
     }
     else
     {
@@ -98,20 +118,19 @@ void String::Resize(unsigned int newLength)
 
             auto* newBuffer = new char[capacity_];
             if (length_)
-                CopyChars(newBuffer, buffer_, length_);
-            delete[] buffer_;
-            buffer_ = newBuffer;
+                CopyChars(newBuffer, heapBuffer_, length_);
+            delete[] heapBuffer_;
+            heapBuffer_ = newBuffer;
         }
     }
 
-    buffer_[newLength] = 0;
+    Buffer()[newLength] = 0;
     length_ = newLength;
 }
 
 String::String(const WString& str)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
 
 }
@@ -119,7 +138,6 @@ String::String(const WString& str)
 String::String(int value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%d", value);
@@ -128,8 +146,7 @@ String::String(int value)
 
 String::String(short value) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%d", value);
@@ -139,7 +156,6 @@ String::String(short value) :
 String::String(long value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%ld", value);
@@ -149,7 +165,6 @@ String::String(long value)
 String::String(long long value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%lld", value);
@@ -159,7 +174,6 @@ String::String(long long value)
 String::String(unsigned value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%u", value);
@@ -169,7 +183,6 @@ String::String(unsigned value)
 String::String(unsigned short value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%u", value);
@@ -179,7 +192,6 @@ String::String(unsigned short value)
 String::String(unsigned long value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%lu", value);
@@ -189,7 +201,6 @@ String::String(unsigned long value)
 String::String(unsigned long long value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%llu", value);
@@ -199,7 +210,6 @@ String::String(unsigned long long value)
 String::String(float value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%g", value);
@@ -209,7 +219,6 @@ String::String(float value)
 String::String(double value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%.15g", value);
@@ -219,7 +228,6 @@ String::String(double value)
 String::String(bool value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     if (value)
         *this = "true";
@@ -231,20 +239,18 @@ String::String(bool value)
 String::String(char value)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     Resize(1);
-    buffer_[0] = value;
+    Buffer()[0] = value;
 }
 
 String::String(char value, unsigned length)
     : length_(0)
     , capacity_(0)
-    , buffer_(&endZero)
 {
     Resize(length);
     for (unsigned i = 0; i < length; ++i)
-        buffer_[i] = value;
+        Buffer()[i] = value;
 }
 
 String& String::operator +=(int rhs)
@@ -417,7 +423,7 @@ String& String::Append(const char *str, unsigned int length)
     {
         unsigned oldLength = length_;
         Resize(oldLength + length);
-        CopyChars(&buffer_[oldLength], str, length);
+        CopyChars(&Buffer()[oldLength], str, length);
     }
 
     return *this;
@@ -456,7 +462,7 @@ void String::Insert(unsigned pos, char c)
         unsigned oldLength = length_;
         Resize(length_ + 1);
         MoveRange(pos + 1, pos, oldLength - pos);
-        buffer_[pos] = c;
+        Buffer()[pos] = c;
     }
 }
 
@@ -523,7 +529,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (buffer_[i] == c)
+            if (Buffer()[i] == c)
                 return i;
         }
     }
@@ -532,7 +538,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(Buffer()[i]) == c)
                 return i;
         }
     }
@@ -545,13 +551,13 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
     if (!str.length_ || str.length_ > length_)
         return NPOS;
 
-    char first = str.buffer_[0];
+    char first = str.Buffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i <= length_ - str.length_; ++i)
     {
-        char c = buffer_[i];
+        char c = Buffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -561,8 +567,8 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = Buffer()[i + j];
+                char d = str.Buffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -597,7 +603,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (buffer_[i] == c)
+            if (Buffer()[i] == c)
                 return i;
         }
     }
@@ -606,7 +612,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(Buffer()[i]) == c)
                 return i;
         }
     }
@@ -621,13 +627,13 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
     if (startPos > length_ - str.length_)
         startPos = length_ - str.length_;
 
-    char first = str.buffer_[0];
+    char first = str.Buffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i < length_; --i)
     {
-        char c = buffer_[i];
+        char c = Buffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -636,8 +642,8 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = Buffer()[i + j];
+                char d = str.Buffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -683,7 +689,7 @@ String String::ToLower() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char) tolower(buffer_[i]);
+        ret[i] = (char) tolower(Buffer()[i]);
 
     return ret;
 }
@@ -692,7 +698,7 @@ String String::ToUpper() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char) toupper(buffer_[i]);
+        ret[i] = (char) toupper(Buffer()[i]);
 
     return ret;
 }
@@ -704,7 +710,7 @@ String String::Trimmed() const
 
     while (trimStart < trimEnd)
     {
-        char c = buffer_[trimStart];
+        char c = Buffer()[trimStart];
         if (c != ' ' & c != 9)
             break;
         ++trimStart;
@@ -712,7 +718,7 @@ String String::Trimmed() const
 
     while (trimEnd > trimStart)
     {
-        char c = buffer_[trimEnd - 1];
+        char c = Buffer()[trimEnd - 1];
         if (c != ' ' && c != 9)
             break;
         --trimEnd;
@@ -737,7 +743,7 @@ String String::Substring(unsigned int pos) const
     {
         String ret;
         ret.Resize(length_ - pos);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        CopyChars(ret.Buffer(), Buffer() + pos, ret.length_);
 
         return ret;
     }
@@ -753,7 +759,7 @@ String String::Substring(unsigned int pos, unsigned int length) const
         if (pos + length > length)
             length = length_ - pos;
         ret.Resize(length);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        CopyChars(ret.Buffer(), Buffer() + pos, ret.length_);
 
         return ret;
     }
@@ -763,12 +769,13 @@ String String::Substring(unsigned int pos, unsigned int length) const
 
 void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
 {
+    char* buffer = Buffer();
     if (caseSensitive)
     {
         for (int i = 0; i < length_; ++i)
         {
-            if (buffer_[i] == replaceThis)
-                buffer_[i] = replaceWith;
+            if (buffer[i] == replaceThis)
+                buffer[i] = replaceWith;
         }
     }
     else 
@@ -776,8 +783,8 @@ void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
         replaceThis = (char) tolower(replaceThis);
         for (unsigned i = 0; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == replaceThis)
-                buffer_[i] = replaceWith;
+            if (tolower(buffer[i]) == replaceThis)
+                buffer[i] = replaceWith;
         }
     }
 }
@@ -831,7 +838,7 @@ void String::Replace(unsigned pos, unsigned length, const char* srcStart, unsign
     else 
         Resize(length + delta);
 
-    CopyChars(buffer_ + pos, srcStart, srcLength);
+    CopyChars(Buffer() + pos, srcStart, srcLength);
 }
 
 void String::SetUTF8FromLatin1(const char* str)
@@ -885,10 +892,10 @@ unsigned String::LengthUTF8() const
 {
     unsigned ret = 0;
 
-    const char* src = buffer_;
+    const char* src = Buffer();
     if (!src)
         return ret;
-    const char* end = buffer_ + length_;
+    const char* end = Buffer() + length_;
 
     while (src < end)
     {
@@ -915,12 +922,12 @@ unsigned String::ByteOffsetUTF8(unsigned index) const
 
 unsigned String::NextUTF8Char(unsigned& byteOffset) const
 {
-    if (!buffer_)
+    if (!Buffer())
         return 0;
 
-    const char* src = buffer_ + byteOffset;
+    const char* src = Buffer() + byteOffset;
     unsigned ret = DecodeUTF8(src);
-    byteOffset = (unsigned)(src - buffer_);
+    byteOffset = (unsigned)(src - Buffer());
 
     return ret;
 }
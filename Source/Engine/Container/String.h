@@ -34,39 +34,38 @@ public:
     using ConstIterator = RandomAccessConstIterator<char>;
 
     /// Construct empty
-    String() noexcept : length_(0), capacity_(0), buffer_(&endZero) { }
+    String() noexcept : length_(0), capacity_(0) { }
     /// Construct from another string
-    String(const String& str) : length_(0), capacity_(0), buffer_(&endZero)
+    String(const String& str) : length_(0), capacity_(0)
     {
         *this = str;
     }
     /// Move-construct from another string
-    String(String&& str) noexcept : length_(0), capacity_(0), buffer_(&endZero)
+    String(String&& str) noexcept : length_(0), capacity_(0)
     {
         Swap(str);
     }
     /// Construct from a C string.
-    String(const char* str) : length_(0), capacity_(0), buffer_(&endZero)
+    String(const char* str) : length_(0), capacity_(0)
     {
         *this = str;
     }
     /// Construct from a C string.
-    String(char* str) : length_(0), capacity_(0), buffer_(&endZero)
+    String(char* str) : length_(0), capacity_(0)
     {
         *this = (const char*) str;
     }
     /// Construct from a char array and length
-    String(const char* str, unsigned length) : length_(0), capacity_(0), buffer_(&endZero)
+    String(const char* str, unsigned length) : length_(0), capacity_(0)
     {
         Resize(length);
-        CopyChars(buffer_, str, length);
+        CopyChars(Buffer(), str, length);
     }
 
     /// Construct from a null-terminated wide character array
     explicit String(const wchar_t* str)
         : length_(0)
         , capacity_(0)
-        , buffer_(&endZero)
     {
         SetUTF8FromWChar(str);
     }
@@ -74,8 +73,7 @@ public:
     /// Construct from a null-terminated wide character array.
     explicit String(wchar_t* str) :
             length_(0),
-            capacity_(0),
-            buffer_(&endZero)
+            capacity_(0)
     {
         SetUTF8FromWChar(str);
     }
@@ -112,7 +110,6 @@ public:
     template<typename T> explicit String(const T& value)
         : length_(0)
         , capacity_(0)
-        , buffer_(&endZero)
     {
         *this = value.ToString();
     }
@@ -120,7 +117,7 @@ public:
     ~String()
     {
         if (capacity_)
-            delete[] buffer_;
+            delete[] heapBuffer_;
     }
     /// Assign a string
     String& operator=(const String& rhs)
@@ -128,7 +125,7 @@ public:
         if (&rhs != this)
         {
             Resize(rhs.length_);
-            CopyChars(buffer_, rhs.buffer_, rhs.length_);
+            CopyChars(Buffer(), rhs.Buffer(), rhs.length_);
         }
 
         return *this;
@@ -146,7 +143,7 @@ public:
     {
         unsigned rhsLength = CStringLength(rhs);
         Resize(rhsLength);
-        CopyChars(buffer_, rhs, rhsLength);
+        CopyChars(Buffer(), rhs, rhsLength);
 
         return *this;
     }
@@ -155,7 +152,7 @@ public:
     {
         unsigned oldLength = length_;
         Resize(length_ + rhs.length_);
-        CopyChars(buffer_ + oldLength, rhs.buffer_, rhs.length_);
+        CopyChars(Buffer() + oldLength, rhs.Buffer(), rhs.length_);
 
         return *this;
     }
@@ -165,7 +162,7 @@ public:
         unsigned rhsLength = CStringLength(rhs);
         unsigned oldLength = length_;
         Resize(length_ + rhsLength);
-        CopyChars(buffer_ + oldLength, rhs, rhsLength);
+        CopyChars(Buffer() + oldLength, rhs, rhsLength);
 
         return *this;
     }
@@ -174,7 +171,7 @@ public:
     {
         unsigned oldLength = length_;
         Resize(length_ + 1);
-        buffer_[oldLength] = rhs;
+        Buffer()[oldLength] = rhs;
 
         return *this;
     }
@@ -208,8 +205,8 @@ public:
     {
         String ret;
         ret.Resize(length_ + rhs.length_);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs.buffer_, rhs.length_);
+        CopyChars(ret.Buffer(), Buffer(), length_);
+        CopyChars(ret.Buffer() + length_, rhs.Buffer(), rhs.length_);
 
         return ret;
     }
@@ -219,8 +216,8 @@ public:
         unsigned rhsLength = CStringLength(rhs);
         String ret;
         ret.Resize(length_ + rhsLength);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs, rhsLength);
+        CopyChars(ret.Buffer(), Buffer(), length_);
+        CopyChars(ret.Buffer() + length_, rhs, rhsLength);
 
         return ret;
     }
@@ -245,31 +242,31 @@ public:
     const char* operator*() const { return CString(); }
 
     /// Return the C string.
-    const char* CString() const { return buffer_; }
+    const char* CString() const { return Buffer(); }
 
     /// Return char at index
     char& operator [](unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
     /// Return const char at index
     const char& operator [](unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
     /// Return char at index
     char& At(unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
     /// Return const char at index
     const char& At(unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
     /// Replace all occurrences of a character
     void Replace(char replaceThis, char replaceWith, bool caseSensitive = true);
@@ -322,17 +319,17 @@ public:
     /// Resize the string.
     void Resize(unsigned newLength);
     /// Return iterator to the beginning
-    Iterator Begin() { return Iterator(buffer_); }
+    Iterator Begin() { return Iterator(Buffer()); }
     /// Return const iterator to the beginning
-    ConstIterator Begin() const { return ConstIterator(buffer_); }
+    ConstIterator Begin() const { return ConstIterator(Buffer()); }
     /// Return iterator to the end
-    Iterator End() { return Iterator(buffer_ + length_); }
+    Iterator End() { return Iterator(Buffer() + length_); }
     /// Return const iterator to the end
-    ConstIterator End() const { return ConstIterator(buffer_ + length_); }
+    ConstIterator End() const { return ConstIterator(Buffer() + length_); }
     /// Return first char, or 0 if empty
-    char Front() const { return buffer_[0]; }
+    char Front() const { return Buffer()[0]; }
     /// Return last char, or 0 if empty
-    char Back() const { return length_ ? buffer_[length_ - 1] : buffer_[0]; }
+    char Back() const { return length_ ? Buffer()[length_ - 1] : Buffer()[0]; }
     /// Return a substring from position to end
     String Substring(unsigned pos) const;
     /// Return a substring with length from position
@@ -361,8 +358,8 @@ public:
     bool EndsWith(const String& str, bool caseSensitive = true) const;
     /// Return length
     unsigned Length() const { return length_; }
-    /// Return buffer capacity
-    unsigned Capacity() const { return capacity_; }
+    /// Return buffer capacity, including the null terminator.
+    unsigned Capacity() const { return capacity_ ? capacity_ : INLINE_CAPACITY; }
     /// Return whether the string is empty
     bool Empty() const { return length_ == 0; }
     /// Return comparison result with a string.
@@ -397,7 +394,7 @@ public:
     unsigned ToHash() const
     {
         unsigned hash = 0;
-        const char* ptr = buffer_;
+        const char* ptr = Buffer();
         while (*ptr)
         {
             hash = *ptr + (hash << 6u) + (hash << 16u) - hash;
@@ -434,6 +431,8 @@ public:
     static const unsigned NPOS = 0xffffffff;
     /// Initial dynamic allocation size
     static const unsigned MIN_CAPACITY = 8;
+    /// Inline buffer size including the null terminator. Strings shorter than this do not allocate. Kept small on 32-bit platforms so that ResourceRef still fits in a Variant.
+    static const unsigned INLINE_CAPACITY = sizeof(char*) >= 8 ? 16 : sizeof(char*);
     /// Empty string
     static const String EMPTY;
 
@@ -442,7 +441,7 @@ private:
     void MoveRange(unsigned  dest, unsigned src, unsigned count)
     {
         if (count)
-            memmove(buffer_ + dest, buffer_ + src, count);
+            memmove(Buffer() + dest, Buffer() + src, count);
     }
     /// Copy chars from one buffer to another.
     static void CopyChars(char* dest, const char* src, unsigned count)
@@ -453,15 +452,22 @@ private:
     /// Replace a substring with another substring
     void Replace(unsigned pos, unsigned length, const char* srcStart, unsigned srcLength);
 
+    /// Return the string buffer.
+    char* Buffer() { return capacity_ ? heapBuffer_ : inlineBuffer_; }
+    /// Return the const string buffer.
+    const char* Buffer() const { return capacity_ ? heapBuffer_ : inlineBuffer_; }
+
     /// String length.
     unsigned length_;
-    /// Capacity, zero if buffer not allocated.
+    /// Capacity, zero if the string is stored inline.
     unsigned capacity_;
-    /// String buffer, point to &endZero if buffer is not allocated.
-    char* buffer_;
-
-    /// End zero for empty strings.
-    static char endZero;
+    union
+    {
+        /// Heap buffer, valid if capacity is nonzero.
+        char* heapBuffer_;
+        /// Inline buffer for short strings, valid if capacity is zero.
+        char inlineBuffer_[INLINE_CAPACITY]{};
+    };
 };
 
 /// Add a string to a C string
@@ -7,6 +7,7 @@
 #include "Container/String.h"
 #include "Container/ListBase.h"
 #include "Container/HashBase.h"
+#include "Container/FlatHashBase.h"
 
 
 namespace My3D
@@ -32,4 +33,9 @@ template <> void Swap<HashBase>(HashBase& first, HashBase& second)
     first.Swap(second);
 }
 
+template <> void Swap<FlatHashBase>(FlatHashBase& first, FlatHashBase& second)
+{
+    first.Swap(second);
+}
+
 }
\ No newline at end of file
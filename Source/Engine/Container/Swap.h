@@ -10,6 +10,7 @@
 namespace My3D
 {
 
+class FlatHashBase;
 class HashBase;
 class ListBase;
 class String;
@@ -27,5 +28,6 @@ template <> MY3D_API void Swap<String>(String& first, String& second);
 template <> MY3D_API void Swap<VectorBase>(VectorBase& first, VectorBase& second);
 template <> MY3D_API void Swap<ListBase>(ListBase& first, ListBase& second);
 template <> MY3D_API void Swap<HashBase>(HashBase& first, HashBase& second);
+template <> MY3D_API void Swap<FlatHashBase>(FlatHashBase& first, FlatHashBase& second);
 
 }
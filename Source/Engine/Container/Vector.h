@@ -81,6 +81,12 @@ public:
         }
         return *this;
     }
+    /// Move-assign from another vector
+    Vector<T>& operator =(Vector<T>&& rhs) noexcept
+    {
+        Swap(rhs);
+        return *this;
+    }
     /// Add an element
     Vector<T> operator+(const T& value)
     {
@@ -161,6 +167,20 @@ public:
             T value(std::forward<Args>(args)...);
             Push(std::move(value));
         }
+        return Back();
+    }
+    /// Create an element at position. Return an iterator to it
+    template<typename... Args>
+    Iterator Emplace(unsigned pos, Args&&... args)
+    {
+        if (pos >= size_)
+        {
+            EmplaceBack(std::forward<Args>(args)...);
+            return End() - 1;
+        }
+
+        T value(std::forward<Args>(args)...);
+        return DoInsertElements(pos, &value, &value + 1, MoveTag{});
     }
     /// Add an element at the end
     void Push(const T& value)
@@ -554,6 +574,11 @@ public:
     {
         *this = vector;
     }
+    /// Move-construct from another vector
+    PODVector(PODVector<T>&& vector) noexcept
+    {
+        Swap(vector);
+    }
     /// Aggregate initialization constructor
     PODVector(const std::initializer_list<T>& list) : PODVector()
     {
@@ -567,13 +592,19 @@ public:
     /// Assign from another vector
     PODVector<T>& operator =(const PODVector<T>& rhs)
     {
-        if (&rhs == this)
+        if (&rhs != this)
         {
             Resize(rhs.size_);
             CopyElements(Buffer(), rhs.Buffer(), rhs.size_);
         }
         return *this;
     }
+    /// Move-assign from another vector
+    PODVector<T>& operator =(PODVector<T>&& rhs) noexcept
+    {
+        Swap(rhs);
+        return *this;
+    }
     /// Add-assign an element
     PODVector<T>& operator +=(const T& rhs)
     {
@@ -794,7 +825,7 @@ public:
         if (it != End())
         {
             Erase(it);
-            return false;
+            return true;
         }
         else
             return false;
@@ -805,10 +836,10 @@ public:
         Iterator it = Find(value);
         if (it != End())
         {
-            EraseSwap(i - Begin());
+            EraseSwap(it - Begin());
             return true;
         }
-        else 
+        else
             return false;
     }
     /// Clear the vector
@@ -843,7 +874,7 @@ public:
     {
         unsigned oldSize = Size();
         Resize(newSize);
-        for (unsigned i = 0; i < newSize; ++i)
+        for (unsigned i = oldSize; i < newSize; ++i)
             At(i) = value;
     }
     /// Set new capacity
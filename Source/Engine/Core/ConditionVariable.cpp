@@ -0,0 +1,218 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Core/ConditionVariable.h"
+#include "Core/Timer.h"
+
+#ifdef PLATFORM_MSVC
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <ctime>
+#endif
+
+
+namespace My3D
+{
+#ifdef PLATFORM_MSVC
+    ConditionVariable::ConditionVariable()
+        : handle_(new CONDITION_VARIABLE)
+    {
+        InitializeConditionVariable((CONDITION_VARIABLE*)handle_);
+    }
+
+    ConditionVariable::~ConditionVariable()
+    {
+        delete (CONDITION_VARIABLE*)handle_;
+        handle_ = nullptr;
+    }
+
+    void ConditionVariable::Wait(Mutex& mutex)
+    {
+        SleepConditionVariableCS((CONDITION_VARIABLE*)handle_, (CRITICAL_SECTION*)mutex.handle_, INFINITE);
+    }
+
+    bool ConditionVariable::WaitFor(Mutex& mutex, unsigned timeoutMs)
+    {
+        return SleepConditionVariableCS((CONDITION_VARIABLE*)handle_, (CRITICAL_SECTION*)mutex.handle_, timeoutMs) != 0;
+    }
+
+    void ConditionVariable::NotifyOne()
+    {
+        WakeConditionVariable((CONDITION_VARIABLE*)handle_);
+    }
+
+    void ConditionVariable::NotifyAll()
+    {
+        WakeAllConditionVariable((CONDITION_VARIABLE*)handle_);
+    }
+#else
+    /// Clock for the timed waits. The monotonic clock does not jump when the system time is changed.
+#ifdef __APPLE__
+    static const clockid_t WAIT_CLOCK = CLOCK_REALTIME;
+#else
+    static const clockid_t WAIT_CLOCK = CLOCK_MONOTONIC;
+#endif
+
+    ConditionVariable::ConditionVariable()
+        : handle_(new pthread_cond_t)
+    {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+#ifndef __APPLE__
+        pthread_condattr_setclock(&attr, WAIT_CLOCK);
+#endif
+        pthread_cond_init((pthread_cond_t*)handle_, &attr);
+        pthread_condattr_destroy(&attr);
+    }
+
+    ConditionVariable::~ConditionVariable()
+    {
+        auto* condition = (pthread_cond_t*)handle_;
+        pthread_cond_destroy(condition);
+        delete condition;
+        handle_ = nullptr;
+    }
+
+    void ConditionVariable::Wait(Mutex& mutex)
+    {
+        pthread_cond_wait((pthread_cond_t*)handle_, (pthread_mutex_t*)mutex.handle_);
+    }
+
+    bool ConditionVariable::WaitFor(Mutex& mutex, unsigned timeoutMs)
+    {
+        timespec deadline{};
+        clock_gettime(WAIT_CLOCK, &deadline);
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            ++deadline.tv_sec;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+        return pthread_cond_timedwait((pthread_cond_t*)handle_, (pthread_mutex_t*)mutex.handle_, &deadline) == 0;
+    }
+
+    void ConditionVariable::NotifyOne()
+    {
+        pthread_cond_signal((pthread_cond_t*)handle_);
+    }
+
+    void ConditionVariable::NotifyAll()
+    {
+        pthread_cond_broadcast((pthread_cond_t*)handle_);
+    }
+#endif
+
+    Semaphore::Semaphore(unsigned count)
+        : count_(count)
+    {
+    }
+
+    void Semaphore::Acquire()
+    {
+        MutexLock lock(mutex_);
+        while (!count_)
+            condition_.Wait(mutex_);
+        --count_;
+    }
+
+    bool Semaphore::TryAcquire()
+    {
+        MutexLock lock(mutex_);
+        if (!count_)
+            return false;
+
+        --count_;
+        return true;
+    }
+
+    bool Semaphore::TryAcquire(unsigned timeoutMs)
+    {
+        MutexLock lock(mutex_);
+        // Spurious wakeups must not extend the wait, so measure the remaining time
+        HiresTimer timer;
+        while (!count_)
+        {
+            long long elapsedMs = timer.GetUSec(false) / 1000;
+            if (elapsedMs >= timeoutMs)
+                return false;
+            condition_.WaitFor(mutex_, timeoutMs - (unsigned)elapsedMs);
+        }
+
+        --count_;
+        return true;
+    }
+
+    void Semaphore::Release(unsigned count)
+    {
+        MutexLock lock(mutex_);
+        count_ += count;
+        if (count == 1)
+            condition_.NotifyOne();
+        else if (count)
+            condition_.NotifyAll();
+    }
+
+    unsigned Semaphore::GetCount() const
+    {
+        MutexLock lock(mutex_);
+        return count_;
+    }
+
+    Event::Event(bool manualReset)
+        : manualReset_(manualReset)
+        , set_(false)
+    {
+    }
+
+    void Event::Set()
+    {
+        MutexLock lock(mutex_);
+        set_ = true;
+        if (manualReset_)
+            condition_.NotifyAll();
+        else
+            condition_.NotifyOne();
+    }
+
+    void Event::Reset()
+    {
+        MutexLock lock(mutex_);
+        set_ = false;
+    }
+
+    void Event::Wait()
+    {
+        MutexLock lock(mutex_);
+        while (!set_)
+            condition_.Wait(mutex_);
+        if (!manualReset_)
+            set_ = false;
+    }
+
+    bool Event::Wait(unsigned timeoutMs)
+    {
+        MutexLock lock(mutex_);
+        HiresTimer timer;
+        while (!set_)
+        {
+            long long elapsedMs = timer.GetUSec(false) / 1000;
+            if (elapsedMs >= timeoutMs)
+                return false;
+            condition_.WaitFor(mutex_, timeoutMs - (unsigned)elapsedMs);
+        }
+
+        if (!manualReset_)
+            set_ = false;
+        return true;
+    }
+
+    bool Event::IsSet() const
+    {
+        MutexLock lock(mutex_);
+        return set_;
+    }
+}
@@ -0,0 +1,110 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Core/Mutex.h"
+
+
+namespace My3D
+{
+    /// Operating system condition variable for blocking on a Mutex until another thread changes a condition. Wakeups may be
+    /// spurious, so wait in a loop that checks the condition.
+    class MY3D_API ConditionVariable
+    {
+    public:
+        /// Construct.
+        ConditionVariable();
+        /// Destruct. No thread may be waiting.
+        ~ConditionVariable();
+        /// Prevent copy construction.
+        ConditionVariable(const ConditionVariable& rhs) = delete;
+        /// Prevent assignment.
+        ConditionVariable& operator =(const ConditionVariable& rhs) = delete;
+
+        /// Release the mutex, block until notified and acquire the mutex again. The calling thread must hold the mutex once.
+        void Wait(Mutex& mutex);
+        /// Wait until notified or the timeout in milliseconds has passed. Return false if timed out.
+        bool WaitFor(Mutex& mutex, unsigned timeoutMs);
+        /// Wait until the predicate returns true. The predicate is called with the mutex held.
+        template <typename T> void Wait(Mutex& mutex, T predicate)
+        {
+            while (!predicate())
+                Wait(mutex);
+        }
+        /// Wake one waiting thread.
+        void NotifyOne();
+        /// Wake all waiting threads.
+        void NotifyAll();
+
+    private:
+        /// Condition variable handle.
+        void* handle_;
+    };
+
+    /// Counting semaphore. Acquiring decrements the count and blocks while it is zero, releasing increments it.
+    class MY3D_API Semaphore
+    {
+    public:
+        /// Construct with initial count.
+        explicit Semaphore(unsigned count = 0);
+        /// Prevent copy construction.
+        Semaphore(const Semaphore& rhs) = delete;
+        /// Prevent assignment.
+        Semaphore& operator =(const Semaphore& rhs) = delete;
+
+        /// Decrement the count. Block while it is zero.
+        void Acquire();
+        /// Decrement the count if it is not zero. Return true if successful.
+        bool TryAcquire();
+        /// Decrement the count, blocking at most the timeout in milliseconds while it is zero. Return true if successful.
+        bool TryAcquire(unsigned timeoutMs);
+        /// Increment the count, waking as many waiting threads.
+        void Release(unsigned count = 1);
+        /// Return the count.
+        unsigned GetCount() const;
+
+    private:
+        /// Mutex for the count.
+        mutable Mutex mutex_;
+        /// Condition for the count becoming nonzero.
+        ConditionVariable condition_;
+        /// Count.
+        unsigned count_;
+    };
+
+    /// Event that threads block on until another thread sets it. A manual-reset event stays set until reset and releases all
+    /// waiting threads, which also makes it a one-shot latch. An auto-reset event releases one waiting thread and resets.
+    class MY3D_API Event
+    {
+    public:
+        /// Construct unset.
+        explicit Event(bool manualReset = true);
+        /// Prevent copy construction.
+        Event(const Event& rhs) = delete;
+        /// Prevent assignment.
+        Event& operator =(const Event& rhs) = delete;
+
+        /// Set the event, waking the waiting threads.
+        void Set();
+        /// Reset the event.
+        void Reset();
+        /// Block until the event is set.
+        void Wait();
+        /// Block until the event is set or the timeout in milliseconds has passed. Return false if timed out.
+        bool Wait(unsigned timeoutMs);
+        /// Return whether the event is set.
+        bool IsSet() const;
+
+    private:
+        /// Mutex for the state.
+        mutable Mutex mutex_;
+        /// Condition for the event being set.
+        ConditionVariable condition_;
+        /// Manual reset flag.
+        bool manualReset_;
+        /// Set flag.
+        bool set_;
+    };
+}
@@ -3,6 +3,7 @@
 
 #include "Context.h"
 #include "IO/Log.h"
+#include "Core/CoreEvents.h"
 #include "Core/Thread.h"
 
 
@@ -58,14 +59,79 @@ namespace My3D
             receivers_.Remove(object);
     }
 
+    void TypedEventReceiverGroup::EndSendEvent()
+    {
+        assert(inSend_ > 0);
+        --inSend_;
+
+        if (inSend_ == 0 && numHoles_)
+            Compact();
+    }
+
+    void TypedEventReceiverGroup::Add(const TypedEventHandler& handler, bool replace)
+    {
+        if (replace)
+        {
+            for (unsigned i = 0; i < handlers_.Size(); ++i)
+            {
+                if (handlers_[i].receiver_ == handler.receiver_)
+                {
+                    handlers_[i] = handler;
+                    return;
+                }
+            }
+        }
+
+        handlers_.Push(handler);
+    }
+
+    void TypedEventReceiverGroup::Remove(Object* receiver)
+    {
+        for (unsigned i = 0; i < handlers_.Size(); ++i)
+        {
+            if (handlers_[i].receiver_ == receiver)
+            {
+                handlers_[i].receiver_ = nullptr;
+                ++numHoles_;
+                break;
+            }
+        }
+
+        // Clean up once half are holes, so that each removal does not move the whole array
+        if (inSend_ == 0 && numHoles_ * 2 > handlers_.Size())
+            Compact();
+    }
+
+    void TypedEventReceiverGroup::Compact()
+    {
+        unsigned dest = 0;
+        for (unsigned i = 0; i < handlers_.Size(); ++i)
+        {
+            if (handlers_[i].receiver_)
+                handlers_[dest++] = handlers_[i];
+        }
+        handlers_.Resize(dest);
+        numHoles_ = 0;
+    }
+
     Context::Context()
-        : eventHandler_(nullptr)
+        : postedEventsFlush_(E_BEGINFRAME)
+        , eventHandler_(nullptr)
     {
         Thread::SetMainThread();
     }
 
     Context::~Context()
     {
+        // Posted events that were not sent may hold references to objects
+        PostedEvent* posted = postedEvents_.exchange(nullptr);
+        while (posted)
+        {
+            PostedEvent* next = posted->next_;
+            delete posted;
+            posted = next;
+        }
+
         subsystems_.Clear();
         factories_.Clear();
 
@@ -124,6 +190,12 @@ namespace My3D
             return SharedPtr<Object>();
     }
 
+    ObjectFactory* Context::GetObjectFactory(StringHash objectType) const
+    {
+        auto it = factories_.Find(objectType);
+        return it != factories_.End() ? it->second_.Get() : nullptr;
+    }
+
     const String& Context::GetTypeName(StringHash objectType) const
     {
         auto it = factories_.Find(objectType);
@@ -203,6 +275,68 @@ namespace My3D
             return nullptr;
     }
 
+    void Context::PostEvent(Object* sender, StringHash eventType, const VariantMap& eventData, bool coalesce)
+    {
+        auto* event = new PostedEvent();
+        event->sender_ = sender;
+        event->eventType_ = eventType;
+        event->eventData_ = eventData;
+        event->coalesce_ = coalesce;
+
+        event->next_ = postedEvents_.load(std::memory_order_relaxed);
+        while (!postedEvents_.compare_exchange_weak(event->next_, event, std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+
+    void Context::SendPostedEvents()
+    {
+        if (!Thread::IsMainThread())
+        {
+            MY3D_LOGERROR("Posted events can only be sent from the main thread");
+            return;
+        }
+
+        // Take all events at once, so that the posting threads never contend with the main thread for single events
+        PostedEvent* posted = postedEvents_.exchange(nullptr, std::memory_order_acquire);
+        if (!posted)
+            return;
+
+        // The list is newest first, so the newest of coalescing events is met first and the older ones can be dropped
+        PODVector<PostedEvent*> events;
+        while (posted)
+        {
+            PostedEvent* next = posted->next_;
+            bool superseded = false;
+            if (posted->coalesce_)
+            {
+                for (unsigned i = 0; i < events.Size(); ++i)
+                {
+                    PostedEvent* newer = events[i];
+                    if (newer->coalesce_ && newer->eventType_ == posted->eventType_ && newer->sender_.Get() == posted->sender_.Get())
+                    {
+                        superseded = true;
+                        break;
+                    }
+                }
+            }
+
+            if (superseded)
+                delete posted;
+            else
+                events.Push(posted);
+            posted = next;
+        }
+
+        for (unsigned i = events.Size() - 1; i < events.Size(); --i)
+        {
+            PostedEvent* event = events[i];
+            SharedPtr<Object> sender = event->sender_.Lock();
+            if (sender)
+                sender->SendEvent(event->eventType_, event->eventData_);
+            delete event;
+        }
+    }
+
     void Context::AddEventReceiver(Object *receiver, StringHash eventType)
     {
         auto& group = eventReceivers_[eventType];
@@ -250,6 +384,21 @@ namespace My3D
             group->Remove(receiver);
     }
 
+    void Context::AddTypedEventReceiver(StringHash eventType, const TypedEventHandler& handler, bool replace)
+    {
+        auto& group = typedEventReceivers_[eventType];
+        if (!group)
+            group = new TypedEventReceiverGroup();
+        group->Add(handler, replace);
+    }
+
+    void Context::RemoveTypedEventReceiver(Object* receiver, StringHash eventType)
+    {
+        TypedEventReceiverGroup* group = GetTypedEventReceivers(eventType);
+        if (group)
+            group->Remove(receiver);
+    }
+
     void Context::BeginSendEvent(Object *sender, StringHash eventType)
     {
         eventSenders_.Push(sender);
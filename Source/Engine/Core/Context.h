@@ -9,6 +9,8 @@
 #include "Container/Ptr.h"
 #include "Container/HashMap.h"
 
+#include <atomic>
+
 
 namespace My3D
 {
@@ -41,6 +43,54 @@ private:
     bool dirty_;
 };
 
+/// Tracking structure for typed event handlers. Handlers are stored by value in a flat array, and removal leaves holes that
+/// are cleaned up in one pass, so that mass removal does not move the array for each receiver.
+class MY3D_API TypedEventReceiverGroup : public RefCounted
+{
+public:
+    /// Construct
+    TypedEventReceiverGroup()
+        : inSend_(0)
+        , numHoles_(0)
+    {
+    }
+
+    /// Begin send event.
+    void BeginSendEvent() { ++inSend_; }
+    /// End event send. Clean up if necessary
+    void EndSendEvent();
+    /// Add a handler. If replace is set, replace the receiver's existing handler if any.
+    void Add(const TypedEventHandler& handler, bool replace);
+    /// Remove a receiver's handler. Leaves a hole.
+    void Remove(Object* receiver);
+    /// Handlers. May contain holes
+    PODVector<TypedEventHandler> handlers_;
+
+private:
+    /// Remove the holes.
+    void Compact();
+
+    /// "In send" recursion counter
+    unsigned inSend_;
+    /// Number of holes
+    unsigned numHoles_;
+};
+
+/// Event posted from any thread, to be sent in the main thread.
+struct PostedEvent
+{
+    /// Next event. Newer events point to older ones.
+    PostedEvent* next_{};
+    /// Sender.
+    WeakPtr<Object> sender_;
+    /// Event type.
+    StringHash eventType_;
+    /// Event parameters.
+    VariantMap eventData_;
+    /// Whether only the newest event of the same sender and type is sent.
+    bool coalesce_{};
+};
+
 /// My3D execution context. Provides access to subsystems, object factories and attributes.
 class MY3D_API Context : public RefCounted
 {
@@ -70,10 +120,15 @@ public:
     void RegisterFactory(ObjectFactory* factory, const char* category);
     /// Return object type name from hash.
     const String& GetTypeName(StringHash objectType) const;
-    /// Template version of registering an object factory
-    template<typename T> void RegisterFactory();
+    /// Template version of registering an object factory. If pooled, the objects are reserved from a per-type pool and
+    /// returned to it when released, instead of allocated individually.
+    template<typename T> void RegisterFactory(bool pooled = false);
     /// Template version of registering an object factory with category.
-    template<typename T> void RegisterFactory(const char* category);
+    template<typename T> void RegisterFactory(const char* category, bool pooled = false);
+    /// Return object factory by type, or null if not registered.
+    ObjectFactory* GetObjectFactory(StringHash objectType) const;
+    /// Return all object factories.
+    const HashMap<StringHash, SharedPtr<ObjectFactory>>& GetObjectFactories() const { return factories_; }
 
     /// Register a subsystem
     void RegisterSubsystem(Object* object);
@@ -113,12 +168,28 @@ public:
         else
             return nullptr;
     }
+    /// Send the events posted from all threads, in posting order. Only the newest of coalescing events of the same sender
+    /// and type is sent, and events whose sender has been destroyed are dropped. Must be called from the main thread.
+    void SendPostedEvents();
+    /// Set event type before which the posted events are sent automatically, if it is sent outside other events. Default
+    /// is E_BEGINFRAME. Zero to send only with SendPostedEvents().
+    void SetPostedEventsFlush(StringHash eventType) { postedEventsFlush_ = eventType; }
+    /// Return event type before which the posted events are sent.
+    StringHash GetPostedEventsFlush() const { return postedEventsFlush_; }
+    /// Return whether there are posted events waiting to be sent.
+    bool HasPostedEvents() const { return postedEvents_.load(std::memory_order_relaxed) != nullptr; }
     /// Return event receivers for an event type
     EventReceiverGroup* GetEventReceivers(StringHash eventType) const
     {
         auto i = eventReceivers_.Find(eventType);
         return i != eventReceivers_.End() ? i->second_ : nullptr;
     }
+    /// Return typed event handlers for an event type
+    TypedEventReceiverGroup* GetTypedEventReceivers(StringHash eventType) const
+    {
+        auto i = typedEventReceivers_.Find(eventType);
+        return i != typedEventReceivers_.End() ? i->second_ : nullptr;
+    }
 
     /// Register object attribute.
     AttributeHandle RegisterAttribute(StringHash objectType, const AttributeInfo& attr);
@@ -170,6 +241,18 @@ private:
     void RemoveEventReceiver(Object* receiver, Object* sender, StringHash eventType);
     /// Remove event receiver from no-specific events
     void RemoveEventReceiver(Object* receiver, StringHash eventType);
+    /// Add typed event handler. If replace is set, replace the receiver's existing handler if any.
+    void AddTypedEventReceiver(StringHash eventType, const TypedEventHandler& handler, bool replace);
+    /// Remove typed event handler
+    void RemoveTypedEventReceiver(Object* receiver, StringHash eventType);
+    /// Queue an event for sending in the main thread. Can be called from any thread.
+    void PostEvent(Object* sender, StringHash eventType, const VariantMap& eventData, bool coalesce);
+    /// Send the posted events if the event type is the flush point and no event is being sent.
+    void CheckPostedEvents(StringHash eventType)
+    {
+        if (eventType == postedEventsFlush_ && eventSenders_.Empty() && HasPostedEvents())
+            SendPostedEvents();
+    }
     /// Begin send event
     void BeginSendEvent(Object* sender, StringHash eventType);
     /// End event send. Clean up event receivers removed in the meanwhile
@@ -189,6 +272,12 @@ private:
     HashMap<StringHash, SharedPtr<EventReceiverGroup>> eventReceivers_;
     /// Event receivers for specific events
     HashMap<Object*, HashMap<StringHash, SharedPtr<EventReceiverGroup>>> specificEventReceivers_;
+    /// Typed event handlers
+    HashMap<StringHash, SharedPtr<TypedEventReceiverGroup>> typedEventReceivers_;
+    /// Posted events, newest first. Threads push with compare-and-swap, and the main thread takes the whole list at once.
+    std::atomic<PostedEvent*> postedEvents_{};
+    /// Event type before which the posted events are sent.
+    StringHash postedEventsFlush_;
     /// Event sender stack
     PODVector<Object*> eventSenders_;
     /// Event data stack
@@ -202,14 +291,20 @@ private:
     HashMap<StringHash, Vector<AttributeInfo>> networkAttributes_;
 };
 
-template<typename T> void Context::RegisterFactory()
+template<typename T> void Context::RegisterFactory(bool pooled)
 {
-    RegisterFactory(new ObjectFactoryImpl<T>(this));
+    if (pooled)
+        RegisterFactory(new PooledObjectFactoryImpl<T>(this));
+    else
+        RegisterFactory(new ObjectFactoryImpl<T>(this));
 }
 
-template <typename T> void Context::RegisterFactory(const char* category)
+template <typename T> void Context::RegisterFactory(const char* category, bool pooled)
 {
-    RegisterFactory(new ObjectFactoryImpl<T>(this), category);
+    if (pooled)
+        RegisterFactory(new PooledObjectFactoryImpl<T>(this), category);
+    else
+        RegisterFactory(new ObjectFactoryImpl<T>(this), category);
 }
 
 template <typename T> T* Context::RegisterSubsystem()
@@ -29,6 +29,18 @@ MY3D_EVENT(E_POSTUPDATE, PostUpdate)
 MY3D_EVENT(E_RENDERUPDATE, RenderUpdate)
 {
     MY3D_PARAM(P_TIMESTEP, TimeStep);
+
+    /// Typed payload
+    struct Payload
+    {
+        MY3D_TYPED_EVENT(E_RENDERUPDATE)
+
+        /// Convert to event parameters
+        void ToVariantMap(My3D::VariantMap& eventData) const { eventData[P_TIMESTEP] = timeStep_; }
+
+        /// Timestep
+        float timeStep_;
+    };
 }
 
 /// Post-render update event
@@ -40,4 +52,20 @@ MY3D_EVENT(E_POSTRENDERUPDATE, PostRenderUpdate)
 /// Frame end event
 MY3D_EVENT(E_ENDFRAME, EndFrame)
 {
+}
+
+/// Periodic frame time statistics summary over the frames since the previous one. Times are in milliseconds.
+MY3D_EVENT(E_FRAMESTATS, FrameStats)
+{
+    MY3D_PARAM(P_NUMFRAMES, NumFrames);         // unsigned
+    MY3D_PARAM(P_MEAN, Mean);                   // float
+    MY3D_PARAM(P_P50, P50);                     // float
+    MY3D_PARAM(P_P95, P95);                     // float
+    MY3D_PARAM(P_P99, P99);                     // float
+    MY3D_PARAM(P_MAX, Max);                     // float
+    MY3D_PARAM(P_HITCHES, Hitches);             // unsigned
+    MY3D_PARAM(P_UPDATE, Update);               // float
+    MY3D_PARAM(P_RENDER, Render);               // float
+    MY3D_PARAM(P_PRESENT, Present);             // float
+    MY3D_PARAM(P_SLEEP, Sleep);                 // float
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Core/CoreEvents.h"
+#include "Core/FrameAllocator.h"
+#include "Core/Thread.h"
+
+#include <atomic>
+
+
+namespace My3D
+{
+    /// Header of a memory chunk. The data follows it.
+    struct FrameChunk
+    {
+        /// Previously used chunk.
+        FrameChunk* next_;
+        /// Size of data in bytes.
+        unsigned size_;
+    };
+
+    /// Chunks of one thread.
+    struct FrameArena
+    {
+        /// Owner thread.
+        ThreadID threadId_;
+        /// Current chunk. Earlier chunks of the frame are linked from it.
+        FrameChunk* chunk_{};
+        /// Next free byte in the current chunk.
+        unsigned char* position_{};
+        /// End of the current chunk.
+        unsigned char* end_{};
+        /// Bytes allocated during this frame.
+        unsigned long long frameBytes_{};
+        /// Highest number of bytes allocated during a single frame.
+        unsigned long long highWaterMark_{};
+    };
+
+    /// Chunk header size, rounded up so that chunk data is aligned by the default alignment.
+    static const unsigned CHUNK_HEADER_SIZE = (unsigned)((sizeof(FrameChunk) + FrameAllocator::DEFAULT_ALIGNMENT - 1) & ~(FrameAllocator::DEFAULT_ALIGNMENT - 1));
+    static const unsigned DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    static std::atomic<unsigned long long> nextFrameAllocatorId(1);
+    static thread_local unsigned long long cachedAllocatorId = 0;
+    static thread_local FrameArena* cachedArena = nullptr;
+
+    static unsigned char* ChunkData(FrameChunk* chunk)
+    {
+        return reinterpret_cast<unsigned char*>(chunk) + CHUNK_HEADER_SIZE;
+    }
+
+    static void AddChunk(FrameArena* arena, unsigned size)
+    {
+        auto* chunk = reinterpret_cast<FrameChunk*>(new unsigned char[CHUNK_HEADER_SIZE + size]);
+        chunk->next_ = arena->chunk_;
+        chunk->size_ = size;
+        arena->chunk_ = chunk;
+        arena->position_ = ChunkData(chunk);
+        arena->end_ = arena->position_ + size;
+    }
+
+    static void FreeChunks(FrameArena* arena)
+    {
+        FrameChunk* chunk = arena->chunk_;
+        while (chunk)
+        {
+            FrameChunk* next = chunk->next_;
+            delete[] reinterpret_cast<unsigned char*>(chunk);
+            chunk = next;
+        }
+
+        arena->chunk_ = nullptr;
+        arena->position_ = nullptr;
+        arena->end_ = nullptr;
+    }
+
+    static unsigned char* AlignPointer(unsigned char* ptr, unsigned alignment)
+    {
+        return reinterpret_cast<unsigned char*>(((size_t)ptr + alignment - 1) & ~(size_t)(alignment - 1));
+    }
+
+    FrameAllocator::FrameAllocator(Context* context)
+        : Object(context)
+        , id_(nextFrameAllocatorId.fetch_add(1, std::memory_order_relaxed))
+        , chunkSize_(DEFAULT_CHUNK_SIZE)
+        , generation_(1)
+        , lastFrameBytes_(0)
+        , highWaterMark_(0)
+    {
+        SubscribeToEvent(E_ENDFRAME, MY3D_HANDLER(FrameAllocator, HandleEndFrame));
+    }
+
+    FrameAllocator::~FrameAllocator()
+    {
+        for (unsigned i = 0; i < arenas_.Size(); ++i)
+        {
+            FreeChunks(arenas_[i]);
+            delete arenas_[i];
+        }
+    }
+
+    void* FrameAllocator::Allocate(unsigned size, unsigned alignment)
+    {
+        assert(alignment && !(alignment & (alignment - 1)) && alignment <= DEFAULT_ALIGNMENT);
+
+        FrameArena* arena = GetThreadArena();
+        unsigned char* ptr = AlignPointer(arena->position_, alignment);
+        if (!arena->chunk_ || ptr + size > arena->end_)
+        {
+            AddChunk(arena, size > chunkSize_ ? size : chunkSize_);
+            ptr = arena->position_;
+        }
+
+        arena->frameBytes_ += (ptr + size) - arena->position_;
+        arena->position_ = ptr + size;
+        return ptr;
+    }
+
+    bool FrameAllocator::Extend(void* ptr, unsigned size, unsigned newSize)
+    {
+        FrameArena* arena = GetThreadArena();
+        auto* start = static_cast<unsigned char*>(ptr);
+        if (start + size != arena->position_ || start + newSize > arena->end_)
+            return false;
+
+        arena->frameBytes_ += newSize - size;
+        arena->position_ = start + newSize;
+        return true;
+    }
+
+    void FrameAllocator::Reset()
+    {
+        unsigned long long frameBytes = 0;
+
+        for (unsigned i = 0; i < arenas_.Size(); ++i)
+        {
+            FrameArena* arena = arenas_[i];
+            frameBytes += arena->frameBytes_;
+            if (arena->frameBytes_ > arena->highWaterMark_)
+                arena->highWaterMark_ = arena->frameBytes_;
+            arena->frameBytes_ = 0;
+
+            if (!arena->chunk_)
+                continue;
+
+            if (arena->chunk_->next_)
+            {
+                // The frame overflowed into several chunks. Replace them with one chunk big enough for the high-water mark,
+                // so that later frames do not need to allocate
+                unsigned long long total = 0;
+                for (FrameChunk* chunk = arena->chunk_; chunk; chunk = chunk->next_)
+                    total += chunk->size_;
+                if (total < arena->highWaterMark_)
+                    total = arena->highWaterMark_;
+
+                FreeChunks(arena);
+                AddChunk(arena, (unsigned)total);
+            }
+            else
+                arena->position_ = ChunkData(arena->chunk_);
+        }
+
+        lastFrameBytes_ = frameBytes;
+        if (frameBytes > highWaterMark_)
+            highWaterMark_ = frameBytes;
+        ++generation_;
+    }
+
+    void FrameAllocator::SetChunkSize(unsigned size)
+    {
+        chunkSize_ = size ? size : DEFAULT_CHUNK_SIZE;
+    }
+
+    unsigned long long FrameAllocator::GetThreadHighWaterMark() const
+    {
+        unsigned long long highWaterMark = 0;
+        for (unsigned i = 0; i < arenas_.Size(); ++i)
+        {
+            if (arenas_[i]->highWaterMark_ > highWaterMark)
+                highWaterMark = arenas_[i]->highWaterMark_;
+        }
+        return highWaterMark;
+    }
+
+    unsigned long long FrameAllocator::GetReservedBytes() const
+    {
+        unsigned long long reserved = 0;
+        for (unsigned i = 0; i < arenas_.Size(); ++i)
+        {
+            for (FrameChunk* chunk = arenas_[i]->chunk_; chunk; chunk = chunk->next_)
+                reserved += chunk->size_;
+        }
+        return reserved;
+    }
+
+    FrameArena* FrameAllocator::GetThreadArena()
+    {
+        if (cachedAllocatorId == id_)
+            return cachedArena;
+
+        ThreadID threadId = Thread::GetCurrentThreadID();
+        FrameArena* arena = nullptr;
+
+        {
+            MutexLock lock(arenasMutex_);
+            for (unsigned i = 0; i < arenas_.Size(); ++i)
+            {
+                if (arenas_[i]->threadId_ == threadId)
+                {
+                    arena = arenas_[i];
+                    break;
+                }
+            }
+
+            if (!arena)
+            {
+                arena = new FrameArena();
+                arena->threadId_ = threadId;
+                arenas_.Push(arena);
+            }
+        }
+
+        cachedAllocatorId = id_;
+        cachedArena = arena;
+        return arena;
+    }
+
+    void FrameAllocator::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+    {
+        Reset();
+    }
+}
@@ -0,0 +1,538 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Iter.h"
+#include "Container/Vector.h"
+#include "Core/Mutex.h"
+#include "Core/Object.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace My3D
+{
+    struct FrameArena;
+
+    /// Per-frame linear memory subsystem. Each thread bump-allocates from its own chunks, which are rewound at the end of the
+    /// frame. Memory must not be used after the frame ends, so work that uses it must be completed within the frame.
+    class MY3D_API FrameAllocator : public Object
+    {
+        MY3D_OBJECT(FrameAllocator, Object)
+
+    public:
+        /// Default alignment of allocations.
+        static const unsigned DEFAULT_ALIGNMENT = 16;
+
+        /// Construct.
+        explicit FrameAllocator(Context* context);
+        /// Destruct. Free all chunks.
+        ~FrameAllocator() override;
+
+        /// Allocate memory that stays valid until the end of the frame. Can be called from any thread.
+        void* Allocate(unsigned size, unsigned alignment = DEFAULT_ALIGNMENT);
+        /// Grow the calling thread's most recent allocation in place. Return true if successful.
+        bool Extend(void* ptr, unsigned size, unsigned newSize);
+        /// Rewind all thread arenas and update the high-water marks. Called automatically at end of frame. No other thread may be allocating.
+        void Reset();
+        /// Set the minimum chunk size in bytes.
+        void SetChunkSize(unsigned size);
+
+        /// Return the minimum chunk size in bytes.
+        unsigned GetChunkSize() const { return chunkSize_; }
+        /// Return the frame generation. Incremented on each reset.
+        unsigned GetGeneration() const { return generation_; }
+        /// Return the bytes allocated by all threads during the last completed frame, including alignment padding.
+        unsigned long long GetLastFrameBytes() const { return lastFrameBytes_; }
+        /// Return the highest number of bytes allocated by all threads during a single frame.
+        unsigned long long GetHighWaterMark() const { return highWaterMark_; }
+        /// Return the highest number of bytes allocated by a single thread during a single frame.
+        unsigned long long GetThreadHighWaterMark() const;
+        /// Return the total size of chunks currently held.
+        unsigned long long GetReservedBytes() const;
+        /// Return the number of threads that have allocated.
+        unsigned GetNumArenas() const { return arenas_.Size(); }
+
+    private:
+        /// Return the calling thread's arena, creating it if necessary.
+        FrameArena* GetThreadArena();
+        /// Handle end of frame event.
+        void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+
+        /// Per-thread arenas.
+        PODVector<FrameArena*> arenas_;
+        /// Mutex for adding arenas.
+        Mutex arenasMutex_;
+        /// Unique id used to find the per-thread arenas.
+        unsigned long long id_;
+        /// Minimum chunk size in bytes.
+        unsigned chunkSize_;
+        /// Frame generation.
+        unsigned generation_;
+        /// Bytes allocated during the last completed frame.
+        unsigned long long lastFrameBytes_;
+        /// Highest number of bytes allocated during a single frame.
+        unsigned long long highWaterMark_;
+    };
+
+    /// Vector of plain data that allocates from the frame allocator, or from the heap if no allocator is set. Contents do not survive
+    /// the end of frame: call Clear() before reusing the vector in a new frame.
+    template <class T> class FramePODVector
+    {
+    public:
+        using ValueType = T;
+        using Iterator = RandomAccessIterator<T>;
+        using ConstIterator = RandomAccessConstIterator<T>;
+
+        /// Construct empty, optionally with an allocator.
+        explicit FramePODVector(FrameAllocator* allocator = nullptr) noexcept
+            : allocator_(allocator)
+        {
+        }
+        /// Copy-construct. Uses the same allocator.
+        FramePODVector(const FramePODVector<T>& vector)
+            : allocator_(vector.allocator_)
+        {
+            if (vector.IsCurrent())
+                Push(vector);
+        }
+        /// Move-construct.
+        FramePODVector(FramePODVector<T>&& vector) noexcept
+        {
+            Swap(vector);
+        }
+        /// Destruct. Arena memory is reclaimed at end of frame.
+        ~FramePODVector()
+        {
+            if (!allocator_)
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+        }
+        /// Assign from another vector.
+        FramePODVector<T>& operator =(const FramePODVector<T>& rhs)
+        {
+            if (&rhs != this)
+            {
+                Clear();
+                if (rhs.IsCurrent())
+                    Push(rhs);
+            }
+            return *this;
+        }
+        /// Move-assign from another vector.
+        FramePODVector<T>& operator =(FramePODVector<T>&& rhs) noexcept
+        {
+            Swap(rhs);
+            return *this;
+        }
+        /// Return element at index.
+        T& operator [](unsigned index) { assert(index < size_); return buffer_[index]; }
+        /// Return const element at index.
+        const T& operator [](unsigned index) const { assert(index < size_); return buffer_[index]; }
+
+        /// Set the allocator. Clears the vector.
+        void SetAllocator(FrameAllocator* allocator)
+        {
+            if (allocator == allocator_)
+                return;
+
+            if (!allocator_)
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+            allocator_ = allocator;
+            buffer_ = nullptr;
+            size_ = 0;
+            capacity_ = 0;
+        }
+        /// Add an element at the end.
+        void Push(const T& value)
+        {
+            if (size_ == capacity_)
+            {
+                // The value may live in the buffer that is about to move
+                T copy = value;
+                Grow(size_ + 1);
+                buffer_[size_++] = copy;
+            }
+            else
+                buffer_[size_++] = value;
+        }
+        /// Add another vector at the end.
+        void Push(const FramePODVector<T>& vector)
+        {
+            // Copy the source size first in case the vector is pushed to itself
+            unsigned count = vector.size_;
+            if (!count)
+                return;
+            if (size_ + count > capacity_)
+                Grow(size_ + count);
+            memcpy(buffer_ + size_, vector.buffer_, count * sizeof(T));
+            size_ += count;
+        }
+        /// Remove the last element.
+        void Pop()
+        {
+            if (size_)
+                --size_;
+        }
+        /// Resize the vector. New elements are left uninitialized.
+        void Resize(unsigned newSize)
+        {
+            if (newSize > capacity_)
+                Grow(newSize);
+            size_ = newSize;
+        }
+        /// Set new capacity.
+        void Reserve(unsigned newCapacity)
+        {
+            if (newCapacity > capacity_)
+                Reallocate(newCapacity);
+        }
+        /// Clear the vector. Keeps the buffer if it was allocated during the current frame.
+        void Clear()
+        {
+            DiscardStale();
+            size_ = 0;
+        }
+        /// Swap with another vector.
+        void Swap(FramePODVector<T>& vector)
+        {
+            My3D::Swap(allocator_, vector.allocator_);
+            My3D::Swap(buffer_, vector.buffer_);
+            My3D::Swap(size_, vector.size_);
+            My3D::Swap(capacity_, vector.capacity_);
+            My3D::Swap(generation_, vector.generation_);
+        }
+
+        /// Return iterator to the beginning.
+        Iterator Begin() { return Iterator(buffer_); }
+        /// Return const iterator to the beginning.
+        ConstIterator Begin() const { return ConstIterator(buffer_); }
+        /// Return iterator to the end.
+        Iterator End() { return Iterator(buffer_ + size_); }
+        /// Return const iterator to the end.
+        ConstIterator End() const { return ConstIterator(buffer_ + size_); }
+        /// Return first element.
+        T& Front() { assert(size_); return buffer_[0]; }
+        /// Return const first element.
+        const T& Front() const { assert(size_); return buffer_[0]; }
+        /// Return last element.
+        T& Back() { assert(size_); return buffer_[size_ - 1]; }
+        /// Return const last element.
+        const T& Back() const { assert(size_); return buffer_[size_ - 1]; }
+        /// Return the buffer.
+        T* Buffer() const { return buffer_; }
+        /// Return the allocator, or null if using the heap.
+        FrameAllocator* GetAllocator() const { return allocator_; }
+        /// Return size of vector.
+        unsigned Size() const { return size_; }
+        /// Return capacity of vector.
+        unsigned Capacity() const { return capacity_; }
+        /// Return whether vector is empty.
+        bool Empty() const { return size_ == 0; }
+
+    private:
+        /// Return whether the contents are valid in the current frame.
+        bool IsCurrent() const { return !allocator_ || generation_ == allocator_->GetGeneration(); }
+        /// Forget a buffer left over from a past frame. Its memory has been rewound.
+        void DiscardStale()
+        {
+            if (!IsCurrent())
+            {
+                buffer_ = nullptr;
+                size_ = 0;
+                capacity_ = 0;
+            }
+        }
+        /// Grow the capacity to hold at least the specified number of elements.
+        void Grow(unsigned minCapacity)
+        {
+            unsigned newCapacity = capacity_ ? capacity_ : 1;
+            while (newCapacity < minCapacity)
+                newCapacity += (newCapacity + 1) >> 1u;
+            Reallocate(newCapacity);
+        }
+        /// Reallocate the buffer.
+        void Reallocate(unsigned newCapacity)
+        {
+            DiscardStale();
+            if (allocator_)
+            {
+                if (buffer_ && allocator_->Extend(buffer_, capacity_ * sizeof(T), newCapacity * sizeof(T)))
+                {
+                    capacity_ = newCapacity;
+                    return;
+                }
+
+                // The old buffer is abandoned to the arena
+                T* newBuffer = static_cast<T*>(allocator_->Allocate(newCapacity * sizeof(T), alignof(T)));
+                if (size_)
+                    memcpy(newBuffer, buffer_, size_ * sizeof(T));
+                buffer_ = newBuffer;
+                generation_ = allocator_->GetGeneration();
+            }
+            else
+            {
+                auto* newBuffer = reinterpret_cast<T*>(new unsigned char[newCapacity * sizeof(T)]);
+                if (size_)
+                    memcpy(newBuffer, buffer_, size_ * sizeof(T));
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+                buffer_ = newBuffer;
+            }
+
+            capacity_ = newCapacity;
+        }
+
+        /// Frame allocator, or null to use the heap.
+        FrameAllocator* allocator_{};
+        /// Buffer.
+        T* buffer_{};
+        /// Size of vector.
+        unsigned size_{};
+        /// Buffer capacity.
+        unsigned capacity_{};
+        /// Frame generation of the buffer.
+        unsigned generation_{};
+    };
+
+    /// Vector of objects that allocates from the frame allocator, or from the heap if no allocator is set. Elements are constructed,
+    /// copied and moved as usual, but must be trivially destructible, as arena memory is rewound at end of frame without running
+    /// destructors. Contents do not survive the end of frame: call Clear() before reusing the vector in a new frame.
+    template <class T> class FrameVector
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameVector elements must be trivially destructible");
+
+    public:
+        using ValueType = T;
+        using Iterator = RandomAccessIterator<T>;
+        using ConstIterator = RandomAccessConstIterator<T>;
+
+        /// Construct empty, optionally with an allocator.
+        explicit FrameVector(FrameAllocator* allocator = nullptr) noexcept
+            : allocator_(allocator)
+        {
+        }
+        /// Copy-construct. Uses the same allocator.
+        FrameVector(const FrameVector<T>& vector)
+            : allocator_(vector.allocator_)
+        {
+            if (vector.IsCurrent())
+                Push(vector);
+        }
+        /// Move-construct.
+        FrameVector(FrameVector<T>&& vector) noexcept
+        {
+            Swap(vector);
+        }
+        /// Destruct. Arena memory is reclaimed at end of frame.
+        ~FrameVector()
+        {
+            if (!allocator_)
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+        }
+        /// Assign from another vector.
+        FrameVector<T>& operator =(const FrameVector<T>& rhs)
+        {
+            if (&rhs != this)
+            {
+                Clear();
+                if (rhs.IsCurrent())
+                    Push(rhs);
+            }
+            return *this;
+        }
+        /// Move-assign from another vector.
+        FrameVector<T>& operator =(FrameVector<T>&& rhs) noexcept
+        {
+            Swap(rhs);
+            return *this;
+        }
+        /// Return element at index.
+        T& operator [](unsigned index) { assert(index < size_); return buffer_[index]; }
+        /// Return const element at index.
+        const T& operator [](unsigned index) const { assert(index < size_); return buffer_[index]; }
+
+        /// Set the allocator. Clears the vector.
+        void SetAllocator(FrameAllocator* allocator)
+        {
+            if (allocator == allocator_)
+                return;
+
+            if (!allocator_)
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+            allocator_ = allocator;
+            buffer_ = nullptr;
+            size_ = 0;
+            capacity_ = 0;
+        }
+        /// Add an element at the end.
+        void Push(const T& value)
+        {
+            if (size_ == capacity_)
+            {
+                // The value may live in the buffer that is about to move
+                T copy(value);
+                Grow(size_ + 1);
+                new (buffer_ + size_) T(std::move(copy));
+            }
+            else
+                new (buffer_ + size_) T(value);
+            ++size_;
+        }
+        /// Construct an element at the end.
+        template <class... Args> T& EmplaceBack(Args&&... args)
+        {
+            if (size_ == capacity_)
+                Grow(size_ + 1);
+            new (buffer_ + size_) T(std::forward<Args>(args)...);
+            return buffer_[size_++];
+        }
+        /// Add another vector at the end.
+        void Push(const FrameVector<T>& vector)
+        {
+            assert(&vector != this);
+            if (vector.Empty())
+                return;
+            if (size_ + vector.size_ > capacity_)
+                Grow(size_ + vector.size_);
+            for (unsigned i = 0; i < vector.size_; ++i)
+                new (buffer_ + size_ + i) T(vector.buffer_[i]);
+            size_ += vector.size_;
+        }
+        /// Remove the last element.
+        void Pop()
+        {
+            if (size_)
+                --size_;
+        }
+        /// Resize the vector. New elements are default-constructed.
+        void Resize(unsigned newSize)
+        {
+            if (newSize > capacity_)
+                Grow(newSize);
+            while (size_ < newSize)
+                new (buffer_ + size_++) T();
+            size_ = newSize;
+        }
+        /// Set new capacity.
+        void Reserve(unsigned newCapacity)
+        {
+            if (newCapacity > capacity_)
+                Reallocate(newCapacity);
+        }
+        /// Clear the vector. Keeps the buffer if it was allocated during the current frame.
+        void Clear()
+        {
+            DiscardStale();
+            size_ = 0;
+        }
+        /// Swap with another vector.
+        void Swap(FrameVector<T>& vector)
+        {
+            My3D::Swap(allocator_, vector.allocator_);
+            My3D::Swap(buffer_, vector.buffer_);
+            My3D::Swap(size_, vector.size_);
+            My3D::Swap(capacity_, vector.capacity_);
+            My3D::Swap(generation_, vector.generation_);
+        }
+
+        /// Return iterator to the beginning.
+        Iterator Begin() { return Iterator(buffer_); }
+        /// Return const iterator to the beginning.
+        ConstIterator Begin() const { return ConstIterator(buffer_); }
+        /// Return iterator to the end.
+        Iterator End() { return Iterator(buffer_ + size_); }
+        /// Return const iterator to the end.
+        ConstIterator End() const { return ConstIterator(buffer_ + size_); }
+        /// Return first element.
+        T& Front() { assert(size_); return buffer_[0]; }
+        /// Return const first element.
+        const T& Front() const { assert(size_); return buffer_[0]; }
+        /// Return last element.
+        T& Back() { assert(size_); return buffer_[size_ - 1]; }
+        /// Return const last element.
+        const T& Back() const { assert(size_); return buffer_[size_ - 1]; }
+        /// Return the buffer.
+        T* Buffer() const { return buffer_; }
+        /// Return the allocator, or null if using the heap.
+        FrameAllocator* GetAllocator() const { return allocator_; }
+        /// Return size of vector.
+        unsigned Size() const { return size_; }
+        /// Return capacity of vector.
+        unsigned Capacity() const { return capacity_; }
+        /// Return whether vector is empty.
+        bool Empty() const { return size_ == 0; }
+
+    private:
+        /// Return whether the contents are valid in the current frame.
+        bool IsCurrent() const { return !allocator_ || generation_ == allocator_->GetGeneration(); }
+        /// Forget a buffer left over from a past frame. Its memory has been rewound.
+        void DiscardStale()
+        {
+            if (!IsCurrent())
+            {
+                buffer_ = nullptr;
+                size_ = 0;
+                capacity_ = 0;
+            }
+        }
+        /// Grow the capacity to hold at least the specified number of elements.
+        void Grow(unsigned minCapacity)
+        {
+            unsigned newCapacity = capacity_ ? capacity_ : 1;
+            while (newCapacity < minCapacity)
+                newCapacity += (newCapacity + 1) >> 1u;
+            Reallocate(newCapacity);
+        }
+        /// Reallocate the buffer, moving the elements.
+        void Reallocate(unsigned newCapacity)
+        {
+            DiscardStale();
+            if (allocator_ && buffer_ && allocator_->Extend(buffer_, capacity_ * sizeof(T), newCapacity * sizeof(T)))
+            {
+                capacity_ = newCapacity;
+                return;
+            }
+
+            T* newBuffer;
+            if (allocator_)
+                newBuffer = static_cast<T*>(allocator_->Allocate(newCapacity * sizeof(T), alignof(T)));
+            else
+                newBuffer = reinterpret_cast<T*>(new unsigned char[newCapacity * sizeof(T)]);
+
+            for (unsigned i = 0; i < size_; ++i)
+                new (newBuffer + i) T(std::move(buffer_[i]));
+
+            if (allocator_)
+                generation_ = allocator_->GetGeneration();
+            else
+                delete[] reinterpret_cast<unsigned char*>(buffer_);
+            buffer_ = newBuffer;
+            capacity_ = newCapacity;
+        }
+
+        /// Frame allocator, or null to use the heap.
+        FrameAllocator* allocator_{};
+        /// Buffer.
+        T* buffer_{};
+        /// Size of vector.
+        unsigned size_{};
+        /// Buffer capacity.
+        unsigned capacity_{};
+        /// Frame generation of the buffer.
+        unsigned generation_{};
+    };
+
+    template <class T> typename FramePODVector<T>::ConstIterator begin(const FramePODVector<T>& v) { return v.Begin(); }
+    template <class T> typename FramePODVector<T>::ConstIterator end(const FramePODVector<T>& v) { return v.End(); }
+    template <class T> typename FramePODVector<T>::Iterator begin(FramePODVector<T>& v) { return v.Begin(); }
+    template <class T> typename FramePODVector<T>::Iterator end(FramePODVector<T>& v) { return v.End(); }
+    template <class T> typename FrameVector<T>::ConstIterator begin(const FrameVector<T>& v) { return v.Begin(); }
+    template <class T> typename FrameVector<T>::ConstIterator end(const FrameVector<T>& v) { return v.End(); }
+    template <class T> typename FrameVector<T>::Iterator begin(FrameVector<T>& v) { return v.Begin(); }
+    template <class T> typename FrameVector<T>::Iterator end(FrameVector<T>& v) { return v.End(); }
+}
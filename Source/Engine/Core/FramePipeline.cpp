@@ -0,0 +1,164 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Core/FramePipeline.h"
+#include "Core/Profiler.h"
+#include "Core/Thread.h"
+#include "Core/Timer.h"
+#include "IO/Log.h"
+
+
+namespace My3D
+{
+    /// Thread that executes the frame packets in pipelined mode.
+    class RenderThread : public Thread, public RefCounted
+    {
+    public:
+        /// Construct.
+        explicit RenderThread(FramePipeline* owner)
+            : owner_(owner)
+        {
+            SetName("Render thread");
+        }
+
+        /// Execute packets until stopped.
+        void ThreadFunction() override
+        {
+            owner_->ProcessPackets();
+        }
+
+    private:
+        /// Frame pipeline.
+        FramePipeline* owner_;
+    };
+
+    void FramePacket::Execute() const
+    {
+        for (const Command& command : commands_)
+            command(*this);
+    }
+
+    void FramePacket::Clear()
+    {
+        commands_.Clear();
+        references_.Clear();
+    }
+
+    FramePipeline::FramePipeline(Context* context)
+        : Object(context)
+        , pending_(nullptr)
+        , currentIndex_(0)
+        , lastWaitTime_(0)
+        , shutDown_(false)
+    {
+        for (unsigned i = 0; i < NUM_FRAME_PACKETS; ++i)
+            packets_[i].index_ = i;
+    }
+
+    FramePipeline::~FramePipeline()
+    {
+        SetPipelined(false);
+    }
+
+    void FramePipeline::SetPipelined(bool enable)
+    {
+        if (enable == IsPipelined())
+            return;
+
+        if (enable)
+        {
+            shutDown_ = false;
+            renderThread_ = new RenderThread(this);
+            if (!renderThread_->Run())
+            {
+                MY3D_LOGERROR("Failed to start the render thread");
+                renderThread_.Reset();
+            }
+        }
+        else
+        {
+            {
+                MutexLock lock(mutex_);
+                WaitIdle();
+                shutDown_ = true;
+                condition_.NotifyAll();
+            }
+            renderThread_->Stop();
+            renderThread_.Reset();
+        }
+    }
+
+    void FramePipeline::BeginFrame(unsigned frameNumber)
+    {
+        unsigned index = frameNumber % NUM_FRAME_PACKETS;
+        FramePacket& packet = packets_[index];
+        {
+            // The render thread only ever holds the previous packet, but wait in case of a frame number discontinuity
+            MutexLock lock(mutex_);
+            if (pending_ == &packet)
+                WaitIdle();
+        }
+
+        packet.Clear();
+        packet.frameNumber_ = frameNumber;
+        currentIndex_ = index;
+    }
+
+    void FramePipeline::Submit()
+    {
+        FramePacket& packet = packets_[currentIndex_];
+
+        if (!IsPipelined())
+        {
+            MY3D_PROFILE("ExecuteFramePacket");
+            lastWaitTime_ = 0;
+            packet.Execute();
+            return;
+        }
+
+        HiresTimer waitTimer;
+        {
+            MY3D_PROFILE("WaitRenderThread");
+            MutexLock lock(mutex_);
+            WaitIdle();
+            pending_ = &packet;
+            condition_.NotifyAll();
+        }
+        lastWaitTime_ = waitTimer.GetUSec(false);
+    }
+
+    void FramePipeline::Flush()
+    {
+        MutexLock lock(mutex_);
+        WaitIdle();
+    }
+
+    void FramePipeline::ProcessPackets()
+    {
+        MutexLock lock(mutex_);
+        for (;;)
+        {
+            condition_.Wait(mutex_, [this]() { return pending_ || shutDown_; });
+            if (!pending_)
+                break;
+
+            // Execute without the lock, so that the main thread can keep updating until it submits the next packet
+            FramePacket* packet = pending_;
+            mutex_.Release();
+            {
+                MY3D_PROFILE("ExecuteFramePacket");
+                packet->Execute();
+            }
+            mutex_.Acquire();
+
+            pending_ = nullptr;
+            condition_.NotifyAll();
+        }
+    }
+
+    void FramePipeline::WaitIdle()
+    {
+        condition_.Wait(mutex_, [this]() { return pending_ == nullptr; });
+    }
+}
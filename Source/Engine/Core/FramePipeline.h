@@ -0,0 +1,130 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Ptr.h"
+#include "Container/RefCounted.h"
+#include "Container/Vector.h"
+#include "Core/ConditionVariable.h"
+#include "Core/Object.h"
+
+#include <functional>
+
+
+namespace My3D
+{
+    class RenderThread;
+
+    /// Number of frame packets. The main thread records one while the render thread executes the other.
+    static const unsigned NUM_FRAME_PACKETS = 2;
+
+    /// Render work of one frame, recorded on the main thread during the update and executed after it, either immediately or
+    /// on the render thread while the main thread updates the next frame. Commands must only read data captured for the
+    /// packet, such as the render state copy at the packet index, must not send events and must not use frame allocator
+    /// memory, as the frame may end before they run.
+    class MY3D_API FramePacket
+    {
+        friend class FramePipeline;
+
+    public:
+        /// Render command.
+        using Command = std::function<void(const FramePacket&)>;
+
+        /// Construct.
+        FramePacket() = default;
+        /// Prevent copy construction.
+        FramePacket(const FramePacket& rhs) = delete;
+        /// Prevent assignment.
+        FramePacket& operator =(const FramePacket& rhs) = delete;
+
+        /// Add a command to execute in order.
+        void AddCommand(const Command& command) { commands_.Push(command); }
+        /// Keep an object, eg. a culled drawable or camera, alive until the packet has been executed. The reference is
+        /// released on the main thread.
+        void AddReference(RefCounted* object) { references_.Push(SharedPtr<RefCounted>(object)); }
+
+        /// Return the frame number.
+        unsigned GetFrameNumber() const { return frameNumber_; }
+        /// Return the packet index, which is also the render state copy the frame captures into.
+        unsigned GetIndex() const { return index_; }
+        /// Return the number of commands.
+        unsigned GetNumCommands() const { return commands_.Size(); }
+        /// Return the number of kept references.
+        unsigned GetNumReferences() const { return references_.Size(); }
+
+    private:
+        /// Execute the commands.
+        void Execute() const;
+        /// Release the commands and references.
+        void Clear();
+
+        /// Commands.
+        Vector<Command> commands_;
+        /// Objects kept alive.
+        Vector<SharedPtr<RefCounted> > references_;
+        /// Frame number.
+        unsigned frameNumber_{};
+        /// Packet index.
+        unsigned index_{};
+    };
+
+    /// Frame packet recording and execution subsystem. In pipelined mode a render thread executes the packet of frame N while
+    /// the main thread updates frame N+1. The main thread owns a packet, and the render state copy with its index, from
+    /// BeginFrame() until Submit(); the render thread owns it from Submit() until it has been executed. The packet is
+    /// reclaimed and cleared on the main thread when its index comes around again.
+    class MY3D_API FramePipeline : public Object
+    {
+        MY3D_OBJECT(FramePipeline, Object)
+
+    public:
+        /// Construct.
+        explicit FramePipeline(Context* context);
+        /// Destruct. Finish the pending packet and stop the render thread.
+        ~FramePipeline() override;
+
+        /// Set pipelined mode. Starts or stops the render thread, finishing the pending packet first. Call between frames.
+        void SetPipelined(bool enable);
+        /// Begin recording the packet of a frame. Reclaims the packet with the same index, waiting for it if necessary.
+        void BeginFrame(unsigned frameNumber);
+        /// End recording. Executes the packet immediately, or in pipelined mode waits for the previous packet and hands
+        /// this one to the render thread.
+        void Submit();
+        /// Wait until the submitted packets have been executed.
+        void Flush();
+
+        /// Return whether pipelined mode is enabled.
+        bool IsPipelined() const { return renderThread_.NotNull(); }
+        /// Return the packet being recorded. Valid on the main thread between BeginFrame() and Submit().
+        FramePacket& GetPacket() { return packets_[currentIndex_]; }
+        /// Return the index of the packet being recorded.
+        unsigned GetCurrentIndex() const { return currentIndex_; }
+        /// Return how long the main thread waited for the render thread in the last Submit(), in microseconds.
+        long long GetLastWaitTime() const { return lastWaitTime_; }
+
+        /// Execute submitted packets until stopped. Called by the render thread.
+        void ProcessPackets();
+
+    private:
+        /// Wait until no packet is pending. The mutex must be held.
+        void WaitIdle();
+
+        /// Frame packets.
+        FramePacket packets_[NUM_FRAME_PACKETS];
+        /// Render thread. Null when not pipelined.
+        SharedPtr<RenderThread> renderThread_;
+        /// Mutex for the handoff.
+        Mutex mutex_;
+        /// Condition for a packet being submitted or executed.
+        ConditionVariable condition_;
+        /// Packet submitted to the render thread and not yet executed, or null.
+        FramePacket* pending_;
+        /// Index of the packet being recorded.
+        unsigned currentIndex_;
+        /// Main thread wait time in the last submit.
+        long long lastWaitTime_;
+        /// Render thread stop flag.
+        bool shutDown_;
+    };
+}
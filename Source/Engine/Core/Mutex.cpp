@@ -10,6 +10,15 @@
 #include <pthread.h>
 #endif
 
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define MY3D_SPIN_PAUSE() _mm_pause()
+#else
+#define MY3D_SPIN_PAUSE()
+#endif
+
 namespace My3D
 {
 #ifdef PLATFORM_MSVC
@@ -86,4 +95,113 @@ MutexLock::~MutexLock()
     mutex_.Release();
 }
 
-}
\ No newline at end of file
+#ifdef PLATFORM_MSVC
+ReadWriteMutex::ReadWriteMutex()
+    : handle_(new SRWLOCK)
+{
+    InitializeSRWLock((SRWLOCK*)handle_);
+}
+
+ReadWriteMutex::~ReadWriteMutex()
+{
+    delete (SRWLOCK*)handle_;
+    handle_ = nullptr;
+}
+
+void ReadWriteMutex::Acquire()
+{
+    AcquireSRWLockExclusive((SRWLOCK*)handle_);
+}
+
+bool ReadWriteMutex::TryAcquire()
+{
+    return TryAcquireSRWLockExclusive((SRWLOCK*)handle_) != 0;
+}
+
+void ReadWriteMutex::Release()
+{
+    ReleaseSRWLockExclusive((SRWLOCK*)handle_);
+}
+
+void ReadWriteMutex::AcquireShared()
+{
+    AcquireSRWLockShared((SRWLOCK*)handle_);
+}
+
+bool ReadWriteMutex::TryAcquireShared()
+{
+    return TryAcquireSRWLockShared((SRWLOCK*)handle_) != 0;
+}
+
+void ReadWriteMutex::ReleaseShared()
+{
+    ReleaseSRWLockShared((SRWLOCK*)handle_);
+}
+#else
+ReadWriteMutex::ReadWriteMutex()
+    : handle_(new pthread_rwlock_t)
+{
+    pthread_rwlock_init((pthread_rwlock_t*)handle_, nullptr);
+}
+
+ReadWriteMutex::~ReadWriteMutex()
+{
+    auto* lock = (pthread_rwlock_t*)handle_;
+    pthread_rwlock_destroy(lock);
+    delete lock;
+    handle_ = nullptr;
+}
+
+void ReadWriteMutex::Acquire()
+{
+    pthread_rwlock_wrlock((pthread_rwlock_t*)handle_);
+}
+
+bool ReadWriteMutex::TryAcquire()
+{
+    return pthread_rwlock_trywrlock((pthread_rwlock_t*)handle_) == 0;
+}
+
+void ReadWriteMutex::Release()
+{
+    pthread_rwlock_unlock((pthread_rwlock_t*)handle_);
+}
+
+void ReadWriteMutex::AcquireShared()
+{
+    pthread_rwlock_rdlock((pthread_rwlock_t*)handle_);
+}
+
+bool ReadWriteMutex::TryAcquireShared()
+{
+    return pthread_rwlock_tryrdlock((pthread_rwlock_t*)handle_) == 0;
+}
+
+void ReadWriteMutex::ReleaseShared()
+{
+    pthread_rwlock_unlock((pthread_rwlock_t*)handle_);
+}
+#endif
+
+void SpinLock::AcquireContended()
+{
+    // Spin on a plain load so that the cache line stays shared until the lock is released. If the owner does not release
+    // it soon it has likely been descheduled, so give up the time slice instead of burning it
+    static const unsigned MAX_SPINS = 64;
+    unsigned spins = 0;
+    do
+    {
+        while (locked_.load(std::memory_order_relaxed))
+        {
+            if (spins < MAX_SPINS)
+            {
+                MY3D_SPIN_PAUSE();
+                ++spins;
+            }
+            else
+                std::this_thread::yield();
+        }
+    } while (locked_.exchange(true, std::memory_order_acquire));
+}
+
+}
@@ -6,11 +6,15 @@
 
 #include "My3D.h"
 
+#include <atomic>
+
 namespace My3D
 {
     /// Operating system mutual exclusion primitive.
     class MY3D_API Mutex
     {
+        friend class ConditionVariable;
+
     public:
         /// Construct
         Mutex();
@@ -46,4 +50,121 @@ namespace My3D
         /// Mutex reference.
         Mutex& mutex_;
     };
+
+    /// Operating system reader-writer lock. Any number of readers can hold it shared, or one writer exclusively. Not recursive
+    /// in exclusive mode. A reader should not acquire it again while holding it, as that may block behind a waiting writer.
+    class MY3D_API ReadWriteMutex
+    {
+    public:
+        /// Construct.
+        ReadWriteMutex();
+        /// Destruct.
+        ~ReadWriteMutex();
+        /// Prevent copy construction.
+        ReadWriteMutex(const ReadWriteMutex& rhs) = delete;
+        /// Prevent assignment.
+        ReadWriteMutex& operator =(const ReadWriteMutex& rhs) = delete;
+
+        /// Acquire exclusively for writing. Block while held by any other thread.
+        void Acquire();
+        /// Try to acquire exclusively without blocking. Return true if successful.
+        bool TryAcquire();
+        /// Release exclusive ownership.
+        void Release();
+        /// Acquire shared for reading. Block while held exclusively.
+        void AcquireShared();
+        /// Try to acquire shared without blocking. Return true if successful.
+        bool TryAcquireShared();
+        /// Release shared ownership.
+        void ReleaseShared();
+
+    private:
+        /// Lock handle.
+        void* handle_;
+    };
+
+    /// Lock that automatically acquires and releases a reader-writer mutex for reading.
+    class MY3D_API ReadLock
+    {
+    public:
+        /// Construct and acquire the mutex shared.
+        explicit ReadLock(ReadWriteMutex& mutex) : mutex_(mutex) { mutex_.AcquireShared(); }
+        /// Destruct. Release the mutex.
+        ~ReadLock() { mutex_.ReleaseShared(); }
+
+        /// Prevent copy construction.
+        ReadLock(const ReadLock& rhs) = delete;
+        /// Prevent assignment.
+        ReadLock& operator =(const ReadLock& rhs) = delete;
+    private:
+        /// Mutex reference.
+        ReadWriteMutex& mutex_;
+    };
+
+    /// Lock that automatically acquires and releases a reader-writer mutex for writing.
+    class MY3D_API WriteLock
+    {
+    public:
+        /// Construct and acquire the mutex exclusively.
+        explicit WriteLock(ReadWriteMutex& mutex) : mutex_(mutex) { mutex_.Acquire(); }
+        /// Destruct. Release the mutex.
+        ~WriteLock() { mutex_.Release(); }
+
+        /// Prevent copy construction.
+        WriteLock(const WriteLock& rhs) = delete;
+        /// Prevent assignment.
+        WriteLock& operator =(const WriteLock& rhs) = delete;
+    private:
+        /// Mutex reference.
+        ReadWriteMutex& mutex_;
+    };
+
+    /// Busy-waiting lock for critical sections of a few instructions. A contended acquire spins for a while, then yields the
+    /// thread so that a descheduled owner can run. Not recursive.
+    class MY3D_API SpinLock
+    {
+    public:
+        /// Construct.
+        SpinLock() : locked_(false) { }
+        /// Prevent copy construction.
+        SpinLock(const SpinLock& rhs) = delete;
+        /// Prevent assignment.
+        SpinLock& operator =(const SpinLock& rhs) = delete;
+
+        /// Acquire the lock. Spin and then yield while held by another thread.
+        void Acquire()
+        {
+            if (locked_.exchange(true, std::memory_order_acquire))
+                AcquireContended();
+        }
+        /// Try to acquire the lock without waiting. Return true if successful.
+        bool TryAcquire() { return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire); }
+        /// Release the lock.
+        void Release() { locked_.store(false, std::memory_order_release); }
+
+    private:
+        /// Wait until the lock can be taken.
+        void AcquireContended();
+
+        /// Locked flag.
+        std::atomic<bool> locked_;
+    };
+
+    /// Lock that automatically acquires and releases a spin lock.
+    class MY3D_API SpinLockGuard
+    {
+    public:
+        /// Construct and acquire the lock.
+        explicit SpinLockGuard(SpinLock& lock) : lock_(lock) { lock_.Acquire(); }
+        /// Destruct. Release the lock.
+        ~SpinLockGuard() { lock_.Release(); }
+
+        /// Prevent copy construction.
+        SpinLockGuard(const SpinLockGuard& rhs) = delete;
+        /// Prevent assignment.
+        SpinLockGuard& operator =(const SpinLockGuard& rhs) = delete;
+    private:
+        /// Lock reference.
+        SpinLock& lock_;
+    };
 }
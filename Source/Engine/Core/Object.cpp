@@ -5,8 +5,10 @@
 #include "Core/Object.h"
 #include "Core/Context.h"
 #include "Core/Thread.h"
+#include "Core/TraceRecorder.h"
 #include "IO/Log.h"
 #include "Container/HashSet.h"
+#include "Container/SmallVector.h"
 
 
 
@@ -14,7 +16,7 @@ namespace My3D
 {
 
 TypeInfo::TypeInfo(const char *typeName, const My3D::TypeInfo *baseTypeInfo)
-    : type_(typeName)
+    : type_(StringHash::Register(typeName))
     , typeName_(typeName)
     , baseTypeInfo_(baseTypeInfo)
 {
@@ -58,6 +60,7 @@ Object::Object(Context* context)
 
 Object::~Object()
 {
+    UnsubscribeFromAllEvents();
     context_->RemoveEventSender(this);
 }
 
@@ -166,17 +169,24 @@ void Object::SendEvent(StringHash eventType, VariantMap &eventData)
 {
     if (!Thread::IsMainThread())
     {
-        MY3D_LOGERROR("Sending events is only supported from the main thread");
+        MY3D_LOGERROR("Sending events is only supported from the main thread, use PostEvent() instead");
         return;
     }
 
+    context_->CheckPostedEvents(eventType);
+
     if (blockEvents_)
         return;
 
+    MY3D_TRACE_EVENT("SendEvent", eventType.Value());
+
     // Make a weak pointer to self to check for destruction during event handling
     WeakPtr<Object> self(this);
     Context* context = context_;
-    HashSet<Object*> processed;
+    // Specific receivers are usually few, so a linear search of an inline list beats hashing. Beyond the inline capacity they
+    // are hashed, so that checking the non-specific receivers does not become quadratic
+    SmallVector<Object*, 16> processed;
+    HashSet<Object*> processedSet;
 
     context_->BeginSendEvent(this, eventType);
 
@@ -200,9 +210,15 @@ void Object::SendEvent(StringHash eventType, VariantMap &eventData)
                 return;
             }
 
-            processed.Insert(receiver);
+            processed.Push(receiver);
         }
         group->EndSendEvent();
+
+        if (!processed.IsInline())
+        {
+            for (unsigned i = 0; i < processed.Size(); ++i)
+                processedSet.Insert(processed[i]);
+        }
     }
 
     // Then the non-specific receivers
@@ -233,7 +249,7 @@ void Object::SendEvent(StringHash eventType, VariantMap &eventData)
             for (unsigned i = 0; i < numReceivers; ++i)
             {
                 Object* receiver = group->receivers_[i];
-                if (!receiver || processed.Contains(receiver))
+                if (!receiver || (processedSet.Empty() ? processed.Contains(receiver) : processedSet.Contains(receiver)))
                     continue;
                 receiver->OnEvent(this, eventType, eventData);
                 if (self.Expired())
@@ -251,6 +267,88 @@ void Object::SendEvent(StringHash eventType, VariantMap &eventData)
     context_->EndSendEvent();
 }
 
+void Object::SubscribeToTypedEvent(StringHash eventType, const TypedEventHandler& handler)
+{
+    bool subscribed = typedEventTypes_.Contains(eventType);
+    context_->AddTypedEventReceiver(eventType, handler, subscribed);
+    if (!subscribed)
+        typedEventTypes_.Push(eventType);
+}
+
+bool Object::UnsubscribeFromTypedEvent(StringHash eventType)
+{
+    if (!typedEventTypes_.Remove(eventType))
+        return false;
+
+    context_->RemoveTypedEventReceiver(this, eventType);
+    return true;
+}
+
+void Object::PostEvent(StringHash eventType, const VariantMap& eventData, bool coalesce)
+{
+    context_->PostEvent(this, eventType, eventData, coalesce);
+}
+
+void Object::PostEvent(StringHash eventType, bool coalesce)
+{
+    context_->PostEvent(this, eventType, Variant::emptyVariantMap, coalesce);
+}
+
+void Object::SendTypedEvent(StringHash eventType, const void* payload, TypedEventConvertFunction convert)
+{
+    if (!Thread::IsMainThread())
+    {
+        MY3D_LOGERROR("Sending events is only supported from the main thread");
+        return;
+    }
+
+    context_->CheckPostedEvents(eventType);
+
+    if (blockEvents_)
+        return;
+
+    // Make a weak pointer to self to check for destruction during event handling
+    WeakPtr<Object> self(this);
+    Context* context = context_;
+
+    SharedPtr<TypedEventReceiverGroup> group(context->GetTypedEventReceivers(eventType));
+    if (group && group->handlers_.Size())
+    {
+        MY3D_TRACE_EVENT("SendEvent", eventType.Value());
+
+        context->BeginSendEvent(this, eventType);
+        group->BeginSendEvent();
+        // Handlers added during the send are not invoked. Copy each handler, as adding may reallocate the array
+        unsigned numHandlers = group->handlers_.Size();
+        for (unsigned i = 0; i < numHandlers; ++i)
+        {
+            TypedEventHandler handler = group->handlers_[i];
+            if (!handler.receiver_ || handler.receiver_->blockEvents_)
+                continue;
+
+            handler.invoke_(handler, payload);
+            if (self.Expired())
+            {
+                group->EndSendEvent();
+                context->EndSendEvent();
+                return;
+            }
+        }
+        group->EndSendEvent();
+        context->EndSendEvent();
+    }
+
+    // Convert the payload only if there are receivers with VariantMap handlers
+    EventReceiverGroup* receivers = context->GetEventReceivers(eventType);
+    EventReceiverGroup* specificReceivers = context->GetEventReceivers(this, eventType);
+    if ((receivers && receivers->receivers_.Size()) || (specificReceivers && specificReceivers->receivers_.Size()))
+    {
+        VariantMap& eventData = GetEventDataMap();
+        convert(payload, eventData);
+        SendEvent(eventType, eventData);
+    }
+}
+
 const String& Object::GetCategory() const
 {
     return String::EMPTY;
@@ -308,7 +406,7 @@ void Object::SubscribeToEvent(StringHash eventType,
 
 bool Object::HasSubscribedToEvent(StringHash eventType) const
 {
-    return FindEventHandler(eventType, nullptr) != nullptr;
+    return FindEventHandler(eventType, nullptr) != nullptr || typedEventTypes_.Contains(eventType);
 }
 
 bool Object::HasSubscribedToEvent(Object *sender, StringHash eventType) const
@@ -390,6 +488,8 @@ EventHandler* Object::FindEventHandler(StringHash eventType, EventHandler **prev
 
 void Object::UnsubscribeFromEvent(StringHash eventType)
 {
+    UnsubscribeFromTypedEvent(eventType);
+
     for (;;)
     {
         EventHandler* previous;
@@ -442,6 +542,10 @@ void Object::UnsubscribeFromEvents(Object *sender)
 
 void Object::UnsubscribeFromAllEvents()
 {
+    for (unsigned i = 0; i < typedEventTypes_.Size(); ++i)
+        context_->RemoveTypedEventReceiver(this, typedEventTypes_[i]);
+    typedEventTypes_.Clear();
+
     for (;;)
     {
         EventHandler* handler = eventHandlers_.First();
@@ -460,6 +564,19 @@ void Object::UnsubscribeFromAllEvents()
 
 void Object::UnsubscribeFromAllEventsExcept(const PODVector<StringHash> &exceptions, bool onlyUserData)
 {
+    // Typed handlers have no userdata
+    if (!onlyUserData)
+    {
+        for (unsigned i = typedEventTypes_.Size() - 1; i < typedEventTypes_.Size(); --i)
+        {
+            if (!exceptions.Contains(typedEventTypes_[i]))
+            {
+                context_->RemoveTypedEventReceiver(this, typedEventTypes_[i]);
+                typedEventTypes_.Erase(i);
+            }
+        }
+    }
+
     EventHandler* previous = nullptr;
     EventHandler* handler = eventHandlers_.First();
 
@@ -481,5 +598,14 @@ void Object::UnsubscribeFromAllEventsExcept(const PODVector<StringHash> &excepti
     }
 }
 
+void ObjectFactory::ReservePool(unsigned count)
+{
+    if (!pool_)
+        return;
+
+    // Memory of objects released in other threads may stay cached there, so this is a hint rather than a guarantee
+    ConcurrentAllocatorStats stats = ConcurrentAllocatorGetStats(pool_);
+    ConcurrentAllocatorReserveCapacity(pool_, stats.liveNodes_ + count);
 }
 
+}
@@ -7,12 +7,15 @@
 #include "My3D.h"
 #include "Core/StringHash.h"
 #include "Container/RefCounted.h"
+#include "Container/ConcurrentAllocator.h"
 #include "Container/Ptr.h"
 #include "Container/LinkedList.h"
 #include "Core/Variant.h"
 
 #include <functional>
 #include <cassert>
+#include <cstring>
+#include <type_traits>
 #include <utility>
 
 
@@ -21,6 +24,27 @@ namespace My3D
 
 class Context;
 class EventHandler;
+class Object;
+
+/// Handler of a typed event. Holds the receiver's member function without allocating and calls it through a type-erased
+/// invoke function, so that receiver lists can be flat arrays.
+struct TypedEventHandler
+{
+    /// Invoke function. Called with the handler and the event payload.
+    using InvokeFunction = void (*)(const TypedEventHandler& handler, const void* payload);
+    /// Maximum size of a member function pointer.
+    static constexpr unsigned MAX_FUNCTION_SIZE = 4 * sizeof(void*);
+
+    /// Receiver. Null if removed during sending.
+    Object* receiver_;
+    /// Invoke function.
+    InvokeFunction invoke_;
+    /// Member function pointer storage.
+    alignas(void*) unsigned char function_[MAX_FUNCTION_SIZE];
+};
+
+/// Function converting a typed event payload to event parameters for receivers that use VariantMap handlers.
+using TypedEventConvertFunction = void (*)(const void* payload, VariantMap& eventData);
 
 
 class MY3D_API TypeInfo
@@ -53,7 +77,7 @@ private:
         virtual My3D::StringHash GetType() const override { return GetTypeInfoStatic()->GetType(); } \
         virtual const My3D::String& GetTypeName() const override { return GetTypeInfoStatic()->GetTypeName(); } \
         virtual const My3D::TypeInfo* GetTypeInfo() const override { return GetTypeInfoStatic(); } \
-        static My3D::StringHash GetTypeStatic() { return GetTypeInfoStatic()->GetType(); } \
+        static constexpr My3D::StringHash GetTypeStatic() { return My3D::StringHash(#typeName); } \
         static const My3D::String& GetTypeNameStatic() { return GetTypeInfoStatic()->GetTypeName(); } \
         static const My3D::TypeInfo* GetTypeInfoStatic() { static const My3D::TypeInfo typeInfoStatic(#typeName, Base::GetTypeInfoStatic()); return &typeInfoStatic; }
 
@@ -125,6 +149,18 @@ public:
     {
         SendEvent(eventType, GetEventDataMap().Populate(args...));
     }
+    /// Post event from any thread to be sent from the main thread at the context's flush point. If coalesce is set, only
+    /// the newest coalescing event of the same type from this object is sent. Posted events of destroyed senders are dropped.
+    void PostEvent(StringHash eventType, const VariantMap& eventData, bool coalesce = false);
+    /// Post event without parameters from any thread.
+    void PostEvent(StringHash eventType, bool coalesce = false);
+    /// Subscribe to a typed event with a member function taking the payload. The payload type is declared with
+    /// MY3D_TYPED_EVENT in the event's namespace. Typed subscriptions do not filter by sender; use GetEventSender() instead.
+    /// Unsubscribe with the event type like VariantMap subscriptions.
+    template<typename T, typename U> void SubscribeToEvent(void (T::*function)(const U&));
+    /// Send a typed event. Typed subscribers get the payload directly, and subscribers with VariantMap handlers, e.g.
+    /// scripts, get it converted to event parameters.
+    template<typename T> auto SendEvent(const T& payload) -> decltype(T::GetEventTypeStatic(), void());
     /// Block object from sending and receiving events
     void SetBlockEvents(bool block) { blockEvents_ = block; }
     /// Return sending and receiving events blocking status
@@ -158,6 +194,14 @@ private:
     EventHandler* FindSpecificEventHandler(Object* sender, StringHash eventType, EventHandler** previous = nullptr) const;
     /// Remove event handlers related to a specific sender
     void RemoveEventSender(Object* sender);
+    /// Subscribe to a typed event.
+    void SubscribeToTypedEvent(StringHash eventType, const TypedEventHandler& handler);
+    /// Unsubscribe from a typed event. Return true if was subscribed.
+    bool UnsubscribeFromTypedEvent(StringHash eventType);
+    /// Send a typed event.
+    void SendTypedEvent(StringHash eventType, const void* payload, TypedEventConvertFunction convert);
+    /// Typed events subscribed to.
+    PODVector<StringHash> typedEventTypes_;
     /// Event handlers.
     LinkedList<EventHandler> eventHandlers_;
     /// Block object from sending and receiving any events
@@ -167,6 +211,34 @@ private:
 template<typename T>
 T* Object::GetSubsystem() const { return static_cast<T*>( GetSubsystem(T::GetTypeStatic()) );}
 
+template<typename T, typename U>
+void Object::SubscribeToEvent(void (T::*function)(const U&))
+{
+    using FunctionPtr = void (T::*)(const U&);
+    static_assert(sizeof(FunctionPtr) <= TypedEventHandler::MAX_FUNCTION_SIZE, "Member function pointer too large");
+    assert(function);
+
+    TypedEventHandler handler{};
+    handler.receiver_ = static_cast<T*>(this);
+    handler.invoke_ = [](const TypedEventHandler& invoked, const void* payload)
+    {
+        FunctionPtr invokedFunction;
+        memcpy(&invokedFunction, invoked.function_, sizeof(FunctionPtr));
+        (static_cast<T*>(invoked.receiver_)->*invokedFunction)(*static_cast<const U*>(payload));
+    };
+    memcpy(handler.function_, &function, sizeof(FunctionPtr));
+    SubscribeToTypedEvent(U::GetEventTypeStatic(), handler);
+}
+
+template<typename T>
+auto Object::SendEvent(const T& payload) -> decltype(T::GetEventTypeStatic(), void())
+{
+    SendTypedEvent(T::GetEventTypeStatic(), &payload, [](const void* payload, VariantMap& eventData)
+    {
+        static_cast<const T*>(payload)->ToVariantMap(eventData);
+    });
+}
+
 /// Base class for object factories
 class MY3D_API ObjectFactory : public RefCounted
 {
@@ -187,12 +259,20 @@ public:
     StringHash GetType() const { return typeInfo_->GetType(); }
     /// Return type name of objects created by this factory
     const String& GetTypeName() const { return typeInfo_->GetTypeName(); }
+    /// Return whether objects are reserved from a pool instead of allocated individually
+    bool IsPooled() const { return pool_ != nullptr; }
+    /// Return object pool statistics. All zero if not pooled
+    ConcurrentAllocatorStats GetPoolStats() const { return ConcurrentAllocatorGetStats(pool_); }
+    /// Grow the object pool so that a number of objects can be created without allocating, for a known burst of creation. No-op if not pooled
+    void ReservePool(unsigned count);
 
 protected:
     /// Execution context
     Context* context_;
     /// Type info
     const TypeInfo* typeInfo_{};
+    /// Object pool, null if not pooled
+    ConcurrentAllocatorState* pool_{};
 };
 
 /// Template implementation of object factory
@@ -213,6 +293,53 @@ public:
     }
 };
 
+/// Object whose memory is reserved from a pool shared by all pooled objects of the type, and returned to it when the last
+/// reference is released
+template <typename T> class PooledObject final : public T
+{
+public:
+    /// Construct
+    explicit PooledObject(Context* context)
+        : T(context)
+    {
+    }
+
+    /// Reserve memory from the pool
+    static void* operator new(size_t size)
+    {
+        assert(size == sizeof(PooledObject<T>));
+        (void)size;
+        return ConcurrentAllocatorReserve(GetPool());
+    }
+    /// Return memory to the pool
+    static void operator delete(void* ptr) { ConcurrentAllocatorFree(GetPool(), ptr); }
+    /// Return the pool. It is never freed, as objects may be released after their context is gone
+    static ConcurrentAllocatorState* GetPool()
+    {
+        static ConcurrentAllocatorState* pool = ConcurrentAllocatorInitialize((unsigned)sizeof(PooledObject<T>), (unsigned)alignof(PooledObject<T>));
+        return pool;
+    }
+};
+
+/// Template implementation of object factory that reserves the objects from a pool
+template <typename T> class PooledObjectFactoryImpl : public ObjectFactory
+{
+public:
+    /// Construct
+    explicit PooledObjectFactoryImpl(Context* context)
+        : ObjectFactory(context)
+    {
+        typeInfo_ = T::GetTypeInfoStatic();
+        pool_ = PooledObject<T>::GetPool();
+    }
+
+    /// Create an object of specific type
+    SharedPtr<Object> CreateObject() override
+    {
+        return SharedPtr<Object>(new PooledObject<T>(context_));
+    }
+};
+
 /// Internal helper class for invoking event handler functions
 class MY3D_API EventHandler : public LinkedListNode
 {
@@ -312,10 +439,20 @@ private:
     HandlerFunctionPtr function_;
 };
 
-/// Describe an event's hash ID and begin a namespace in which to define its parameters
-#define MY3D_EVENT(eventID, eventName) static const My3D::StringHash eventID(#eventName); namespace eventName
-/// Describe an event's parameter hash ID. Should be used inside an event namespace.
-#define MY3D_PARAM(paramID, paramName) static const My3D::StringHash paramID(#paramName);
+#ifdef MY3D_HASH_DEBUG
+/// Describe an event's hash ID and begin a namespace in which to define its parameters. The name is registered for reverse lookup.
+#define MY3D_EVENT(eventID, eventName) static const My3D::StringHash eventID(My3D::StringHash::Register(#eventName)); namespace eventName
+/// Describe an event's parameter hash ID. Should be used inside an event namespace. The name is registered for reverse lookup.
+#define MY3D_PARAM(paramID, paramName) static const My3D::StringHash paramID(My3D::StringHash::Register(#paramName));
+#else
+/// Describe an event's hash ID and begin a namespace in which to define its parameters. The hash is calculated at compile time.
+#define MY3D_EVENT(eventID, eventName) static constexpr My3D::StringHash eventID(#eventName); namespace eventName
+/// Describe an event's parameter hash ID. Should be used inside an event namespace. The hash is calculated at compile time.
+#define MY3D_PARAM(paramID, paramName) static constexpr My3D::StringHash paramID(#paramName);
+#endif
+/// Declare the event type of a typed event payload struct, which is defined in the event's namespace and must also have
+/// a "void ToVariantMap(VariantMap& eventData) const" function for VariantMap handlers.
+#define MY3D_TYPED_EVENT(eventID) static My3D::StringHash GetEventTypeStatic() { return eventID; }
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function
 #define MY3D_HANDLER(className, function) (new My3D::EventHandlerImpl<className>(this, &className::function))
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function, and also defines a userdata pointer.
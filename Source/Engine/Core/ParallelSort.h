@@ -0,0 +1,134 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Sort.h"
+#include "Core/WorkQueue.h"
+
+
+namespace My3D
+{
+    /// Minimum number of elements per chunk for ParallelSort to split the work.
+    static const unsigned PARALLELSORT_MIN_CHUNK = 2048;
+
+    /// Sort or merge task of a ParallelSort.
+    template <class T, class U> struct ParallelSortTask
+    {
+        /// Source elements.
+        T* src_;
+        /// Destination elements for a merge.
+        T* dest_;
+        /// Range start.
+        unsigned begin_;
+        /// Range middle. Equal to the end for a sort task.
+        unsigned middle_;
+        /// Range end.
+        unsigned end_;
+        /// Compare function.
+        const U* compare_;
+    };
+
+    /// Merge two adjacent sorted ranges of the source into the destination. Equal elements keep their order.
+    template <class T, class U> void MergeSortedRanges(const T* src, T* dest, unsigned begin, unsigned middle, unsigned end, const U& compare)
+    {
+        unsigned i = begin;
+        unsigned j = middle;
+        unsigned k = begin;
+        while (i < middle && j < end)
+            dest[k++] = compare(src[j], src[i]) ? src[j++] : src[i++];
+        while (i < middle)
+            dest[k++] = src[i++];
+        while (j < end)
+            dest[k++] = src[j++];
+    }
+
+    /// Work function of ParallelSort.
+    template <class T, class U> void ParallelSortWork(const WorkItem* item, unsigned /*threadIndex*/)
+    {
+        auto* task = reinterpret_cast<ParallelSortTask<T, U>*>(item->start_);
+        if (!task->dest_)
+            Sort(RandomAccessIterator<T>(task->src_ + task->begin_), RandomAccessIterator<T>(task->src_ + task->end_), *task->compare_);
+        else
+            MergeSortedRanges(task->src_, task->dest_, task->begin_, task->middle_, task->end_, *task->compare_);
+    }
+
+    /// Sort using a compare function, splitting the work across the work queue threads. The array is divided into one chunk per
+    /// thread, the chunks are sorted in parallel and then merged pairwise, each level of merges also in parallel. Falls back to
+    /// Sort for small arrays or when there are no worker threads. Must be called from the main thread, not from a work item.
+    /// The scratch vector is resized to the array size; keep it between calls to avoid allocating every frame.
+    template <class T, class U> void ParallelSort(WorkQueue* queue, RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U compare,
+        PODVector<T>& scratch)
+    {
+        auto count = (unsigned)(end - begin);
+        unsigned numChunks = queue ? queue->GetNumThreads() + 1 : 1;
+        while (numChunks > 1 && count / numChunks < PARALLELSORT_MIN_CHUNK)
+            --numChunks;
+        if (numChunks < 2)
+        {
+            Sort(begin, end, compare);
+            return;
+        }
+
+        PODVector<unsigned> bounds(numChunks + 1);
+        for (unsigned i = 0; i <= numChunks; ++i)
+            bounds[i] = (unsigned)((unsigned long long)count * i / numChunks);
+
+        scratch.Resize(count);
+        T* src = begin.ptr_;
+        T* dest = scratch.Buffer();
+        PODVector<ParallelSortTask<T, U> > tasks(numChunks);
+
+        for (unsigned i = 0; i < numChunks; ++i)
+            tasks[i] = {src, nullptr, bounds[i], bounds[i + 1], bounds[i + 1], &compare};
+        for (unsigned i = 0; i < numChunks; ++i)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = ParallelSortWork<T, U>;
+            item->start_ = &tasks[i];
+            queue->AddWorkItem(item);
+        }
+        queue->Complete(M_MAX_UNSIGNED);
+
+        for (unsigned width = 1; width < numChunks; width *= 2)
+        {
+            unsigned numTasks = 0;
+            for (unsigned i = 0; i < numChunks; i += 2 * width)
+            {
+                unsigned middle = i + width < numChunks ? i + width : numChunks;
+                unsigned last = i + 2 * width < numChunks ? i + 2 * width : numChunks;
+                tasks[numTasks++] = {src, dest, bounds[i], bounds[middle], bounds[last], &compare};
+            }
+
+            // Merge the last pair in the main thread while the workers take the others
+            for (unsigned i = 0; i + 1 < numTasks; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = M_MAX_UNSIGNED;
+                item->workFunction_ = ParallelSortWork<T, U>;
+                item->start_ = &tasks[i];
+                queue->AddWorkItem(item);
+            }
+            const ParallelSortTask<T, U>& last = tasks[numTasks - 1];
+            MergeSortedRanges(last.src_, last.dest_, last.begin_, last.middle_, last.end_, compare);
+            queue->Complete(M_MAX_UNSIGNED);
+
+            Swap(src, dest);
+        }
+
+        if (src != begin.ptr_)
+        {
+            for (unsigned i = 0; i < count; ++i)
+                begin.ptr_[i] = src[i];
+        }
+    }
+
+    /// Sort using a compare function, splitting the work across the work queue threads. Allocates a temporary scratch vector.
+    template <class T, class U> void ParallelSort(WorkQueue* queue, RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U compare)
+    {
+        PODVector<T> scratch;
+        ParallelSort(queue, begin, end, compare, scratch);
+    }
+}
@@ -4,6 +4,8 @@
 
 #include "SDL.h"
 #include "Core/ProcessUtils.h"
+#include "Core/StringUtils.h"
+#include "Math/MathDefs.h"
 
 #include <cstdio>
 #ifdef PLATFORM_MSVC
@@ -169,12 +171,153 @@ String GetPlatform()
 
 unsigned GetNumPhysicalCPUs()
 {
-    return SDL_GetCPUCount();
+    return GetCPUTopology().numCores_;
 }
 
 unsigned GetNumLogicalCPUs()
 {
-    return SDL_GetCPUCount();
+    return GetCPUTopology().cpus_.Size();
+}
+
+#ifdef __linux__
+/// Read the first line of a sysfs file. Return empty if it does not exist.
+static String ReadSysFile(const String& path)
+{
+    String result;
+    FILE* file = fopen(path.CString(), "r");
+    if (!file)
+        return result;
+
+    char buffer[1024];
+    if (fgets(buffer, sizeof buffer, file))
+        result = String(buffer).Trimmed();
+    fclose(file);
+    return result;
+}
+
+/// Parse a sysfs CPU or node list such as "0-3,8-11".
+static void ParseSysList(const String& list, PODVector<unsigned>& dest)
+{
+    dest.Clear();
+    Vector<String> ranges = list.Split(',');
+    for (const String& range : ranges)
+    {
+        Vector<String> bounds = range.Split('-');
+        unsigned first = ToUInt(bounds[0]);
+        unsigned last = bounds.Size() > 1 ? ToUInt(bounds[1]) : first;
+        for (unsigned i = first; i <= last; ++i)
+            dest.Push(i);
+    }
+}
+
+/// Return the index of a key among the keys seen so far, adding it if new.
+template <class T> static unsigned GetKeyIndex(Vector<T>& keys, const T& key)
+{
+    for (unsigned i = 0; i < keys.Size(); ++i)
+    {
+        if (keys[i] == key)
+            return i;
+    }
+
+    keys.Push(key);
+    return keys.Size() - 1;
+}
+
+/// Read the processor topology from sysfs. Leave it empty if not available, eg. in a restricted container.
+static void ReadCPUTopology(CPUTopology& topology)
+{
+    const String cpuDir = "/sys/devices/system/cpu/";
+    PODVector<unsigned> indices;
+    ParseSysList(ReadSysFile(cpuDir + "online"), indices);
+
+    // Map each CPU to its NUMA node, if the kernel has NUMA support
+    PODVector<unsigned> nodes;
+    PODVector<unsigned> nodeCPUs;
+    PODVector<unsigned> cpuNodes;
+    ParseSysList(ReadSysFile("/sys/devices/system/node/online"), nodes);
+    for (unsigned node : nodes)
+    {
+        ParseSysList(ReadSysFile("/sys/devices/system/node/node" + String(node) + "/cpulist"), nodeCPUs);
+        for (unsigned cpu : nodeCPUs)
+        {
+            if (cpuNodes.Size() <= cpu)
+                cpuNodes.Resize(cpu + 1, 0);
+            cpuNodes[cpu] = node;
+        }
+    }
+
+    Vector<Pair<unsigned, unsigned> > coreKeys;
+    Vector<String> cacheKeys;
+    Vector<unsigned> nodeKeys;
+    Vector<unsigned> packageKeys;
+
+    for (unsigned index : indices)
+    {
+        String topologyDir = cpuDir + "cpu" + String(index) + "/topology/";
+        String packageId = ReadSysFile(topologyDir + "physical_package_id");
+        String coreId = ReadSysFile(topologyDir + "core_id");
+        if (packageId.Empty() || coreId.Empty())
+        {
+            topology.cpus_.Clear();
+            return;
+        }
+
+        // The last level cache is the highest level listed. Without cache information group by package
+        String cacheKey = "package" + packageId;
+        unsigned cacheLevel = 0;
+        for (unsigned i = 0;; ++i)
+        {
+            String cacheDir = cpuDir + "cpu" + String(index) + "/cache/index" + String(i) + "/";
+            String level = ReadSysFile(cacheDir + "level");
+            if (level.Empty())
+                break;
+            if (ToUInt(level) >= cacheLevel)
+            {
+                cacheLevel = ToUInt(level);
+                cacheKey = ReadSysFile(cacheDir + "shared_cpu_list");
+            }
+        }
+
+        CPUInfo info{};
+        info.index_ = index;
+        info.package_ = GetKeyIndex(packageKeys, ToUInt(packageId));
+        info.core_ = GetKeyIndex(coreKeys, MakePair(ToUInt(packageId), ToUInt(coreId)));
+        info.cacheGroup_ = GetKeyIndex(cacheKeys, cacheKey);
+        info.numaNode_ = GetKeyIndex(nodeKeys, index < cpuNodes.Size() ? cpuNodes[index] : 0);
+        topology.cpus_.Push(info);
+    }
+
+    topology.numCores_ = coreKeys.Size();
+    topology.numCacheGroups_ = cacheKeys.Size();
+    topology.numNumaNodes_ = nodeKeys.Size();
+    topology.numPackages_ = packageKeys.Size();
+}
+#endif
+
+const CPUTopology& GetCPUTopology()
+{
+    static const CPUTopology topology = []()
+    {
+        CPUTopology result;
+#ifdef __linux__
+        ReadCPUTopology(result);
+#endif
+        // Fall back to reporting each logical CPU as its own core
+        if (result.cpus_.Empty())
+        {
+            unsigned numCPUs = (unsigned)Max(SDL_GetCPUCount(), 1);
+            for (unsigned i = 0; i < numCPUs; ++i)
+                result.cpus_.Push(CPUInfo{i, i, 0, 0, 0});
+            result.numCores_ = numCPUs;
+            result.numCacheGroups_ = 1;
+            result.numNumaNodes_ = 1;
+            result.numPackages_ = 1;
+        }
+
+        return result;
+    }();
+
+    return topology;
 }
 
 }
\ No newline at end of file
@@ -37,10 +37,43 @@ MY3D_API const Vector<String>& ParseArguments(int argc, char** argv);
 /// Return previously parsed arguments.
 MY3D_API const Vector<String>& GetArguments();
 
+/// Logical CPU in the processor topology.
+struct CPUInfo
+{
+    /// Logical CPU index used by the operating system, eg. for thread affinity.
+    unsigned index_;
+    /// Physical core index, unique across packages.
+    unsigned core_;
+    /// Index of the group of cores sharing the last level cache.
+    unsigned cacheGroup_;
+    /// NUMA node index.
+    unsigned numaNode_;
+    /// Package (socket) index.
+    unsigned package_;
+};
+
+/// Processor topology. The core, cache group, node and package indices are numbered from zero without gaps.
+struct CPUTopology
+{
+    /// Online logical CPUs in index order.
+    PODVector<CPUInfo> cpus_;
+    /// Number of physical cores.
+    unsigned numCores_{};
+    /// Number of last level cache groups.
+    unsigned numCacheGroups_{};
+    /// Number of NUMA nodes.
+    unsigned numNumaNodes_{};
+    /// Number of packages.
+    unsigned numPackages_{};
+};
+
 /// Return the runtime platform identifier, or (?) if not identified.
 MY3D_API String GetPlatform();
 /// Return the number of physical CPU cores.
 MY3D_API unsigned GetNumPhysicalCPUs();
 /// Return the number of logical CPUs (different from physical if hyperthreading is used).
 MY3D_API unsigned GetNumLogicalCPUs();
+/// Return the processor topology. Read from sysfs on Linux once. On other platforms each logical CPU is reported as its own
+/// core, with one cache group, node and package.
+MY3D_API const CPUTopology& GetCPUTopology();
 }
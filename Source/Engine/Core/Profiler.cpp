@@ -0,0 +1,241 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Core/Profiler.h"
+#include "Core/Thread.h"
+
+#include <cstdio>
+#include <cstring>
+
+
+namespace My3D
+{
+    static const unsigned LINE_MAX_LENGTH = 256;
+    static const int NAME_MAX_LENGTH = 40;
+
+    /// Calling thread's block tree and the identifier of the profiler it belongs to.
+    struct ProfilerThreadData
+    {
+        /// Profiler identifier.
+        unsigned profilerId_;
+        /// Block tree.
+        ProfilerThread* thread_;
+    };
+
+    static thread_local ProfilerThreadData currentThreadData{};
+    static std::atomic<unsigned> nextProfilerId(1);
+
+    std::atomic<Profiler*> Profiler::active(nullptr);
+
+    ProfilerBlock::ProfilerBlock(ProfilerBlock* parent, const char* name)
+        : name_(name)
+        , parent_(parent)
+    {
+    }
+
+    ProfilerBlock::~ProfilerBlock()
+    {
+        for (unsigned i = 0; i < children_.Size(); ++i)
+            delete children_[i];
+    }
+
+    void ProfilerBlock::EndFrame()
+    {
+        frameTime_ = time_.exchange(0, std::memory_order_relaxed);
+        frameCount_ = count_.exchange(0, std::memory_order_relaxed);
+
+        if (frameCount_)
+        {
+            if (!intervalFrames_ || frameTime_ < intervalMinTime_)
+                intervalMinTime_ = frameTime_;
+            if (frameTime_ > intervalMaxTime_)
+                intervalMaxTime_ = frameTime_;
+            intervalTime_ += frameTime_;
+            intervalCount_ += frameCount_;
+            ++intervalFrames_;
+        }
+
+        for (unsigned i = 0; i < children_.Size(); ++i)
+            children_[i]->EndFrame();
+    }
+
+    void ProfilerBlock::BeginInterval()
+    {
+        intervalTime_ = 0;
+        intervalMinTime_ = 0;
+        intervalMaxTime_ = 0;
+        intervalCount_ = 0;
+        intervalFrames_ = 0;
+
+        for (unsigned i = 0; i < children_.Size(); ++i)
+            children_[i]->BeginInterval();
+    }
+
+    ProfilerBlock* ProfilerBlock::FindChild(const char* name) const
+    {
+        // Names are usually string literals, so compare the pointers before the contents
+        for (unsigned i = 0; i < children_.Size(); ++i)
+        {
+            if (children_[i]->name_ == name)
+                return children_[i];
+        }
+        for (unsigned i = 0; i < children_.Size(); ++i)
+        {
+            if (!strcmp(children_[i]->name_, name))
+                return children_[i];
+        }
+
+        return nullptr;
+    }
+
+    Profiler::Profiler(Context* context)
+        : Object(context)
+        , id_(nextProfilerId++)
+    {
+        active.store(this, std::memory_order_release);
+    }
+
+    Profiler::~Profiler()
+    {
+        Profiler* expected = this;
+        active.compare_exchange_strong(expected, nullptr);
+
+        for (unsigned i = 0; i < threads_.Size(); ++i)
+            delete threads_[i];
+    }
+
+    void Profiler::BeginBlock(const char* name)
+    {
+        ProfilerThread* thread = GetThreadData();
+        ProfilerBlock* parent = thread->current_;
+        ProfilerBlock* block = parent->FindChild(name);
+        if (!block)
+        {
+            block = new ProfilerBlock(parent, name);
+            MutexLock lock(thread->mutex_);
+            parent->children_.Push(block);
+        }
+
+        thread->current_ = block;
+        block->Begin();
+    }
+
+    void Profiler::EndBlock()
+    {
+        ProfilerThread* thread = GetThreadData();
+        if (thread->current_ != &thread->root_)
+        {
+            thread->current_->End();
+            thread->current_ = thread->current_->parent_;
+        }
+    }
+
+    void Profiler::BeginFrame()
+    {
+        frameTimer_.Reset();
+    }
+
+    void Profiler::EndFrame()
+    {
+        intervalFrameTime_ += frameTimer_.GetUSec(false);
+        ++intervalFrames_;
+
+        MutexLock lock(threadsMutex_);
+        for (unsigned i = 0; i < threads_.Size(); ++i)
+        {
+            MutexLock threadLock(threads_[i]->mutex_);
+            threads_[i]->root_.EndFrame();
+        }
+    }
+
+    void Profiler::BeginInterval()
+    {
+        intervalFrameTime_ = 0;
+        intervalFrames_ = 0;
+
+        MutexLock lock(threadsMutex_);
+        for (unsigned i = 0; i < threads_.Size(); ++i)
+        {
+            MutexLock threadLock(threads_[i]->mutex_);
+            threads_[i]->root_.BeginInterval();
+        }
+    }
+
+    String Profiler::PrintData(bool showUnused, unsigned maxDepth) const
+    {
+        String output;
+        char line[LINE_MAX_LENGTH];
+
+        snprintf(line, sizeof(line), "Frames: %u, average frame %.3f ms\n\n", intervalFrames_,
+            intervalFrames_ ? intervalFrameTime_ / 1000.0 / intervalFrames_ : 0.0);
+        output.Append(line);
+
+        MutexLock lock(threadsMutex_);
+        for (unsigned i = 0; i < threads_.Size(); ++i)
+        {
+            ProfilerThread* thread = threads_[i];
+            MutexLock threadLock(thread->mutex_);
+
+            snprintf(line, sizeof(line), "%-*s %8s %8s %10s %10s %10s\n", NAME_MAX_LENGTH, thread->name_.CString(), "Count",
+                "Frames", "Average", "Min", "Max");
+            output.Append(line);
+            for (unsigned j = 0; j < thread->root_.children_.Size(); ++j)
+                PrintBlock(output, thread->root_.children_[j], 1, showUnused, maxDepth);
+            output += "\n";
+        }
+
+        return output;
+    }
+
+    unsigned Profiler::GetNumThreads() const
+    {
+        MutexLock lock(threadsMutex_);
+        return threads_.Size();
+    }
+
+    const ProfilerBlock* Profiler::GetRootBlock(unsigned index) const
+    {
+        MutexLock lock(threadsMutex_);
+        return index < threads_.Size() ? &threads_[index]->root_ : nullptr;
+    }
+
+    String Profiler::GetThreadName(unsigned index) const
+    {
+        MutexLock lock(threadsMutex_);
+        return index < threads_.Size() ? threads_[index]->name_ : String::EMPTY;
+    }
+
+    ProfilerThread* Profiler::GetThreadData()
+    {
+        ProfilerThreadData& data = currentThreadData;
+        if (data.profilerId_ == id_)
+            return data.thread_;
+
+        auto* thread = new ProfilerThread(Thread::GetCurrentThreadName());
+        {
+            MutexLock lock(threadsMutex_);
+            threads_.Push(thread);
+        }
+
+        data.profilerId_ = id_;
+        data.thread_ = thread;
+        return thread;
+    }
+
+    void Profiler::PrintBlock(String& output, const ProfilerBlock* block, unsigned depth, bool showUnused, unsigned maxDepth) const
+    {
+        if (depth > maxDepth || (!showUnused && !block->intervalCount_))
+            return;
+
+        char line[LINE_MAX_LENGTH];
+        int indent = Min((int)depth * 2, NAME_MAX_LENGTH / 2);
+        snprintf(line, sizeof(line), "%*s%-*s %8u %8u %10.3f %10.3f %10.3f\n", indent, "", NAME_MAX_LENGTH - indent, block->name_,
+            block->intervalCount_, block->intervalFrames_, block->GetIntervalAverageTime() / 1000.0,
+            block->intervalMinTime_ / 1000.0, block->intervalMaxTime_ / 1000.0);
+        output.Append(line);
+
+        for (unsigned i = 0; i < block->children_.Size(); ++i)
+            PrintBlock(output, block->children_[i], depth + 1, showUnused, maxDepth);
+    }
+}
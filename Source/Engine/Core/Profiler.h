@@ -0,0 +1,223 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/String.h"
+#include "Core/Mutex.h"
+#include "Core/Object.h"
+#include "Core/Timer.h"
+#include "Core/TraceRecorder.h"
+
+#include <atomic>
+
+
+namespace My3D
+{
+    /// Profiling data for one block of code. Timing is accumulated by the thread that owns the block, and collected into frame
+    /// and frame interval statistics by the main thread at the end of each frame.
+    class MY3D_API ProfilerBlock
+    {
+    public:
+        /// Construct with the parent block and a name, which must stay valid as long as the block exists.
+        ProfilerBlock(ProfilerBlock* parent, const char* name);
+        /// Destruct. Free the child blocks.
+        ~ProfilerBlock();
+
+        /// Prevent copy construction.
+        ProfilerBlock(const ProfilerBlock& rhs) = delete;
+        /// Prevent assignment.
+        ProfilerBlock& operator =(const ProfilerBlock& rhs) = delete;
+
+        /// Begin timing.
+        void Begin() { timer_.Reset(); }
+        /// End timing and add the time to the current frame.
+        void End()
+        {
+            time_.fetch_add(timer_.GetUSec(false), std::memory_order_relaxed);
+            count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        /// Collect the current frame's timing into the frame and interval statistics.
+        void EndFrame();
+        /// Clear the interval statistics.
+        void BeginInterval();
+        /// Return a child block with the given name, or null if not found. Names are compared by pointer first.
+        ProfilerBlock* FindChild(const char* name) const;
+
+        /// Return name.
+        const char* GetName() const { return name_; }
+        /// Return parent block.
+        ProfilerBlock* GetParent() const { return parent_; }
+        /// Return child blocks.
+        const PODVector<ProfilerBlock*>& GetChildren() const { return children_; }
+        /// Return time in microseconds during the last frame.
+        long long GetFrameTime() const { return frameTime_; }
+        /// Return number of calls during the last frame.
+        unsigned GetFrameCount() const { return frameCount_; }
+        /// Return total time in microseconds during the interval.
+        long long GetIntervalTime() const { return intervalTime_; }
+        /// Return lowest time in microseconds of a frame the block was called in during the interval.
+        long long GetIntervalMinTime() const { return intervalMinTime_; }
+        /// Return highest time in microseconds of a frame during the interval.
+        long long GetIntervalMaxTime() const { return intervalMaxTime_; }
+        /// Return average time in microseconds of a frame the block was called in during the interval.
+        long long GetIntervalAverageTime() const { return intervalFrames_ ? intervalTime_ / intervalFrames_ : 0; }
+        /// Return number of calls during the interval.
+        unsigned GetIntervalCount() const { return intervalCount_; }
+        /// Return number of frames the block was called in during the interval.
+        unsigned GetIntervalFrames() const { return intervalFrames_; }
+
+    private:
+        friend class Profiler;
+
+        /// Block name.
+        const char* name_;
+        /// Parent block.
+        ProfilerBlock* parent_;
+        /// Child blocks. Only the owner thread adds children, under the mutex of its profiler thread data.
+        PODVector<ProfilerBlock*> children_;
+        /// High-resolution timer for measuring the block.
+        HiresTimer timer_;
+        /// Time accumulated during the current frame.
+        std::atomic<long long> time_{};
+        /// Calls during the current frame.
+        std::atomic<unsigned> count_{};
+        /// Time during the last frame.
+        long long frameTime_{};
+        /// Calls during the last frame.
+        unsigned frameCount_{};
+        /// Total time during the interval.
+        long long intervalTime_{};
+        /// Lowest frame time during the interval.
+        long long intervalMinTime_{};
+        /// Highest frame time during the interval.
+        long long intervalMaxTime_{};
+        /// Calls during the interval.
+        unsigned intervalCount_{};
+        /// Frames with calls during the interval.
+        unsigned intervalFrames_{};
+    };
+
+    /// Profiling blocks of one thread.
+    struct ProfilerThread
+    {
+        /// Construct with a name.
+        explicit ProfilerThread(const String& name)
+            : name_(name)
+            , root_(nullptr, "Root")
+            , current_(&root_)
+        {
+        }
+
+        /// Thread name for the report.
+        String name_;
+        /// Root block. Not timed itself.
+        ProfilerBlock root_;
+        /// Innermost open block.
+        ProfilerBlock* current_;
+        /// Mutex for adding child blocks while the main thread collects the statistics.
+        Mutex mutex_;
+    };
+
+    /// Hierarchical CPU profiler subsystem. Each thread that enters profiling blocks, including the work queue and background
+    /// loader threads, gets its own block tree. The blocks accumulate time per frame, and the main thread aggregates the frames
+    /// into interval statistics until the interval is restarted.
+    class MY3D_API Profiler : public Object
+    {
+        MY3D_OBJECT(Profiler, Object)
+
+    public:
+        /// Construct.
+        explicit Profiler(Context* context);
+        /// Destruct.
+        ~Profiler() override;
+
+        /// Begin a block in the calling thread's tree.
+        void BeginBlock(const char* name);
+        /// End the innermost block of the calling thread.
+        void EndBlock();
+        /// Begin a frame. Called by the Time subsystem.
+        void BeginFrame();
+        /// End a frame and collect the statistics of all threads. Called by the Time subsystem.
+        void EndFrame();
+        /// Clear the interval statistics.
+        void BeginInterval();
+
+        /// Return a text report of the interval statistics of all threads. Times are in milliseconds per frame the block was
+        /// called in. Blocks not called during the interval are left out unless showUnused is set.
+        String PrintData(bool showUnused = false, unsigned maxDepth = M_MAX_UNSIGNED) const;
+        /// Return number of threads with a block tree.
+        unsigned GetNumThreads() const;
+        /// Return root block of a thread, or null if the index is out of range. Threads are in the order they first profiled.
+        const ProfilerBlock* GetRootBlock(unsigned index) const;
+        /// Return name of a thread, or empty if the index is out of range.
+        String GetThreadName(unsigned index) const;
+        /// Return number of frames in the interval.
+        unsigned GetIntervalFrames() const { return intervalFrames_; }
+        /// Return total frame time in microseconds during the interval.
+        long long GetIntervalFrameTime() const { return intervalFrameTime_; }
+
+        /// Return the active profiler, or null if none. Used by the profiling macros, which may be used outside objects and
+        /// in worker threads.
+        static Profiler* GetActive() { return active.load(std::memory_order_acquire); }
+
+    private:
+        /// Return the calling thread's block tree, creating it on first use.
+        ProfilerThread* GetThreadData();
+        /// Append a block and its children to the report.
+        void PrintBlock(String& output, const ProfilerBlock* block, unsigned depth, bool showUnused, unsigned maxDepth) const;
+
+        /// Block trees by thread.
+        PODVector<ProfilerThread*> threads_;
+        /// Mutex for the thread list.
+        mutable Mutex threadsMutex_;
+        /// Identifier of this profiler, to tell it from destroyed ones in the per-thread data.
+        unsigned id_;
+        /// Frame timer.
+        HiresTimer frameTimer_;
+        /// Total frame time during the interval.
+        long long intervalFrameTime_{};
+        /// Frames during the interval.
+        unsigned intervalFrames_{};
+
+        /// Active profiler.
+        static std::atomic<Profiler*> active;
+    };
+
+    /// Helper class for automatically beginning and ending a profiling block. The block is also recorded as a trace event.
+    class MY3D_API AutoProfileBlock
+    {
+    public:
+        /// Construct and begin a block in the active profiler and trace recorder, if any.
+        explicit AutoProfileBlock(const char* name)
+            : profiler_(Profiler::GetActive())
+            , traceEvent_(name)
+        {
+            if (profiler_)
+                profiler_->BeginBlock(name);
+        }
+
+        /// Destruct and end the block.
+        ~AutoProfileBlock()
+        {
+            if (profiler_)
+                profiler_->EndBlock();
+        }
+
+    private:
+        /// Profiler.
+        Profiler* profiler_;
+        /// Trace event.
+        AutoTraceEvent traceEvent_;
+    };
+
+#define MY3D_PROFILE_CONCAT_IMPL(a, b) a ## b
+#define MY3D_PROFILE_CONCAT(a, b) MY3D_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef MY3D_PROFILING
+#define MY3D_PROFILE(name) My3D::AutoProfileBlock MY3D_PROFILE_CONCAT(profileBlock, __LINE__)(name)
+#else
+#define MY3D_PROFILE(name)
+#endif
+}
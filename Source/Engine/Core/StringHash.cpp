@@ -3,7 +3,7 @@
 //
 
 #include "Core/StringHash.h"
-#include "Math/MathDefs.h"
+#include "Core/StringHashRegister.h"
 #include <cstdio>
 
 
@@ -12,21 +12,38 @@ namespace My3D
 
 const StringHash StringHash::ZERO;
 
+#ifdef MY3D_HASH_DEBUG
+/// Return the global register. Constructed on first use, so that hashes of static objects can be registered during static initialization.
+static StringHashRegister& GetHashRegister()
+{
+    static StringHashRegister hashRegister(true);
+    return hashRegister;
+}
+#endif
 
-StringHash::StringHash(const char* str) noexcept : value_(Calculate(str)) { }
-
-StringHash::StringHash(const String& str) noexcept : value_(Calculate(str.CString())) { }
-
-unsigned StringHash::Calculate(const char *str, unsigned int hash)
+StringHash::StringHash(const String& str) noexcept : value_(Calculate(str.CString()))
 {
-    if (!str) return hash;
+#ifdef MY3D_HASH_DEBUG
+    GetHashRegister().RegisterString(*this, str.CString());
+#endif
+}
 
-    while (*str)
-    {
-        hash = SDBMHash(hash, (unsigned char) *str++);
-    }
+StringHash StringHash::Register(const char* str)
+{
+#ifdef MY3D_HASH_DEBUG
+    return GetHashRegister().RegisterString(str);
+#else
+    return StringHash(str);
+#endif
+}
 
-    return hash;
+StringHashRegister* StringHash::GetGlobalStringHashRegister()
+{
+#ifdef MY3D_HASH_DEBUG
+    return &GetHashRegister();
+#else
+    return nullptr;
+#endif
 }
 
 String StringHash::ToString() const
@@ -36,4 +53,13 @@ String StringHash::ToString() const
     return String(tempBuffer);
 }
 
+String StringHash::Reverse() const
+{
+#ifdef MY3D_HASH_DEBUG
+    return GetHashRegister().GetStringCopy(*this);
+#else
+    return String::EMPTY;
+#endif
+}
+
 }
@@ -6,6 +6,7 @@
 
 #include "My3D.h"
 #include "Container/String.h"
+#include "Math/MathDefs.h"
 
 namespace My3D
 {
@@ -16,24 +17,19 @@ class MY3D_API StringHash
 {
 public:
     /// Construct with zero value
-    StringHash() noexcept : value_(0) { }
+    constexpr StringHash() noexcept : value_(0) { }
     /// Construct from another hash
-    StringHash(const StringHash& rhs) noexcept = default;
+    constexpr StringHash(const StringHash& rhs) noexcept = default;
     /// Construct with an initial value
-    explicit StringHash(unsigned value) noexcept : value_(value) { }
-    /// Construct from a C string
-    StringHash(const char* str) noexcept;
+    constexpr explicit StringHash(unsigned value) noexcept : value_(value) { }
+    /// Construct from a C string. Evaluated at compile time for string literals in constant expressions.
+    constexpr StringHash(const char* str) noexcept : value_(Calculate(str)) { }
     /// Construct from a string
     StringHash(const String& str) noexcept;
     /// Assign from another hash
     StringHash& operator =(const StringHash& rhs) noexcept = default;
     /// Add a hash
-    StringHash operator +(const StringHash& rhs) const
-    {
-        StringHash ret;
-        ret.value_ = value_ + rhs.value_;
-        return ret;
-    }
+    constexpr StringHash operator +(const StringHash& rhs) const { return StringHash(value_ + rhs.value_); }
     /// Add-assign a hash
     StringHash& operator +=(const StringHash& rhs)
     {
@@ -41,28 +37,45 @@ public:
         return *this;
     }
     /// Test equality with another hash
-    bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
+    constexpr bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
     /// Test inequality with another hash
-    bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
+    constexpr bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
     /// Test less than another hash
-    bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
+    constexpr bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
     /// Test greater than another hash
-    bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
+    constexpr bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
     /// Return true if nonzero hash value
-    explicit operator bool() const { return value_ != 0; }
+    constexpr explicit operator bool() const { return value_ != 0; }
     /// return as string
     String ToString() const;
     /// Return hash value for Hashset & Hashmap
-    unsigned ToHash() const { return value_; }
+    constexpr unsigned ToHash() const { return value_; }
     /// Return hash value
-    unsigned Value() const { return value_; }
-    /// Calculate hash value from a C string
-    static unsigned Calculate(const char* str, unsigned hash = 0);
-    /// Get global StringHashRegister. Used for debug only.
-    static StringHashRegister* GetGlobalStringHashRegister() { return nullptr; }
+    constexpr unsigned Value() const { return value_; }
+    /// Return the string this hash was calculated from, if it was registered. Return empty if not registered or if MY3D_HASH_DEBUG is disabled.
+    String Reverse() const;
+    /// Calculate hash value from a C string using the SDBM algorithm.
+    static constexpr unsigned Calculate(const char* str, unsigned hash = 0)
+    {
+        if (!str)
+            return hash;
+
+        while (*str)
+        {
+            hash = SDBMHash(hash, (unsigned char) *str);
+            ++str;
+        }
+
+        return hash;
+    }
+    /// Calculate hash value from a C string and register it with the global StringHashRegister if MY3D_HASH_DEBUG is enabled.
+    static StringHash Register(const char* str);
+    /// Get global StringHashRegister. Return null if MY3D_HASH_DEBUG is disabled.
+    static StringHashRegister* GetGlobalStringHashRegister();
     /// Zero hash
     static const StringHash ZERO;
 private:
+    /// Hash value.
     unsigned value_;
 };
 
@@ -0,0 +1,115 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Core/StringHashRegister.h"
+#include "IO/Log.h"
+
+
+namespace My3D
+{
+
+StringHashRegister::StringHashRegister(bool threadSafe)
+    : threadSafe_(threadSafe)
+    , numCollisions_(0)
+{
+}
+
+StringHash StringHashRegister::RegisterString(const StringHash& hash, const char* string)
+{
+    if (threadSafe_)
+        mutex_.Acquire();
+
+    auto it = map_.Find(hash);
+    if (it == map_.End())
+        map_[hash] = string;
+    else if (it->second_.Compare(string, true) != 0)
+    {
+        ++numCollisions_;
+        MY3D_LOGWARNINGF("StringHash collision detected! Both \"%s\" and \"%s\" have hash #%s", string, it->second_.CString(),
+            hash.ToString().CString());
+    }
+
+    if (threadSafe_)
+        mutex_.Release();
+
+    return hash;
+}
+
+StringHash StringHashRegister::RegisterString(const char* string)
+{
+    return RegisterString(StringHash(string), string);
+}
+
+void StringHashRegister::Clear()
+{
+    if (threadSafe_)
+        mutex_.Acquire();
+
+    map_.Clear();
+    numCollisions_ = 0;
+
+    if (threadSafe_)
+        mutex_.Release();
+}
+
+String StringHashRegister::GetStringCopy(const StringHash& hash) const
+{
+    if (threadSafe_)
+        mutex_.Acquire();
+
+    auto it = map_.Find(hash);
+    String copy = it != map_.End() ? it->second_ : String::EMPTY;
+
+    if (threadSafe_)
+        mutex_.Release();
+
+    return copy;
+}
+
+bool StringHashRegister::Contains(const StringHash& hash) const
+{
+    if (threadSafe_)
+        mutex_.Acquire();
+
+    bool contains = map_.Contains(hash);
+
+    if (threadSafe_)
+        mutex_.Release();
+
+    return contains;
+}
+
+const String& StringHashRegister::GetString(const StringHash& hash) const
+{
+    auto it = map_.Find(hash);
+    return it != map_.End() ? it->second_ : String::EMPTY;
+}
+
+unsigned StringHashRegister::GetNumStrings() const
+{
+    if (threadSafe_)
+        mutex_.Acquire();
+
+    unsigned numStrings = map_.Size();
+
+    if (threadSafe_)
+        mutex_.Release();
+
+    return numStrings;
+}
+
+unsigned StringHashRegister::GetNumCollisions() const
+{
+    if (threadSafe_)
+        mutex_.Acquire();
+
+    unsigned numCollisions = numCollisions_;
+
+    if (threadSafe_)
+        mutex_.Release();
+
+    return numCollisions;
+}
+
+}
@@ -0,0 +1,60 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/HashMap.h"
+#include "Core/Mutex.h"
+#include "Core/StringHash.h"
+
+
+namespace My3D
+{
+
+/// Map of string hashes back to the strings they were calculated from. Used for profiler and log output.
+class MY3D_API StringHashRegister
+{
+public:
+    /// Construct. If thread-safe, registration and lookup can be called from any thread.
+    explicit StringHashRegister(bool threadSafe);
+    /// Destruct.
+    ~StringHashRegister() = default;
+
+    /// Prevent copy construction.
+    StringHashRegister(const StringHashRegister& rhs) = delete;
+    /// Prevent assignment.
+    StringHashRegister& operator =(const StringHashRegister& rhs) = delete;
+
+    /// Register a string with a precalculated hash. Log a warning and keep the first string if another string already has the same hash.
+    StringHash RegisterString(const StringHash& hash, const char* string);
+    /// Calculate the hash of a string and register it.
+    StringHash RegisterString(const char* string);
+    /// Remove all registered strings.
+    void Clear();
+
+    /// Return a copy of the string registered for a hash, or empty if not registered.
+    String GetStringCopy(const StringHash& hash) const;
+    /// Return whether a hash is registered.
+    bool Contains(const StringHash& hash) const;
+    /// Return the string registered for a hash, or empty if not registered. Not safe if other threads can register strings at the same time.
+    const String& GetString(const StringHash& hash) const;
+    /// Return number of registered strings.
+    unsigned GetNumStrings() const;
+    /// Return number of hash collisions detected.
+    unsigned GetNumCollisions() const;
+    /// Return the internal map. Not safe if other threads can register strings at the same time.
+    const StringMap& GetInternalMap() const { return map_; }
+
+private:
+    /// Whether to lock the mutex.
+    bool threadSafe_;
+    /// Number of hash collisions detected.
+    unsigned numCollisions_;
+    /// Mutex for thread-safe access.
+    mutable Mutex mutex_;
+    /// Registered strings.
+    StringMap map_;
+};
+
+}
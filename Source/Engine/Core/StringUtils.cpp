@@ -662,7 +662,7 @@ namespace My3D
                 break;
 
             case VAR_RESOURCEREF:
-                value_.resourceRef_.~ResourceRef();
+                delete value_.resourceRef_;
                 break;
 
             case VAR_RESOURCEREFLIST:
@@ -714,7 +714,7 @@ namespace My3D
                 break;
 
             case VAR_RESOURCEREF:
-                new (&value_.resourceRef_) ResourceRef();
+                value_.resourceRef_ = new ResourceRef();
                 break;
 
             case VAR_RESOURCEREFLIST:
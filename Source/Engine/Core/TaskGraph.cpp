@@ -0,0 +1,258 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Core/TaskGraph.h"
+#include "Core/Thread.h"
+#include "Core/WorkQueue.h"
+#include "IO/Log.h"
+
+
+namespace My3D
+{
+    TaskGraph::TaskGraph(WorkQueue* queue)
+        : queue_(queue)
+    {
+    }
+
+    TaskGraph::~TaskGraph()
+    {
+        for (unsigned i = 0; i < tasks_.Size(); ++i)
+            delete tasks_[i];
+        for (unsigned i = 0; i < freeTasks_.Size(); ++i)
+            delete freeTasks_[i];
+    }
+
+    Task* TaskGraph::AddTask(const TaskFunction& function, void* data)
+    {
+        assert(!running_);
+        return CreateTask(function, data, nullptr);
+    }
+
+    void TaskGraph::AddDependency(Task* task, Task* predecessor)
+    {
+        assert(!running_);
+        if (task && predecessor && task != predecessor)
+            Link(task, predecessor);
+    }
+
+    Task* TaskGraph::Spawn(Task* parent, const TaskFunction& function, void* data)
+    {
+        assert(running_ && parent && !parent->IsFinished());
+        Task* task = CreateTask(function, data, parent);
+        ReleasePredecessor(task);
+        return task;
+    }
+
+    Task* TaskGraph::AddContinuation(Task* task, const TaskFunction& function, void* data)
+    {
+        Task* continuation = CreateTask(function, data, task->parent_);
+        while (task->continuation_)
+            task = task->continuation_;
+
+        // Take over the successors, so that they wait for the continuation instead
+        {
+            MutexLock lock(task->mutex_);
+            if (!task->finished_)
+            {
+                continuation->successors_.Swap(task->successors_);
+                task->successors_.Push(continuation);
+                ++continuation->numPredecessors_;
+            }
+            task->continuation_ = continuation;
+        }
+
+        if (running_)
+            ReleasePredecessor(continuation);
+        return continuation;
+    }
+
+    void TaskGraph::Run()
+    {
+        if (!Thread::IsMainThread())
+        {
+            MY3D_LOGERROR("TaskGraph::Run() can not be called from worker threads");
+            return;
+        }
+        if (running_ || tasks_.Empty())
+            return;
+        // The predecessor counts have been used up, and spawned tasks would run again
+        if (numFinished_)
+        {
+            MY3D_LOGERROR("TaskGraph::Run() called again without Clear()");
+            return;
+        }
+
+        running_ = true;
+        done_ = false;
+
+        // Release the submission hold of all tasks. The ones without predecessors become ready
+        unsigned numTasks = tasks_.Size();
+        for (unsigned i = 0; i < numTasks; ++i)
+            ReleasePredecessor(tasks_[i]);
+
+        // Let one runner per worker thread execute tasks alongside the main thread
+        Vector<SharedPtr<WorkItem> > runners;
+        WorkGroup group;
+        WorkQueue* queue = queue_;
+        unsigned numRunners = queue ? Min(queue->GetNumThreads(), numTasks - 1) : 0;
+        for (unsigned i = 0; i < numRunners; ++i)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = ProcessTasksWork;
+            item->aux_ = this;
+            queue->AddWorkItem(item, &group);
+            runners.Push(item);
+        }
+
+        ProcessTasks(0, true);
+
+        // Runners that were not started are removed, the others exit as soon as they see that the graph is done
+        if (numRunners)
+        {
+            queue->RemoveWorkItems(runners);
+            queue->Complete(group);
+        }
+
+        running_ = false;
+    }
+
+    void TaskGraph::Clear()
+    {
+        assert(!running_);
+        for (unsigned i = 0; i < tasks_.Size(); ++i)
+        {
+            Task* task = tasks_[i];
+            task->function_ = nullptr;
+            task->successors_.Clear();
+            freeTasks_.Push(task);
+        }
+        tasks_.Clear();
+        numTasks_ = 0;
+        numFinished_ = 0;
+    }
+
+    Task* TaskGraph::CreateTask(const TaskFunction& function, void* data, Task* parent)
+    {
+        Task* task;
+        {
+            MutexLock lock(tasksMutex_);
+            if (freeTasks_.Size())
+            {
+                task = freeTasks_.Back();
+                freeTasks_.Pop();
+            }
+            else
+                task = new Task();
+            tasks_.Push(task);
+            ++numTasks_;
+        }
+
+        task->function_ = function;
+        task->data_ = data;
+        task->graph_ = this;
+        task->parent_ = parent;
+        task->continuation_ = nullptr;
+        task->numPredecessors_ = 1;
+        task->numPending_ = 1;
+        task->finished_ = false;
+        if (parent)
+            ++parent->numPending_;
+        return task;
+    }
+
+    bool TaskGraph::Link(Task* task, Task* predecessor)
+    {
+        while (predecessor->continuation_)
+            predecessor = predecessor->continuation_;
+
+        MutexLock lock(predecessor->mutex_);
+        if (predecessor->finished_)
+            return false;
+
+        ++task->numPredecessors_;
+        predecessor->successors_.Push(task);
+        return true;
+    }
+
+    void TaskGraph::ReleasePredecessor(Task* task, Task** next)
+    {
+        if (--task->numPredecessors_)
+            return;
+
+        if (next && !*next)
+        {
+            *next = task;
+            return;
+        }
+
+        MutexLock lock(readyMutex_);
+        ready_.Push(task);
+        if (numWaiting_)
+            readyCondition_.NotifyOne();
+    }
+
+    void TaskGraph::ReleasePending(Task* task, Task** next)
+    {
+        // Finishing a child may finish its parent, so walk up the chain
+        while (task && !--task->numPending_)
+        {
+            {
+                MutexLock lock(task->mutex_);
+                task->finished_.store(true, std::memory_order_release);
+            }
+            // No successors can be added after the finished flag is set
+            for (unsigned i = 0; i < task->successors_.Size(); ++i)
+                ReleasePredecessor(task->successors_[i], next);
+
+            // A task only creates others before it finishes, so when all the created tasks have finished the graph is done
+            Task* parent = task->parent_;
+            if (++numFinished_ == numTasks_)
+            {
+                MutexLock lock(readyMutex_);
+                done_ = true;
+                readyCondition_.NotifyAll();
+            }
+            task = parent;
+        }
+    }
+
+    void TaskGraph::ProcessTasks(unsigned threadIndex, bool wait)
+    {
+        for (;;)
+        {
+            Task* task;
+            {
+                MutexLock lock(readyMutex_);
+                while (wait && ready_.Empty() && !done_)
+                {
+                    ++numWaiting_;
+                    readyCondition_.Wait(readyMutex_);
+                    --numWaiting_;
+                }
+                if (ready_.Empty())
+                    return;
+
+                task = ready_.Back();
+                ready_.Pop();
+            }
+
+            while (task)
+            {
+                if (task->function_)
+                    task->function_(task, threadIndex);
+                Task* next = nullptr;
+                ReleasePending(task, &next);
+                task = next;
+            }
+        }
+    }
+
+    void TaskGraph::ProcessTasksWork(const WorkItem* item, unsigned threadIndex)
+    {
+        // The main thread only takes a runner when a task completes other work, eg. a ParallelFor, from inside Run(). It must
+        // not wait for the graph there, as the graph can not finish before that task returns
+        static_cast<TaskGraph*>(item->aux_)->ProcessTasks(threadIndex, threadIndex != 0);
+    }
+}
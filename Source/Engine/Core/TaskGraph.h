@@ -0,0 +1,147 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/Ptr.h"
+#include "Container/Vector.h"
+#include "Core/ConditionVariable.h"
+
+#include <atomic>
+#include <functional>
+
+
+namespace My3D
+{
+    class TaskGraph;
+    class WorkQueue;
+    struct Task;
+    struct WorkItem;
+
+    /// Task function. Called with the task and thread index (0 = main thread) as parameters.
+    using TaskFunction = std::function<void(Task*, unsigned)>;
+
+    /// Task of a task graph. Runs when all its predecessors have finished, and finishes when its function has returned and
+    /// all the children it spawned have finished.
+    struct MY3D_API Task
+    {
+        friend class TaskGraph;
+
+    public:
+        /// Return the graph.
+        TaskGraph* GetGraph() const { return graph_; }
+        /// Return the task that spawned this one, or the parent of the task whose continuation this is. Null if none.
+        Task* GetParent() const { return parent_; }
+        /// Return the continuation, or null if none.
+        Task* GetContinuation() const { return continuation_; }
+        /// Return whether has finished. Successors may still be waiting for the continuation.
+        bool IsFinished() const { return finished_.load(std::memory_order_acquire); }
+
+        /// User data pointer.
+        void* data_{};
+
+    private:
+        /// Task function.
+        TaskFunction function_;
+        /// Graph.
+        TaskGraph* graph_{};
+        /// Parent task.
+        Task* parent_{};
+        /// Continuation, which has taken over the successors.
+        Task* continuation_{};
+        /// Tasks that wait for this one.
+        PODVector<Task*> successors_;
+        /// Mutex for the successors and the finished flag.
+        Mutex mutex_;
+        /// Number of unfinished predecessors, plus one until the task is submitted.
+        std::atomic<int> numPredecessors_{};
+        /// Number of unfinished children, plus one until the function has returned.
+        std::atomic<int> numPending_{};
+        /// Finished flag.
+        std::atomic<bool> finished_{};
+    };
+
+    /// Graph of tasks with dependencies, run on the work queue threads and the main thread. Tasks are added and linked before
+    /// Run(), and a running task can spawn children and add continuations. Tasks start as soon as their predecessors have
+    /// finished, so there is no barrier between stages of work; Run() only returns when the whole graph has finished.
+    class MY3D_API TaskGraph : public RefCounted
+    {
+    public:
+        /// Construct. Without a work queue or worker threads the tasks run in the main thread.
+        explicit TaskGraph(WorkQueue* queue);
+        /// Destruct.
+        ~TaskGraph() override;
+
+        /// Prevent copy construction.
+        TaskGraph(const TaskGraph& rhs) = delete;
+        /// Prevent assignment.
+        TaskGraph& operator =(const TaskGraph& rhs) = delete;
+
+        /// Add a task. Can not be called while running.
+        Task* AddTask(const TaskFunction& function, void* data = nullptr);
+        /// Make a task wait for a predecessor to finish. Can not be called while running.
+        void AddDependency(Task* task, Task* predecessor);
+        /// Spawn a child task from a running task. The parent does not finish before the child, so successors of the parent
+        /// wait for it too. Can be called from any thread.
+        Task* Spawn(Task* parent, const TaskFunction& function, void* data = nullptr);
+        /// Add a continuation that runs after the task and its children have finished. Tasks that wait for the task, and the
+        /// task's parent, wait for the continuation too. Several continuations of a task run in the order they were added.
+        /// Can be called before running or from the running task.
+        Task* AddContinuation(Task* task, const TaskFunction& function, void* data = nullptr);
+        /// Run all tasks and wait for them to finish. The main thread also executes tasks. Must be called from the main thread.
+        /// A graph runs once; Clear() it before adding the tasks of the next run. Tasks may wait for work groups, eg. through
+        /// WorkQueue::ParallelFor, but not complete work queue priorities, as the runners of the worker threads stay unfinished
+        /// until the graph is done.
+        void Run();
+        /// Remove all tasks. The task objects are kept for reuse. Can not be called while running.
+        void Clear();
+
+        /// Return number of tasks, including spawned ones.
+        unsigned GetNumTasks() const { return numTasks_; }
+        /// Return whether is running.
+        bool IsRunning() const { return running_; }
+
+    private:
+        /// Allocate a task. It is held from running until released.
+        Task* CreateTask(const TaskFunction& function, void* data, Task* parent);
+        /// Make a task wait for a predecessor, or for its last continuation if it has any, unless it has already finished.
+        /// Return true if linked.
+        bool Link(Task* task, Task* predecessor);
+        /// Remove one predecessor or the submission hold from a task. If it becomes ready, return it through next if that is
+        /// given and still empty, otherwise queue it.
+        void ReleasePredecessor(Task* task, Task** next = nullptr);
+        /// Remove one pending count from a task. Finish it and release its successors and parent if it drops to zero. The
+        /// first successor that becomes ready is returned through next, so that the thread runs it without queuing.
+        void ReleasePending(Task* task, Task** next);
+        /// Execute ready tasks until the graph has finished, or without waiting only until no tasks are ready.
+        void ProcessTasks(unsigned threadIndex, bool wait);
+        /// Work function of the worker thread runners.
+        static void ProcessTasksWork(const WorkItem* item, unsigned threadIndex);
+
+        /// Work queue.
+        WeakPtr<WorkQueue> queue_;
+        /// Tasks of the current run.
+        PODVector<Task*> tasks_;
+        /// Task objects for reuse.
+        PODVector<Task*> freeTasks_;
+        /// Mutex for allocating tasks.
+        Mutex tasksMutex_;
+        /// Ready tasks.
+        PODVector<Task*> ready_;
+        /// Mutex for the ready tasks and the done flag.
+        Mutex readyMutex_;
+        /// Condition for waiting for ready tasks.
+        ConditionVariable readyCondition_;
+        /// Number of threads waiting for ready tasks.
+        unsigned numWaiting_{};
+        /// Number of tasks.
+        std::atomic<unsigned> numTasks_{};
+        /// Number of finished tasks.
+        std::atomic<unsigned> numFinished_{};
+        /// All tasks finished flag.
+        bool done_{};
+        /// Running flag.
+        bool running_{};
+    };
+}
@@ -9,15 +9,100 @@
 #else
 #include <pthread.h>
 #endif
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cctype>
 
 
 namespace My3D
 {
 
+/// Thread object running the executing thread, if any.
+static thread_local const Thread* currentThread = nullptr;
+
+#if !defined(PLATFORM_MSVC) && !defined(__APPLE__)
+/// Maximum length of a thread name given to the operating system, without the terminator.
+static const unsigned MAX_SYSTEM_THREAD_NAME = 15;
+
+/// Return the thread name shortened for the operating system. A trailing number is kept, so that eg. numbered worker threads
+/// can still be told apart.
+static String GetSystemThreadName(const String& name)
+{
+	if (name.Length() <= MAX_SYSTEM_THREAD_NAME)
+		return name;
+
+	unsigned numberStart = name.Length();
+	while (numberStart > 0 && isdigit((unsigned char)name[numberStart - 1]))
+		--numberStart;
+	String number = name.Substring(numberStart);
+	if (number.Length() >= MAX_SYSTEM_THREAD_NAME)
+		return name.Substring(0, MAX_SYSTEM_THREAD_NAME);
+	return name.Substring(0, MAX_SYSTEM_THREAD_NAME - number.Length()) + number;
+}
+#endif
+
+/// Apply the name, priority and affinity of a thread object to the executing thread.
+static void ApplyThreadSettings(const Thread* thread)
+{
+#ifdef PLATFORM_MSVC
+	// SetThreadDescription is only available from Windows 10 1607, so look it up at runtime
+	using SetThreadDescriptionFunction = HRESULT (WINAPI*)(HANDLE, PCWSTR);
+	static const auto setThreadDescription = (SetThreadDescriptionFunction)GetProcAddress(GetModuleHandleW(L"kernel32.dll"),
+		"SetThreadDescription");
+	if (setThreadDescription && !thread->GetName().Empty())
+		setThreadDescription(GetCurrentThread(), WString(thread->GetName()).CString());
+
+	static const int priorities[] = { THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_ABOVE_NORMAL };
+	if (thread->GetPriority() != PRIORITY_NORMAL)
+		SetThreadPriority(GetCurrentThread(), priorities[thread->GetPriority()]);
+
+	DWORD_PTR mask = 0;
+	for (unsigned cpu : thread->GetAffinity())
+	{
+		if (cpu < sizeof(DWORD_PTR) * 8)
+			mask |= (DWORD_PTR)1 << cpu;
+	}
+	if (mask)
+		SetThreadAffinityMask(GetCurrentThread(), mask);
+#elif defined(__APPLE__)
+	if (!thread->GetName().Empty())
+		pthread_setname_np(thread->GetName().CString());
+#else
+	if (!thread->GetName().Empty())
+		pthread_setname_np(pthread_self(), GetSystemThreadName(thread->GetName()).CString());
+
+#ifdef __linux__
+	// Linux threads have their own nice value, which applies to the normal time-sharing scheduler
+	static const int niceValues[] = { 5, 0, -5 };
+	if (thread->GetPriority() != PRIORITY_NORMAL)
+		setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), niceValues[thread->GetPriority()]);
+
+	if (!thread->GetAffinity().Empty())
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (unsigned cpu : thread->GetAffinity())
+		{
+			if (cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &set);
+		}
+		pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+	}
+#endif
+#endif
+}
+
 #ifdef PLATFORM_MSVC
 static DWORD WINAPI ThreadFunctionStatic(void* data)
 {
 	Thread* thread = static_cast<Thread*>(data);
+	currentThread = thread;
+	ApplyThreadSettings(thread);
 	thread->ThreadFunction();
 	return 0;
 }
@@ -26,6 +111,8 @@ static DWORD WINAPI ThreadFunctionStatic(void* data)
 static void* ThreadFunctionStatic(void* data)
 {
 	auto* thread = static_cast<Thread*>(data);
+	currentThread = thread;
+	ApplyThreadSettings(thread);
 	thread->ThreadFunction();
 	pthread_exit((void*)nullptr);
 	return nullptr;
@@ -37,6 +124,7 @@ ThreadID Thread::mainThreadID;
 Thread::Thread()
 : handle_(nullptr)
 , shouldRun_(false)
+, priority_(PRIORITY_NORMAL)
 {
 }
 
@@ -80,18 +168,6 @@ void Thread::Stop()
 	handle_ = nullptr;
 }
 
-void Thread::SetPriority(int priority)
-{
-#ifdef PLATFORM_MSVC
-	if (handle_)
-		SetThreadPriority((HANDLE)handle_, priority);
-#else
-	auto* thread = (pthread_t*)handle_;
-	if (thread)
-		pthread_setschedprio(*thread, priority);
-#endif
-}
-
 void Thread::SetMainThread()
 {
 	mainThreadID = GetCurrentThreadID();
@@ -111,4 +187,14 @@ bool Thread::IsMainThread()
 	return GetCurrentThreadID() == mainThreadID;
 }
 
+String Thread::GetCurrentThreadName()
+{
+	if (IsMainThread())
+		return "Main thread";
+	else if (currentThread && !currentThread->name_.Empty())
+		return currentThread->name_;
+	else
+		return "Thread";
+}
+
 }
\ No newline at end of file
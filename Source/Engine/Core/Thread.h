@@ -5,6 +5,8 @@
 #pragma once
 
 #include "My3D.h"
+#include "Container/String.h"
+#include "Container/Vector.h"
 
 
 #ifdef PLATFORM_MSVC
@@ -17,6 +19,14 @@ using ThreadID = pthread_t;
 
 namespace My3D
 {
+
+/// Scheduling priority of a thread, relative to normal threads of the process.
+enum ThreadPriority
+{
+    PRIORITY_LOW = 0,
+    PRIORITY_NORMAL,
+    PRIORITY_HIGH
+};
     
 /// Operating system thead
 class MY3D_API Thread
@@ -34,20 +44,42 @@ public:
     bool Run();
     // Set the running flag to false and wait for the thread to finish.
     void Stop();
-    // Set thread priority
-    void SetPriority(int priority);
+    // Set the scheduling priority. Must be set before running. Raising the priority may need privileges on Linux and is
+    // ignored without them.
+    void SetPriority(ThreadPriority priority) { priority_ = priority; }
+    // Set the logical CPUs the thread may run on, or empty to allow all. Must be set before running. Not supported on Apple
+    // platforms, and only the first 64 CPUs can be used on Windows.
+    void SetAffinity(const PODVector<unsigned>& cpus) { affinity_ = cpus; }
     // Return whether thread exists
     bool IsStarted() const { return handle_ != nullptr; }
+    // Set the name reported for the thread by profiling and to the operating system, eg. for perf and top. Must be set
+    // before running. The operating system name may be shortened, eg. to 15 characters on Linux.
+    void SetName(const String& name) { name_ = name; }
+    // Return the name.
+    const String& GetName() const { return name_; }
+    // Return the scheduling priority.
+    ThreadPriority GetPriority() const { return priority_; }
+    // Return the logical CPUs the thread may run on. Empty if all.
+    const PODVector<unsigned>& GetAffinity() const { return affinity_; }
     // Return the current thread's ID
     static ThreadID GetCurrentThreadID();
     // Return whether is executing int main thread
     static bool IsMainThread();
+    // Return name of the executing thread: "Main thread" for the main thread, the name of a Thread object running it if set,
+    // otherwise "Thread".
+    static String GetCurrentThreadName();
 
 protected:
     // Thread handle
     void* handle_;
     // Running flag
     volatile bool shouldRun_;
+    // Name for profiling
+    String name_;
+    // Scheduling priority
+    ThreadPriority priority_;
+    // Logical CPUs the thread may run on
+    PODVector<unsigned> affinity_;
     // Main thread's thread ID
     static ThreadID mainThreadID;
 };
@@ -3,7 +3,11 @@
 //
 
 #include "Timer.h"
+#include "Container/Sort.h"
+#include "Core/Context.h"
 #include "Core/CoreEvents.h"
+#include "Core/Profiler.h"
+#include "Math/MathDefs.h"
 
 #ifdef PLATFORM_MSVC
 #include <windows.h>
@@ -12,7 +16,10 @@
 #include <sys/time.h>
 #include <unistd.h>
 #endif
+#include <cerrno>
+#include <cmath>
 #include <ctime>
+#include <thread>
 
 namespace My3D
 {
@@ -43,9 +50,28 @@ static long long HiresTick()
     else
         return timeGetTime();
 #else
-    struct timeval time{};
-    gettimeofday(&time, nullptr);
-    return time.tv_sec * 1000000LL + time.tv_usec;
+    // Monotonic so that the clock neither jumps with wall clock adjustments nor differs from the clock sleeps use
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000LL + time.tv_nsec / 1000;
+#endif
+}
+
+/// Sleep for the given microseconds with the highest resolution the operating system offers.
+static void HiresSleep(long long uSec)
+{
+#ifdef PLATFORM_MSVC
+    ::Sleep((DWORD)(uSec / 1000));
+#else
+    // Sleep to an absolute deadline so that an interrupted sleep resumes without drifting
+    timespec deadline{};
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    long long nSec = deadline.tv_nsec + uSec * 1000LL;
+    deadline.tv_sec += (time_t)(nSec / 1000000000LL);
+    deadline.tv_nsec = (long)(nSec % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+    {
+    }
 #endif
 }
 
@@ -72,6 +98,13 @@ Time::Time(Context *context)
     , frameNumber_(0)
     , timeStep_(0.0f)
     , timerPeriod_(0)
+    , frameSamples_(new FrameTimeSlot[FRAME_SAMPLES])
+    , numFrameSamples_(0)
+    , currentSample_{}
+    , frameStartTick_(0)
+    , phaseMarkTick_(0)
+    , hitchThreshold_(50000)
+    , frameStatsInterval_(300)
 {
 #ifdef PLATFORM_MSVC
     LARGE_INTEGER frequency;
@@ -125,6 +158,21 @@ void Time::BeginFrame(float timeStep)
 
     timeStep_ = timeStep;
 
+    currentSample_ = FrameTimeSample{};
+    currentSample_.frameNumber_ = frameNumber_;
+    frameStartTick_ = phaseMarkTick_ = HiresTick();
+
+#ifdef MY3D_PROFILING
+    auto* profiler = GetSubsystem<Profiler>();
+    if (profiler)
+        profiler->BeginFrame();
+    auto* traceRecorder = GetSubsystem<TraceRecorder>();
+    if (traceRecorder)
+        traceRecorder->BeginFrame();
+#endif
+
+    MY3D_PROFILE("BeginFrame");
+
     // Frame begin event
     using namespace BeginFrame;
     VariantMap& eventData = GetEventDataMap();
@@ -136,7 +184,153 @@ void Time::BeginFrame(float timeStep)
 
 void Time::EndFrame()
 {
-    SendEvent(E_ENDFRAME);
+    {
+        MY3D_PROFILE("EndFrame");
+        SendEvent(E_ENDFRAME);
+    }
+
+#ifdef MY3D_PROFILING
+    auto* traceRecorder = GetSubsystem<TraceRecorder>();
+    if (traceRecorder)
+        traceRecorder->EndFrame();
+    auto* profiler = GetSubsystem<Profiler>();
+    if (profiler)
+        profiler->EndFrame();
+#endif
+
+    StoreFrameTimeSample();
+}
+
+void Time::MarkFramePhase(FramePhase phase)
+{
+    long long tick = HiresTick();
+    currentSample_.phaseTimes_[phase] += (unsigned)((tick - phaseMarkTick_) * 1000000LL / HiresTimer::frequency);
+    phaseMarkTick_ = tick;
+}
+
+void Time::StoreFrameTimeSample()
+{
+    // A frame that was not begun has no start time
+    if (!frameStartTick_)
+        return;
+
+    currentSample_.frameTime_ = (unsigned)((HiresTick() - frameStartTick_) * 1000000LL / HiresTimer::frequency);
+    frameStartTick_ = 0;
+
+    // Write the slot between odd and even sequence values. Only the main thread writes, so the count can be read relaxed
+    unsigned index = numFrameSamples_.load(std::memory_order_relaxed);
+    FrameTimeSlot& slot = frameSamples_[index & (FRAME_SAMPLES - 1)];
+    unsigned sequence = slot.sequence_.load(std::memory_order_relaxed);
+    slot.sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sample_ = currentSample_;
+    slot.sequence_.store(sequence + 2, std::memory_order_release);
+    numFrameSamples_.store(index + 1, std::memory_order_release);
+
+    // Compute the summary only when it is due and somebody listens
+    if (!frameStatsInterval_ || (index + 1) % frameStatsInterval_ || (!context_->GetEventReceivers(E_FRAMESTATS) &&
+        !context_->GetEventReceivers(this, E_FRAMESTATS)))
+        return;
+
+    FrameTimeStats stats = GetFrameTimeStats(frameStatsInterval_);
+
+    using namespace FrameStats;
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_NUMFRAMES] = stats.numFrames_;
+    eventData[P_MEAN] = stats.mean_ / 1000.0f;
+    eventData[P_P50] = stats.p50_ / 1000.0f;
+    eventData[P_P95] = stats.p95_ / 1000.0f;
+    eventData[P_P99] = stats.p99_ / 1000.0f;
+    eventData[P_MAX] = stats.max_ / 1000.0f;
+    eventData[P_HITCHES] = stats.numHitches_;
+    eventData[P_UPDATE] = stats.phaseMeans_[FRAME_PHASE_UPDATE] / 1000.0f;
+    eventData[P_RENDER] = stats.phaseMeans_[FRAME_PHASE_RENDER] / 1000.0f;
+    eventData[P_PRESENT] = stats.phaseMeans_[FRAME_PHASE_PRESENT] / 1000.0f;
+    eventData[P_SLEEP] = stats.phaseMeans_[FRAME_PHASE_SLEEP] / 1000.0f;
+    SendEvent(E_FRAMESTATS, eventData);
+}
+
+void Time::GetFrameTimeSamples(PODVector<FrameTimeSample>& dest, unsigned numFrames) const
+{
+    dest.Clear();
+    unsigned total = numFrameSamples_.load(std::memory_order_acquire);
+    unsigned count = Min(total, FRAME_SAMPLES);
+    if (numFrames)
+        count = Min(count, numFrames);
+    dest.Reserve(count);
+
+    for (unsigned index = total - count; index != total; ++index)
+    {
+        // Leave out a sample that the main thread is writing or has overwritten with a newer frame's during the copy
+        const FrameTimeSlot& slot = frameSamples_[index & (FRAME_SAMPLES - 1)];
+        unsigned sequence = slot.sequence_.load(std::memory_order_acquire);
+        if (sequence & 1u)
+            continue;
+        FrameTimeSample sample = slot.sample_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence_.load(std::memory_order_relaxed) != sequence)
+            continue;
+        // A slot can also have been refilled completely before the sequence was first read
+        if (sequence != ((index / FRAME_SAMPLES) + 1) * 2)
+            continue;
+        dest.Push(sample);
+    }
+}
+
+/// Return a percentile of sorted frame times with the nearest-rank method.
+static unsigned GetPercentile(const PODVector<unsigned>& sortedTimes, float percentile)
+{
+    if (sortedTimes.Empty())
+        return 0;
+
+    auto rank = (unsigned)ceilf(Clamp(percentile, 0.0f, 100.0f) * 0.01f * sortedTimes.Size());
+    return sortedTimes[rank ? rank - 1 : 0];
+}
+
+FrameTimeStats Time::GetFrameTimeStats(unsigned numFrames) const
+{
+    FrameTimeStats stats;
+    PODVector<FrameTimeSample> samples;
+    GetFrameTimeSamples(samples, numFrames);
+    if (samples.Empty())
+        return stats;
+
+    PODVector<unsigned> times(samples.Size());
+    unsigned long long totalTime = 0;
+    unsigned long long phaseTotals[MAX_FRAME_PHASES] = {};
+    for (unsigned i = 0; i < samples.Size(); ++i)
+    {
+        const FrameTimeSample& sample = samples[i];
+        times[i] = sample.frameTime_;
+        totalTime += sample.frameTime_;
+        for (unsigned j = 0; j < MAX_FRAME_PHASES; ++j)
+            phaseTotals[j] += sample.phaseTimes_[j];
+        if (sample.frameTime_ > hitchThreshold_)
+            ++stats.numHitches_;
+    }
+    Sort(times.Begin(), times.End());
+
+    stats.numFrames_ = samples.Size();
+    stats.mean_ = (unsigned)(totalTime / samples.Size());
+    stats.p50_ = GetPercentile(times, 50.0f);
+    stats.p95_ = GetPercentile(times, 95.0f);
+    stats.p99_ = GetPercentile(times, 99.0f);
+    stats.max_ = times.Back();
+    for (unsigned j = 0; j < MAX_FRAME_PHASES; ++j)
+        stats.phaseMeans_[j] = (unsigned)(phaseTotals[j] / samples.Size());
+    return stats;
+}
+
+unsigned Time::GetFrameTimePercentile(float percentile, unsigned numFrames) const
+{
+    PODVector<FrameTimeSample> samples;
+    GetFrameTimeSamples(samples, numFrames);
+
+    PODVector<unsigned> times(samples.Size());
+    for (unsigned i = 0; i < samples.Size(); ++i)
+        times[i] = samples[i].frameTime_;
+    Sort(times.Begin(), times.End());
+    return GetPercentile(times, percentile);
 }
 
 void Time::SetTimerPeriod(unsigned int mSec)
@@ -186,4 +380,105 @@ void HiresTimer::Reset()
     startTime_ = HiresTick();
 }
 
+/// Shortest time in microseconds that is worth sleeping instead of spinning.
+static const long long MIN_SLEEP_USEC = 100;
+/// Time in microseconds to spin on top of the expected sleep overshoot.
+static const long long SPIN_SLACK_USEC = 50;
+
+FramePacer::FramePacer()
+    : overshootMean_(100.0f)
+    , overshootDeviation_(50.0f)
+    , maxSpin_(2000)
+{
+    ResetStats();
+}
+
+long long FramePacer::Wait(HiresTimer& timer, long long targetUSec)
+{
+    long long elapsed = timer.GetUSec(false);
+    if (elapsed >= targetUSec)
+    {
+        ++numOverruns_;
+        return elapsed;
+    }
+
+    // Wake up early by the expected overshoot plus a few deviations, but never so early that the spin gets longer
+    // than allowed
+    auto margin = Clamp((long long)(overshootMean_ + 2.0f * overshootDeviation_) + SPIN_SLACK_USEC, 0LL, maxSpin_);
+    for (;;)
+    {
+        long long remaining = targetUSec - elapsed;
+        if (remaining <= margin || remaining - margin < MIN_SLEEP_USEC)
+            break;
+
+        long long request = remaining - margin;
+        HiresSleep(request);
+        long long slept = timer.GetUSec(false) - elapsed;
+        AddOvershoot(slept - request);
+        sleepTotal_ += slept;
+        elapsed += slept;
+    }
+
+    long long spinStart = elapsed;
+    while (elapsed < targetUSec)
+    {
+        std::this_thread::yield();
+        elapsed = timer.GetUSec(false);
+    }
+    spinTotal_ += elapsed - spinStart;
+
+    RecordFrame(elapsed, targetUSec);
+    return elapsed;
+}
+
+void FramePacer::RecordFrame(long long elapsedUSec, long long targetUSec)
+{
+    long long error = Abs(elapsedUSec - targetUSec);
+    ++numFrames_;
+    errorSum_ += (double)error;
+    maxError_ = Max(maxError_, error);
+    frameTimeSum_ += (double)elapsedUSec;
+    frameTimeSquareSum_ += (double)elapsedUSec * (double)elapsedUSec;
+}
+
+void FramePacer::ResetStats()
+{
+    numFrames_ = 0;
+    numOverruns_ = 0;
+    errorSum_ = 0.0;
+    maxError_ = 0;
+    frameTimeSum_ = 0.0;
+    frameTimeSquareSum_ = 0.0;
+    sleepTotal_ = 0;
+    spinTotal_ = 0;
+}
+
+FramePacingStats FramePacer::GetStats() const
+{
+    FramePacingStats stats;
+    stats.numFrames_ = numFrames_;
+    stats.numOverruns_ = numOverruns_;
+    stats.sleepOvershoot_ = overshootMean_;
+    if (!numFrames_)
+        return stats;
+
+    double mean = frameTimeSum_ / numFrames_;
+    stats.meanError_ = (float)(errorSum_ / numFrames_);
+    stats.maxError_ = (float)maxError_;
+    stats.jitter_ = (float)sqrt(Max(frameTimeSquareSum_ / numFrames_ - mean * mean, 0.0));
+    stats.meanSleep_ = (float)sleepTotal_ / numFrames_;
+    stats.meanSpin_ = (float)spinTotal_ / numFrames_;
+    return stats;
+}
+
+void FramePacer::AddOvershoot(long long uSec)
+{
+    // Smooth like a round-trip time estimate: the mean reacts faster than the deviation. An overshoot longer than the
+    // spin limit could not be compensated anyway, so a preempted sleep does not inflate the estimate beyond it
+    auto sample = (float)Clamp(uSec, -maxSpin_, maxSpin_);
+    float difference = sample - overshootMean_;
+    overshootMean_ += difference * 0.125f;
+    overshootDeviation_ += (Abs(difference) - overshootDeviation_) * 0.25f;
+}
+
 }
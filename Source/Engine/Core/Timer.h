@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include "Container/ArrayPtr.h"
 #include "Core/Object.h"
 
+#include <atomic>
+
 
 namespace My3D
 {
@@ -52,6 +55,121 @@ private:
     static long long frequency;
 };
 
+/// Frame pacing statistics. Times are in microseconds.
+struct FramePacingStats
+{
+    /// Number of frames that waited for the frame limit.
+    unsigned numFrames_{};
+    /// Number of frames that were already over the target time and did not wait.
+    unsigned numOverruns_{};
+    /// Mean absolute difference between the frame time and the target of the frames that waited.
+    float meanError_{};
+    /// Largest difference between the frame time and the target of the frames that waited.
+    float maxError_{};
+    /// Standard deviation of the frame time of the frames that waited.
+    float jitter_{};
+    /// Mean time slept per frame.
+    float meanSleep_{};
+    /// Mean time spun per frame.
+    float meanSpin_{};
+    /// Current estimate of how much longer than requested the operating system sleeps.
+    float sleepOvershoot_{};
+};
+
+/// Frame limiter that learns the operating system sleep overshoot, sleeps with a high-resolution timer until shortly
+/// before the target and spins for the rest.
+class MY3D_API FramePacer
+{
+public:
+    /// Construct.
+    FramePacer();
+    /// Wait until the timer reaches the target time in microseconds and return the elapsed time. The timer is not reset.
+    long long Wait(HiresTimer& timer, long long targetUSec);
+    /// Record a frame limited by other means, with the frame time and target in microseconds.
+    void RecordFrame(long long elapsedUSec, long long targetUSec);
+    /// Set the longest time in microseconds to spin after sleeping. Default 2000.
+    void SetMaxSpin(long long uSec) { maxSpin_ = Max(uSec, 0LL); }
+    /// Reset the statistics. The learned sleep overshoot is kept.
+    void ResetStats();
+    /// Return the longest time to spin after sleeping.
+    long long GetMaxSpin() const { return maxSpin_; }
+    /// Return statistics since the last reset.
+    FramePacingStats GetStats() const;
+
+private:
+    /// Update the sleep overshoot estimate with a new observation.
+    void AddOvershoot(long long uSec);
+
+    /// Smoothed sleep overshoot in microseconds.
+    float overshootMean_;
+    /// Smoothed deviation of the sleep overshoot in microseconds.
+    float overshootDeviation_;
+    /// Longest time to spin after sleeping.
+    long long maxSpin_;
+    /// Frames that waited.
+    unsigned numFrames_;
+    /// Frames that were over the target.
+    unsigned numOverruns_;
+    /// Sum of absolute pacing errors.
+    double errorSum_;
+    /// Largest pacing error.
+    long long maxError_;
+    /// Sum of frame times.
+    double frameTimeSum_;
+    /// Sum of squared frame times.
+    double frameTimeSquareSum_;
+    /// Total time slept.
+    long long sleepTotal_;
+    /// Total time spun.
+    long long spinTotal_;
+};
+
+/// Phase of a frame for the frame time breakdown.
+enum FramePhase
+{
+    /// Logic and scene update.
+    FRAME_PHASE_UPDATE = 0,
+    /// Rendering.
+    FRAME_PHASE_RENDER,
+    /// Presenting the rendered frame.
+    FRAME_PHASE_PRESENT,
+    /// Frame limiter sleep.
+    FRAME_PHASE_SLEEP,
+    MAX_FRAME_PHASES
+};
+
+/// Timing sample of one frame. Times are in microseconds.
+struct FrameTimeSample
+{
+    /// Frame number.
+    unsigned frameNumber_;
+    /// Time from the beginning to the end of the frame.
+    unsigned frameTime_;
+    /// Time spent in each phase.
+    unsigned phaseTimes_[MAX_FRAME_PHASES];
+};
+
+/// Frame time statistics over a window of recent frames. Times are in microseconds.
+struct FrameTimeStats
+{
+    /// Number of frames in the window.
+    unsigned numFrames_{};
+    /// Mean frame time.
+    unsigned mean_{};
+    /// Median frame time.
+    unsigned p50_{};
+    /// 95th percentile frame time.
+    unsigned p95_{};
+    /// 99th percentile frame time.
+    unsigned p99_{};
+    /// Maximum frame time.
+    unsigned max_{};
+    /// Mean time spent in each phase.
+    unsigned phaseMeans_[MAX_FRAME_PHASES]{};
+    /// Number of frames longer than the hitch threshold.
+    unsigned numHitches_{};
+};
+
 /// Time and frame counter subsystem
 class MY3D_API Time : public Object
 {
@@ -67,6 +185,13 @@ public:
     void EndFrame();
     /// Set the low-resolution timer period in milliseconds. 0 resets to the default period
     void SetTimerPeriod(unsigned mSec);
+    /// Attribute the time since the previous mark, or the beginning of the frame, to a frame phase.
+    void MarkFramePhase(FramePhase phase);
+    /// Set the frame time in microseconds above which a frame counts as a hitch.
+    void SetHitchThreshold(unsigned uSec) { hitchThreshold_ = uSec; }
+    /// Set the number of frames between frame statistics summary events. 0 disables. The summary is only computed if the
+    /// event has receivers.
+    void SetFrameStatsInterval(unsigned frames) { frameStatsInterval_ = frames; }
     /// Return current frame timestep as seconds
     float GetTimeStep() const { return timeStep_; }
     /// Return frame number
@@ -77,6 +202,18 @@ public:
     float GetElapsedTime();
     /// Return current frames per second
     float GetFramesPerSecond() const;
+    /// Return the frame time in microseconds above which a frame counts as a hitch.
+    unsigned GetHitchThreshold() const { return hitchThreshold_; }
+    /// Return the number of frames between frame statistics summary events.
+    unsigned GetFrameStatsInterval() const { return frameStatsInterval_; }
+    /// Return the timing samples of the most recent frames, oldest first. The number is limited to the ring capacity, and
+    /// 0 returns all available. Can be called from any thread; a sample overwritten during the copy is left out.
+    void GetFrameTimeSamples(PODVector<FrameTimeSample>& dest, unsigned numFrames = 0) const;
+    /// Return frame time statistics over the most recent frames, or all available if 0. Can be called from any thread.
+    FrameTimeStats GetFrameTimeStats(unsigned numFrames = 0) const;
+    /// Return a frame time percentile in microseconds over the most recent frames, or all available if 0. Can be called
+    /// from any thread.
+    unsigned GetFrameTimePercentile(float percentile, unsigned numFrames = 0) const;
     /// Get system time as milliseconds
     static unsigned GetSystemTime();
     /// Get system time as seconds since 1970.1.1
@@ -86,7 +223,23 @@ public:
     /// Sleep for a number of milliseconds
     static void Sleep(unsigned mSec);
 
+    /// Number of frame time samples kept in the ring.
+    static constexpr unsigned FRAME_SAMPLES = 1024;
+
 private:
+    /// Slot of the frame time ring. The sequence is odd while the main thread writes the sample, so that readers in other
+    /// threads can detect a torn copy without locking.
+    struct FrameTimeSlot
+    {
+        /// Write sequence.
+        std::atomic<unsigned> sequence_{};
+        /// Sample.
+        FrameTimeSample sample_{};
+    };
+
+    /// Store the sample of the ending frame and send the summary event if due.
+    void StoreFrameTimeSample();
+
     /// Elapsed time since program start
     Timer elapsedTime_;
     /// Frame number
@@ -95,6 +248,20 @@ private:
     float timeStep_;
     /// Low-resolution timer period
     unsigned timerPeriod_;
+    /// Frame time sample ring.
+    SharedArrayPtr<FrameTimeSlot> frameSamples_;
+    /// Number of samples stored in total.
+    std::atomic<unsigned> numFrameSamples_;
+    /// Sample of the current frame.
+    FrameTimeSample currentSample_;
+    /// High-resolution tick at the beginning of the current frame.
+    long long frameStartTick_;
+    /// High-resolution tick at the last frame phase mark.
+    long long phaseMarkTick_;
+    /// Frame time in microseconds above which a frame counts as a hitch.
+    unsigned hitchThreshold_;
+    /// Number of frames between frame statistics summary events.
+    unsigned frameStatsInterval_;
 };
 
 }
@@ -0,0 +1,245 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "Core/TraceRecorder.h"
+#include "Core/StringHash.h"
+#include "Core/Thread.h"
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/Log.h"
+
+#include <cstdio>
+
+
+namespace My3D
+{
+    /// Calling thread's buffer and the identifier of the recorder it belongs to.
+    struct TraceThreadData
+    {
+        /// Recorder identifier.
+        unsigned recorderId_;
+        /// Buffer.
+        TraceThread* thread_;
+    };
+
+    static thread_local TraceThreadData currentThreadData{};
+    static std::atomic<unsigned> nextRecorderId(1);
+
+    std::atomic<TraceRecorder*> TraceRecorder::active(nullptr);
+
+    /// Append a string as a quoted JSON string.
+    static void AppendJSONString(String& output, const char* str)
+    {
+        output += '"';
+        for (; *str; ++str)
+        {
+            char c = *str;
+            if (c == '"' || c == '\\')
+            {
+                output += '\\';
+                output += c;
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)c);
+                output.Append(escaped);
+            }
+            else
+                output += c;
+        }
+        output += '"';
+    }
+
+    TraceRecorder::TraceRecorder(Context* context)
+        : Object(context)
+        , id_(nextRecorderId++)
+    {
+        frameStarts_.Resize(MAX_TRACE_FRAMES);
+        active.store(this, std::memory_order_release);
+    }
+
+    TraceRecorder::~TraceRecorder()
+    {
+        TraceRecorder* expected = this;
+        active.compare_exchange_strong(expected, nullptr);
+
+        for (unsigned i = 0; i < threads_.Size(); ++i)
+            delete threads_[i];
+    }
+
+    void TraceRecorder::SetBufferSize(unsigned size)
+    {
+        bufferSize_ = NextPowerOfTwo(Max(size, 2U));
+    }
+
+    void TraceRecorder::SetAutoDump(long long thresholdUSec, unsigned numFrames, const String& fileName)
+    {
+        autoDumpThreshold_ = Max(thresholdUSec, 0LL);
+        autoDumpFrames_ = Clamp(numFrames, 1U, MAX_TRACE_FRAMES);
+        autoDumpFileName_ = fileName;
+        autoDumpCooldownEnd_ = 0;
+    }
+
+    void TraceRecorder::BeginFrame()
+    {
+        frameStarts_[numFrames_ % MAX_TRACE_FRAMES] = timer_.GetUSec(false);
+        ++numFrames_;
+        Record("Frame", 0, 'B');
+    }
+
+    void TraceRecorder::EndFrame()
+    {
+        Record(nullptr, 0, 'E');
+
+        if (!autoDumpThreshold_ || !numFrames_ || numFrames_ < autoDumpCooldownEnd_)
+            return;
+
+        long long frameTime = timer_.GetUSec(false) - frameStarts_[(numFrames_ - 1) % MAX_TRACE_FRAMES];
+        if (frameTime <= autoDumpThreshold_)
+            return;
+
+        String fileName = GetPath(autoDumpFileName_) + GetFileName(autoDumpFileName_) + "_" + String(numFrames_) +
+            GetExtension(autoDumpFileName_, false);
+        if (SaveJSON(fileName, autoDumpFrames_))
+        {
+            MY3D_LOGINFOF("Frame %u took %.3f ms, saved trace of the last %u frames to %s", numFrames_, frameTime / 1000.0,
+                autoDumpFrames_, fileName.CString());
+        }
+        ++numAutoDumps_;
+        autoDumpCooldownEnd_ = numFrames_ + autoDumpFrames_;
+    }
+
+    String TraceRecorder::ToJSON(unsigned numFrames) const
+    {
+        long long startTime = 0;
+        numFrames = Min(numFrames, Min(numFrames_, MAX_TRACE_FRAMES));
+        if (numFrames)
+            startTime = frameStarts_[(numFrames_ - numFrames) % MAX_TRACE_FRAMES];
+
+        PODVector<TraceThread*> threads;
+        {
+            MutexLock lock(threadsMutex_);
+            threads = threads_;
+        }
+
+        String output;
+        output.Reserve(1024);
+        output += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        char line[128];
+        PODVector<TraceEvent> events;
+
+        for (unsigned i = 0; i < threads.Size(); ++i)
+        {
+            TraceThread* thread = threads[i];
+            auto size = (unsigned long long)thread->events_.Size();
+
+            // Copy the events, then drop the ones the owner thread may have overwritten meanwhile
+            unsigned long long end = thread->writeIndex_.load(std::memory_order_acquire);
+            unsigned long long begin = end > size ? end - size : 0;
+            events.Resize((unsigned)(end - begin));
+            for (unsigned long long j = begin; j < end; ++j)
+                events[(unsigned)(j - begin)] = thread->events_[(unsigned)j & thread->mask_];
+            unsigned long long written = thread->writeIndex_.load(std::memory_order_acquire);
+            unsigned long long validBegin = written >= size ? written - size + 1 : 0;
+            unsigned skip = validBegin > begin ? (unsigned)Min(validBegin - begin, end - begin) : 0;
+
+            snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",", thread->tid_);
+            output.Append(line);
+            AppendJSONString(output, thread->name_.CString());
+            output += "}}";
+            first = false;
+
+            // End events whose begin is not included are left out
+            unsigned depth = 0;
+            for (unsigned j = skip; j < events.Size(); ++j)
+            {
+                const TraceEvent& event = events[j];
+                if (event.time_ < startTime)
+                    continue;
+
+                if (event.phase_ == 'B')
+                {
+                    snprintf(line, sizeof(line), ",{\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"name\":", thread->tid_,
+                        event.time_);
+                    output.Append(line);
+                    AppendJSONString(output, event.name_);
+                    if (event.arg_)
+                    {
+                        StringHash hash(event.arg_);
+                        String argText = hash.Reverse();
+                        output += ",\"args\":{\"arg\":";
+                        AppendJSONString(output, argText.Empty() ? hash.ToString().CString() : argText.CString());
+                        output += '}';
+                    }
+                    output += '}';
+                    ++depth;
+                }
+                else if (depth)
+                {
+                    snprintf(line, sizeof(line), ",{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%lld}", thread->tid_, event.time_);
+                    output.Append(line);
+                    --depth;
+                }
+            }
+        }
+
+        output += "]}\n";
+        return output;
+    }
+
+    bool TraceRecorder::SaveJSON(const String& fileName, unsigned numFrames) const
+    {
+        File file(context_, fileName, FILE_WRITE);
+        if (!file.IsOpen())
+        {
+            MY3D_LOGERROR("Could not open " + fileName + " for writing the trace");
+            return false;
+        }
+
+        String json = ToJSON(numFrames);
+        return file.Write(json.CString(), json.Length()) == json.Length();
+    }
+
+    unsigned TraceRecorder::GetNumThreads() const
+    {
+        MutexLock lock(threadsMutex_);
+        return threads_.Size();
+    }
+
+    void TraceRecorder::Record(const char* name, unsigned arg, char phase)
+    {
+        if (!IsEnabled())
+            return;
+
+        TraceThread* thread = GetThreadData();
+        unsigned long long index = thread->writeIndex_.load(std::memory_order_relaxed);
+        TraceEvent& event = thread->events_[(unsigned)index & thread->mask_];
+        event.name_ = name;
+        event.time_ = timer_.GetUSec(false);
+        event.arg_ = arg;
+        event.phase_ = phase;
+        thread->writeIndex_.store(index + 1, std::memory_order_release);
+    }
+
+    TraceThread* TraceRecorder::GetThreadData()
+    {
+        TraceThreadData& data = currentThreadData;
+        if (data.recorderId_ == id_)
+            return data.thread_;
+
+        TraceThread* thread;
+        {
+            MutexLock lock(threadsMutex_);
+            thread = new TraceThread(Thread::GetCurrentThreadName(), threads_.Size() + 1, bufferSize_);
+            threads_.Push(thread);
+        }
+
+        data.recorderId_ = id_;
+        data.thread_ = thread;
+        return thread;
+    }
+}
@@ -0,0 +1,182 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#include "Container/String.h"
+#include "Core/Mutex.h"
+#include "Core/Object.h"
+#include "Core/Timer.h"
+
+#include <atomic>
+
+
+namespace My3D
+{
+    /// Default number of events kept per thread.
+    static const unsigned DEFAULT_TRACE_BUFFER_SIZE = 65536;
+    /// Number of frame start times kept for selecting the last frames.
+    static const unsigned MAX_TRACE_FRAMES = 1024;
+
+    /// Begin or end event of a trace.
+    struct TraceEvent
+    {
+        /// Name, which must stay valid as long as the recorder exists. Usually a string literal.
+        const char* name_;
+        /// Time in microseconds since the recorder was created.
+        long long time_;
+        /// Optional string hash argument, e.g. an event type. Zero if none.
+        unsigned arg_;
+        /// Phase: 'B' for begin, 'E' for end.
+        char phase_;
+    };
+
+    /// Event ring buffer of one thread. Only the owner thread writes, so recording takes no locks: the event is written first
+    /// and then published by advancing the write index. Readers copy the events and discard the ones that may have been
+    /// overwritten during the copy.
+    struct TraceThread
+    {
+        /// Construct with a name, trace thread identifier and buffer size, which must be a power of two.
+        TraceThread(const String& name, unsigned tid, unsigned bufferSize)
+            : name_(name)
+            , tid_(tid)
+            , mask_(bufferSize - 1)
+        {
+            events_.Resize(bufferSize);
+        }
+
+        /// Thread name.
+        String name_;
+        /// Thread identifier in the trace.
+        unsigned tid_;
+        /// Buffer size minus one.
+        unsigned mask_;
+        /// Events.
+        PODVector<TraceEvent> events_;
+        /// Total number of events written.
+        std::atomic<unsigned long long> writeIndex_{};
+    };
+
+    /// Timeline recorder of begin and end events of all threads, exported as Chrome Trace Event JSON, which can be opened in
+    /// chrome://tracing or Perfetto. Each thread records into its own lock-free ring buffer. The trace can be saved on demand,
+    /// or automatically for the last frames when a frame takes longer than a threshold. Does not depend on graphics, so it
+    /// works in headless runs.
+    class MY3D_API TraceRecorder : public Object
+    {
+        MY3D_OBJECT(TraceRecorder, Object)
+
+    public:
+        /// Construct.
+        explicit TraceRecorder(Context* context);
+        /// Destruct.
+        ~TraceRecorder() override;
+
+        /// Set whether events are recorded.
+        void SetEnabled(bool enable) { enabled_.store(enable, std::memory_order_relaxed); }
+        /// Set number of events kept per thread. Rounded up to a power of two. Affects threads that start recording later.
+        void SetBufferSize(unsigned size);
+        /// Save the last frames automatically when a frame takes longer than the threshold in microseconds. After a dump the
+        /// threshold is not checked again until as many frames have passed. Zero threshold disables.
+        void SetAutoDump(long long thresholdUSec, unsigned numFrames = 300, const String& fileName = "Trace.json");
+
+        /// Record a begin event in the calling thread.
+        void BeginEvent(const char* name, unsigned arg = 0) { Record(name, arg, 'B'); }
+        /// Record an end event in the calling thread.
+        void EndEvent() { Record(nullptr, 0, 'E'); }
+        /// Begin a frame. Called by the Time subsystem.
+        void BeginFrame();
+        /// End a frame and check the automatic dump threshold. Called by the Time subsystem.
+        void EndFrame();
+
+        /// Return the events of the last frames, or all recorded events if zero, as Chrome Trace Event JSON. The frame in
+        /// progress is included.
+        String ToJSON(unsigned numFrames = 0) const;
+        /// Save the events of the last frames, or all recorded events if zero, to a JSON file. Return true if successful.
+        bool SaveJSON(const String& fileName, unsigned numFrames = 0) const;
+
+        /// Return whether events are recorded.
+        bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+        /// Return number of events kept per thread.
+        unsigned GetBufferSize() const { return bufferSize_; }
+        /// Return number of threads that have recorded events.
+        unsigned GetNumThreads() const;
+        /// Return number of frames recorded.
+        unsigned GetNumFrames() const { return numFrames_; }
+        /// Return number of automatic dumps made.
+        unsigned GetNumAutoDumps() const { return numAutoDumps_; }
+
+        /// Return the active recorder, or null if none. Used by the profiling macros.
+        static TraceRecorder* GetActive() { return active.load(std::memory_order_acquire); }
+
+    private:
+        /// Record an event in the calling thread's buffer.
+        void Record(const char* name, unsigned arg, char phase);
+        /// Return the calling thread's buffer, creating it on first use.
+        TraceThread* GetThreadData();
+
+        /// Thread buffers.
+        PODVector<TraceThread*> threads_;
+        /// Mutex for the thread list.
+        mutable Mutex threadsMutex_;
+        /// Identifier of this recorder, to tell it from destroyed ones in the per-thread data.
+        unsigned id_;
+        /// Timer for the event times.
+        mutable HiresTimer timer_;
+        /// Enabled flag.
+        std::atomic<bool> enabled_{true};
+        /// Events kept per thread.
+        unsigned bufferSize_{DEFAULT_TRACE_BUFFER_SIZE};
+        /// Start times of the last frames.
+        PODVector<long long> frameStarts_;
+        /// Number of frames recorded.
+        unsigned numFrames_{};
+        /// Automatic dump threshold in microseconds.
+        long long autoDumpThreshold_{};
+        /// Frames to save in an automatic dump.
+        unsigned autoDumpFrames_{};
+        /// Automatic dump file name. The frame number is appended to the name.
+        String autoDumpFileName_;
+        /// Frame number after which the threshold is checked again.
+        unsigned autoDumpCooldownEnd_{};
+        /// Number of automatic dumps.
+        unsigned numAutoDumps_{};
+
+        /// Active recorder.
+        static std::atomic<TraceRecorder*> active;
+    };
+
+    /// Helper class for automatically recording begin and end trace events.
+    class MY3D_API AutoTraceEvent
+    {
+    public:
+        /// Construct and record a begin event in the active recorder, if any and enabled.
+        explicit AutoTraceEvent(const char* name, unsigned arg = 0)
+            : recorder_(TraceRecorder::GetActive())
+        {
+            if (recorder_ && recorder_->IsEnabled())
+                recorder_->BeginEvent(name, arg);
+            else
+                recorder_ = nullptr;
+        }
+
+        /// Destruct and record the end event.
+        ~AutoTraceEvent()
+        {
+            if (recorder_)
+                recorder_->EndEvent();
+        }
+
+    private:
+        /// Recorder.
+        TraceRecorder* recorder_;
+    };
+
+#ifdef MY3D_PROFILING
+#define MY3D_TRACE_EVENT(name, arg) My3D::AutoTraceEvent MY3D_TRACE_CONCAT(traceEvent, __LINE__)(name, arg)
+#define MY3D_TRACE_CONCAT_IMPL(a, b) a ## b
+#define MY3D_TRACE_CONCAT(a, b) MY3D_TRACE_CONCAT_IMPL(a, b)
+#else
+#define MY3D_TRACE_EVENT(name, arg)
+#endif
+}
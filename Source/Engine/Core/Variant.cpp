@@ -81,6 +81,14 @@ namespace My3D
                 value_.variantMap_ = rhs.value_.variantMap_;
                 break;
 
+            case VAR_RESOURCEREF:
+                *value_.resourceRef_ = *rhs.value_.resourceRef_;
+                break;
+
+            case VAR_RESOURCEREFLIST:
+                value_.resourceRefList_ = rhs.value_.resourceRefList_;
+                break;
+
             case VAR_PTR:
                 value_.weakPtr_ = rhs.value_.weakPtr_;
                 break;
@@ -98,13 +106,25 @@ namespace My3D
                 break;
 
             default:
-                memcpy(&value_, &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
+                memcpy(value_.storage_, rhs.value_.storage_, sizeof(VariantValue));
                 break;
         }
 
         return *this;
     }
 
+    Variant& Variant::operator =(Variant&& rhs) noexcept
+    {
+        if (&rhs == this)
+            return *this;
+
+        SetType(VAR_NONE);
+        type_ = rhs.type_;
+        memcpy(value_.storage_, rhs.value_.storage_, sizeof(VariantValue));
+        rhs.type_ = VAR_NONE;
+        return *this;
+    }
+
     Variant& Variant::operator =(const VectorBuffer& rhs)
     {
         SetType(VAR_BUFFER);
@@ -251,7 +271,7 @@ namespace My3D
                 return value_.voidPtr_ == nullptr;
 
             case VAR_RESOURCEREF:
-                return value_.resourceRef_.name_.Empty();
+                return value_.resourceRef_->name_.Empty();
 
             case VAR_RESOURCEREFLIST:
             {
@@ -374,7 +394,7 @@ namespace My3D
                 return value_.buffer_ == rhs.value_.buffer_;
 
             case VAR_RESOURCEREF:
-                return value_.resourceRef_ == rhs.value_.resourceRef_;
+                return *value_.resourceRef_ == *rhs.value_.resourceRef_;
 
             case VAR_RESOURCEREFLIST:
                 return value_.resourceRefList_ == rhs.value_.resourceRefList_;
@@ -472,8 +492,8 @@ namespace My3D
             if (values.Size() == 2)
             {
                 SetType(VAR_RESOURCEREF);
-                value_.resourceRef_.type_ = values[0];
-                value_.resourceRef_.name_ = values[1];
+                value_.resourceRef_->type_ = values[0];
+                value_.resourceRef_->name_ = values[1];
             }
             break;
         }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "Container/FlatMap.h"
 #include "Container/HashMap.h"
 #include "Container/Ptr.h"
 #include "Core/StringHash.h"
@@ -17,6 +18,8 @@
 #include "Math/BoundingBox.h"
 #include "Math/Color.h"
 
+#include <cstring>
+
 
 namespace My3D
 {
@@ -63,8 +66,9 @@ namespace My3D
     using VariantVector = Vector<Variant>;
     /// Vector of string
     using StringVector = Vector<String>;
-    /// Map of variants
-    using VariantMap = HashMap<StringHash, Variant>;
+    /// Map of variants. Stored in one array with a small index table, as event parameters and attribute maps usually have
+    /// only a few keys.
+    using VariantMap = FlatMap<StringHash, Variant>;
 
     /// Typed resource reference
     struct MY3D_API ResourceRef
@@ -132,9 +136,10 @@ namespace My3D
         bool operator !=(const ResourceRefList& rhs) const { return type_ != rhs.type_ || names_ != rhs.names_; }
     };
 
-    /// Size of variant value. 16 bytes on 32-bit platform, 32 bytes on 64-bit platform.
-    static const unsigned VARIANT_VALUE_SIZE = sizeof(void*) * 4;
-    /// Union for the possible variant values. Objects exceeding the VARIANT_VALUE_SIZE are allocated on the heap.
+    /// Size of variant value. 16 bytes on 32-bit platform, 24 bytes on 64-bit platform, which holds a String with its inline buffer.
+    static const unsigned VARIANT_VALUE_SIZE = sizeof(void*) >= 8 ? 24 : 16;
+    /// Union for the possible variant values. Objects exceeding the VARIANT_VALUE_SIZE are allocated on the heap. None of
+    /// the stored objects point into themselves, so variants are moved by copying the bytes and emptying the source.
     union VariantValue
     {
         unsigned char storage_[VARIANT_VALUE_SIZE]{};
@@ -163,7 +168,7 @@ namespace My3D
         VariantVector variantVector_;
         VariantMap variantMap_;
         PODVector<unsigned char> buffer_;
-        ResourceRef resourceRef_;
+        ResourceRef* resourceRef_;
         ResourceRefList resourceRefList_;
 
         /// Construct uninitialized.
@@ -211,10 +216,14 @@ namespace My3D
         Variant(const Color& value) { *this = value; }
         /// Construct from a string
         Variant(const String& value) { *this = value; }
+        /// Construct by moving a string
+        Variant(String&& value) { *this = std::move(value); }
         /// Construct from a C string
         Variant(const char* value) { *this = value; }
         /// Construct from a buffer
         Variant(const PODVector<unsigned char>& value) { *this = value; }
+        /// Construct by moving a buffer
+        Variant(PODVector<unsigned char>&& value) { *this = std::move(value); }
         /// Construct from a VectorBuffer and store as a buffer.
         Variant(const VectorBuffer& value) { *this = value; }
         /// Construct from a pointer
@@ -225,10 +234,16 @@ namespace My3D
         Variant(const ResourceRefList& value) { *this = value; }
         /// Construct from a variant vector
         Variant(const VariantVector& value) { *this = value; }
+        /// Construct by moving a variant vector.
+        Variant(VariantVector&& value) { *this = std::move(value); }
         /// Construct from a variant map.
         Variant(const VariantMap& value) { *this = value; }
+        /// Construct by moving a variant map.
+        Variant(VariantMap&& value) { *this = std::move(value); }
         /// Construct from a string vector
         Variant(const StringVector& value) { *this = value; }
+        /// Construct by moving a string vector
+        Variant(StringVector&& value) { *this = std::move(value); }
         /// Construct from a rect
         Variant(const Rect& value) { *this = value; }
         /// Construct from an integer rect.
@@ -270,6 +285,13 @@ namespace My3D
         {
             *this = value;
         }
+        /// Move-construct from another variant. The other variant is left empty.
+        Variant(Variant&& value) noexcept
+            : type_(value.type_)
+        {
+            memcpy(value_.storage_, value.value_.storage_, sizeof(VariantValue));
+            value.type_ = VAR_NONE;
+        }
         /// Destruct.
         ~Variant()
         {
@@ -282,6 +304,8 @@ namespace My3D
         }
         /// Assign from another variant.
         Variant& operator =(const Variant& rhs);
+        /// Move-assign from another variant. The other variant is left empty.
+        Variant& operator =(Variant&& rhs) noexcept;
         /// Assign from an integer.
         Variant& operator =(int rhs)
         {
@@ -381,6 +405,13 @@ namespace My3D
             value_.string_ = rhs;
             return *this;
         }
+        /// Move-assign from a string.
+        Variant& operator =(String&& rhs)
+        {
+            SetType(VAR_STRING);
+            value_.string_ = std::move(rhs);
+            return *this;
+        }
         /// Assign from a C string.
         Variant& operator =(const char* rhs)
         {
@@ -395,6 +426,13 @@ namespace My3D
             value_.buffer_ = rhs;
             return *this;
         }
+        /// Move-assign from a buffer.
+        Variant& operator =(PODVector<unsigned char>&& rhs)
+        {
+            SetType(VAR_BUFFER);
+            value_.buffer_ = std::move(rhs);
+            return *this;
+        }
         /// Assign from a VectorBuffer and store as a buffer
         Variant& operator =(const VectorBuffer& rhs);
         /// Assign from a void pointer.
@@ -408,7 +446,7 @@ namespace My3D
         Variant& operator =(const ResourceRef& rhs)
         {
             SetType(VAR_RESOURCEREF);
-            value_.resourceRef_ = rhs;
+            *value_.resourceRef_ = rhs;
             return *this;
         }
         /// Assign from a resource reference list
@@ -425,6 +463,13 @@ namespace My3D
             value_.variantVector_ = rhs;
             return *this;
         }
+        /// Move-assign from a variant vector.
+        Variant& operator =(VariantVector&& rhs)
+        {
+            SetType(VAR_VARIANTVECTOR);
+            value_.variantVector_ = std::move(rhs);
+            return *this;
+        }
         /// Assign from a string vector.
         Variant& operator =(const StringVector& rhs)
         {
@@ -432,6 +477,13 @@ namespace My3D
             value_.stringVector_ = rhs;
             return *this;
         }
+        /// Move-assign from a string vector.
+        Variant& operator =(StringVector&& rhs)
+        {
+            SetType(VAR_STRINGVECTOR);
+            value_.stringVector_ = std::move(rhs);
+            return *this;
+        }
 
         /// Assign from a variant map.
         Variant& operator =(const VariantMap& rhs)
@@ -440,6 +492,13 @@ namespace My3D
             value_.variantMap_ = rhs;
             return *this;
         }
+        /// Move-assign from a variant map.
+        Variant& operator =(VariantMap&& rhs)
+        {
+            SetType(VAR_VARIANTMAP);
+            value_.variantMap_ = std::move(rhs);
+            return *this;
+        }
 
         /// Assign from a Rect.
         Variant& operator =(const Rect& rhs)
@@ -633,7 +692,7 @@ namespace My3D
         /// Test for equality with a resource reference. To return true, both the type and value must match.
         bool operator ==(const ResourceRef& rhs) const
         {
-            return type_ == VAR_RESOURCEREF && value_.resourceRef_ == rhs;
+            return type_ == VAR_RESOURCEREF && *value_.resourceRef_ == rhs;
         }
         /// Test for equality with a resource reference list. To return true, both the type and value must match.
         bool operator ==(const ResourceRefList& rhs) const
@@ -820,7 +879,7 @@ namespace My3D
         /// Return a resource reference or empty on type mismatch.
         const ResourceRef& GetResourceRef() const
         {
-            return type_ == VAR_RESOURCEREF ? value_.resourceRef_ : emptyResourceRef;
+            return type_ == VAR_RESOURCEREF ? *value_.resourceRef_ : emptyResourceRef;
         }
         /// Return a resource reference list or empty on type mismatch.
         const ResourceRefList& GetResourceRefList() const
@@ -5,13 +5,18 @@
 #include "Core/Thread.h"
 #include "Core/CoreEvents.h"
 #include "Core/ProcessUtils.h"
+#include "Core/Profiler.h"
 #include "Core/WorkQueue.h"
+#include "Container/Sort.h"
 #include "IO/Log.h"
 #include "Core/Timer.h"
 
 
 namespace My3D
 {
+    /// Index of the calling thread within its work queue. Zero for the main thread and other threads.
+    static thread_local unsigned currentThreadIndex = 0;
+
     /// Worker thread managed by the work queue.
     class WorkerThread : public Thread, public RefCounted
     {
@@ -21,11 +26,13 @@ namespace My3D
             : owner_(owner)
             , index_(index)
         {
+            SetName("Worker thread " + String(index));
         }
 
         /// Process work item until stopped
         void ThreadFunction() override
         {
+            currentThreadIndex = index_;
             owner_->ProcessItems(index_);
         }
 
@@ -36,11 +43,101 @@ namespace My3D
         unsigned index_;
     };
 
+    /// Number of unfinished work items with one priority.
+    struct WorkPriorityCounter
+    {
+        /// Priority.
+        unsigned priority_;
+        /// Number of unfinished work items.
+        std::atomic<unsigned> count_{};
+    };
+
+    /// Maximum number of items a worker thread moves from the injection queue to its own deque at once.
+    static const unsigned WORKSTEALING_MAX_BATCH = 32;
+
+    /// Work item deque of one thread for the work-stealing scheduler. The owner pushes and pops at the back, other threads steal
+    /// from the front. Access is guarded by the mutex.
+    struct WorkStealingQueue
+    {
+        /// Add an item to the back.
+        void PushBack(WorkItem* item)
+        {
+            if (size_ == items_.Size())
+                Grow();
+            items_[(head_ + size_) & (items_.Size() - 1)] = item;
+            count_.store(++size_, std::memory_order_relaxed);
+        }
+        /// Take the newest item if it has at least the specified priority.
+        WorkItem* PopBack(unsigned priority)
+        {
+            if (!size_)
+                return nullptr;
+            WorkItem* item = items_[(head_ + size_ - 1) & (items_.Size() - 1)];
+            if (item->priority_ < priority)
+                return nullptr;
+            count_.store(--size_, std::memory_order_relaxed);
+            return item;
+        }
+        /// Take the oldest item if it has at least the specified priority.
+        WorkItem* PopFront(unsigned priority)
+        {
+            if (!size_ || items_[head_]->priority_ < priority)
+                return nullptr;
+            WorkItem* item = items_[head_];
+            head_ = (head_ + 1) & (items_.Size() - 1);
+            count_.store(--size_, std::memory_order_relaxed);
+            return item;
+        }
+        /// Remove an item. Return true if was found.
+        bool Remove(WorkItem* item)
+        {
+            unsigned mask = items_.Size() - 1;
+            for (unsigned i = 0; i < size_; ++i)
+            {
+                if (items_[(head_ + i) & mask] == item)
+                {
+                    for (unsigned j = i + 1; j < size_; ++j)
+                        items_[(head_ + j - 1) & mask] = items_[(head_ + j) & mask];
+                    count_.store(--size_, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+        /// Double the capacity, keeping the items in order.
+        void Grow()
+        {
+            PODVector<WorkItem*> newItems(items_.Size() ? items_.Size() * 2 : 16);
+            for (unsigned i = 0; i < size_; ++i)
+                newItems[i] = items_[(head_ + i) & (items_.Size() - 1)];
+            items_.Swap(newItems);
+            head_ = 0;
+        }
+
+        /// Mutex guarding the deque.
+        Mutex mutex_;
+        /// Ring buffer of items. Capacity is a power of two.
+        PODVector<WorkItem*> items_;
+        /// Index of the oldest item.
+        unsigned head_{};
+        /// Number of items.
+        unsigned size_{};
+        /// Number of items, for checking the deque without the mutex.
+        std::atomic<unsigned> count_{};
+        /// Random state for choosing steal victims. Used only by the owner thread.
+        unsigned random_{};
+    };
+
     WorkQueue::WorkQueue(Context *context)
         : Object(context)
         , shutDown_(false)
-        , pausing_(false)
         , paused_(false)
+        , workStealing_(false)
+        , workerAffinity_(WORKER_AFFINITY_NONE)
+        , numQueuedItems_(0)
+        , numInjectedItems_(0)
+        , numParkedThreads_(0)
+        , numCompleteWaiters_(0)
         , completing_(false)
         , tolerance_(10)
         , lastSize_(0)
@@ -54,9 +151,20 @@ namespace My3D
         // Stop the worker threads. First make sure they are not waiting for work items
         shutDown_ = true;
         Resume();
+        WakeThreads(true);
+        if (stealingQueues_.Empty())
+        {
+            MutexLock lock(queueMutex_);
+            queueCondition_.NotifyAll();
+        }
 
         for (unsigned i = 0; i < threads_.Size(); ++i)
             threads_[i]->Stop();
+
+        for (unsigned i = 0; i < stealingQueues_.Size(); ++i)
+            delete stealingQueues_[i];
+        for (unsigned i = 0; i < priorityCounters_.Size(); ++i)
+            delete priorityCounters_[i];
     }
 
     void WorkQueue::CreateThreads(unsigned int numThreads)
@@ -64,18 +172,96 @@ namespace My3D
         if (!threads_.Empty())
             return;
 
+        // Create the deques first, as they select how the queue pauses
+        if (workStealing_ && numThreads)
+        {
+            for (unsigned i = 0; i <= numThreads; ++i)
+            {
+                auto* queue = new WorkStealingQueue();
+                queue->random_ = (i + 1) * 2654435761u;
+                stealingQueues_.Push(queue);
+            }
+        }
+
         // Start thread in paused mode
         Pause();
 
+        PODVector<unsigned> cpus;
         for (unsigned i = 0; i < numThreads; ++i)
         {
             SharedPtr<WorkerThread> thread(new WorkerThread(this, i + 1));
+            GetWorkerCPUs(i + 1, cpus);
+            thread->SetAffinity(cpus);
             thread->Run();
             threads_.Push(thread);
         }
 
     }
 
+    void WorkQueue::SetWorkStealing(bool enable)
+    {
+        if (!threads_.Empty())
+        {
+            MY3D_LOGERROR("Can not change the work queue scheduler after creating the worker threads");
+            return;
+        }
+
+        workStealing_ = enable;
+    }
+
+    void WorkQueue::SetWorkerAffinity(WorkerAffinity affinity)
+    {
+        if (!threads_.Empty())
+        {
+            MY3D_LOGERROR("Can not change the worker thread affinity after creating the worker threads");
+            return;
+        }
+
+        workerAffinity_ = affinity;
+    }
+
+    void WorkQueue::GetWorkerCPUs(unsigned threadIndex, PODVector<unsigned>& dest) const
+    {
+        dest.Clear();
+        const CPUTopology& topology = GetCPUTopology();
+        if (workerAffinity_ == WORKER_AFFINITY_NONE || topology.numCores_ < 2)
+            return;
+
+        // Order the cores by node and cache group. The main thread is counted as index 0, so it gets the first core
+        PODVector<const CPUInfo*> cores;
+        for (const CPUInfo& cpu : topology.cpus_)
+        {
+            bool found = false;
+            for (const CPUInfo* core : cores)
+            {
+                if (core->core_ == cpu.core_)
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                cores.Push(&cpu);
+        }
+        Sort(cores.Begin(), cores.End(), [](const CPUInfo* lhs, const CPUInfo* rhs)
+        {
+            if (lhs->numaNode_ != rhs->numaNode_)
+                return lhs->numaNode_ < rhs->numaNode_;
+            if (lhs->cacheGroup_ != rhs->cacheGroup_)
+                return lhs->cacheGroup_ < rhs->cacheGroup_;
+            return lhs->core_ < rhs->core_;
+        });
+
+        const CPUInfo& target = *cores[threadIndex % cores.Size()];
+        for (const CPUInfo& cpu : topology.cpus_)
+        {
+            if ((workerAffinity_ == WORKER_AFFINITY_CORE && cpu.core_ == target.core_) ||
+                (workerAffinity_ == WORKER_AFFINITY_CACHE && cpu.cacheGroup_ == target.cacheGroup_) ||
+                (workerAffinity_ == WORKER_AFFINITY_NUMA && cpu.numaNode_ == target.numaNode_))
+                dest.Push(cpu.index_);
+        }
+    }
+
     SharedPtr<WorkItem> WorkQueue::GetFreeItem()
     {
         if (poolItems_.Size() > 0)
@@ -93,7 +279,7 @@ namespace My3D
         }
     }
 
-    void WorkQueue::AddWorkItem(const SharedPtr<WorkItem> &item)
+    void WorkQueue::AddWorkItem(const SharedPtr<WorkItem> &item, WorkGroup* group)
     {
         if (!item)
         {
@@ -109,33 +295,67 @@ namespace My3D
         workItems_.Push(item);
         item->completed_ = false;
 
-        // Make sure worker threads' list is safe to modify
-        if (threads_.Size() && !paused_)
-            queueMutex_.Acquire();
-
-        // Find position for new item
-        if (queue_.Empty())
-            queue_.Push(item);
-        else
+        // Count the item as unfinished for its priority and group. A counter that has dropped to zero is no longer referenced
+        // by any item, so it is reused for a new priority, which keeps the counters to the priorities in flight at once
+        WorkPriorityCounter* counter = nullptr;
+        WorkPriorityCounter* freeCounter = nullptr;
+        for (unsigned i = 0; i < priorityCounters_.Size(); ++i)
+        {
+            if (priorityCounters_[i]->priority_ == item->priority_)
+            {
+                counter = priorityCounters_[i];
+                break;
+            }
+            if (!freeCounter && !priorityCounters_[i]->count_.load())
+                freeCounter = priorityCounters_[i];
+        }
+        if (!counter)
         {
-            bool inserted = false;
+            if (freeCounter)
+                counter = freeCounter;
+            else
+            {
+                counter = new WorkPriorityCounter();
+                priorityCounters_.Push(counter);
+            }
+            counter->priority_ = item->priority_;
+        }
+        ++counter->count_;
+        item->counter_ = counter;
+        item->group_ = group;
+        if (group)
+        {
+            ++group->numPending_;
+            group->minPriority_ = Min(group->minPriority_, item->priority_);
+        }
 
-            for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
+        if (!stealingQueues_.Empty())
+        {
+            // Count the item before it can be taken, so that the count does not underflow
+            unsigned numQueued;
             {
-                if ((*i)->priority_ <= item->priority_)
-                {
-                    queue_.Insert(i, item);
-                    inserted = true;
-                    break;
-                }
+                MutexLock lock(queueMutex_);
+                InsertQueued(item);
+                numQueued = numQueuedItems_++;
             }
 
-            if (!inserted)
-                queue_.Push(item);
+            // Wake a thread when work appears. While there is queued work, threads that take an item wake the next one
+            if (paused_.exchange(false))
+                WakeThreads(true);
+            else if (!numQueued)
+                WakeThreads(false);
+            return;
         }
 
+        // Make sure worker threads' list is safe to modify
+        if (threads_.Size() && !paused_)
+            queueMutex_.Acquire();
+
+        InsertQueued(item);
+
         if (threads_.Size())
         {
+            queueCondition_.NotifyOne();
             queueMutex_.Release();
             paused_ = false;
         }
@@ -146,43 +366,30 @@ namespace My3D
         if (!item)
             return false;
 
-        MutexLock lock(queueMutex_);
-
         // Can only remove successfully if the item was not yet taken by threads for execution
-        List<WorkItem*>::Iterator i = queue_.Find(item.Get());
-        if (i != queue_.End())
-        {
-            List<SharedPtr<WorkItem> >::Iterator j = workItems_.Find(item);
-            if (j != workItems_.End())
-            {
-                queue_.Erase(i);
-                ReturnToPool(item);
-                workItems_.Erase(j);
-                return true;
-            }
-        }
+        List<SharedPtr<WorkItem> >::Iterator i = workItems_.Find(item);
+        if (i == workItems_.End() || !RemoveQueued(item.Get()))
+            return false;
 
-        return false;
+        ReleaseCounters(item.Get());
+        ReturnToPool(item);
+        workItems_.Erase(i);
+        return true;
     }
 
     unsigned int WorkQueue::RemoveWorkItems(const Vector<SharedPtr<WorkItem>>& items)
     {
-        MutexLock lock(queueMutex_);
         unsigned removed = 0;
 
         for (auto const& item : items)
         {
-            auto it = queue_.Find(item.Get());
-            if (it != queue_.End())
+            auto index = workItems_.Find(item);
+            if (index != workItems_.End() && RemoveQueued(item.Get()))
             {
-                auto index = workItems_.Find(item);
-                if (index != workItems_.End())
-                {
-                    queue_.Erase(it);
-                    ReturnToPool(*index);
-                    workItems_.Erase(index);
-                    ++removed;
-                }
+                ReleaseCounters(item.Get());
+                ReturnToPool(*index);
+                workItems_.Erase(index);
+                ++removed;
             }
         }
 
@@ -193,12 +400,15 @@ namespace My3D
     {
         if (!paused_)
         {
-            pausing_ = true;
+            // The work-stealing worker threads do not contend for the queue mutex, they park while paused
+            if (!stealingQueues_.Empty())
+            {
+                paused_ = true;
+                return;
+            }
 
             queueMutex_.Acquire();
             paused_ = true;
-
-            pausing_ = false;
         }
     }
 
@@ -206,20 +416,50 @@ namespace My3D
     {
         if (paused_)
         {
-            queueMutex_.Release();
+            if (stealingQueues_.Empty())
+                queueMutex_.Release();
             paused_ = false;
+            WakeThreads(true);
         }
     }
 
     void WorkQueue::Complete(unsigned int priority)
+    {
+        CompleteItems(priority, nullptr);
+    }
+
+    void WorkQueue::Complete(WorkGroup& group)
+    {
+        CompleteItems(group.minPriority_, &group);
+        group.minPriority_ = M_MAX_UNSIGNED;
+    }
+
+    void WorkQueue::CompleteItems(unsigned priority, WorkGroup* group)
     {
         completing_ = true;
 
-        if (threads_.Size())
+        if (!stealingQueues_.Empty())
+        {
+            Resume();
+            // Take work items also in the main thread, stealing from the worker threads when the injection queue has no
+            // high-priority items anymore. Then wait for the items still executing in the worker threads
+            while (!IsCompleted(priority, group))
+            {
+                WorkItem* item = TakeWorkItem(0, priority);
+                if (!item)
+                {
+                    WaitCompleted(priority, group);
+                    break;
+                }
+
+                ExecuteWorkItem(item, 0);
+            }
+        }
+        else if (threads_.Size())
         {
             Resume();
             // Take work items also in the main thread until queue empty or no high-priority items anymore
-            while (!queue_.Empty())
+            while (!queue_.Empty() && !IsCompleted(priority, group))
             {
                 queueMutex_.Acquire();
                 if (!queue_.Empty() && queue_.Front()->priority_ >= priority)
@@ -227,8 +467,7 @@ namespace My3D
                     WorkItem* item = queue_.Front();
                     queue_.PopFront();
                     queueMutex_.Release();
-                    item->workFunction_(item, 0);
-                    item->completed_ = true;
+                    ExecuteWorkItem(item, 0);
                 }
                 else
                 {
@@ -238,7 +477,7 @@ namespace My3D
             }
 
             // Wait for threaded work to complete
-            while (!IsCompleted(priority)) { }
+            WaitCompleted(priority, group);
 
             // If no work at all remaining, pause worker threads by leaving the mutex locked
             if (queue_.Empty())
@@ -247,12 +486,11 @@ namespace My3D
         else
         {
             // No worker threads: ensure all high-priority items are completed in the main thread
-            while (!queue_.Empty() && queue_.Front()->priority_ >= priority)
+            while (!queue_.Empty() && queue_.Front()->priority_ >= priority && !IsCompleted(priority, group))
             {
                 WorkItem* item = queue_.Front();
                 queue_.PopFront();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
+                ExecuteWorkItem(item, 0);
             }
         }
 
@@ -262,48 +500,254 @@ namespace My3D
 
     bool WorkQueue::IsCompleted(unsigned int priority) const
     {
-        for (const auto& item : workItems_)
+        for (unsigned i = 0; i < priorityCounters_.Size(); ++i)
         {
-            if (item->priority_ >= priority && !item->completed_)
+            if (priorityCounters_[i]->priority_ >= priority && priorityCounters_[i]->count_.load())
                 return false;
         }
 
         return true;
     }
 
+    void WorkQueue::WaitCompleted(unsigned priority, const WorkGroup* group)
+    {
+        // The waiter count is raised before checking the counters, and ExecuteWorkItem lowers a counter before checking for
+        // waiters, so a wakeup can not be missed
+        MutexLock lock(completeMutex_);
+        ++numCompleteWaiters_;
+        while (!IsCompleted(priority, group))
+            completeCondition_.Wait(completeMutex_);
+        --numCompleteWaiters_;
+    }
+
+    void WorkQueue::ExecuteWorkItem(WorkItem* item, unsigned threadIndex)
+    {
+        {
+            MY3D_PROFILE("WorkItem");
+            item->workFunction_(item, threadIndex);
+        }
+
+        // Once the completed flag is set the main thread may purge and reuse the item, and once the group count drops to zero
+        // the group may be destroyed, so do not touch either afterward
+        WorkPriorityCounter* counter = item->counter_;
+        WorkGroup* group = item->group_;
+        item->completed_ = true;
+
+        bool finished = !--counter->count_;
+        if (group && !--group->numPending_)
+            finished = true;
+
+        if (finished && numCompleteWaiters_)
+        {
+            MutexLock lock(completeMutex_);
+            completeCondition_.NotifyAll();
+        }
+    }
+
+    void WorkQueue::ReleaseCounters(WorkItem* item)
+    {
+        --item->counter_->count_;
+        if (item->group_)
+            --item->group_->numPending_;
+    }
+
+    unsigned WorkQueue::GetThreadIndex()
+    {
+        return currentThreadIndex;
+    }
+
+    unsigned WorkQueue::GetNumParallelChunks(unsigned count, unsigned grainSize) const
+    {
+        if (!Thread::IsMainThread())
+            return 1;
+
+        unsigned numChunks = (count + Max(grainSize, 1U) - 1) / Max(grainSize, 1U);
+        return Clamp(numChunks, 1U, threads_.Size() + 1);
+    }
+
     void WorkQueue::ProcessItems(unsigned int threadIndex)
     {
-        bool wasActive = false;
+        if (!stealingQueues_.Empty())
+        {
+            ProcessItemsStealing(threadIndex);
+            return;
+        }
 
         for (;;)
         {
+            // Block while the queue is empty. Waiting releases the mutex, so the main thread can still pause by holding it
+            queueMutex_.Acquire();
+            while (!shutDown_ && queue_.Empty())
+                queueCondition_.Wait(queueMutex_);
             if (shutDown_)
+            {
+                queueMutex_.Release();
                 return;
+            }
 
-            if (pausing_ && !wasActive)
-                Time::Sleep(0);
-            else
+            WorkItem* item = queue_.Front();
+            queue_.PopFront();
+            queueMutex_.Release();
+
+            ExecuteWorkItem(item, threadIndex);
+        }
+    }
+
+    void WorkQueue::ProcessItemsStealing(unsigned threadIndex)
+    {
+        for (;;)
+        {
+            if (shutDown_)
+                return;
+
+            WorkItem* item = paused_ ? nullptr : TakeWorkItem(threadIndex, 0);
+            if (item)
             {
-                queueMutex_.Acquire();
-                if (!queue_.Empty())
-                {
-                    wasActive = true;
+                ExecuteWorkItem(item, threadIndex);
+                continue;
+            }
 
-                    WorkItem* item = queue_.Front();
-                    queue_.PopFront();
-                    queueMutex_.Release();
+            // Park until work is added or the queue resumes. The count is raised before checking for work, and producers
+            // raise the work count before checking for parked threads, so a wakeup can not be missed
+            MutexLock lock(parkMutex_);
+            ++numParkedThreads_;
+            if (!shutDown_ && (paused_ || !numQueuedItems_))
+                parkCondition_.Wait(parkMutex_);
+            --numParkedThreads_;
+        }
+    }
 
-                    item->workFunction_(item, threadIndex);
-                    item->completed_ = true;
+    WorkItem* WorkQueue::TakeWorkItem(unsigned threadIndex, unsigned priority)
+    {
+        WorkStealingQueue* local = stealingQueues_[threadIndex];
+        WorkItem* item = nullptr;
+
+        // Newest item of the own deque first, as its data is most likely still in cache
+        if (local->count_.load(std::memory_order_relaxed))
+        {
+            MutexLock lock(local->mutex_);
+            item = local->PopBack(priority);
+        }
+
+        // Then the highest-priority item of the injection queue. A worker thread also moves its share of the following
+        // items with the same priority to its own deque, so that the others steal from it instead of contending for the queue
+        if (!item && numInjectedItems_.load(std::memory_order_relaxed))
+        {
+            MutexLock lock(queueMutex_);
+            if (!queue_.Empty() && queue_.Front()->priority_ >= priority)
+            {
+                item = queue_.Front();
+                queue_.PopFront();
+
+                if (threadIndex)
+                {
+                    unsigned batch = Min(queue_.Size() / stealingQueues_.Size(), WORKSTEALING_MAX_BATCH);
+                    MutexLock localLock(local->mutex_);
+                    for (unsigned moved = 0; moved < batch && queue_.Front()->priority_ == item->priority_; ++moved)
+                    {
+                        local->PushBack(queue_.Front());
+                        queue_.PopFront();
+                    }
                 }
-                else
+
+                numInjectedItems_.store(queue_.Size(), std::memory_order_relaxed);
+            }
+        }
+
+        if (!item)
+            item = StealWorkItem(threadIndex, priority);
+
+        if (item && --numQueuedItems_)
+            WakeThreads(false);
+        return item;
+    }
+
+    WorkItem* WorkQueue::StealWorkItem(unsigned threadIndex, unsigned priority)
+    {
+        WorkStealingQueue* local = stealingQueues_[threadIndex];
+        unsigned numQueues = stealingQueues_.Size();
+
+        // Xorshift to pick where to start, so that idle threads do not all contend for the same victim
+        local->random_ ^= local->random_ << 13u;
+        local->random_ ^= local->random_ >> 17u;
+        local->random_ ^= local->random_ << 5u;
+        unsigned start = local->random_ % numQueues;
+
+        for (unsigned i = 0; i < numQueues; ++i)
+        {
+            unsigned index = (start + i) % numQueues;
+            WorkStealingQueue* victim = stealingQueues_[index];
+            if (index == threadIndex || !victim->count_.load(std::memory_order_relaxed))
+                continue;
+
+            MutexLock lock(victim->mutex_);
+            WorkItem* item = victim->PopFront(priority);
+            if (item)
+                return item;
+        }
+
+        return nullptr;
+    }
+
+    void WorkQueue::InsertQueued(WorkItem* item)
+    {
+        // Items go before the first item with the same or lower priority. Check the back first, as lower-priority items are
+        // usually appended
+        if (queue_.Empty() || queue_.Back()->priority_ > item->priority_)
+            queue_.Push(item);
+        else
+        {
+            for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
+            {
+                if ((*i)->priority_ <= item->priority_)
                 {
-                    wasActive = false;
-                    queueMutex_.Release();
-                    Time::Sleep(0);
+                    queue_.Insert(i, item);
+                    break;
                 }
             }
         }
+
+        numInjectedItems_.store(queue_.Size(), std::memory_order_relaxed);
+    }
+
+    bool WorkQueue::RemoveQueued(WorkItem* item)
+    {
+        {
+            MutexLock lock(queueMutex_);
+            List<WorkItem*>::Iterator i = queue_.Find(item);
+            if (i != queue_.End())
+            {
+                queue_.Erase(i);
+                numInjectedItems_.store(queue_.Size(), std::memory_order_relaxed);
+                if (!stealingQueues_.Empty())
+                    --numQueuedItems_;
+                return true;
+            }
+        }
+
+        for (unsigned i = 0; i < stealingQueues_.Size(); ++i)
+        {
+            MutexLock lock(stealingQueues_[i]->mutex_);
+            if (stealingQueues_[i]->Remove(item))
+            {
+                --numQueuedItems_;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void WorkQueue::WakeThreads(bool all)
+    {
+        if (!numParkedThreads_)
+            return;
+
+        MutexLock lock(parkMutex_);
+        if (all)
+            parkCondition_.NotifyAll();
+        else
+            parkCondition_.NotifyOne();
     }
 
     void WorkQueue::PurgeCompleted(unsigned int priority)
@@ -362,6 +806,8 @@ namespace My3D
             item->priority_ = M_MAX_UNSIGNED;
             item->sendEvent_ = false;
             item->completed_ = false;
+            item->group_ = nullptr;
+            item->counter_ = nullptr;
 
             poolItems_.Push(item);
         }
@@ -376,9 +822,8 @@ namespace My3D
             while (!queue_.Empty() && timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
             {
                 WorkItem* item = queue_.Front();
-                queue_.Pop();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
+                queue_.PopFront();
+                ExecuteWorkItem(item, 0);
             }
         }
 
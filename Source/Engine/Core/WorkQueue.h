@@ -5,8 +5,10 @@
 #pragma once
 
 #include "Container/List.h"
+#include "Core/ConditionVariable.h"
 #include "Core/Object.h"
 #include "Core/Mutex.h"
+#include "Core/Thread.h"
 
 #include <atomic>
 
@@ -19,7 +21,24 @@ namespace My3D
         MY3D_PARAM(P_ITEM, Item);                        // WorkItem ptr
     }
 
+    /// CPU affinity of the worker threads. Threads are placed on the cores in order of NUMA node and last level cache group,
+    /// so that a few threads share one cache, and the first core is left for the main thread while there are enough cores.
+    enum WorkerAffinity
+    {
+        /// Let the operating system move the worker threads freely.
+        WORKER_AFFINITY_NONE = 0,
+        /// Pin each worker thread to the logical CPUs of one physical core.
+        WORKER_AFFINITY_CORE,
+        /// Restrict each worker thread to the cores sharing the last level cache with its core.
+        WORKER_AFFINITY_CACHE,
+        /// Restrict each worker thread to the cores of the NUMA node of its core.
+        WORKER_AFFINITY_NUMA
+    };
+
     class WorkerThread;
+    class WorkGroup;
+    struct WorkPriorityCounter;
+    struct WorkStealingQueue;
 
     /// Work queue item
     struct WorkItem : public RefCounted
@@ -44,6 +63,47 @@ namespace My3D
 
     private:
         bool pooled_ {};
+        /// Group the item was added to, if any.
+        WorkGroup* group_ {};
+        /// Counter of unfinished items with the same priority.
+        WorkPriorityCounter* counter_ {};
+    };
+
+    /// Set of work items that can be completed separately from the rest of the queued work. Must stay alive until it has been
+    /// completed.
+    class MY3D_API WorkGroup
+    {
+        friend class WorkQueue;
+
+    public:
+        /// Construct.
+        WorkGroup() = default;
+        /// Prevent copy construction.
+        WorkGroup(const WorkGroup& rhs) = delete;
+        /// Prevent assignment.
+        WorkGroup& operator =(const WorkGroup& rhs) = delete;
+
+        /// Return number of unfinished work items.
+        unsigned GetNumPending() const { return numPending_; }
+        /// Return whether all work items have finished.
+        bool IsCompleted() const { return !numPending_; }
+
+    private:
+        /// Number of unfinished work items.
+        std::atomic<unsigned> numPending_ {};
+        /// Lowest priority of the work items added since the group was last completed.
+        unsigned minPriority_ {M_MAX_UNSIGNED};
+    };
+
+    /// Chunk of a WorkQueue::ParallelFor range.
+    struct ParallelForChunk
+    {
+        /// Chunk index.
+        unsigned index_;
+        /// Range start.
+        unsigned begin_;
+        /// Range end.
+        unsigned end_;
     };
 
     /// Work queue subsystem for multithreading
@@ -60,10 +120,17 @@ namespace My3D
 
         /// Create worker thread. Can only be called once
         void CreateThreads(unsigned numThreads);
+        /// Enable or disable the work-stealing scheduler. Each thread then has its own deque of work items: items added from
+        /// the main thread go to a shared priority-ordered injection queue, idle workers take a share of them into their own
+        /// deque and steal from the other threads' deques when out of work, and park until new work arrives instead of
+        /// spinning. Must be called before CreateThreads.
+        void SetWorkStealing(bool enable);
+        /// Set the CPU affinity of the worker threads. Must be called before CreateThreads.
+        void SetWorkerAffinity(WorkerAffinity affinity);
         /// Get pointer to an usable WorkItem from the item pool. Allocate one if no more free items.
         SharedPtr<WorkItem> GetFreeItem();
-        /// Add a work item and resume worker threads.
-        void AddWorkItem(const SharedPtr<WorkItem>& item);
+        /// Add a work item and resume worker threads. Optionally add it to a group that can be completed separately.
+        void AddWorkItem(const SharedPtr<WorkItem>& item, WorkGroup* group = nullptr);
         /// Remove a work item before it has started executing. Return true if successfully removed.
         bool RemoveWorkItem(SharedPtr<WorkItem>& item);
         /// Remove a number of work items before they have started executing. Return the number of items successfully removed.
@@ -74,14 +141,34 @@ namespace My3D
         void Resume();
         /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
         void Complete(unsigned priority);
+        /// Finish the work items of a group, without waiting for other work. Main thread will also execute queued work with at
+        /// least the lowest priority of the group while its items are pending.
+        void Complete(WorkGroup& group);
+        /// Call a function for the range [begin, end) split into chunks of at least grainSize elements, at most one per thread
+        /// including the calling one, and wait for all of them to finish. The function is called as
+        /// function(chunkBegin, chunkEnd, threadIndex). The calling thread executes the last chunk. Runs inline when there are
+        /// no worker threads, the range fits in one chunk or when not called from the main thread. Only the chunks are waited
+        /// for, not other queued work.
+        template <class T> void ParallelFor(unsigned begin, unsigned end, unsigned grainSize, const T& function);
+        /// Reduce the range [begin, end) in chunks like ParallelFor. Each chunk is evaluated as
+        /// function(chunkBegin, chunkEnd, threadIndex), and the chunk results are combined in range order on the calling
+        /// thread as value = combine(value, chunkResult), starting from the identity value.
+        template <class T, class U, class V> T ParallelReduce(unsigned begin, unsigned end, unsigned grainSize, T identity,
+            const U& function, const V& combine);
         /// Set the pool telerance before it starts deleting pool items.
         void SetTolerance(int tolerance) { tolerance_ = tolerance; }
         /// Set how many milliseconds maximum per frame to spend on low-priority work, when there are no worker threads.
         void SetNonThreadedWorkMs(int ms) { maxNonThreadedWorkMs_ = Max(ms, 1); }
         /// Return number of worker threads.
         unsigned GetNumThreads() const { return threads_.Size(); }
+        /// Return whether the work-stealing scheduler is enabled.
+        bool GetWorkStealing() const { return workStealing_; }
+        /// Return the CPU affinity of the worker threads.
+        WorkerAffinity GetWorkerAffinity() const { return workerAffinity_; }
         /// Return whether all work with at least the specified priority is finished.
         bool IsCompleted(unsigned priority) const;
+        /// Return index of the calling thread: 1 and up for the worker threads, 0 for the main thread and any other thread.
+        static unsigned GetThreadIndex();
         /// Return whether the queue is currently completing work in the main thread.
         bool IsCompleting() const { return completing_; }
         /// Return the pool tolerance.
@@ -90,8 +177,40 @@ namespace My3D
         int GetNonThreadedWorkMs() const { return maxNonThreadedWorkMs_; }
 
     private:
+        /// Return the logical CPUs a worker thread may run on according to the affinity. Empty if all.
+        void GetWorkerCPUs(unsigned threadIndex, PODVector<unsigned>& dest) const;
+        /// Return number of chunks to split a range into for ParallelFor or ParallelReduce.
+        unsigned GetNumParallelChunks(unsigned count, unsigned grainSize) const;
+        /// Split a range into the given number of chunks, execute them in the worker threads and the calling thread, and wait
+        /// for them to finish. The function is called as function(chunkIndex, chunkBegin, chunkEnd, threadIndex).
+        template <class T> void ParallelForChunks(unsigned begin, unsigned end, unsigned numChunks, const T& function);
+        /// Work function of ParallelForChunks.
+        template <class T> static void ParallelForWork(const WorkItem* item, unsigned threadIndex);
+        /// Finish queued work with at least the specified priority, or only until the group has completed if given.
+        void CompleteItems(unsigned priority, WorkGroup* group);
+        /// Return whether the work being completed has finished.
+        bool IsCompleted(unsigned priority, const WorkGroup* group) const { return group ? group->IsCompleted() : IsCompleted(priority); }
+        /// Wait without spinning until the work being completed has finished.
+        void WaitCompleted(unsigned priority, const WorkGroup* group);
+        /// Execute a work item, mark it completed, update the counters and wake the main thread if it waits for them.
+        void ExecuteWorkItem(WorkItem* item, unsigned threadIndex);
+        /// Update the counters for a work item that was removed without executing.
+        void ReleaseCounters(WorkItem* item);
         /// Process work items util shut down. Called by the worker threads.
         void ProcessItems(unsigned threadIndex);
+        /// Process work items with the work-stealing scheduler until shut down, parking when there is no work.
+        void ProcessItemsStealing(unsigned threadIndex);
+        /// Take a work item which has at least the specified priority for execution with the work-stealing scheduler: from the
+        /// thread's own deque, then from the injection queue, then from the other threads' deques. Return null if none found.
+        WorkItem* TakeWorkItem(unsigned threadIndex, unsigned priority);
+        /// Steal a work item which has at least the specified priority from another thread's deque, starting from a random one.
+        WorkItem* StealWorkItem(unsigned threadIndex, unsigned priority);
+        /// Insert a work item into the injection queue by priority. Queue mutex must be held.
+        void InsertQueued(WorkItem* item);
+        /// Remove a work item that has not been taken for execution from the queues. Return true if was found.
+        bool RemoveQueued(WorkItem* item);
+        /// Wake one or all parked worker threads.
+        void WakeThreads(bool all);
         /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
         void PurgeCompleted(unsigned priority);
         /// Purge the pool to reduce allocation where its unneeded.
@@ -111,12 +230,37 @@ namespace My3D
         List<WorkItem*> queue_;
         /// Worker queue mutex.
         Mutex queueMutex_;
+        /// Condition for waking worker threads blocked on an empty queue.
+        ConditionVariable queueCondition_;
         /// Shutting down flag.
         std::atomic<bool> shutDown_;
-        /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
-        std::atomic<bool> pausing_;
-        /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-        bool paused_;
+        /// Paused flag. Indicates the queue mutex being held by the main thread, so that worker threads do not take items
+        /// while it queues them. With the work-stealing scheduler the worker threads park instead while it is set.
+        std::atomic<bool> paused_;
+        /// Work-stealing scheduler flag.
+        bool workStealing_;
+        /// CPU affinity of the worker threads.
+        WorkerAffinity workerAffinity_;
+        /// Work-stealing deques by thread index, main thread first.
+        PODVector<WorkStealingQueue*> stealingQueues_;
+        /// Number of work items in the injection queue and the deques with the work-stealing scheduler.
+        std::atomic<unsigned> numQueuedItems_;
+        /// Number of work items in the injection queue, for checking it without the mutex.
+        std::atomic<unsigned> numInjectedItems_;
+        /// Number of parked worker threads.
+        std::atomic<unsigned> numParkedThreads_;
+        /// Mutex for parking worker threads.
+        Mutex parkMutex_;
+        /// Condition for waking parked worker threads.
+        ConditionVariable parkCondition_;
+        /// Counters of unfinished work items by priority. Only the main thread adds and reuses counters.
+        PODVector<WorkPriorityCounter*> priorityCounters_;
+        /// Number of threads waiting for work to complete.
+        std::atomic<unsigned> numCompleteWaiters_;
+        /// Mutex for waiting for work to complete.
+        Mutex completeMutex_;
+        /// Condition for waking the main thread when a counter drops to zero.
+        ConditionVariable completeCondition_;
         /// Completing work in the main thread flag.
         bool completing_;
         /// Tolerance for the shared pool before it begins to deallocate.
@@ -126,4 +270,77 @@ namespace My3D
         /// Maximum milliseconds per frame to spend on low-priority work, when there are no worker threads.
         int maxNonThreadedWorkMs_;
     };
-}
\ No newline at end of file
+
+    template <class T> void WorkQueue::ParallelFor(unsigned begin, unsigned end, unsigned grainSize, const T& function)
+    {
+        if (end <= begin)
+            return;
+
+        ParallelForChunks(begin, end, GetNumParallelChunks(end - begin, grainSize),
+            [&function](unsigned /*index*/, unsigned chunkBegin, unsigned chunkEnd, unsigned threadIndex)
+        {
+            function(chunkBegin, chunkEnd, threadIndex);
+        });
+    }
+
+    template <class T, class U, class V> T WorkQueue::ParallelReduce(unsigned begin, unsigned end, unsigned grainSize, T identity,
+        const U& function, const V& combine)
+    {
+        if (end <= begin)
+            return identity;
+
+        unsigned numChunks = GetNumParallelChunks(end - begin, grainSize);
+        if (numChunks == 1)
+            return combine(identity, function(begin, end, GetThreadIndex()));
+
+        Vector<T> results(numChunks);
+        ParallelForChunks(begin, end, numChunks,
+            [&function, &results](unsigned index, unsigned chunkBegin, unsigned chunkEnd, unsigned threadIndex)
+        {
+            results[index] = function(chunkBegin, chunkEnd, threadIndex);
+        });
+
+        for (unsigned i = 0; i < numChunks; ++i)
+            identity = combine(identity, results[i]);
+        return identity;
+    }
+
+    template <class T> void WorkQueue::ParallelForChunks(unsigned begin, unsigned end, unsigned numChunks, const T& function)
+    {
+        if (numChunks == 1)
+        {
+            function(0, begin, end, GetThreadIndex());
+            return;
+        }
+
+        unsigned count = end - begin;
+        PODVector<ParallelForChunk> chunks(numChunks);
+        for (unsigned i = 0; i < numChunks; ++i)
+        {
+            chunks[i].index_ = i;
+            chunks[i].begin_ = begin + (unsigned)((unsigned long long)count * i / numChunks);
+            chunks[i].end_ = begin + (unsigned)((unsigned long long)count * (i + 1) / numChunks);
+        }
+
+        WorkGroup group;
+        for (unsigned i = 0; i < numChunks - 1; ++i)
+        {
+            SharedPtr<WorkItem> item = GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = ParallelForWork<T>;
+            item->start_ = &chunks[i];
+            item->aux_ = const_cast<T*>(&function);
+            AddWorkItem(item, &group);
+        }
+
+        const ParallelForChunk& last = chunks.Back();
+        function(last.index_, last.begin_, last.end_, 0);
+        Complete(group);
+    }
+
+    template <class T> void WorkQueue::ParallelForWork(const WorkItem* item, unsigned threadIndex)
+    {
+        const auto* chunk = reinterpret_cast<const ParallelForChunk*>(item->start_);
+        (*reinterpret_cast<const T*>(item->aux_))(chunk->index_, chunk->begin_, chunk->end_, threadIndex);
+    }
+}
@@ -52,23 +52,62 @@ namespace My3D
             return lhs->sortKey_ < rhs->sortKey_;
     }
 
-    inline bool CompareInstancesFrontToBack(const InstanceData& lhs, const InstanceData& rhs)
+    inline bool CompareBatchGroupOrder(BatchGroup* lhs, BatchGroup* rhs)
     {
-        return lhs.distance_ < rhs.distance_;
+        return lhs->renderOrder_ < rhs->renderOrder_;
     }
 
-    inline bool CompareBatchGroupOrder(BatchGroup* lhs, BatchGroup* rhs)
+    /// Sort batches in the order of CompareBatchesFrontToBack. Large queues use stable radix sort passes from the least to the most
+    /// significant key.
+    static void SortBatchesFrontToBack(PODVector<Batch*>& batches, PODVector<unsigned char>& scratch)
     {
-        return lhs->renderOrder_ < rhs->renderOrder_;
+        if (batches.Size() < RADIXSORT_THRESHOLD)
+        {
+            Sort(batches.Begin(), batches.End(), CompareBatchesFrontToBack);
+            return;
+        }
+
+        RadixSort(batches.Begin(), batches.End(), [](const Batch* batch) { return batch->sortKey_; }, scratch);
+        RadixSort(batches.Begin(), batches.End(), [](const Batch* batch) {
+            return ((unsigned long long)batch->renderOrder_ << 32u) | RadixKey(batch->distance_); }, scratch);
+    }
+
+    /// Sort batches in the order of CompareBatchesBackToFront.
+    static void SortBatchesBackToFront(PODVector<Batch*>& batches, PODVector<unsigned char>& scratch)
+    {
+        if (batches.Size() < RADIXSORT_THRESHOLD)
+        {
+            Sort(batches.Begin(), batches.End(), CompareBatchesBackToFront);
+            return;
+        }
+
+        // Inverting the distance key sorts far batches first
+        RadixSort(batches.Begin(), batches.End(), [](const Batch* batch) { return batch->sortKey_; }, scratch);
+        RadixSort(batches.Begin(), batches.End(), [](const Batch* batch) {
+            return ((unsigned long long)batch->renderOrder_ << 32u) | (unsigned)~RadixKey(batch->distance_); }, scratch);
+    }
+
+    /// Sort batches in the order of CompareBatchesState.
+    static void SortBatchesState(PODVector<Batch*>& batches, PODVector<unsigned char>& scratch)
+    {
+        if (batches.Size() < RADIXSORT_THRESHOLD)
+        {
+            Sort(batches.Begin(), batches.End(), CompareBatchesState);
+            return;
+        }
+
+        RadixSort(batches.Begin(), batches.End(), [](const Batch* batch) { return batch->distance_; }, scratch);
+        RadixSort(batches.Begin(), batches.End(), [](const Batch* batch) { return batch->sortKey_; }, scratch);
+        RadixSort(batches.Begin(), batches.End(), [](const Batch* batch) { return (unsigned)batch->renderOrder_; }, scratch);
     }
 
-    void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer)
+    void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer, unsigned stateIndex)
     {
-        Camera* shadowCamera = queue->shadowSplits_[split].shadowCamera_;
+        const CameraRenderState& shadowCamera = queue->shadowSplits_[split].shadowCamera_->GetRenderState(stateIndex);
         const IntRect& viewport = queue->shadowSplits_[split].shadowViewport_;
 
-        const Matrix3x4& shadowView(shadowCamera->GetView());
-        Matrix4 shadowProj(shadowCamera->GetGPUProjection());
+        const Matrix3x4& shadowView(shadowCamera.view_);
+        const Matrix4& shadowProj(shadowCamera.gpuProjection_);
         Matrix4 texAdjust(Matrix4::IDENTITY);
 
         Texture2D* shadowMap = queue->shadowMap_;
@@ -106,19 +145,18 @@ namespace My3D
         dest = texAdjust * shadowProj * shadowView;
     }
 
-    void CalculateSpotMatrix(Matrix4& dest, Light* light)
+    void CalculateSpotMatrix(Matrix4& dest, const LightRenderState& light)
     {
-        Node* lightNode = light->GetNode();
-        Matrix3x4 spotView = Matrix3x4(lightNode->GetWorldPosition(), lightNode->GetWorldRotation(), 1.0f).Inverse();
+        Matrix3x4 spotView = Matrix3x4(light.position_, light.rotation_, 1.0f).Inverse();
         Matrix4 spotProj(Matrix4::ZERO);
         Matrix4 texAdjust(Matrix4::IDENTITY);
 
         // Make the projected light slightly smaller than the shadow map to prevent light spill
-        float h = 1.005f / tanf(light->GetFov() * M_DEGTORAD * 0.5f);
-        float w = h / light->GetAspectRatio();
+        float h = 1.005f / tanf(light.fov_ * M_DEGTORAD * 0.5f);
+        float w = h / light.aspectRatio_;
         spotProj.m00_ = w;
         spotProj.m11_ = h;
-        spotProj.m22_ = 1.0f / Max(light->GetRange(), M_EPSILON);
+        spotProj.m22_ = 1.0f / Max(light.range_, M_EPSILON);
         spotProj.m32_ = 1.0f;
 
 #ifdef MY3D_OPENGL
@@ -155,8 +193,12 @@ namespace My3D
 
         Graphics* graphics = view->GetGraphics();
         Renderer* renderer = view->GetRenderer();
-        Node* cameraNode = camera ? camera->GetNode() : nullptr;
+        // Transforms, projections and light colors are read from the state captured during the update, as the scene may
+        // already be updating the next frame
+        unsigned stateIndex = view->GetFrameInfo().renderStateIndex_;
+        const CameraRenderState* cameraState = camera ? &camera->GetRenderState(stateIndex) : nullptr;
         Light* light = lightQueue_ ? lightQueue_->light_ : nullptr;
+        const LightRenderState* lightState = light ? &light->GetLightRenderState(stateIndex) : nullptr;
         Texture2D* shadowMap = lightQueue_ ? lightQueue_->shadowMap_ : nullptr;
 
         // Set shaders first. The available shader parameters and their register/uniform positions depend on the currently set shaders
@@ -230,7 +272,7 @@ namespace My3D
                 if (numWorldTransforms_ > 1)
                     graphics->SetShaderParameter(VSP_BILLBOARDROT, worldTransform_[1].RotationMatrix());
                 else
-                    graphics->SetShaderParameter(VSP_BILLBOARDROT, cameraNode->GetWorldRotation().RotationMatrix());
+                    graphics->SetShaderParameter(VSP_BILLBOARDROT, cameraState->rotation_.RotationMatrix());
             }
         }
 
@@ -259,7 +301,7 @@ namespace My3D
             graphics->SetShaderParameter(PSP_ZONEMIN, zone_->GetBoundingBox().min_);
             graphics->SetShaderParameter(PSP_ZONEMAX, zone_->GetBoundingBox().max_);
 
-            float farClip = camera->GetFarClip();
+            float farClip = cameraState->farClip_;
             float fogStart = Min(zone_->GetFogStart(), farClip);
             float fogEnd = Min(zone_->GetFogEnd(), farClip);
             if (fogStart >= fogEnd * (1.0f - M_LARGE_EPSILON))
@@ -283,10 +325,9 @@ namespace My3D
         {
             if (light && graphics->NeedParameterUpdate(SP_LIGHT, lightQueue_))
             {
-                Node* lightNode = light->GetNode();
-                float atten = 1.0f / Max(light->GetRange(), M_EPSILON);
-                Vector3 lightDir(lightNode->GetWorldRotation() * Vector3::BACK);
-                Vector4 lightPos(lightNode->GetWorldPosition(), atten);
+                float atten = 1.0f / Max(lightState->range_, M_EPSILON);
+                Vector3 lightDir(lightState->rotation_ * Vector3::BACK);
+                Vector4 lightPos(lightState->position_, atten);
 
                 graphics->SetShaderParameter(VSP_LIGHTDIR, lightDir);
                 graphics->SetShaderParameter(VSP_LIGHTPOS, lightPos);
@@ -300,7 +341,7 @@ namespace My3D
                             Matrix4 shadowMatrices[MAX_CASCADE_SPLITS];
                             unsigned numSplits = Min(MAX_CASCADE_SPLITS, lightQueue_->shadowSplits_.Size());
                             for (unsigned i = 0; i < numSplits; ++i)
-                                CalculateShadowMatrix(shadowMatrices[i], lightQueue_, i, renderer);
+                                CalculateShadowMatrix(shadowMatrices[i], lightQueue_, i, renderer, stateIndex);
 
                             graphics->SetShaderParameter(VSP_LIGHTMATRICES, shadowMatrices[0].Data(), 16 * numSplits);
                         }
@@ -310,10 +351,10 @@ namespace My3D
                         {
                             Matrix4 shadowMatrices[2];
 
-                            CalculateSpotMatrix(shadowMatrices[0], light);
+                            CalculateSpotMatrix(shadowMatrices[0], *lightState);
                             bool isShadowed = shadowMap && graphics->HasTextureUnit(TU_SHADOWMAP);
                             if (isShadowed)
-                                CalculateShadowMatrix(shadowMatrices[1], lightQueue_, 0, renderer);
+                                CalculateShadowMatrix(shadowMatrices[1], lightQueue_, 0, renderer, stateIndex);
 
                             graphics->SetShaderParameter(VSP_LIGHTMATRICES, shadowMatrices[0].Data(), isShadowed ? 32 : 16);
                         }
@@ -321,7 +362,7 @@ namespace My3D
 
                         case LIGHT_POINT:
                         {
-                            Matrix4 lightVecRot(lightNode->GetWorldRotation().RotationMatrix());
+                            Matrix4 lightVecRot(lightState->rotation_.RotationMatrix());
                             // HLSL compiler will pack the parameters as if the matrix is only 3x4, so must be careful to not overwrite
                             // the next parameter
                         #ifdef MY3D_OPENGL
@@ -340,14 +381,14 @@ namespace My3D
 
                 // Do fade calculation for light if both fade & draw distance defined
                 if (light->GetLightType() != LIGHT_DIRECTIONAL && fadeEnd > 0.0f && fadeStart > 0.0f && fadeStart < fadeEnd)
-                    fade = Min(1.0f - (light->GetDistance() - fadeStart) / (fadeEnd - fadeStart), 1.0f);
+                    fade = Min(1.0f - (lightState->distance_ - fadeStart) / (fadeEnd - fadeStart), 1.0f);
 
                 // Negative lights will use subtract blending, so write absolute RGB values to the shader parameter
-                graphics->SetShaderParameter(PSP_LIGHTCOLOR, Color(light->GetEffectiveColor().Abs(), light->GetEffectiveSpecularIntensity()) * fade);
+                graphics->SetShaderParameter(PSP_LIGHTCOLOR, Color(lightState->effectiveColor_.Abs(), lightState->effectiveSpecularIntensity_) * fade);
                 graphics->SetShaderParameter(PSP_LIGHTDIR, lightDir);
                 graphics->SetShaderParameter(PSP_LIGHTPOS, lightPos);
-                graphics->SetShaderParameter(PSP_LIGHTRAD, light->GetRadius());
-                graphics->SetShaderParameter(PSP_LIGHTLENGTH, light->GetLength());
+                graphics->SetShaderParameter(PSP_LIGHTRAD, lightState->radius_);
+                graphics->SetShaderParameter(PSP_LIGHTLENGTH, lightState->length_);
 
                 if (graphics->HasShaderParameter(PSP_LIGHTMATRICES))
                 {
@@ -359,7 +400,7 @@ namespace My3D
                             unsigned numSplits = Min(MAX_CASCADE_SPLITS, lightQueue_->shadowSplits_.Size());
 
                             for (unsigned i = 0; i < numSplits; ++i)
-                                CalculateShadowMatrix(shadowMatrices[i], lightQueue_, i, renderer);
+                                CalculateShadowMatrix(shadowMatrices[i], lightQueue_, i, renderer, stateIndex);
 
                             graphics->SetShaderParameter(PSP_LIGHTMATRICES, shadowMatrices[0].Data(), 16 * numSplits);
                         }
@@ -369,10 +410,10 @@ namespace My3D
                         {
                             Matrix4 shadowMatrices[2];
 
-                            CalculateSpotMatrix(shadowMatrices[0], light);
+                            CalculateSpotMatrix(shadowMatrices[0], *lightState);
                             bool isShadowed = lightQueue_->shadowMap_ != nullptr;
                             if (isShadowed)
-                                CalculateShadowMatrix(shadowMatrices[1], lightQueue_, 0, renderer);
+                                CalculateShadowMatrix(shadowMatrices[1], lightQueue_, 0, renderer, stateIndex);
 
                             graphics->SetShaderParameter(PSP_LIGHTMATRICES, shadowMatrices[0].Data(), isShadowed ? 32 : 16);
                         }
@@ -380,7 +421,7 @@ namespace My3D
 
                         case LIGHT_POINT:
                         {
-                            Matrix4 lightVecRot(lightNode->GetWorldRotation().RotationMatrix());
+                            Matrix4 lightVecRot(lightState->rotation_.RotationMatrix());
                             // HLSL compiler will pack the parameters as if the matrix is only 3x4, so must be careful to not overwrite
                             // the next parameter
                         #ifdef MY3D_OPENGL
@@ -426,14 +467,14 @@ namespace My3D
                     {
                         // Calculate shadow camera depth parameters for point light shadows and shadow fade parameters for
                         //  directional light shadows, stored in the same uniform
-                        Camera* shadowCamera = lightQueue_->shadowSplits_[0].shadowCamera_;
-                        float nearClip = shadowCamera->GetNearClip();
-                        float farClip = shadowCamera->GetFarClip();
+                        const CameraRenderState& shadowCamera = lightQueue_->shadowSplits_[0].shadowCamera_->GetRenderState(stateIndex);
+                        float nearClip = shadowCamera.nearClip_;
+                        float farClip = shadowCamera.farClip_;
                         float q = farClip / (farClip - nearClip);
                         float r = -q * nearClip;
 
                         const CascadeParameters& parameters = light->GetShadowCascade();
-                        float viewFarClip = camera->GetFarClip();
+                        float viewFarClip = cameraState->farClip_;
                         float shadowRange = parameters.GetShadowRange();
                         float fadeStart = parameters.fadeStart_ * shadowRange / viewFarClip;
                         float fadeEnd = shadowRange / viewFarClip;
@@ -447,7 +488,7 @@ namespace My3D
                         float fadeStart = light->GetShadowFadeDistance();
                         float fadeEnd = light->GetShadowDistance();
                         if (fadeStart > 0.0f && fadeEnd > 0.0f && fadeEnd > fadeStart)
-                            intensity = Lerp(intensity, 1.0f, Clamp((light->GetDistance() - fadeStart) / (fadeEnd - fadeStart), 0.0f, 1.0f));
+                            intensity = Lerp(intensity, 1.0f, Clamp((lightState->distance_ - fadeStart) / (fadeEnd - fadeStart), 0.0f, 1.0f));
                         float pcfValues = (1.0f - intensity);
                         float samples = 1.0f;
                         if (renderer->GetShadowQuality() == SHADOWQUALITY_PCF_16BIT || renderer->GetShadowQuality() == SHADOWQUALITY_PCF_24BIT)
@@ -461,11 +502,11 @@ namespace My3D
 
                     Vector4 lightSplits(M_LARGE_VALUE, M_LARGE_VALUE, M_LARGE_VALUE, M_LARGE_VALUE);
                     if (lightQueue_->shadowSplits_.Size() > 1)
-                        lightSplits.x_ = lightQueue_->shadowSplits_[0].farSplit_ / camera->GetFarClip();
+                        lightSplits.x_ = lightQueue_->shadowSplits_[0].farSplit_ / cameraState->farClip_;
                     if (lightQueue_->shadowSplits_.Size() > 2)
-                        lightSplits.y_ = lightQueue_->shadowSplits_[1].farSplit_ / camera->GetFarClip();
+                        lightSplits.y_ = lightQueue_->shadowSplits_[1].farSplit_ / cameraState->farClip_;
                     if (lightQueue_->shadowSplits_.Size() > 3)
-                        lightSplits.z_ = lightQueue_->shadowSplits_[2].farSplit_ / camera->GetFarClip();
+                        lightSplits.z_ = lightQueue_->shadowSplits_[2].farSplit_ / cameraState->farClip_;
 
                     graphics->SetShaderParameter(PSP_SHADOWSPLITS, lightSplits);
 
@@ -504,12 +545,12 @@ namespace My3D
                      graphics->NeedParameterUpdate(SP_LIGHT, lightQueue_))
             {
                 Vector4 vertexLights[MAX_VERTEX_LIGHTS * 3];
-                const PODVector<Light*>& lights = lightQueue_->vertexLights_;
+                const LightList& lights = lightQueue_->vertexLights_;
 
                 for (unsigned i = 0; i < lights.Size(); ++i)
                 {
                     Light* vertexLight = lights[i];
-                    Node* vertexLightNode = vertexLight->GetNode();
+                    const LightRenderState& vertexLightState = vertexLight->GetLightRenderState(stateIndex);
                     LightType type = vertexLight->GetLightType();
 
                     // Attenuation
@@ -517,10 +558,10 @@ namespace My3D
                     if (type == LIGHT_DIRECTIONAL)
                         invRange = 0.0f;
                     else
-                        invRange = 1.0f / Max(vertexLight->GetRange(), M_EPSILON);
+                        invRange = 1.0f / Max(vertexLightState.range_, M_EPSILON);
                     if (type == LIGHT_SPOT)
                     {
-                        cutoff = Cos(vertexLight->GetFov() * 0.5f);
+                        cutoff = Cos(vertexLightState.fov_ * 0.5f);
                         invCutoff = 1.0f / (1.0f - cutoff);
                     }
                     else
@@ -536,16 +577,16 @@ namespace My3D
 
                     // Do fade calculation for light if both fade & draw distance defined
                     if (vertexLight->GetLightType() != LIGHT_DIRECTIONAL && fadeEnd > 0.0f && fadeStart > 0.0f && fadeStart < fadeEnd)
-                        fade = Min(1.0f - (vertexLight->GetDistance() - fadeStart) / (fadeEnd - fadeStart), 1.0f);
+                        fade = Min(1.0f - (vertexLightState.distance_ - fadeStart) / (fadeEnd - fadeStart), 1.0f);
 
-                    Color color = vertexLight->GetEffectiveColor() * fade;
+                    Color color = vertexLightState.effectiveColor_ * fade;
                     vertexLights[i * 3] = Vector4(color.r_, color.g_, color.b_, invRange);
 
                     // Direction
-                    vertexLights[i * 3 + 1] = Vector4(-(vertexLightNode->GetWorldDirection()), cutoff);
+                    vertexLights[i * 3 + 1] = Vector4(-(vertexLightState.rotation_ * Vector3::FORWARD), cutoff);
 
                     // Position
-                    vertexLights[i * 3 + 2] = Vector4(vertexLightNode->GetWorldPosition(), invCutoff);
+                    vertexLights[i * 3 + 2] = Vector4(vertexLightState.position_, invCutoff);
                 }
 
                 graphics->SetShaderParameter(VSP_VERTEXLIGHTS, vertexLights[0].Data(), lights.Size() * 3 * 4);
@@ -695,7 +736,7 @@ namespace My3D
         for (unsigned i = 0; i < batches_.Size(); ++i)
             sortedBatches_[i] = &batches_[i];
 
-        Sort(sortedBatches_.Begin(), sortedBatches_.End(), CompareBatchesBackToFront);
+        SortBatchesBackToFront(sortedBatches_, sortScratch_);
 
         sortedBatchGroups_.Resize(batchGroups_.Size());
 
@@ -720,14 +761,15 @@ namespace My3D
         {
             if (i->second_.instances_.Size() <= maxSortedInstances_)
             {
-                Sort(i->second_.instances_.Begin(), i->second_.instances_.End(), CompareInstancesFrontToBack);
+                RadixSort(i->second_.instances_.Begin(), i->second_.instances_.End(), [](const InstanceData& instance) { return instance.distance_; },
+                    sortScratch_);
                 if (i->second_.instances_.Size())
                     i->second_.distance_ = i->second_.instances_[0].distance_;
             }
             else
             {
                 float minDistance = M_INFINITY;
-                for (PODVector<InstanceData>::ConstIterator j = i->second_.instances_.Begin(); j != i->second_.instances_.End(); ++j)
+                for (FramePODVector<InstanceData>::ConstIterator j = i->second_.instances_.Begin(); j != i->second_.instances_.End(); ++j)
                     minDistance = Min(minDistance, j->distance_);
                 i->second_.distance_ = minDistance;
             }
@@ -744,7 +786,7 @@ namespace My3D
 
     void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
     {
-        Sort(batches.Begin(), batches.End(), CompareBatchesFrontToBack);
+        SortBatchesFrontToBack(batches, sortScratch_);
 
         unsigned freeShaderID = 0;
         unsigned short freeMaterialID = 0;
@@ -792,7 +834,7 @@ namespace My3D
         geometryRemapping_.Clear();
 
         // Finally sort again with the rewritten ID's
-        Sort(batches.Begin(), batches.End(), CompareBatchesState);
+        SortBatchesState(batches, sortScratch_);
     }
 
     void BatchQueue::SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex)
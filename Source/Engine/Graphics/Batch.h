@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Container/Ptr.h"
+#include "Core/FrameAllocator.h"
 #include "Graphics/Drawable.h"
 #include "Graphics/Material.h"
 #include "Math/MathDefs.h"
@@ -149,8 +150,8 @@ namespace My3D
         /// Prepare and draw.
         void Draw(View* view, Camera* camera, bool allowDepthWrite) const;
 
-        /// Instance data.
-        PODVector<InstanceData> instances_;
+        /// Instance data. Allocated from the frame allocator when one is set.
+        FramePODVector<InstanceData> instances_;
         /// Instance stream start index, or M_MAX_UNSIGNED if transforms not pre-set.
         unsigned startIndex_;
     };
@@ -240,6 +241,8 @@ namespace My3D
         PODVector<Batch*> sortedBatches_;
         /// Sorted instanced draw calls.
         PODVector<BatchGroup*> sortedBatchGroups_;
+        /// Scratch memory for radix sorting, kept between frames.
+        PODVector<unsigned char> sortScratch_;
         /// Maximum sorted instances.
         unsigned maxSortedInstances_;
         /// Whether the pass command contains extra shader defines.
@@ -285,7 +288,7 @@ namespace My3D
         /// Shadow map split queues.
         Vector<ShadowBatchQueue> shadowSplits_;
         /// Per-vertex lights.
-        PODVector<Light*> vertexLights_;
+        LightList vertexLights_;
         /// Light volume draw calls.
         PODVector<Batch> volumeBatches_;
     };
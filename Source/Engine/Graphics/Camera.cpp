@@ -541,6 +541,20 @@ namespace My3D
         return useReflection_ ? reflectionMatrix_ * worldTransform : worldTransform;
     }
 
+    void Camera::CaptureRenderState(unsigned index)
+    {
+        CameraRenderState& state = renderStates_[index];
+        Vector3 nearVector;
+        state.effectiveWorldTransform_ = GetEffectiveWorldTransform();
+        state.rotation_ = node_ ? node_->GetWorldRotation() : Quaternion::IDENTITY;
+        state.view_ = GetView();
+        state.gpuProjection_ = GetGPUProjection();
+        GetFrustumSize(nearVector, state.farFrustumSize_);
+        state.nearClip_ = GetNearClip();
+        state.farClip_ = GetFarClip();
+        state.orthographic_ = orthographic_;
+    }
+
     bool Camera::IsProjectionValid() const
     {
         return GetFarClip() > GetNearClip();
@@ -26,6 +26,26 @@ namespace My3D
     };
     MY3D_FLAGSET(ViewOverride, ViewOverrideFlags);
 
+    /// Camera state captured during the update for rendering.
+    struct CameraRenderState
+    {
+        /// World transform including reflection but excluding node scaling.
+        Matrix3x4 effectiveWorldTransform_;
+        /// World rotation of the node.
+        Quaternion rotation_;
+        /// View matrix.
+        Matrix3x4 view_;
+        /// API-specific projection matrix.
+        Matrix4 gpuProjection_;
+        /// View-space frustum corner at the far clip distance.
+        Vector3 farFrustumSize_;
+        /// Near clip distance.
+        float nearClip_{};
+        /// Far clip distance.
+        float farClip_{};
+        /// Orthographic flag.
+        bool orthographic_{};
+    };
 
     /// Camera component
     class MY3D_API Camera : public Component
@@ -172,6 +192,10 @@ namespace My3D
         Matrix3x4 GetEffectiveWorldTransform() const;
         /// Return if projection parameters are valid for rendering and raycasting.
         bool IsProjectionValid() const;
+        /// Copy the state that rendering reads into a render state copy. Called during the update.
+        void CaptureRenderState(unsigned index);
+        /// Return a render state copy.
+        const CameraRenderState& GetRenderState(unsigned index) const { return renderStates_[index]; }
         /// Set aspect ratio without disabling the "auto aspect ratio" mode. Called internally by View.
         void SetAspectRatioInternal(float aspectRatio);
         /// Set orthographic size attribute without forcing the aspect ratio.
@@ -251,5 +275,7 @@ namespace My3D
         bool useClipping_;
         /// Use custom projection matrix flag. Used internally.
         mutable bool customProjection_;
+        /// Render state copies.
+        CameraRenderState renderStates_[NUM_RENDER_STATES];
     };
 }
@@ -3,6 +3,7 @@
 //
 
 #include "Core/Context.h"
+#include "Core/FramePipeline.h"
 #include "Graphics/Camera.h"
 #include "Graphics/Geometry.h"
 #include "Graphics/Drawable.h"
@@ -18,6 +19,8 @@
 
 namespace My3D
 {
+    static_assert(NUM_RENDER_STATES == NUM_FRAME_PACKETS, "A render state copy is needed for each frame packet");
+
     const char* GEOMETRY_CATEGORY = "Geometry";
 
     SourceBatch::SourceBatch() = default;
@@ -106,9 +109,12 @@ namespace My3D
     void Drawable::UpdateBatches(const FrameInfo& frame)
     {
         const BoundingBox& worldBoundingBox = GetWorldBoundingBox();
-        const Matrix3x4& worldTransform = node_->GetWorldTransform();
         distance_ = frame.camera_->GetDistance(worldBoundingBox.Center());
 
+        // Batches point to the captured transform, so that the node may move while the frame renders
+        CaptureRenderState(frame.renderStateIndex_);
+        const Matrix3x4& worldTransform = renderStates_[frame.renderStateIndex_].worldTransform_;
+
         for (unsigned i = 0; i < batches_.Size(); ++i)
         {
             batches_[i].distance_ = distance_;
@@ -141,6 +147,14 @@ namespace My3D
 
     }
 
+    void Drawable::CaptureRenderState(unsigned index)
+    {
+        DrawableRenderState& state = renderStates_[index];
+        state.worldTransform_ = node_ ? node_->GetWorldTransform() : Matrix3x4::IDENTITY;
+        state.worldBoundingBox_ = GetWorldBoundingBox();
+        state.distance_ = distance_;
+    }
+
     void Drawable::SetDrawDistance(float distance)
     {
         drawDistance_ = distance;
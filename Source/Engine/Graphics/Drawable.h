@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "Container/SmallVector.h"
 #include "Graphics/GraphicsDefs.h"
 #include "Math/BoundingBox.h"
 #include "Scene/Component.h"
@@ -28,13 +29,15 @@ namespace My3D
     class File;
     class Geometry;
     class Light;
+
+    /// List of lights affecting a drawable. Usually holds only a few lights, so they are stored inline.
+    using LightList = SmallVector<Light*, MAX_VERTEX_LIGHTS>;
     class Material;
     class OcclusionBuffer;
     class Octant;
     class RayOctreeQuery;
     class Zone;
     struct RayQueryResult;
-    struct WorkItem;
 
     /// Geometry update type.
     enum UpdateGeometryType
@@ -55,6 +58,19 @@ namespace My3D
         IntVector2 viewSize_;
         /// Camera being used.
         Camera* camera_;
+        /// Render state copy the frame captures into and renders from.
+        unsigned renderStateIndex_;
+    };
+
+    /// Drawable state captured during the update for rendering.
+    struct DrawableRenderState
+    {
+        /// World transform.
+        Matrix3x4 worldTransform_;
+        /// World-space bounding box.
+        BoundingBox worldBoundingBox_;
+        /// Distance from camera.
+        float distance_{};
     };
 
     /// Source data for a 3D geometry draw call.
@@ -93,7 +109,6 @@ namespace My3D
 
         friend class Octant;
         friend class Octree;
-        friend void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex);
 
     public:
         /// Construct.
@@ -123,6 +138,8 @@ namespace My3D
         virtual bool DrawOcclusion(OcclusionBuffer* buffer);
         /// Visualize the component as debug geometry.
         void DrawDebugGeometry(DebugRenderer* debug, bool depthTest) override;
+        /// Copy the state that rendering reads into a render state copy. Called during the update, may be called from worker threads.
+        virtual void CaptureRenderState(unsigned index);
 
         /// Set draw distance.
         void SetDrawDistance(float distance);
@@ -182,6 +199,8 @@ namespace My3D
         bool IsInView(Camera* camera) const;
         /// Return draw call source data.
         const Vector<SourceBatch>& GetBatches() const { return batches_; }
+        /// Return a render state copy.
+        const DrawableRenderState& GetRenderState(unsigned index) const { return renderStates_[index]; }
         /// Set new zone. Zone assignment may optionally be temporary, meaning it needs to be re-evaluated on the next frame.
         void SetZone(Zone* zone, bool temporary = false);
         /// Set sorting value.
@@ -219,9 +238,9 @@ namespace My3D
         /// Return whether has a base pass.
         bool HasBasePass(unsigned batchIndex) const { return (basePassFlags_ & (1u << batchIndex)) != 0; }
         /// Return per-pixel lights.
-        const PODVector<Light*>& GetLights() const { return lights_; }
+        const LightList& GetLights() const { return lights_; }
         /// Return per-vertex lights.
-        const PODVector<Light*>& GetVertexLights() const { return vertexLights_; }
+        const LightList& GetVertexLights() const { return vertexLights_; }
         /// Return the first added per-pixel light.
         Light* GetFirstLight() const { return firstLight_; }
         /// Return the minimum view-space depth.
@@ -325,9 +344,11 @@ protected:
         /// First per-pixel light added this frame.
         Light* firstLight_;
         /// Per-pixel lights affecting this drawable.
-        PODVector<Light*> lights_;
+        LightList lights_;
         /// Per-vertex lights affecting this drawable.
-        PODVector<Light*> vertexLights_;
+        LightList vertexLights_;
+        /// Render state copies.
+        DrawableRenderState renderStates_[NUM_RENDER_STATES];
     };
 
     inline bool CompareDrawables(Drawable* lhs, Drawable* rhs)
@@ -432,4 +432,8 @@ namespace My3D
     static const int MAX_CONSTANT_REGISTERS = 256;
 
     static const int BITS_PER_COMPONENT = 8;
+
+    /// Number of copies of the render state of drawables, lights and cameras: one is read by the frame being rendered while
+    /// the next frame captures into the other. The copy of a frame has the index of its frame packet.
+    static const unsigned NUM_RENDER_STATES = 2;
 }
\ No newline at end of file
@@ -211,6 +211,23 @@ namespace My3D
 
     }
 
+    void Light::CaptureRenderState(unsigned index)
+    {
+        Drawable::CaptureRenderState(index);
+
+        LightRenderState& state = lightRenderStates_[index];
+        state.position_ = node_ ? node_->GetWorldPosition() : Vector3::ZERO;
+        state.rotation_ = node_ ? node_->GetWorldRotation() : Quaternion::IDENTITY;
+        state.effectiveColor_ = GetEffectiveColor();
+        state.effectiveSpecularIntensity_ = GetEffectiveSpecularIntensity();
+        state.range_ = range_;
+        state.fov_ = fov_;
+        state.aspectRatio_ = aspectRatio_;
+        state.radius_ = lightRad_;
+        state.length_ = lightLength_;
+        state.distance_ = distance_;
+    }
+
     void Light::SetLightType(LightType type)
     {
         lightType_ = type;
@@ -121,6 +121,31 @@ namespace My3D
         float minView_;
     };
 
+    /// Light state captured during the update for rendering.
+    struct LightRenderState
+    {
+        /// World position.
+        Vector3 position_;
+        /// World rotation.
+        Quaternion rotation_;
+        /// Color including brightness and temperature.
+        Color effectiveColor_;
+        /// Specular intensity including brightness.
+        float effectiveSpecularIntensity_{};
+        /// Range.
+        float range_{};
+        /// Spotlight field of view.
+        float fov_{};
+        /// Spotlight aspect ratio.
+        float aspectRatio_{};
+        /// Area light radius.
+        float radius_{};
+        /// Tube light length.
+        float length_{};
+        /// Distance from camera.
+        float distance_{};
+    };
+
     /// Light Component
     class MY3D_API Light : public Drawable
     {
@@ -140,6 +165,8 @@ namespace My3D
         void UpdateBatches(const FrameInfo& frame) override;
         /// Visualize the component as debug geometry.
         void DrawDebugGeometry(DebugRenderer* debug, bool depthTest) override;
+        /// Copy the state that rendering reads into a render state copy. Called during the update.
+        void CaptureRenderState(unsigned index) override;
 
         /// Set light type.
         void SetLightType(LightType type);
@@ -258,6 +285,8 @@ namespace My3D
 
         /// Return light queue. Called by View.
         LightBatchQueue* GetLightQueue() const { return lightQueue_; }
+        /// Return a light render state copy.
+        const LightRenderState& GetLightRenderState(unsigned index) const { return lightRenderStates_[index]; }
 
         /// Return a divisor value based on intensity for calculating the sort value.
         float GetIntensityDivisor(float attenuation = 1.0f) const
@@ -338,6 +367,8 @@ namespace My3D
         bool perVertex_;
         /// Use physical light values flag.
         bool usePhysicalValues_;
+        /// Light render state copies.
+        LightRenderState lightRenderStates_[NUM_RENDER_STATES];
     };
 
     inline bool CompareLights(Light* lhs, Light* rhs)
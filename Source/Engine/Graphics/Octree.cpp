@@ -6,6 +6,7 @@
 #include "Graphics/Octree.h"
 #include "Core/Context.h"
 #include "Core/CoreEvents.h"
+#include "Core/Profiler.h"
 #include "Core/Timer.h"
 #include "Core/Thread.h"
 #include "Core/WorkQueue.h"
@@ -19,21 +20,7 @@ namespace My3D
 {
     static const float DEFAULT_OCTREE_SIZE = 1000.0f;
     static const int DEFAULT_OCTREE_LEVELS = 8;
-
-    void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex)
-    {
-        const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-        auto** start = reinterpret_cast<Drawable**>(item->start_);
-        auto** end = reinterpret_cast<Drawable**>(item->end_);
-
-        while (start != end)
-        {
-            Drawable* drawable = *start;
-            if (drawable)
-                drawable->Update(frame);
-            ++start;
-        }
-    }
+    static const unsigned DRAWABLE_UPDATE_GRAIN = 16;
 
     inline bool CompareRayQueryResults(const RayQueryResult& lhs, const RayQueryResult& rhs)
     {
@@ -270,7 +257,7 @@ namespace My3D
         // If the engine is running headless, subscribe to RenderUpdate events for manually updating the octree
         // to allow raycasts and animation update
         if (!GetSubsystem<Graphics>())
-            SubscribeToEvent(E_RENDERUPDATE, MY3D_HANDLER(Octree, HandleRenderUpdate));
+            SubscribeToEvent(&Octree::HandleRenderUpdate);
     }
 
     Octree::~Octree()
@@ -299,6 +286,8 @@ namespace My3D
             return;
         }
 
+        MY3D_PROFILE("UpdateOctree");
+
         // Let drawables update themselves before reinsertion. This can be used for animation
         if (!drawableUpdates_.Empty())
         {
@@ -308,31 +297,16 @@ namespace My3D
             auto* queue = GetSubsystem<WorkQueue>();
             scene->BeginThreadedUpdate();
 
-            int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-            int drawablesPerItem = Max((int)(drawableUpdates_.Size() / numWorkItems), 1);
-
-            PODVector<Drawable*>::Iterator start = drawableUpdates_.Begin();
-
-            // Create a work item for each thread
-            for (int i = 0; i < numWorkItems; ++i)
+            queue->ParallelFor(0, drawableUpdates_.Size(), DRAWABLE_UPDATE_GRAIN, [this, &frame](unsigned begin, unsigned end, unsigned)
             {
-                SharedPtr<WorkItem> item = queue->GetFreeItem();
-                item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ = UpdateDrawablesWork;
-                item->aux_ = const_cast<FrameInfo*>(&frame);
-
-                PODVector<Drawable*>::Iterator end = drawableUpdates_.End();
-                if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                    end = start + drawablesPerItem;
-
-                item->start_ = &(*start);
-                item->end_ = &(*end);
-                queue->AddWorkItem(item);
-
-                start = end;
-            }
+                for (unsigned i = begin; i < end; ++i)
+                {
+                    Drawable* drawable = drawableUpdates_[i];
+                    if (drawable)
+                        drawable->Update(frame);
+                }
+            });
 
-            queue->Complete(M_MAX_UNSIGNED);
             scene->EndThreadedUpdate();
         }
 
@@ -490,19 +464,18 @@ namespace My3D
         drawable->updateQueued_ = false;
     }
 
-    void Octree::HandleRenderUpdate(StringHash eventType, VariantMap &eventData)
+    void Octree::HandleRenderUpdate(const RenderUpdate::Payload& data)
     {
         // When running in headless mode, update the Octree manually during the RenderUpdate event
         Scene* scene = GetScene();
         if (!scene || !scene->IsUpdateEnabled())
             return;
 
-        using namespace RenderUpdate;
-
         FrameInfo frame;
         frame.frameNumber_ = GetSubsystem<Time>()->GetFrameNumber();
-        frame.timeStep_ = eventData[P_TIMESTEP].GetFloat();
+        frame.timeStep_ = data.timeStep_;
         frame.camera_ = nullptr;
+        frame.renderStateIndex_ = frame.frameNumber_ % NUM_RENDER_STATES;
 
         Update(frame);
     }
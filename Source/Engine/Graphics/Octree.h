@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "Core/CoreEvents.h"
 #include "Core/Mutex.h"
 #include "Graphics/Drawable.h"
 #include "Graphics/OctreeQuery.h"
@@ -163,7 +164,7 @@ namespace My3D
 
     private:
         /// Handle render update in case of headless execution.
-        void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+        void HandleRenderUpdate(const RenderUpdate::Payload& data);
         /// Update octree size.
         void UpdateOctreeSize() { SetSize(worldBoundingBox_, numLevels_); }
         /// Drawable objects that require update.
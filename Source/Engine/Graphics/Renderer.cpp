@@ -1136,6 +1136,7 @@ namespace My3D
         frame_.frameNumber_ = GetSubsystem<Time>()->GetFrameNumber();
         frame_.timeStep_ = timeStep;
         frame_.camera_ = nullptr;
+        frame_.renderStateIndex_ = frame_.frameNumber_ % NUM_RENDER_STATES;
         numShadowCameras_ = 0;
         numOcclusionBuffers_ = 0;
         updatedOctrees_.Clear();
@@ -1449,7 +1450,7 @@ namespace My3D
 
         initialized_ = true;
 
-        SubscribeToEvent(E_RENDERUPDATE, MY3D_HANDLER(Renderer, HandleRenderUpdate));
+        SubscribeToEvent(&Renderer::HandleRenderUpdate);
 
         MY3D_LOGINFO("Initialized renderer");
     }
@@ -1720,11 +1721,9 @@ namespace My3D
             resetViews_ = true;
     }
 
-    void Renderer::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+    void Renderer::HandleRenderUpdate(const RenderUpdate::Payload& data)
     {
-        using namespace RenderUpdate;
-
-        Update(eventData[P_TIMESTEP].GetFloat());
+        Update(data.timeStep_);
     }
 
     void Renderer::BlurShadowMap(View* view, Texture2D* shadowMap, float blurScale)
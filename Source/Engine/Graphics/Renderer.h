@@ -2,6 +2,7 @@
 // Created by luchu on 2022/2/3.
 //
 
+#include "Core/CoreEvents.h"
 #include "Core/Mutex.h"
 #include "Container/HashSet.h"
 #include "Graphics/Viewport.h"
@@ -400,7 +401,7 @@ namespace My3D
         /// Handle screen mode event.
         void HandleScreenMode(StringHash eventType, VariantMap& eventData);
         /// Handle render update event.
-        void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+        void HandleRenderUpdate(const RenderUpdate::Payload& data);
         /// Blur the shadow map.
         void BlurShadowMap(View* view, Texture2D* shadowMap, float blurScale);
 
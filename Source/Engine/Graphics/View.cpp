@@ -2,6 +2,7 @@
 // Created by luchu on 2022/2/25.
 //
 
+#include "Core/Profiler.h"
 #include "Core/WorkQueue.h"
 #include "Container/Sort.h"
 #include "Graphics/Camera.h"
@@ -28,6 +29,8 @@
 
 namespace My3D
 {
+    static const unsigned VISIBILITY_CHECK_GRAIN = 16;
+
     /// Frustum octree query for shadowcasters.
     class ShadowCasterOctreeQuery : public FrustumOctreeQuery
     {
@@ -128,11 +131,8 @@ namespace My3D
         OcclusionBuffer* buffer_;
     };
 
-    void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
+    void CheckVisibility(View* view, Drawable** start, Drawable** end, unsigned threadIndex)
     {
-        auto* view = reinterpret_cast<View*>(item->aux_);
-        auto** start = reinterpret_cast<Drawable**>(item->start_);
-        auto** end = reinterpret_cast<Drawable**>(item->end_);
         OcclusionBuffer* buffer = view->occlusionBuffer_;
         const Matrix3x4& viewMatrix = view->cullCamera_->GetView();
         Vector3 viewZ = Vector3(viewMatrix.m20_, viewMatrix.m21_, viewMatrix.m22_);
@@ -254,6 +254,7 @@ namespace My3D
         : Object(context)
         , graphics_(GetSubsystem<Graphics>())
         , renderer_(GetSubsystem<Renderer>())
+        , frameAllocator_(GetSubsystem<FrameAllocator>())
     {
         // Create octree query and scene results vector for each thread
         unsigned numThreads = GetSubsystem<WorkQueue>()->GetNumThreads() + 1; // Worker threads + main thread
@@ -484,10 +485,13 @@ namespace My3D
         if (sourceView_)
             return;
 
+        MY3D_PROFILE("UpdateView");
+
         frame_.camera_ = cullCamera_;
         frame_.timeStep_ = frame.timeStep_;
         frame_.frameNumber_ = frame.frameNumber_;
         frame_.viewSize_ = viewSize_;
+        frame_.renderStateIndex_ = frame.renderStateIndex_;
 
         using namespace BeginViewUpdate;
 
@@ -518,6 +522,7 @@ namespace My3D
 
         GetDrawables();
         GetBatches();
+        CaptureRenderState();
         renderer_->StorePreparedView(this, cullCamera_);
 
         SendViewEvent(E_ENDVIEWUPDATE);
@@ -658,22 +663,23 @@ namespace My3D
     {
         if (!camera)
             return;
-        Matrix3x4 cameraEffectiveTransform = camera->GetEffectiveWorldTransform();
+        const CameraRenderState& state = camera->GetRenderState(frame_.renderStateIndex_);
+        const Matrix3x4& cameraEffectiveTransform = state.effectiveWorldTransform_;
 
         graphics_->SetShaderParameter(VSP_CAMERAPOS, cameraEffectiveTransform.Translation());
         graphics_->SetShaderParameter(VSP_VIEWINV, cameraEffectiveTransform);
-        graphics_->SetShaderParameter(VSP_VIEW, camera->GetView());
+        graphics_->SetShaderParameter(VSP_VIEW, state.view_);
         graphics_->SetShaderParameter(PSP_CAMERAPOS, cameraEffectiveTransform.Translation());
 
-        float nearClip = camera->GetNearClip();
-        float farClip = camera->GetFarClip();
+        float nearClip = state.nearClip_;
+        float farClip = state.farClip_;
         graphics_->SetShaderParameter(VSP_NEARCLIP, nearClip);
         graphics_->SetShaderParameter(VSP_FARCLIP, farClip);
         graphics_->SetShaderParameter(PSP_NEARCLIP, nearClip);
         graphics_->SetShaderParameter(PSP_FARCLIP, farClip);
 
         Vector4 depthMode = Vector4::ZERO;
-        if (camera->IsOrthographic())
+        if (state.orthographic_)
         {
             depthMode.x_ = 1.0f;
 #ifdef MY3D_OPENGL
@@ -684,20 +690,18 @@ namespace My3D
 #endif
         }
         else
-            depthMode.w_ = 1.0f / camera->GetFarClip();
+            depthMode.w_ = 1.0f / farClip;
 
         graphics_->SetShaderParameter(VSP_DEPTHMODE, depthMode);
 
         Vector4 depthReconstruct
-                (farClip / (farClip - nearClip), -nearClip / (farClip - nearClip), camera->IsOrthographic() ? 1.0f : 0.0f,
-                 camera->IsOrthographic() ? 0.0f : 1.0f);
+                (farClip / (farClip - nearClip), -nearClip / (farClip - nearClip), state.orthographic_ ? 1.0f : 0.0f,
+                 state.orthographic_ ? 0.0f : 1.0f);
         graphics_->SetShaderParameter(PSP_DEPTHRECONSTRUCT, depthReconstruct);
 
-        Vector3 nearVector, farVector;
-        camera->GetFrustumSize(nearVector, farVector);
-        graphics_->SetShaderParameter(VSP_FRUSTUMSIZE, farVector);
+        graphics_->SetShaderParameter(VSP_FRUSTUMSIZE, state.farFrustumSize_);
 
-        Matrix4 projection = camera->GetGPUProjection();
+        Matrix4 projection = state.gpuProjection_;
 #ifdef MY3D_OPENGL
         // Add constant depth bias manually to the projection matrix due to glPolygonOffset() inconsistency
         float constantBias = 2.0f * graphics_->GetDepthConstantBias();
@@ -705,7 +709,7 @@ namespace My3D
         projection.m23_ += projection.m33_ * constantBias;
 #endif
 
-        graphics_->SetShaderParameter(VSP_VIEWPROJ, projection * camera->GetView());
+        graphics_->SetShaderParameter(VSP_VIEWPROJ, projection * state.view_);
 
         // If in a scene pass and the command defines shader parameters, set them now
         if (passCommand_)
@@ -877,30 +881,11 @@ namespace My3D
                 result.maxZ_ = 0.0f;
             }
 
-            int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-            int drawablesPerItem = tempDrawables.Size() / numWorkItems;
-
-            PODVector<Drawable*>::Iterator start = tempDrawables.Begin();
-            // Create a work item for each thread
-            for (int i = 0; i < numWorkItems; ++i)
+            Drawable** drawables = tempDrawables.Buffer();
+            queue->ParallelFor(0, tempDrawables.Size(), VISIBILITY_CHECK_GRAIN, [this, drawables](unsigned begin, unsigned end, unsigned threadIndex)
             {
-                SharedPtr<WorkItem> item = queue->GetFreeItem();
-                item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ = CheckVisibilityWork;
-                item->aux_ = this;
-
-                PODVector<Drawable*>::Iterator end = tempDrawables.End();
-                if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                    end = start + drawablesPerItem;
-
-                item->start_ = &(*start);
-                item->end_ = &(*end);
-                queue->AddWorkItem(item);
-
-                start = end;
-            }
-
-            queue->Complete(M_MAX_UNSIGNED);
+                CheckVisibility(this, drawables + begin, drawables + end, threadIndex);
+            });
         }
 
         // Combine lights, geometries & scene Z range from the threads
@@ -957,6 +942,30 @@ namespace My3D
         GetBaseBatches();
     }
 
+    void View::CaptureRenderState()
+    {
+        // Geometries captured their state in UpdateBatches. Capture the cameras and lights the batches refer to, so that
+        // the view renders from the same state even if the scene moves on
+        unsigned index = frame_.renderStateIndex_;
+        if (camera_)
+            camera_->CaptureRenderState(index);
+        if (cullCamera_ && cullCamera_ != camera_)
+            cullCamera_->CaptureRenderState(index);
+
+        for (unsigned i = 0; i < lights_.Size(); ++i)
+            lights_[i]->CaptureRenderState(index);
+
+        for (unsigned i = 0; i < lightQueues_.Size(); ++i)
+        {
+            Vector<ShadowBatchQueue>& shadowSplits = lightQueues_[i].shadowSplits_;
+            for (unsigned j = 0; j < shadowSplits.Size(); ++j)
+            {
+                if (shadowSplits[j].shadowCamera_)
+                    shadowSplits[j].shadowCamera_->CaptureRenderState(index);
+            }
+        }
+    }
+
     void View::ProcessLights()
     {
         // Process lit geometries and shadow casters for each light
@@ -972,6 +981,8 @@ namespace My3D
 
             LightQueryResult& query = lightQueryResults_[i];
             query.light_ = lights_[i];
+            query.litGeometries_.SetAllocator(frameAllocator_);
+            query.shadowCasters_.SetAllocator(frameAllocator_);
 
             item->start_ = &query;
             queue->AddWorkItem(item);
@@ -1145,7 +1156,7 @@ namespace My3D
             for (auto drawable : maxLightsDrawables_)
             {
                 drawable->LimitLights();
-                const PODVector<Light*>& lights = drawable->GetLights();
+                const LightList& lights = drawable->GetLights();
 
                 for (auto light : lights)
                 {
@@ -1204,7 +1215,7 @@ namespace My3D
 
                     if (info.vertexLights_)
                     {
-                        const PODVector<Light*>& drawableVertexLights = drawable->GetVertexLights();
+                        const LightList& drawableVertexLights = drawable->GetVertexLights();
                         if (drawableVertexLights.Size() && !vertexLightsProcessed)
                         {
                             // Limit vertex lights. If this is a deferred opaque batch, remove converted per-pixel lights,
@@ -2291,6 +2302,7 @@ namespace My3D
                 // Create a new group based on the batch
                 // In case the group remains below the instancing limit, do not enable instancing shaders yet
                 BatchGroup newGroup(batch);
+                newGroup.instances_.SetAllocator(frameAllocator_);
                 newGroup.geometryType_ = GEOM_STATIC;
                 renderer_->SetBatchShaders(newGroup, tech, allowShadows, queue);
                 newGroup.CalculateSortKey();
@@ -34,10 +34,10 @@ namespace My3D
     {
         /// Light.
         Light* light_;
-        /// Lit geometries.
-        PODVector<Drawable*> litGeometries_;
-        /// Shadow casters.
-        PODVector<Drawable*> shadowCasters_;
+        /// Lit geometries. Allocated from the frame allocator of the worker thread that processes the light.
+        FramePODVector<Drawable*> litGeometries_;
+        /// Shadow casters. Allocated from the frame allocator of the worker thread that processes the light.
+        FramePODVector<Drawable*> shadowCasters_;
         /// Shadow cameras.
         Camera* shadowCameras_[MAX_LIGHT_SPLITS];
         /// Shadow caster start indices.
@@ -87,7 +87,7 @@ namespace My3D
     /// Internal structure for 3D rendering work. Created for each backbuffer and texture viewport, but not for shadow cameras.
     class MY3D_API View : public Object
     {
-        friend void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex);
+        friend void CheckVisibility(View* view, Drawable** start, Drawable** end, unsigned threadIndex);
         friend void ProcessLightWork(const WorkItem* item, unsigned threadIndex);
 
         MY3D_OBJECT(View, Object)
@@ -178,6 +178,8 @@ namespace My3D
         void GetDrawables();
         /// Construct batches from the drawable objects.
         void GetBatches();
+        /// Capture the render state of the cameras and lights used by the batches.
+        void CaptureRenderState();
         /// Get lit geometries and shadowcasters for visible lights.
         void ProcessLights();
         /// Get batches from lit geometries and shadowcasters.
@@ -276,10 +278,10 @@ namespace My3D
         }
 
         /// Return hash code for a vertex light queue.
-        unsigned long long GetVertexLightQueueHash(const PODVector<Light*>& vertexLights)
+        unsigned long long GetVertexLightQueueHash(const LightList& vertexLights)
         {
             unsigned long long hash = 0;
-            for (PODVector<Light*>::ConstIterator i = vertexLights.Begin(); i != vertexLights.End(); ++i)
+            for (LightList::ConstIterator i = vertexLights.Begin(); i != vertexLights.End(); ++i)
                 hash += (unsigned long long)(*i);
             return hash;
         }
@@ -288,6 +290,8 @@ namespace My3D
         WeakPtr<Graphics> graphics_;
         /// Renderer subsystem.
         WeakPtr<Renderer> renderer_;
+        /// Frame allocator subsystem. Null if not registered, in which case per-frame vectors use the heap.
+        WeakPtr<FrameAllocator> frameAllocator_;
         /// Scene to use.
         Scene* scene_{};
         /// Octree to use.
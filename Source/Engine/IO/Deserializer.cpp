@@ -284,6 +284,7 @@ namespace My3D
     {
         VariantMap ret;
         unsigned num = ReadVLE();
+        ret.Reserve(num);
 
         for (unsigned i = 0; i < num; ++i)
         {
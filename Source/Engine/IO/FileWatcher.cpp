@@ -3,6 +3,7 @@
 //
 
 #include "IO/FileWatcher.h"
+#include "Core/Profiler.h"
 #include "IO/File.h"
 #include "IO/Log.h"
 #include "IO/FileSystem.h"
@@ -30,6 +31,8 @@ namespace My3D
         , delay_(1.0f)
         , watchSubDirs_(false)
     {
+        SetName("File watcher");
+        SetPriority(PRIORITY_LOW);
     }
 
     FileWatcher::~FileWatcher()
@@ -221,6 +224,8 @@ namespace My3D
 
     void FileWatcher::AddChange(const String& fileName)
     {
+        MY3D_PROFILE("AddFileChange");
+
         MutexLock lock(changesMutex_);
 
         // Reset the timer associated with the filename. Will be notified once timer exceeds the delay
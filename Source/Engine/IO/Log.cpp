@@ -24,8 +24,15 @@ const char* logLevelPrefixes[] =
     nullptr
 };
 
+/// Log message posted from another thread.
+MY3D_EVENT(E_THREADLOGMESSAGE, ThreadLogMessage)
+{
+    MY3D_PARAM(P_MESSAGE, Message);     // String
+    MY3D_PARAM(P_LEVEL, Level);         // int, LOG_RAW for raw messages
+    MY3D_PARAM(P_ERROR, Error);         // bool, error flag for raw messages
+}
+
 static Log* logInstance = nullptr;
-static bool threadErrorDisplayed = false;
 
 Log::Log(Context *context)
     : Base(context)
@@ -39,7 +46,7 @@ Log::Log(Context *context)
     , quiet_(false)
 {
     logInstance = this;
-    SubscribeToEvent(E_ENDFRAME, MY3D_HANDLER(Log, HandleEndFrame));
+    SubscribeToEvent(this, E_THREADLOGMESSAGE, MY3D_HANDLER(Log, HandleThreadLogMessage));
 }
 
 Log::~Log()
@@ -113,15 +120,10 @@ void Log::Write(int level, const String &message)
     if (level < LOG_TRACE || level >= LOG_NONE)
         return;
 
-    // If not in the main thread, store message for later processing
+    // If not in the main thread, post message for later processing
     if (!Thread::IsMainThread())
     {
-        if (logInstance)
-        {
-            MutexLock lock(logInstance->logMutex_);
-            logInstance->threadMessages_.Push(StoredLogMessage(message, level, false));
-        }
-
+        PostThreadMessage(message, level, false);
         return;
     }
     // Do not log if message level excluded or if currently sending a log event
@@ -154,15 +156,10 @@ void Log::Write(int level, const String &message)
 
 void Log::WriteRaw(const String &message, bool error)
 {
-    // If not in the main thread, store message for later processing
+    // If not in the main thread, post message for later processing
     if (!Thread::IsMainThread())
     {
-        if (logInstance)
-        {
-            MutexLock lock(logInstance->logMutex_);
-            logInstance->threadMessages_.Push(StoredLogMessage(message, LOG_RAW, error));
-        }
-
+        PostThreadMessage(message, LOG_RAW, error);
         return;
     }
     // Prevent recursion during log event
@@ -202,33 +199,30 @@ void Log::WriteFormat(int level, const char *format, ...)
     Write(level, message);
 }
 
-void Log::HandleEndFrame(StringHash eventType, VariantMap &eventData)
+void Log::PostThreadMessage(const String& message, int level, bool error)
 {
-    // If the MainThreadID is not valid, processing this loop can potentially be endless
-    if (!Thread::IsMainThread())
-    {
-        if (!threadErrorDisplayed)
-        {
-            fprintf(stderr, "Thread::mainThreadID is not setup correctly! Threaded log handling disabled\n");
-            threadErrorDisplayed = true;
-        }
+    Log* log = logInstance;
+    if (!log || (level != LOG_RAW && log->level_ > level))
         return;
-    }
 
-    MutexLock lock(logMutex_);
+    using namespace ThreadLogMessage;
 
-    // Process messages accumulated from other threads (if any)
-    while (!threadMessages_.Empty())
-    {
-        const StoredLogMessage& stored = threadMessages_.Front();
+    VariantMap eventData;
+    eventData[P_MESSAGE] = message;
+    eventData[P_LEVEL] = level;
+    eventData[P_ERROR] = error;
+    log->PostEvent(E_THREADLOGMESSAGE, eventData);
+}
 
-        if (stored.level_ != LOG_RAW)
-            Write(stored.level_, stored.message_);
-        else
-            WriteRaw(stored.message_, stored.error_);
+void Log::HandleThreadLogMessage(StringHash /*eventType*/, VariantMap& eventData)
+{
+    using namespace ThreadLogMessage;
 
-        threadMessages_.PopFront();
-    }
+    int level = eventData[P_LEVEL].GetInt();
+    if (level != LOG_RAW)
+        Write(level, eventData[P_MESSAGE].GetString());
+    else
+        WriteRaw(eventData[P_MESSAGE].GetString(), eventData[P_ERROR].GetBool());
 }
 
 void Log::SendLogEvent(const String& message, int level)
@@ -4,9 +4,7 @@
 
 #pragma once
 
-#include "Container/List.h"
 #include "Core/Object.h"
-#include "Core/Mutex.h"
 #include "Core/StringUtils.h"
 
 
@@ -30,28 +28,6 @@ static const int LOG_NONE = 5;
 
 class File;
 
-/// Stored log message from another thread.
-struct StoredLogMessage
-{
-    /// Construct undefined.
-    StoredLogMessage() = default;
-
-    /// Construct with parameters.
-    StoredLogMessage(const String& message, int level, bool error)
-        : message_(message)
-        , level_(level)
-        , error_(error)
-    {
-    }
-
-    /// Message text.
-    String message_;
-    /// Message level. -1 for raw messages.
-    int level_{};
-    /// Error flag for raw messages.
-    bool error_{};
-};
-
 class MY3D_API Log : public Object
 {
     MY3D_OBJECT(Log, Object)
@@ -93,12 +69,10 @@ private:
     /// Send logging event
     static void SendLogEvent(const String& message, int level);
 
-    /// Handle end of frame. Process the threaded log messages.
-    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
-    /// Mutex for threaded operation.
-    Mutex logMutex_;
-    /// Log messages from other threads.
-    List<StoredLogMessage> threadMessages_;
+    /// Post a message from another thread to be written in the main thread.
+    static void PostThreadMessage(const String& message, int level, bool error);
+    /// Handle a message posted from another thread.
+    void HandleThreadLogMessage(StringHash eventType, VariantMap& eventData);
     /// Log file.
     SharedPtr<File> logFile_;
     /// Last log message
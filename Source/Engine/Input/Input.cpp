@@ -387,7 +387,7 @@ namespace My3D
         {
             using namespace SDLRawInput;
 
-            VariantMap eventData = GetEventDataMap();
+            VariantMap& eventData = GetEventDataMap();
             eventData[P_SDLEVENT] = &evt;
             eventData[P_CONSUMED] = false;
             SendEvent(E_SDLRAWINPUT, eventData);
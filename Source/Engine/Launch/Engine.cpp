@@ -4,6 +4,9 @@
 
 #include "Launch/Engine.h"
 #include "Core/Context.h"
+#include "Core/FrameAllocator.h"
+#include "Core/FramePipeline.h"
+#include "Core/Profiler.h"
 #include "IO/Log.h"
 #include "Core/StringUtils.h"
 #include "Core/Timer.h"
@@ -25,6 +28,16 @@ namespace My3D
 {
 extern const char* logLevelPrefixes[];
 
+/// Worker thread affinity names for the engine parameter.
+static const char* workerAffinityNames[] =
+{
+    "None",
+    "Core",
+    "Cache",
+    "NUMA",
+    nullptr
+};
+
 Engine::Engine(Context *context)
     : Base(context)
     , timeStep_(0.0f)
@@ -32,6 +45,7 @@ Engine::Engine(Context *context)
     , minFps_(10)
     , maxFps_(200)
     , maxInactiveFps_(60)
+    , adaptiveFramePacing_(true)
     , pauseMinimized_(false)
     , autoExit_(true)
     , initialized_(false)
@@ -43,7 +57,13 @@ Engine::Engine(Context *context)
     context_->RegisterSubsystem<Log>();
 #endif
     context_->RegisterSubsystem<Time>();
+#ifdef MY3D_PROFILING
+    context_->RegisterSubsystem<Profiler>();
+    context_->RegisterSubsystem<TraceRecorder>();
+#endif
     context_->RegisterSubsystem<WorkQueue>();
+    context_->RegisterSubsystem<FrameAllocator>();
+    context_->RegisterSubsystem<FramePipeline>();
     context_->RegisterSubsystem<Input>();
     context_->RegisterSubsystem<FileSystem>();
     context_->RegisterSubsystem<ResourceCache>();
@@ -75,15 +95,41 @@ bool Engine::Initialize(const VariantMap& parameters)
 
     GetSubsystem<Time>()->SetTimerPeriod(1);
 
+#ifdef MY3D_PROFILING
+    // Configure automatic trace dumps of slow frames
+    auto* traceRecorder = GetSubsystem<TraceRecorder>();
+    if (traceRecorder && HasParameter(parameters, EP_TRACE_DUMP_THRESHOLD))
+    {
+        traceRecorder->SetAutoDump(
+            (long long)(GetParameter(parameters, EP_TRACE_DUMP_THRESHOLD).GetFloat() * 1000.0f),
+            GetParameter(parameters, EP_TRACE_DUMP_FRAMES, 300).GetUInt(),
+            GetParameter(parameters, EP_TRACE_FILE, "Trace.json").GetString()
+        );
+    }
+#endif
+
+    // Configure before which event the events posted from other threads are sent, e.g. "BeginFrame" or "Update"
+    if (HasParameter(parameters, EP_POSTED_EVENTS_FLUSH))
+        context_->SetPostedEventsFlush(GetParameter(parameters, EP_POSTED_EVENTS_FLUSH).GetString());
+
     // Configure max FPS
     if (!GetParameter(parameters, EP_FRAME_LIMITER, false).GetBool())
         SetMaxFps(0);
-
-    // Set amount of worker threads according to the available physical CPU cores.
-    unsigned numThreads = GetNumPhysicalCPUs() - 1;
+    SetAdaptiveFramePacing(GetParameter(parameters, EP_ADAPTIVE_FRAME_PACING, true).GetBool());
+    SetPipelinedRendering(GetParameter(parameters, EP_PIPELINED_RENDERING, false).GetBool());
+
+    // Set amount of worker threads according to the available physical CPU cores, unless given
+    const CPUTopology& topology = GetCPUTopology();
+    MY3D_LOGINFOF("Detected %u logical CPUs in %u cores, %u cache groups and %u NUMA nodes", topology.cpus_.Size(),
+        topology.numCores_, topology.numCacheGroups_, topology.numNumaNodes_);
+    unsigned numThreads = GetParameter(parameters, EP_WORKER_THREADS, GetNumPhysicalCPUs() - 1).GetUInt();
     if (numThreads)
     {
-        GetSubsystem<WorkQueue>()->CreateThreads(numThreads);
+        auto* workQueue = GetSubsystem<WorkQueue>();
+        workQueue->SetWorkStealing(GetParameter(parameters, EP_WORK_STEALING, false).GetBool());
+        workQueue->SetWorkerAffinity((WorkerAffinity)GetStringListIndex(
+            GetParameter(parameters, EP_WORKER_AFFINITY, "None").GetString().CString(), workerAffinityNames, WORKER_AFFINITY_NONE));
+        workQueue->CreateThreads(numThreads);
         MY3D_LOGINFOF("Created %u worker thread%s", numThreads, numThreads > 1 ? "s" : "");
     }
 
@@ -151,18 +197,38 @@ void Engine::RunFrame()
 
     auto* time = GetSubsystem<Time>();
     time->BeginFrame(timeStep_);
+    GetSubsystem<FramePipeline>()->BeginFrame(time->GetFrameNumber());
 
-    Update();
-
-    Render();
-    ApplyFrameLimit();
+    {
+        MY3D_PROFILE("RunFrame");
+        Update();
+        time->MarkFramePhase(FRAME_PHASE_UPDATE);
+        Render();
+        time->MarkFramePhase(FRAME_PHASE_RENDER);
+        ApplyFrameLimit();
+        time->MarkFramePhase(FRAME_PHASE_SLEEP);
+    }
 
     time->EndFrame();
 }
 
 void Engine::Render()
 {
+    MY3D_PROFILE("Render");
+
+    // In pipelined mode this only waits for the previous frame's packet, and the render thread executes this one while the
+    // next frame updates
+    GetSubsystem<FramePipeline>()->Submit();
+}
 
+void Engine::SetPipelinedRendering(bool enable)
+{
+    GetSubsystem<FramePipeline>()->SetPipelined(enable);
+}
+
+bool Engine::GetPipelinedRendering() const
+{
+    return GetSubsystem<FramePipeline>()->IsPipelined();
 }
 
 void Engine::ApplyFrameLimit()
@@ -170,23 +236,34 @@ void Engine::ApplyFrameLimit()
     if (!initialized_)
         return;
 
+    MY3D_PROFILE("ApplyFrameLimit");
+
     unsigned maxFps = maxFps_;
 
     long long elapsed = 0;
     if (maxFps)
     {
         long long targetMax = 1000000LL / maxFps;
-        for (;;)
+        if (adaptiveFramePacing_)
+            framePacer_.Wait(frameTimer_, targetMax);
+        else
         {
-            elapsed = frameTimer_.GetUSec(false);
-            if (elapsed >= targetMax)
-                break;
-            // Sleep if 1 ms or more off the frame limiting goal
-            if (targetMax - elapsed >= 1000LL)
+            bool waited = false;
+            for (;;)
             {
-                auto sleepTime = static_cast<unsigned>((targetMax - elapsed) / 1000LL);
-                Time::Sleep(sleepTime);
+                elapsed = frameTimer_.GetUSec(false);
+                if (elapsed >= targetMax)
+                    break;
+                waited = true;
+                // Sleep if 1 ms or more off the frame limiting goal
+                if (targetMax - elapsed >= 1000LL)
+                {
+                    auto sleepTime = static_cast<unsigned>((targetMax - elapsed) / 1000LL);
+                    Time::Sleep(sleepTime);
+                }
             }
+            if (waited)
+                framePacer_.RecordFrame(elapsed, targetMax);
         }
     }
 
@@ -220,6 +297,8 @@ void Engine::Exit()
 
 void Engine::Update()
 {
+    MY3D_PROFILE("Update");
+
     using namespace Update;
 
     // Logic update event
@@ -231,7 +310,7 @@ void Engine::Update()
     SendEvent(E_POSTUPDATE, eventData);
 
     // Rendering update event
-    SendEvent(E_RENDERUPDATE, eventData);
+    SendEvent(RenderUpdate::Payload{timeStep_});
 
     // Post-render update event
     SendEvent(E_POSTRENDERUPDATE, eventData);
@@ -244,6 +323,8 @@ void Engine::HandleExitRequested(StringHash eventType, VariantMap &eventData)
 
 void Engine::DoExit()
 {
+    // Finish the frame the render thread may still be executing
+    GetSubsystem<FramePipeline>()->Flush();
     exiting_ = true;
 }
 
@@ -32,6 +32,12 @@ public:
     void SetMaxFps(unsigned fps) { maxFps_ = Max(0u, fps); }
     /// Set maximum frames per second when the application does not have input focus.
     void SetMaxInactiveFps(unsigned fps) { maxInactiveFps_ = Max(0u, fps); }
+    /// Set whether the frame limiter learns the sleep overshoot and spins only briefly, instead of sleeping in whole
+    /// milliseconds and spinning for the rest.
+    void SetAdaptiveFramePacing(bool enable) { adaptiveFramePacing_ = enable; }
+    /// Set whether the frame packet is executed on the render thread while the next frame updates, instead of right
+    /// after the update. Call between frames.
+    void SetPipelinedRendering(bool enable);
     /// Set how many frames to average for timestep smoothing. Default is 2. 1 disables smoothing.
     void SetTimeStepSmoothing(unsigned frames) { timeStepSmoothing_ = Clamp(frames, 1u, 20u); }
     /// Set whether to exit automatically on exit request (window close button).
@@ -46,6 +52,12 @@ public:
     unsigned GetMaxFps() const { return maxFps_; }
     /// Return the maximum frames per second when the application does not have input focus.
     unsigned GetMaxInactiveFps() const { return maxInactiveFps_; }
+    /// Return whether adaptive frame pacing is used.
+    bool GetAdaptiveFramePacing() const { return adaptiveFramePacing_; }
+    /// Return the frame pacer, which holds the frame limiter statistics.
+    FramePacer& GetFramePacer() { return framePacer_; }
+    /// Return whether pipelined rendering is enabled.
+    bool GetPipelinedRendering() const;
     /// Return how many frames to average for timestep smoothing
     unsigned GetTimeStepSmoothing() const { return timeStepSmoothing_; }
     /// Return whether to exit automatically on exit request
@@ -56,7 +68,7 @@ public:
     bool IsExiting() const { return exiting_; }
     /// Send frame update events
     void Update();
-    /// Render after frame update
+    /// Render after frame update. Submits the frame packet for execution.
     void Render();
     /// Get the timestep for the next frame and sleep for frame limiting if necessary
     void ApplyFrameLimit();
@@ -77,6 +89,8 @@ private:
 
     /// Frame update timer
     HiresTimer frameTimer_;
+    /// Frame limiter and its statistics
+    FramePacer framePacer_;
     /// Previous timesteps for smoothing
     PODVector<float> lastTimeSteps_;
     /// Next frame timestep in seconds
@@ -89,6 +103,8 @@ private:
     unsigned minFps_;
     /// Maximum frames per second when the application does not have input focus
     unsigned maxInactiveFps_;
+    /// Adaptive frame pacing flag
+    bool adaptiveFramePacing_;
     /// Pause when minimized flag
     bool pauseMinimized_;
     /// Auto-exit flag
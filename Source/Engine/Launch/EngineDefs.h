@@ -38,5 +38,22 @@ namespace My3D
 
     // Frame Limit
     static const String EP_FRAME_LIMITER = "FrameLimiter";
+    static const String EP_ADAPTIVE_FRAME_PACING = "AdaptiveFramePacing";
+
+    // Rendering
+    static const String EP_PIPELINED_RENDERING = "PipelinedRendering";
+
+    // Work Queue
+    static const String EP_WORK_STEALING = "WorkStealing";
+    static const String EP_WORKER_THREADS = "WorkerThreads";
+    static const String EP_WORKER_AFFINITY = "WorkerAffinity";
+
+    // Events
+    static const String EP_POSTED_EVENTS_FLUSH = "PostedEventsFlush";
+
+    // Trace
+    static const String EP_TRACE_DUMP_THRESHOLD = "TraceDumpThreshold";
+    static const String EP_TRACE_DUMP_FRAMES = "TraceDumpFrames";
+    static const String EP_TRACE_FILE = "TraceFile";
 }
 
@@ -3,6 +3,7 @@
 //
 
 #include "Core/Context.h"
+#include "Core/Profiler.h"
 #include "Resource/ResourceCache.h"
 #include "Resource/BackgroundLoader.h"
 #include "IO/Log.h"
@@ -14,11 +15,21 @@ namespace My3D
     BackgroundLoader::BackgroundLoader(ResourceCache *owner)
         : owner_(owner)
     {
+        SetName("Background loader");
+        // Run at lower priority, so that the thread does not compete with frame work
+        SetPriority(PRIORITY_LOW);
     }
 
     BackgroundLoader::~BackgroundLoader()
     {
-        MutexLock lock(backgroundLoadMutex_);
+        // Wake the loader thread if it is waiting for work, and stop it before the conditions are destroyed
+        {
+            MutexLock lock(backgroundLoadMutex_);
+            shouldRun_ = false;
+            queueCondition_.NotifyAll();
+        }
+
+        Stop();
     }
 
     void BackgroundLoader::ThreadFunction()
@@ -38,9 +49,10 @@ namespace My3D
 
             if (i == backgroundLoadQueue_.End())
             {
-                // No resource to load found
+                // No resource to load found, block until one is queued or the loader is stopped
+                if (shouldRun_)
+                    queueCondition_.Wait(backgroundLoadMutex_);
                 backgroundLoadMutex_.Release();
-                Time::Sleep(5);
             }
             else
             {
@@ -55,6 +67,7 @@ namespace My3D
                 SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
                 if (file)
                 {
+                    MY3D_PROFILE("BeginLoadResource");
                     success = resource->BeginLoad(*file);
                 }
                 // Process dependencies now
@@ -74,6 +87,7 @@ namespace My3D
                 }
 
                 resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
+                loadedCondition_.NotifyAll();
                 backgroundLoadMutex_.Release();
             }
         }
@@ -132,6 +146,8 @@ namespace My3D
                 MY3D_LOGWARNING("Resource " + caller->GetName() + " requested for a background loaded resource but was not in the background load queue");
         }
 
+        queueCondition_.NotifyOne();
+
         // Start the background loader thread now
         if (!IsStarted())
             Run();
@@ -147,12 +163,12 @@ namespace My3D
         HashMap<Pair<StringHash, StringHash>, BackgroundLoadItem>::Iterator i = backgroundLoadQueue_.Find(key);
         if (i != backgroundLoadQueue_.End())
         {
-            backgroundLoadMutex_.Release();
             {
                 Resource* resource = i->second_.resource_;
                 HiresTimer waitTimer;
                 bool didWait = false;
 
+                // The loader thread changes the load state and dependencies under the mutex and notifies after each change
                 for (;;)
                 {
                     unsigned numDeps = i->second_.dependencies_.Size();
@@ -160,12 +176,14 @@ namespace My3D
                     if (numDeps > 0 || state == ASYNC_QUEUED || state == ASYNC_LOADING)
                     {
                         didWait = true;
-                        Time::Sleep(1);
+                        loadedCondition_.Wait(backgroundLoadMutex_);
                     }
                     else
                         break;
                 }
 
+                backgroundLoadMutex_.Release();
+
                 if (didWait)
                     MY3D_LOGDEBUG("Waited " + String(waitTimer.GetUSec(false) / 1000) + " ms for background loaded resource " + resource->GetName());
             }
@@ -230,6 +248,7 @@ namespace My3D
         if (success)
         {
             MY3D_LOGDEBUG("Finishing background loaded resource " + resource->GetName());
+            MY3D_PROFILE("FinishLoadResource");
             success = resource->EndLoad();
         }
 
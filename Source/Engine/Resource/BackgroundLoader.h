@@ -8,6 +8,7 @@
 #include "Container/HashSet.h"
 #include "Container/RefCounted.h"
 #include "Container/Ptr.h"
+#include "Core/ConditionVariable.h"
 #include "Core/Mutex.h"
 #include "Core/StringHash.h"
 #include "Core/Thread.h"
@@ -37,7 +38,7 @@ class BackgroundLoader : public RefCounted, public Thread
 public:
     /// Construct.
     explicit BackgroundLoader(ResourceCache* owner);
-    /// Destruct. Forcibly clear the load queue.
+    /// Destruct. Stop the loader thread and forcibly clear the load queue.
     ~BackgroundLoader() override;
     /// Resource background loading loop.
     void ThreadFunction() override;
@@ -58,6 +59,10 @@ private:
     ResourceCache* owner_;
     /// Mutex for thread-safe access to the background load queue.
     mutable Mutex backgroundLoadMutex_;
+    /// Condition for waking the loader thread when a resource is queued.
+    ConditionVariable queueCondition_;
+    /// Condition for waking threads waiting for a resource to finish its background loading.
+    ConditionVariable loadedCondition_;
     /// Resource that are queued for background loading
     HashMap<Pair<StringHash, StringHash>, BackgroundLoadItem> backgroundLoadQueue_;
 };
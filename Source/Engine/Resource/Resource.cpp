@@ -3,6 +3,7 @@
 //
 
 #include "Resource/Resource.h"
+#include "Core/Profiler.h"
 #include "IO/Log.h"
 #include "IO/File.h"
 #include "Resource/XMLElement.h"
@@ -21,6 +22,8 @@ namespace My3D
 
     bool Resource::Load(Deserializer &source)
     {
+        MY3D_PROFILE("LoadResource");
+
         // If we are loading synchronously in a non-main thread, behave as if async loading (for example use
         // GetTempResource() instead of GetResource() to load resource dependencies)
         SetAsyncLoadState(Thread::IsMainThread() ? ASYNC_DONE : ASYNC_LOADING);
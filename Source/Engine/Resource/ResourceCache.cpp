@@ -38,18 +38,21 @@ namespace My3D
 
     static const SharedPtr<Resource> noResource;
 
+    /// Resource routing flag to prevent endless recursion. Per thread, as routers may run concurrently.
+    static thread_local bool isRouting = false;
+
     ResourceCache::ResourceCache(Context *context)
         : Object(context)
         , autoReloadResources_(false)
         , returnFailedResources_(false)
         , searchPackagesFirst_(true)
-        , isRouting_(false)
         , finishBackgroundResourcesMs_(5)
     {
         // Register Resource library object factories
         RegisterResourceLibrary(context_);
         // Create resource background loader. Its thread will start on the first background request
         backgroundLoader_ = new BackgroundLoader(this);
+        searchPaths_ = new ResourceSearchPaths();
         // Subscribe BeginFrame for handling directory watchers and background loaded resource finalization
         SubscribeToEvent(E_BEGINFRAME, MY3D_HANDLER(ResourceCache, HandleBeginFrame));
     }
@@ -61,8 +64,6 @@ namespace My3D
 
     bool ResourceCache::AddResourceDir(const String &pathName, unsigned int priority)
     {
-        MutexLock lock(resourceMutex_);
-
         auto* fileSystem = GetSubsystem<FileSystem>();
         if (!fileSystem || !fileSystem->DirExists(pathName))
         {
@@ -73,17 +74,23 @@ namespace My3D
         // Convert path to absolut
         String fixedPath = SanitateResourceDirName(pathName);
 
-        // Check that the same path does not already exist
-        for (unsigned i = 0; i < resourceDirs_.Size(); ++i)
+        // Logging sends an event, so the lock is released before logging or starting a file watcher
         {
-            if (!resourceDirs_[i].Compare(fixedPath, false))
-                return true;
-        }
+            WriteLock lock(resourceMutex_);
 
-        if (priority < resourceDirs_.Size())
-            resourceDirs_.Insert(priority, fixedPath);
-        else
-            resourceDirs_.Push(fixedPath);
+            // Check that the same path does not already exist
+            for (unsigned i = 0; i < resourceDirs_.Size(); ++i)
+            {
+                if (!resourceDirs_[i].Compare(fixedPath, false))
+                    return true;
+            }
+
+            if (priority < resourceDirs_.Size())
+                resourceDirs_.Insert(priority, fixedPath);
+            else
+                resourceDirs_.Push(fixedPath);
+            UpdateSearchPaths();
+        }
 
         // If resource auto-reloading active, create a file watcher for the directory
         if (autoReloadResources_)
@@ -99,19 +106,21 @@ namespace My3D
 
     bool ResourceCache::AddPackageFile(PackageFile* package, unsigned priority)
     {
-        MutexLock lock(resourceMutex_);
-
         // Do not add packages that failed to load
         if (!package || !package->GetNumFiles())
         {
-            MY3D_LOGERRORF("Could not add package file %s due to load failure", package->GetName().CString());
+            MY3D_LOGERRORF("Could not add package file %s due to load failure", package ? package->GetName().CString() : "");
             return false;
         }
 
-        if (priority < packages_.Size())
-            packages_.Insert(priority, SharedPtr<PackageFile>(package));
-        else
-            packages_.Push(SharedPtr<PackageFile>(package));
+        {
+            WriteLock lock(resourceMutex_);
+            if (priority < packages_.Size())
+                packages_.Insert(priority, SharedPtr<PackageFile>(package));
+            else
+                packages_.Push(SharedPtr<PackageFile>(package));
+            UpdateSearchPaths();
+        }
 
         MY3D_LOGINFO("Added resource package " + package->GetName());
         return true;
@@ -145,41 +154,51 @@ namespace My3D
 
     void ResourceCache::RemoveResourceDir(const String &pathName)
     {
-        MutexLock lock(resourceMutex_);
-
         String fixedPath = SanitateResourceDirName(pathName);
 
-        for (unsigned i = 0; i < resourceDirs_.Size(); ++i)
         {
-            if (!resourceDirs_[i].Compare(fixedPath, false))
-            {
-                resourceDirs_.Erase(i);
-                // Remove the filewatcher with the matching path
-                for (unsigned j = 0; j < fileWatchers_.Size(); ++j)
-                {
-                    if (!fileWatchers_[j]->GetPath().Compare(fixedPath, false))
-                    {
-                        fileWatchers_.Erase(j);
-                        break;
-                    }
-                }
-                MY3D_LOGINFO("Removed resource path " + fixedPath);
+            WriteLock lock(resourceMutex_);
+            unsigned i = 0;
+            while (i < resourceDirs_.Size() && resourceDirs_[i].Compare(fixedPath, false))
+                ++i;
+            if (i == resourceDirs_.Size())
                 return;
+            resourceDirs_.Erase(i);
+            UpdateSearchPaths();
+        }
+
+        // Remove the filewatcher with the matching path. Stopping it logs, so this is done without the lock
+        for (unsigned j = 0; j < fileWatchers_.Size(); ++j)
+        {
+            if (!fileWatchers_[j]->GetPath().Compare(fixedPath, false))
+            {
+                fileWatchers_.Erase(j);
+                break;
             }
         }
+        MY3D_LOGINFO("Removed resource path " + fixedPath);
     }
 
     SharedPtr<File> ResourceCache::GetFile(const String &name, bool sendEventOnFailure)
     {
-        MutexLock lock(resourceMutex_);
+        // Routers and event handlers may add resource paths or look up files, so they run without the lock
+        SharedPtr<ResourceSearchPaths> paths;
+        String sanitatedName;
+        {
+            ReadLock lock(resourceMutex_);
+            paths = searchPaths_;
+            sanitatedName = SanitateResourceName(name);
+        }
+        const Vector<SharedPtr<ResourceRouter> >& routers = paths->routers_;
+        const Vector<String>& resourceDirs = paths->resourceDirs_;
+        const Vector<SharedPtr<PackageFile> >& packages = paths->packages_;
 
-        String sanitatedName = SanitateResourceName(name);
-        if (!isRouting_)
+        if (!isRouting)
         {
-            isRouting_ = true;
-            for (unsigned i = 0; i < resourceRouters_.Size(); ++i)
-                resourceRouters_[i]->Route(sanitatedName, RESOURCE_GETFILE);
-            isRouting_ = false;
+            isRouting = true;
+            for (unsigned i = 0; i < routers.Size(); ++i)
+                routers[i]->Route(sanitatedName, RESOURCE_GETFILE);
+            isRouting = false;
         }
 
         if (sanitatedName.Length())
@@ -187,15 +206,15 @@ namespace My3D
             File* file = nullptr;
             if (searchPackagesFirst_)
             {
-                file = SearchPackages(sanitatedName);
+                file = SearchPackages(packages, sanitatedName);
                 if (!file)
-                    file = SearchResourceDirs(sanitatedName);
+                    file = SearchResourceDirs(resourceDirs, sanitatedName);
             }
             else
             {
-                file = SearchResourceDirs(sanitatedName);
+                file = SearchResourceDirs(resourceDirs, sanitatedName);
                 if (!file)
-                    file = SearchPackages(sanitatedName);
+                    file = SearchPackages(packages, sanitatedName);
             }
 
             if (file)
@@ -204,7 +223,7 @@ namespace My3D
 
         if (sendEventOnFailure)
         {
-            if (resourceRouters_.Size() && sanitatedName.Empty() && !name.Empty())
+            if (routers.Size() && sanitatedName.Empty() && !name.Empty())
                 MY3D_LOGERROR("Resource request " + name + " was blocked");
             else
                 MY3D_LOGERROR("Could not find resource " + sanitatedName);
@@ -310,30 +329,39 @@ namespace My3D
 
     bool ResourceCache::Exists(const String& name) const
     {
-        MutexLock lock(resourceMutex_);
+        // Routers may look up files, so they run without the lock
+        SharedPtr<ResourceSearchPaths> paths;
+        String sanitatedName;
+        {
+            ReadLock lock(resourceMutex_);
+            paths = searchPaths_;
+            sanitatedName = SanitateResourceName(name);
+        }
+        const Vector<SharedPtr<ResourceRouter> >& routers = paths->routers_;
+        const Vector<String>& resourceDirs = paths->resourceDirs_;
+        const Vector<SharedPtr<PackageFile> >& packages = paths->packages_;
 
-        String sanitatedName = SanitateResourceName(name);
-        if (!isRouting_)
+        if (!isRouting)
         {
-            isRouting_ = true;
-            for (unsigned i = 0; i < resourceRouters_.Size(); ++i)
-                resourceRouters_[i]->Route(sanitatedName, RESOURCE_CHECKEXISTS);
-            isRouting_ = false;
+            isRouting = true;
+            for (unsigned i = 0; i < routers.Size(); ++i)
+                routers[i]->Route(sanitatedName, RESOURCE_CHECKEXISTS);
+            isRouting = false;
         }
 
         if (sanitatedName.Empty())
             return false;
 
-        for (unsigned i = 0; i < packages_.Size(); ++i)
+        for (unsigned i = 0; i < packages.Size(); ++i)
         {
-            if (packages_[i]->Exists(sanitatedName))
+            if (packages[i]->Exists(sanitatedName))
                 return true;
         }
 
         auto* fileSystem = GetSubsystem<FileSystem>();
-        for (unsigned i = 0; i < resourceDirs_.Size(); ++i)
+        for (unsigned i = 0; i < resourceDirs.Size(); ++i)
         {
-            if (fileSystem->FileExists(resourceDirs_[i] + sanitatedName))
+            if (fileSystem->FileExists(resourceDirs[i] + sanitatedName))
                 return true;
         }
 
@@ -651,6 +679,8 @@ namespace My3D
 
     void ResourceCache::AddResourceRouter(ResourceRouter* router, bool addAsFirst)
     {
+        WriteLock lock(resourceMutex_);
+
         // Check for duplicate
         for (unsigned i = 0; i < resourceRouters_.Size(); ++i)
         {
@@ -662,15 +692,19 @@ namespace My3D
             resourceRouters_.Insert(0, SharedPtr<ResourceRouter>(router));
         else
             resourceRouters_.Push(SharedPtr<ResourceRouter>(router));
+        UpdateSearchPaths();
     }
 
     void ResourceCache::RemoveResourceRouter(ResourceRouter* router)
     {
+        WriteLock lock(resourceMutex_);
+
         for (unsigned i = 0; i < resourceRouters_.Size(); ++i)
         {
             if (resourceRouters_[i] == router)
             {
                 resourceRouters_.Erase(i);
+                UpdateSearchPaths();
                 return;
             }
         }
@@ -724,7 +758,7 @@ namespace My3D
         if (!resource)
             return;
 
-        MutexLock lock(resourceMutex_);
+        WriteLock lock(resourceMutex_);
 
         StringHash nameHash(resource->GetName());
         HashSet<StringHash>& dependents = dependentResources_[dependency];
@@ -736,7 +770,7 @@ namespace My3D
         if (!resource)
             return;
 
-        MutexLock lock(resourceMutex_);
+        WriteLock lock(resourceMutex_);
 
         StringHash nameHash(resource->GetName());
 
@@ -768,7 +802,7 @@ namespace My3D
 
     const SharedPtr<Resource>& ResourceCache::FindResource(StringHash type, StringHash nameHash)
     {
-        MutexLock lock(resourceMutex_);
+        ReadLock lock(resourceMutex_);
 
         HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Find(type);
         if (i == resourceGroups_.End())
@@ -782,7 +816,7 @@ namespace My3D
 
     const SharedPtr<Resource>& ResourceCache::FindResource(StringHash nameHash)
     {
-        MutexLock lock(resourceMutex_);
+        ReadLock lock(resourceMutex_);
 
         for (HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Begin(); i != resourceGroups_.End(); ++i)
         {
@@ -856,16 +890,26 @@ namespace My3D
         backgroundLoader_->FinishResources(finishBackgroundResourcesMs_);
     }
 
-    File *ResourceCache::SearchResourceDirs(const String &name)
+    void ResourceCache::UpdateSearchPaths()
+    {
+        // Lookups may still be using the previous copy, so publish a new one instead of modifying it
+        SharedPtr<ResourceSearchPaths> paths(new ResourceSearchPaths());
+        paths->resourceDirs_ = resourceDirs_;
+        paths->packages_ = packages_;
+        paths->routers_ = resourceRouters_;
+        searchPaths_ = paths;
+    }
+
+    File *ResourceCache::SearchResourceDirs(const Vector<String>& resourceDirs, const String &name)
     {
         auto* fileSystem = GetSubsystem<FileSystem>();
-        for (unsigned i = 0; i < resourceDirs_.Size(); ++i)
+        for (unsigned i = 0; i < resourceDirs.Size(); ++i)
         {
-            if (fileSystem->FileExists(resourceDirs_[i] + name))
+            if (fileSystem->FileExists(resourceDirs[i] + name))
             {
                 // Construct the file first with full path, then rename it to not contain the resource path,
                 // so that the file's sanitatedName can be used in further GetFile() calls (for example over the network)
-                File* file(new File(context_, resourceDirs_[i] + name));
+                File* file(new File(context_, resourceDirs[i] + name));
                 file->SetName(name);
                 return file;
             }
@@ -878,12 +922,12 @@ namespace My3D
         return nullptr;
     }
 
-    File *ResourceCache::SearchPackages(const String &name)
+    File *ResourceCache::SearchPackages(const Vector<SharedPtr<PackageFile> >& packages, const String &name)
     {
-        for (unsigned i = 0; i < packages_.Size(); ++i)
+        for (unsigned i = 0; i < packages.Size(); ++i)
         {
-            if (packages_[i]->Exists(name))
-                return new File(context_, packages_[i], name);
+            if (packages[i]->Exists(name))
+                return new File(context_, packages[i], name);
         }
 
         return nullptr;
@@ -56,9 +56,22 @@ namespace My3D
         }
 
         /// Process the resource request and optionally modify the resource name string. Empty name string means the resource is not found or not allowed.
+        /// May be called concurrently from several threads. The cache does not hold its lock, so the router may look up files.
         virtual void Route(String& name, ResourceRequest requestType) = 0;
     };
 
+    /// Resource directories, package files and routers used by file lookups. Not modified after it has been published, so that
+    /// lookups can use it without holding the lock.
+    struct ResourceSearchPaths : public RefCounted
+    {
+        /// Resource load directories.
+        Vector<String> resourceDirs_;
+        /// Package files.
+        Vector<SharedPtr<PackageFile> > packages_;
+        /// Resource routers.
+        Vector<SharedPtr<ResourceRouter> > routers_;
+    };
+
     /// Resource cache subsystem. Loads resources on demand and stores them for later access.
     class MY3D_API ResourceCache : public Object
     {
@@ -188,13 +201,17 @@ namespace My3D
         void UpdateResourceGroup(StringHash type);
         /// Handle begin frame event. Automatic resource reloads and the finalization of background loaded resources are processed here.
         void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
-        /// Search FileSystem for file.
-        File* SearchResourceDirs(const String& name);
-        /// Search resource packages for file.
-        File* SearchPackages(const String& name);
+        /// Publish a new copy of the search paths for file lookups. The lock must be held for writing.
+        void UpdateSearchPaths();
+        /// Search a copy of the resource directories for file.
+        File* SearchResourceDirs(const Vector<String>& resourceDirs, const String& name);
+        /// Search a copy of the resource packages for file.
+        File* SearchPackages(const Vector<SharedPtr<PackageFile> >& packages, const String& name);
 
-        /// Mutex for thread-safe access to the resource directories, resource packages and resource dependencies.
-        mutable Mutex resourceMutex_;
+        /// Reader-writer mutex for thread-safe access to the resource directories, resource packages and resource dependencies.
+        /// File lookups share it, so that the background loader and worker threads do not serialize on each other. It is not
+        /// recursive, so routers, event handlers and logging, which sends an event, must not be called while it is held.
+        mutable ReadWriteMutex resourceMutex_;
         /// Resources by type.
         HashMap<StringHash, ResourceGroup> resourceGroups_;
         /// Resource load directories.
@@ -209,14 +226,14 @@ namespace My3D
         SharedPtr<BackgroundLoader> backgroundLoader_;
         /// Resource routers.
         Vector<SharedPtr<ResourceRouter> > resourceRouters_;
+        /// Search paths published for file lookups.
+        SharedPtr<ResourceSearchPaths> searchPaths_;
         /// Automatic resource reloading flag.
         bool autoReloadResources_;
         /// Return failed resources flag.
         bool returnFailedResources_;
         /// Search priority flag.
         bool searchPackagesFirst_;
-        /// Resource routing flag to prevent endless recursion.
-        mutable bool isRouting_;
         /// How many milliseconds maximum per frame to spend on finishing background loaded resources.
         int finishBackgroundResourcesMs_;
     };
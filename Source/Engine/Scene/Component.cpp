@@ -163,20 +163,19 @@ namespace My3D
     void Component::OnAttributeAnimationAdded()
     {
         if (attributeAnimationInfos_.Size() == 1)
-            SubscribeToEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE, MY3D_HANDLER(Component, HandleAttributeAnimationUpdate));
+            SubscribeToEvent(&Component::HandleAttributeAnimationUpdate);
     }
 
     void Component::OnAttributeAnimationRemoved()
     {
         if (attributeAnimationInfos_.Empty())
-            UnsubscribeFromEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE);
+            UnsubscribeFromEvent(E_ATTRIBUTEANIMATIONUPDATE);
     }
 
-    void Component::HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData)
+    void Component::HandleAttributeAnimationUpdate(const AttributeAnimationUpdate::Payload& data)
     {
-        using namespace AttributeAnimationUpdate;
-
-        UpdateAttributeAnimations(eventData[P_TIMESTEP].GetFloat());
+        if (data.scene_ == GetScene())
+            UpdateAttributeAnimations(data.timeStep_);
     }
 
     Component* Component::GetFixedUpdateSource()
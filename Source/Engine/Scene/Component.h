@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Scene/Animatable.h"
+#include "Scene/SceneEvents.h"
 
 namespace My3D
 {
@@ -100,7 +101,7 @@ namespace My3D
         /// Set scene node. Called by Node when creating the component.
         void SetNode(Node* node);
         /// Handle scene attribute animation update event.
-        void HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData);
+        void HandleAttributeAnimationUpdate(const AttributeAnimationUpdate::Payload& data);
         /// Return a component from the scene root that sends out fixed update events (either PhysicsWorld or PhysicsWorld2D). Return null if neither exists.
         Component* GetFixedUpdateSource();
         /// Perform autoremove. Called by subclasses. Caller should keep a weak pointer to itself to check whether was actually removed, and return immediately without further member operations in that case.
@@ -0,0 +1,126 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#pragma once
+
+#ifdef MY3D_SCENE_SLOTMAP
+#include "Container/SlotMap.h"
+#else
+#include "Container/HashMap.h"
+#endif
+
+#include <cassert>
+
+
+namespace My3D
+{
+    /// Map from scene node or component IDs within a range to objects, and allocator of free IDs in that range. By default
+    /// a hash map, where allocating an ID probes for the next unused one. With MY3D_SCENE_SLOTMAP the IDs are slot indices of
+    /// a SlotMap offset by the first ID: lookup is array indexing and free IDs come from the free list, at the cost of memory
+    /// proportional to the highest ID in use.
+    template <class T> class IDRegistry
+    {
+    public:
+        /// Construct with the ID range.
+        IDRegistry(unsigned firstID, unsigned lastID)
+            : firstID_(firstID)
+            , lastID_(lastID)
+            , nextID_(firstID)
+        {
+        }
+
+        /// Return object by ID, or null if not registered.
+        T* Get(unsigned id) const
+        {
+#ifdef MY3D_SCENE_SLOTMAP
+            T* const* object = objects_.GetAt(id - firstID_);
+            return object ? *object : nullptr;
+#else
+            typename HashMap<unsigned, T*>::ConstIterator i = objects_.Find(id);
+            return i != objects_.End() ? i->second_ : nullptr;
+#endif
+        }
+        /// Register an object, replacing any object with the same ID.
+        void Set(unsigned id, T* object)
+        {
+            assert(id >= firstID_ && id <= lastID_);
+#ifdef MY3D_SCENE_SLOTMAP
+            objects_.EmplaceAt(id - firstID_, object);
+#else
+            objects_[id] = object;
+#endif
+        }
+        /// Unregister an object by ID.
+        void Erase(unsigned id)
+        {
+#ifdef MY3D_SCENE_SLOTMAP
+            objects_.EraseAt(id - firstID_);
+#else
+            objects_.Erase(id);
+#endif
+        }
+        /// Return a free ID. With the slot map the ID is reserved for a null object until set or erased, so that allocating
+        /// again before registering returns a different ID.
+        unsigned GetFreeID()
+        {
+#ifdef MY3D_SCENE_SLOTMAP
+            unsigned id = firstID_ + objects_.Insert(nullptr).index_;
+            assert(id <= lastID_);
+            return id;
+#else
+            for (;;)
+            {
+                unsigned ret = nextID_;
+                if (nextID_ < lastID_)
+                    ++nextID_;
+                else
+                    nextID_ = firstID_;
+
+                if (!objects_.Contains(ret))
+                    return ret;
+            }
+#endif
+        }
+        /// Restart ID allocation from the first ID.
+        void ResetFreeIDs()
+        {
+#ifdef MY3D_SCENE_SLOTMAP
+            objects_.ResetFreeList();
+#else
+            nextID_ = firstID_;
+#endif
+        }
+        /// Return all registered objects. Reserved IDs are not included.
+        PODVector<T*> GetObjects() const
+        {
+            PODVector<T*> ret;
+#ifdef MY3D_SCENE_SLOTMAP
+            for (T* object : objects_)
+            {
+                if (object)
+                    ret.Push(object);
+            }
+#else
+            for (typename HashMap<unsigned, T*>::ConstIterator i = objects_.Begin(); i != objects_.End(); ++i)
+                ret.Push(i->second_);
+#endif
+            return ret;
+        }
+
+    private:
+#ifdef MY3D_SCENE_SLOTMAP
+        /// Objects indexed by ID minus the first ID.
+        SlotMap<T*> objects_;
+#else
+        /// Objects by ID.
+        HashMap<unsigned, T*> objects_;
+#endif
+        /// First ID of the range.
+        unsigned firstID_;
+        /// Last ID of the range.
+        unsigned lastID_;
+        /// Next ID to try when allocating without the slot map.
+        unsigned nextID_;
+    };
+}
@@ -426,13 +426,13 @@ namespace My3D
     void Node::OnAttributeAnimationAdded()
     {
         if (attributeAnimationInfos_.Size() == 1)
-            SubscribeToEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE, MY3D_HANDLER(Node, HandleAttributeAnimationUpdate));
+            SubscribeToEvent(&Node::HandleAttributeAnimationUpdate);
     }
 
     void Node::OnAttributeAnimationRemoved()
     {
         if (attributeAnimationInfos_.Empty())
-            UnsubscribeFromEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE);
+            UnsubscribeFromEvent(E_ATTRIBUTEANIMATIONUPDATE);
     }
 
     Animatable* Node::FindAttributeAnimationTarget(const String& name, String& outName)
@@ -1459,7 +1459,10 @@ namespace My3D
 
     Node* Node::CreateChild(unsigned id, CreateMode mode, bool temporary)
     {
-        SharedPtr<Node> newNode(new Node(context_));
+        // Create through the factory if registered, which may reserve the node from a pool
+        SharedPtr<Node> newNode = context_->CreateObject<Node>();
+        if (!newNode)
+            newNode = new Node(context_);
         newNode->SetTemporary(temporary);
 
         // If zero ID specified, or the ID is already taken, let the scene assign
@@ -1650,10 +1653,9 @@ namespace My3D
         scale_ = scale;
     }
 
-    void Node::HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData)
+    void Node::HandleAttributeAnimationUpdate(const AttributeAnimationUpdate::Payload& data)
     {
-        using namespace AttributeAnimationUpdate;
-
-        UpdateAttributeAnimations(eventData[P_TIMESTEP].GetFloat());
+        if (data.scene_ == GetScene())
+            UpdateAttributeAnimations(data.timeStep_);
     }
 }
\ No newline at end of file
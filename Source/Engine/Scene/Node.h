@@ -7,6 +7,7 @@
 #include "IO/VectorBuffer.h"
 #include "Math/Matrix3x4.h"
 #include "Scene/Animatable.h"
+#include "Scene/SceneEvents.h"
 
 
 namespace My3D
@@ -414,7 +415,7 @@ namespace My3D
         /// Clone node recursively.
         Node* CloneRecursive(Node* parent, SceneResolver& resolver, CreateMode mode);
         /// Handle attribute animation update event.
-        void HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData);
+        void HandleAttributeAnimationUpdate(const AttributeAnimationUpdate::Payload& data);
         /// World-space transform matrix.
         mutable Matrix3x4 worldTransform_;
         /// World transform needs update flag.
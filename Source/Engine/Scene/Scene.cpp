@@ -4,6 +4,7 @@
 
 #include "Core/Context.h"
 #include "Core/CoreEvents.h"
+#include "Core/Profiler.h"
 #include "IO/Log.h"
 #include "IO/PackageFile.h"
 #include "Resource/ResourceCache.h"
@@ -25,10 +26,10 @@ namespace My3D
 
     Scene::Scene(Context *context)
         : Node(context)
-        , replicatedNodeID_(FIRST_REPLICATED_ID)
-        , replicatedComponentID_(FIRST_REPLICATED_ID)
-        , localNodeID_(FIRST_LOCAL_ID)
-        , localComponentID_(FIRST_LOCAL_ID)
+        , replicatedNodes_(FIRST_REPLICATED_ID, LAST_REPLICATED_ID)
+        , localNodes_(FIRST_LOCAL_ID, LAST_LOCAL_ID)
+        , replicatedComponents_(FIRST_REPLICATED_ID, LAST_REPLICATED_ID)
+        , localComponents_(FIRST_LOCAL_ID, LAST_LOCAL_ID)
         , checksum_(0)
         , timeScale_(1.0f)
         , elapsedTime_(0)
@@ -49,10 +50,10 @@ namespace My3D
         RemoveAllChildren();
 
         // Remove scene reference and owner from all nodes that still exist
-        for (HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
-            i->second_->ResetScene();
-        for (HashMap<unsigned, Node*>::Iterator i = localNodes_.Begin(); i != localNodes_.End(); ++i)
-            i->second_->ResetScene();
+        PODVector<Node*> nodes = replicatedNodes_.GetObjects();
+        nodes.Push(localNodes_.GetObjects());
+        for (PODVector<Node*>::Iterator i = nodes.Begin(); i != nodes.End(); ++i)
+            (*i)->ResetScene();
     }
 
     void Scene::RegisterObject(Context* context)
@@ -255,78 +256,24 @@ namespace My3D
         // Reset ID generators
         if (clearReplicated)
         {
-            replicatedNodeID_ = FIRST_REPLICATED_ID;
-            replicatedComponentID_ = FIRST_REPLICATED_ID;
+            replicatedNodes_.ResetFreeIDs();
+            replicatedComponents_.ResetFreeIDs();
         }
         if (clearLocal)
         {
-            localNodeID_ = FIRST_LOCAL_ID;
-            localComponentID_ = FIRST_LOCAL_ID;
+            localNodes_.ResetFreeIDs();
+            localComponents_.ResetFreeIDs();
         }
     }
 
     unsigned Scene::GetFreeNodeID(CreateMode mode)
     {
-        if (mode == REPLICATED)
-        {
-            for (;;)
-            {
-                unsigned ret = replicatedNodeID_;
-                if (replicatedNodeID_ < LAST_REPLICATED_ID)
-                    ++replicatedNodeID_;
-                else
-                    replicatedNodeID_ = FIRST_REPLICATED_ID;
-
-                if (!replicatedNodes_.Contains(ret))
-                    return ret;
-            }
-        }
-        else
-        {
-            for (;;)
-            {
-                unsigned ret = localNodeID_;
-                if (localNodeID_ < LAST_LOCAL_ID)
-                    ++localNodeID_;
-                else
-                    localNodeID_ = FIRST_LOCAL_ID;
-
-                if (!localNodes_.Contains(ret))
-                    return ret;
-            }
-        }
+        return mode == REPLICATED ? replicatedNodes_.GetFreeID() : localNodes_.GetFreeID();
     }
 
     unsigned Scene::GetFreeComponentID(CreateMode mode)
     {
-        if (mode == REPLICATED)
-        {
-            for (;;)
-            {
-                unsigned ret = replicatedComponentID_;
-                if (replicatedComponentID_ < LAST_REPLICATED_ID)
-                    ++replicatedComponentID_;
-                else
-                    replicatedComponentID_ = FIRST_REPLICATED_ID;
-
-                if (!replicatedComponents_.Contains(ret))
-                    return ret;
-            }
-        }
-        else
-        {
-            for (;;)
-            {
-                unsigned ret = localComponentID_;
-                if (localComponentID_ < LAST_LOCAL_ID)
-                    ++localComponentID_;
-                else
-                    localComponentID_ = FIRST_LOCAL_ID;
-
-                if (!localComponents_.Contains(ret))
-                    return ret;
-            }
-        }
+        return mode == REPLICATED ? replicatedComponents_.GetFreeID() : localComponents_.GetFreeID();
     }
 
     void Scene::NodeAdded(Node* node)
@@ -352,27 +299,27 @@ namespace My3D
         // If node with same ID exists, remove the scene reference from it and overwrite with the new node
         if (IsReplicatedID(id))
         {
-            HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Find(id);
-            if (i != replicatedNodes_.End() && i->second_ != node)
+            Node* existing = replicatedNodes_.Get(id);
+            if (existing && existing != node)
             {
                 MY3D_LOGWARNING("Overwriting node with ID " + String(id));
-                NodeRemoved(i->second_);
+                NodeRemoved(existing);
             }
 
-            replicatedNodes_[id] = node;
+            replicatedNodes_.Set(id, node);
 
             MarkNetworkUpdate(node);
             MarkReplicationDirty(node);
         }
         else
         {
-            HashMap<unsigned, Node*>::Iterator i = localNodes_.Find(id);
-            if (i != localNodes_.End() && i->second_ != node)
+            Node* existing = localNodes_.Get(id);
+            if (existing && existing != node)
             {
                 MY3D_LOGWARNING("Overwriting node with ID " + String(id));
-                NodeRemoved(i->second_);
+                NodeRemoved(existing);
             }
-            localNodes_[id] = node;
+            localNodes_.Set(id, node);
         }
 
         // Cache tag if already tagged.
@@ -451,25 +398,25 @@ namespace My3D
 
         if (IsReplicatedID(id))
         {
-            HashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Find(id);
-            if (i != replicatedComponents_.End() && i->second_ != component)
+            Component* existing = replicatedComponents_.Get(id);
+            if (existing && existing != component)
             {
                 MY3D_LOGWARNING("Overwriting component with ID " + String(id));
-                ComponentRemoved(i->second_);
+                ComponentRemoved(existing);
             }
 
-            replicatedComponents_[id] = component;
+            replicatedComponents_.Set(id, component);
         }
         else
         {
-            HashMap<unsigned, Component*>::Iterator i = localComponents_.Find(id);
-            if (i != localComponents_.End() && i->second_ != component)
+            Component* existing = localComponents_.Get(id);
+            if (existing && existing != component)
             {
                 MY3D_LOGWARNING("Overwriting component with ID " + String(id));
-                ComponentRemoved(i->second_);
+                ComponentRemoved(existing);
             }
 
-            localComponents_[id] = component;
+            localComponents_.Set(id, component);
         }
 
         component->OnSceneSet(this);
@@ -525,16 +472,7 @@ namespace My3D
 
     Node* Scene::GetNode(unsigned id) const
     {
-        if (IsReplicatedID(id))
-        {
-            HashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Find(id);
-            return i != replicatedNodes_.End() ? i->second_ : nullptr;
-        }
-        else
-        {
-            HashMap<unsigned, Node*>::ConstIterator i = localNodes_.Find(id);
-            return i != localNodes_.End() ? i->second_ : nullptr;
-        }
+        return IsReplicatedID(id) ? replicatedNodes_.Get(id) : localNodes_.Get(id);
     }
 
     bool Scene::GetNodesWithTag(PODVector<Node*>& dest, const String& tag) const
@@ -552,16 +490,7 @@ namespace My3D
 
     Component* Scene::GetComponent(unsigned id) const
     {
-        if (IsReplicatedID(id))
-        {
-            HashMap<unsigned, Component*>::ConstIterator i = replicatedComponents_.Find(id);
-            return i != replicatedComponents_.End() ? i->second_ : nullptr;
-        }
-        else
-        {
-            HashMap<unsigned, Component*>::ConstIterator i = localComponents_.Find(id);
-            return i != localComponents_.End() ? i->second_ : nullptr;
-        }
+        return IsReplicatedID(id) ? replicatedComponents_.Get(id) : localComponents_.Get(id);
     }
 
     void Scene::RegisterVar(const String& name)
@@ -579,8 +508,22 @@ namespace My3D
         varNames_.Clear();
     }
 
+    void SceneUpdate::Payload::ToVariantMap(VariantMap& eventData) const
+    {
+        eventData[P_SCENE] = scene_;
+        eventData[P_TIMESTEP] = timeStep_;
+    }
+
+    void AttributeAnimationUpdate::Payload::ToVariantMap(VariantMap& eventData) const
+    {
+        eventData[P_SCENE] = scene_;
+        eventData[P_TIMESTEP] = timeStep_;
+    }
+
     void Scene::Update(float timeStep)
     {
+        MY3D_PROFILE("UpdateScene");
+
         if (asyncLoading_)
         {
             UpdateAsyncLoading();
@@ -591,16 +534,16 @@ namespace My3D
 
         timeStep *= timeScale_;
 
-        using namespace SceneUpdate;
-        VariantMap& eventData = GetEventDataMap();
-        eventData[P_SCENE] = this;
-        eventData[P_TIMESTEP] = timeStep;
-
         // Update variable timestep logic
-        SendEvent(E_SCENEUPDATE, eventData);
+        SendEvent(SceneUpdate::Payload{this, timeStep});
 
         // Update scene attribute animation.
-        SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
+        SendEvent(AttributeAnimationUpdate::Payload{this, timeStep});
+
+        using namespace SceneSubsystemUpdate;
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_SCENE] = this;
+        eventData[P_TIMESTEP] = timeStep;
 
         // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
         SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
@@ -7,6 +7,7 @@
 #include "Container/HashSet.h"
 #include "Core/Mutex.h"
 #include "Resource/XMLElement.h"
+#include "Scene/IDRegistry.h"
 #include "Scene/Node.h"
 #include "Scene/SceneResolver.h"
 
@@ -248,13 +249,13 @@ namespace My3D
         void PreloadResourcesXML(const XMLElement& element);
 
         /// Replicated scene nodes by ID.
-        HashMap<unsigned, Node*> replicatedNodes_;
+        IDRegistry<Node> replicatedNodes_;
         /// Local scene nodes by ID.
-        HashMap<unsigned, Node*> localNodes_;
+        IDRegistry<Node> localNodes_;
         /// Replicated components by ID.
-        HashMap<unsigned, Component*> replicatedComponents_;
+        IDRegistry<Component> replicatedComponents_;
         /// Local components by ID.
-        HashMap<unsigned, Component*> localComponents_;
+        IDRegistry<Component> localComponents_;
         /// Cached tagged nodes by tag.
         HashMap<StringHash, PODVector<Node*> > taggedNodes_;
         /// Asynchronous loading progress.
@@ -277,14 +278,6 @@ namespace My3D
         Mutex sceneMutex_;
         /// Preallocated event data map for smoothing update events.
         VariantMap smoothingData_;
-        /// Next free non-local node ID.
-        unsigned replicatedNodeID_;
-        /// Next free non-local component ID.
-        unsigned replicatedComponentID_;
-        /// Next free local node ID.
-        unsigned localNodeID_;
-        /// Next free local component ID.
-        unsigned localComponentID_;
         /// Scene source file checksum.
         mutable unsigned checksum_;
         /// Maximum milliseconds per frame to spend on async scene loading.
@@ -8,11 +8,27 @@
 
 namespace My3D
 {
+    class Scene;
+
     /// Variable timestep scene update.
     MY3D_EVENT(E_SCENEUPDATE, SceneUpdate)
     {
         MY3D_PARAM(P_SCENE, Scene);                  // Scene pointer
         MY3D_PARAM(P_TIMESTEP, TimeStep);            // float
+
+        /// Typed payload.
+        struct MY3D_API Payload
+        {
+            MY3D_TYPED_EVENT(E_SCENEUPDATE)
+
+            /// Convert to event parameters.
+            void ToVariantMap(VariantMap& eventData) const;
+
+            /// Scene.
+            Scene* scene_;
+            /// Timestep.
+            float timeStep_;
+        };
     }
 
     /// Variable timestep scene post-update.
@@ -40,6 +56,20 @@ namespace My3D
     {
         MY3D_PARAM(P_SCENE, Scene);                  // Scene pointer
         MY3D_PARAM(P_TIMESTEP, TimeStep);            // float
+
+        /// Typed payload.
+        struct MY3D_API Payload
+        {
+            MY3D_TYPED_EVENT(E_ATTRIBUTEANIMATIONUPDATE)
+
+            /// Convert to event parameters.
+            void ToVariantMap(VariantMap& eventData) const;
+
+            /// Scene.
+            Scene* scene_;
+            /// Timestep.
+            float timeStep_;
+        };
     }
 
     /// Attribute animation added to object animation.
@@ -118,7 +118,7 @@ namespace My3D
                             }
                         }
 
-                        component->SetAttribute(j, newIDs);
+                        component->SetAttribute(j, std::move(newIDs));
                     }
                 }
             }
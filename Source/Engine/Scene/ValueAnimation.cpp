@@ -182,7 +182,7 @@ namespace My3D
         keyFrame.value_ = value;
 
         if (keyFrames_.Empty() || time > keyFrames_.Back().time_)
-            keyFrames_.Push(keyFrame);
+            keyFrames_.Push(std::move(keyFrame));
         else
         {
             for (unsigned i = 0; i < keyFrames_.Size(); ++i)
@@ -193,7 +193,7 @@ namespace My3D
 
                 if (time < keyFrames_[i].time_)
                 {
-                    keyFrames_.Insert(i, keyFrame);
+                    keyFrames_.Insert(i, std::move(keyFrame));
                     break;
                 }
             }
@@ -214,14 +214,14 @@ namespace My3D
         eventFrame.eventData_ = eventData;
 
         if (eventFrames_.Empty() || time >= eventFrames_.Back().time_)
-            eventFrames_.Push(eventFrame);
+            eventFrames_.Push(std::move(eventFrame));
         else
         {
             for (unsigned i = 0; i < eventFrames_.Size(); ++i)
             {
                 if (time < eventFrames_[i].time_)
                 {
-                    eventFrames_.Insert(i, eventFrame);
+                    eventFrames_.Insert(i, std::move(eventFrame));
                     break;
                 }
             }
@@ -0,0 +1,302 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "catch.hpp"
+
+#include "Container/HashMap.h"
+#include "Container/FlatHashMap.h"
+#include "Container/SmallVector.h"
+#include "Container/Sort.h"
+#include "Core/StringHash.h"
+#include "Core/Variant.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace My3D;
+
+/// Number of global operator new calls, used to count allocations made by the benchmarked code.
+static std::atomic<unsigned> allocationCount(0);
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+// Benchmarks are hidden from the default test run. Run them with: TestContainer [benchmark]
+
+namespace
+{
+    /// Build a set of distinct string hash keys, like event parameter or attribute names.
+    Vector<StringHash> MakeKeys(unsigned count, const char* prefix)
+    {
+        Vector<StringHash> keys;
+        keys.Reserve(count);
+        for (unsigned i = 0; i < count; ++i)
+            keys.Push(StringHash(String(prefix) + String(i)));
+        return keys;
+    }
+
+    template <typename MapType, typename ValueType> void BenchmarkMap(const char* name, unsigned count, const ValueType& value)
+    {
+        const Vector<StringHash> keys = MakeKeys(count, "Key");
+        const Vector<StringHash> missing = MakeKeys(count, "Missing");
+
+        MapType map;
+        for (unsigned i = 0; i < count; ++i)
+            map[keys[i]] = value;
+
+        BENCHMARK(String(name).Append(" insert ").Append(String(count)).CString())
+        {
+            MapType fresh;
+            for (unsigned i = 0; i < count; ++i)
+                fresh[keys[i]] = value;
+            return fresh.Size();
+        };
+
+        BENCHMARK(String(name).Append(" find hit ").Append(String(count)).CString())
+        {
+            unsigned found = 0;
+            for (unsigned i = 0; i < count; ++i)
+                found += map.Find(keys[i]) != map.End();
+            return found;
+        };
+
+        BENCHMARK(String(name).Append(" find miss ").Append(String(count)).CString())
+        {
+            unsigned found = 0;
+            for (unsigned i = 0; i < count; ++i)
+                found += map.Contains(missing[i]);
+            return found;
+        };
+
+        BENCHMARK(String(name).Append(" iterate ").Append(String(count)).CString())
+        {
+            unsigned hash = 0;
+            for (auto it = map.Begin(); it != map.End(); ++it)
+                hash += it->first_.Value();
+            return hash;
+        };
+    }
+}
+
+TEST_CASE("HashMap vs FlatHashMap StringHash to Variant", "[.][benchmark]")
+{
+    const Variant value(Vector3(1.0f, 2.0f, 3.0f));
+    for (unsigned count : {8u, 64u, 4096u})
+    {
+        BenchmarkMap<HashMap<StringHash, Variant> >("HashMap<StringHash, Variant>", count, value);
+        BenchmarkMap<FlatHashMap<StringHash, Variant> >("FlatHashMap<StringHash, Variant>", count, value);
+    }
+}
+
+TEST_CASE("HashMap vs FlatHashMap StringHash to pointer", "[.][benchmark]")
+{
+    static int target = 0;
+    void* value = &target;
+    for (unsigned count : {8u, 64u, 4096u})
+    {
+        BenchmarkMap<HashMap<StringHash, void*> >("HashMap<StringHash, void*>", count, value);
+        BenchmarkMap<FlatHashMap<StringHash, void*> >("FlatHashMap<StringHash, void*>", count, value);
+    }
+}
+
+namespace
+{
+    /// Look up resources by name the way ResourceCache does: build a String from the requested name, sanitate it and hash it.
+    unsigned LookupResources(const HashMap<StringHash, unsigned>& resources, const Vector<const char*>& names)
+    {
+        unsigned found = 0;
+        for (unsigned i = 0; i < names.Size(); ++i)
+        {
+            String name(names[i]);
+            name.Replace('\\', '/');
+            found += resources.Contains(StringHash(name));
+        }
+        return found;
+    }
+
+    void BenchmarkResourceLookup(const char* title, const Vector<String>& names)
+    {
+        HashMap<StringHash, unsigned> resources;
+        Vector<const char*> requests;
+        for (unsigned i = 0; i < names.Size(); ++i)
+        {
+            resources[StringHash(names[i])] = i;
+            requests.Push(names[i].CString());
+        }
+
+        unsigned before = allocationCount.load();
+        unsigned found = LookupResources(resources, requests);
+        unsigned allocations = allocationCount.load() - before;
+        REQUIRE(found == names.Size());
+        WARN(title << ": " << allocations << " allocations for " << names.Size() << " lookups");
+
+        BENCHMARK(title)
+        {
+            return LookupResources(resources, requests);
+        };
+    }
+}
+
+TEST_CASE("String resource name lookup", "[.][benchmark]")
+{
+    Vector<String> shortNames;
+    Vector<String> longNames;
+    for (unsigned i = 0; i < 256; ++i)
+    {
+        // Short names fit the inline buffer, long names need a heap buffer
+        shortNames.Push("Tex/" + String(i) + ".dds");
+        longNames.Push("Textures/Terrain/Detail" + String(i) + ".dds");
+    }
+
+    BenchmarkResourceLookup("short resource names", shortNames);
+    BenchmarkResourceLookup("long resource names", longNames);
+}
+
+namespace
+{
+    /// Build and sort a short temporary list, like the light lists gathered per drawable.
+    template <typename VectorType> unsigned BuildTemporary(unsigned count, unsigned seed)
+    {
+        VectorType vec;
+        for (unsigned i = 0; i < count; ++i)
+            vec.Push((seed + i * 7919u) & 0xffu);
+        Sort(vec.Begin(), vec.End());
+
+        unsigned sum = 0;
+        for (unsigned i = 0; i < vec.Size(); ++i)
+            sum += vec[i];
+        return sum;
+    }
+}
+
+TEST_CASE("PODVector vs SmallVector temporaries", "[.][benchmark]")
+{
+    for (unsigned count : {2u, 4u, 8u, 32u})
+    {
+        BENCHMARK(String("PODVector<unsigned> ").Append(String(count)).CString())
+        {
+            unsigned sum = 0;
+            for (unsigned seed = 0; seed < 1000; ++seed)
+                sum += BuildTemporary<PODVector<unsigned> >(count, seed);
+            return sum;
+        };
+
+        BENCHMARK(String("SmallVector<unsigned, 8> ").Append(String(count)).CString())
+        {
+            unsigned sum = 0;
+            for (unsigned seed = 0; seed < 1000; ++seed)
+                sum += BuildTemporary<SmallVector<unsigned, 8> >(count, seed);
+            return sum;
+        };
+    }
+}
+
+namespace
+{
+    /// Minimal stand-in for a render batch.
+    struct SortableBatch
+    {
+        unsigned long long sortKey_;
+        float distance_;
+        unsigned char renderOrder_;
+    };
+
+    bool CompareSortableBatches(SortableBatch* lhs, SortableBatch* rhs)
+    {
+        if (lhs->renderOrder_ != rhs->renderOrder_)
+            return lhs->renderOrder_ < rhs->renderOrder_;
+        else if (lhs->distance_ != rhs->distance_)
+            return lhs->distance_ < rhs->distance_;
+        else
+            return lhs->sortKey_ < rhs->sortKey_;
+    }
+}
+
+TEST_CASE("Sort vs RadixSort batch queues", "[.][benchmark]")
+{
+    for (unsigned count : {64u, 256u, 1024u, 4096u})
+    {
+        PODVector<SortableBatch> batches(count);
+        unsigned seed = count;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            batches[i].sortKey_ = ((unsigned long long)(seed >> 24u) << 32u) | (seed & 0xffffu);
+            batches[i].distance_ = (float)(seed % 10000u) * 0.01f;
+            batches[i].renderOrder_ = 128;
+        }
+
+        PODVector<SortableBatch*> source(count);
+        for (unsigned i = 0; i < count; ++i)
+            source[i] = &batches[i];
+        PODVector<SortableBatch*> sorted(count);
+        PODVector<unsigned char> scratch;
+
+        BENCHMARK(String("Sort with compare function ").Append(String(count)).CString())
+        {
+            memcpy(sorted.Buffer(), source.Buffer(), count * sizeof(SortableBatch*));
+            Sort(sorted.Begin(), sorted.End(), CompareSortableBatches);
+            return sorted.Front();
+        };
+
+        BENCHMARK(String("RadixSort two keys ").Append(String(count)).CString())
+        {
+            memcpy(sorted.Buffer(), source.Buffer(), count * sizeof(SortableBatch*));
+            RadixSort(sorted.Begin(), sorted.End(), [](const SortableBatch* batch) { return batch->sortKey_; }, scratch);
+            RadixSort(sorted.Begin(), sorted.End(), [](const SortableBatch* batch) {
+                return ((unsigned long long)batch->renderOrder_ << 32u) | RadixKey(batch->distance_); }, scratch);
+            return sorted.Front();
+        };
+
+        PODVector<float> distances(count);
+        for (unsigned i = 0; i < count; ++i)
+            distances[i] = batches[i].distance_;
+        PODVector<float> sortedDistances(count);
+
+        BENCHMARK(String("Sort floats ").Append(String(count)).CString())
+        {
+            memcpy(sortedDistances.Buffer(), distances.Buffer(), count * sizeof(float));
+            Sort(sortedDistances.Begin(), sortedDistances.End());
+            return sortedDistances.Front();
+        };
+
+        BENCHMARK(String("RadixSort floats ").Append(String(count)).CString())
+        {
+            memcpy(sortedDistances.Buffer(), distances.Buffer(), count * sizeof(float));
+            RadixSort(sortedDistances.Begin(), sortedDistances.End(), [](float value) { return value; }, scratch);
+            return sortedDistances.Front();
+        };
+    }
+}
@@ -5,11 +5,22 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include "Container/ConcurrentAllocator.h"
 #include "Container/List.h"
+#include "Container/Ptr.h"
 #include "Container/Vector.h"
 #include "Container/HashMap.h"
 #include "Container/HashSet.h"
+#include "Container/SlotMap.h"
+#include "Container/SmallVector.h"
+#include "Container/Sort.h"
+#include "Container/FlatHashMap.h"
+#include "Container/FlatMap.h"
+#include "Container/FlatHashSet.h"
 #include "Container/String.h"
+#include "Math/MathDefs.h"
+
+#include <thread>
 
 using namespace My3D;
 
@@ -40,6 +51,14 @@ TEST_CASE("pod vector testing", "[engine]")
     }
 
     REQUIRE(vec.Empty());
+
+    // Resizing with a value fills only the new elements
+    PODVector<unsigned> pod{1, 2};
+    pod.Resize(4, 7);
+    REQUIRE(pod.Size() == 4);
+    REQUIRE(pod[0] == 1);
+    REQUIRE(pod[1] == 2);
+    REQUIRE(pod[3] == 7);
 }
 
 TEST_CASE("vector testing", "[engine]")
@@ -75,6 +94,253 @@ TEST_CASE("hashset testing", "[engine]")
     REQUIRE(hashset.Empty());
 }
 
+TEST_CASE("flat hashmap testing", "[engine]")
+{
+    FlatHashMap<String, String> hashmap;
+    REQUIRE(hashmap.Empty());
+    REQUIRE(hashmap.Begin() == hashmap.End());
+    REQUIRE_FALSE(hashmap.Contains("one"));
+
+    hashmap.Populate("one", "ONE");
+    hashmap["two"] = "Two";
+    REQUIRE(hashmap.Contains("one"));
+    REQUIRE(hashmap.Contains("two"));
+
+    hashmap["one"] = "One";
+    REQUIRE(hashmap.Size() == 2);
+    REQUIRE(hashmap.Find("one")->second_ == "One");
+
+    FlatHashMap<int, int> numbers;
+    for (int i = 0; i < 1000; ++i)
+        numbers[i] = i * 2;
+    REQUIRE(numbers.Size() == 1000);
+
+    // Erase half the keys, leaving erased markers behind, then insert new ones into the freed slots
+    for (int i = 0; i < 1000; i += 2)
+        REQUIRE(numbers.Erase(i));
+    REQUIRE_FALSE(numbers.Erase(0));
+    for (int i = 1000; i < 1500; ++i)
+        numbers.Insert(MakePair(i, i * 2));
+    REQUIRE(numbers.Size() == 1000);
+
+    unsigned count = 0;
+    unsigned odd = 0;
+    for (auto it = numbers.Begin(); it != numbers.End(); ++it)
+    {
+        REQUIRE(it->second_ == it->first_ * 2);
+        if (it->first_ < 1000)
+            REQUIRE((it->first_ & 1) == 1);
+        odd += it->first_ & 1;
+        ++count;
+    }
+    REQUIRE(count == 1000);
+    REQUIRE(odd == 750);
+    REQUIRE(numbers.Keys().Size() == 1000);
+
+    int value = 0;
+    REQUIRE(numbers.TryGetValue(1499, value));
+    REQUIRE(value == 2998);
+    REQUIRE_FALSE(numbers.TryGetValue(998, value));
+
+    for (auto it = numbers.Begin(); it != numbers.End();)
+        it = numbers.Erase(it);
+    REQUIRE(numbers.Empty());
+
+    FlatHashMap<int, int> copy(numbers);
+    copy[1] = 1;
+    FlatHashMap<int, int> moved(std::move(copy));
+    REQUIRE(moved.Size() == 1);
+    REQUIRE(copy.Empty());
+    REQUIRE(moved != numbers);
+}
+
+TEST_CASE("flat hashset testing", "[engine]")
+{
+    FlatHashSet<String> hashset;
+    REQUIRE(hashset.Empty());
+
+    bool exists;
+    hashset.Insert("one", exists);
+    REQUIRE_FALSE(exists);
+    hashset.Insert("one", exists);
+    REQUIRE(exists);
+    REQUIRE(hashset.Size() == 1);
+
+    FlatHashSet<void*> pointers;
+    for (size_t i = 1; i <= 100; ++i)
+        pointers.Insert(reinterpret_cast<void*>(i * 16));
+    REQUIRE(pointers.Size() == 100);
+    REQUIRE(pointers.Contains(reinterpret_cast<void*>(1600)));
+    REQUIRE_FALSE(pointers.Contains(reinterpret_cast<void*>(8)));
+
+    pointers.Clear();
+    REQUIRE(pointers.Empty());
+    REQUIRE(pointers.Begin() == pointers.End());
+}
+
+TEST_CASE("flat map testing", "[engine]")
+{
+    FlatMap<String, String> map;
+    REQUIRE(map.Empty());
+    REQUIRE(map.Begin() == map.End());
+    REQUIRE(map["missing"].Empty());
+    REQUIRE(map.Erase("missing"));
+
+    map.Populate("two", "TWO", "one", "ONE");
+    map["three"] = "Three";
+    map["one"] = "One";
+    REQUIRE(map.Size() == 3);
+    REQUIRE(map.Find("one")->second_ == "One");
+    REQUIRE(*static_cast<const FlatMap<String, String>&>(map)["two"] == "TWO");
+    REQUIRE(static_cast<const FlatMap<String, String>&>(map)["four"] == nullptr);
+
+    // Iteration is in insertion order
+    REQUIRE(map.Front().first_ == "two");
+    REQUIRE(map.Back().first_ == "three");
+
+    // Grow the table many times, then erase every other pair so that the following pairs move down
+    FlatMap<int, int> numbers;
+    for (int i = 999; i >= 0; --i)
+        numbers[i] = i * 2;
+    REQUIRE(numbers.Size() == 1000);
+    for (int i = 0; i < 1000; i += 2)
+        REQUIRE(numbers.Erase(i));
+    REQUIRE_FALSE(numbers.Erase(0));
+    numbers.Insert(MakePair(1000, 2000));
+    REQUIRE(numbers.Size() == 501);
+
+    REQUIRE(numbers.Back().first_ == 1000);
+    int previous = 1001;
+    for (auto it = numbers.Begin(); it != numbers.End() - 1; ++it)
+    {
+        REQUIRE(it->first_ < previous);
+        REQUIRE(it->second_ == it->first_ * 2);
+        previous = it->first_;
+    }
+
+    int value = 0;
+    REQUIRE(numbers.TryGetValue(999, value));
+    REQUIRE(value == 1998);
+    REQUIRE_FALSE(numbers.TryGetValue(998, value));
+    REQUIRE(numbers.Contains(1000));
+
+    FlatMap<int, int> copy(numbers);
+    REQUIRE(copy == numbers);
+    copy[1] = 0;
+    REQUIRE(copy != numbers);
+    FlatMap<int, int> moved(std::move(copy));
+    REQUIRE(copy.Empty());
+    REQUIRE(moved.Size() == 501);
+
+    // Clearing keeps the buffer for reuse
+    unsigned capacity = moved.Capacity();
+    moved.Clear();
+    REQUIRE(moved.Empty());
+    REQUIRE(moved.Capacity() == capacity);
+    for (auto it = numbers.Begin(); it != numbers.End();)
+        it = numbers.Erase(it);
+    REQUIRE(numbers.Empty());
+}
+
+TEST_CASE("concurrent allocator testing", "[engine]")
+{
+    struct Payload
+    {
+        explicit Payload(unsigned value) : value_(value) { }
+        unsigned value_;
+        unsigned padding_[3];
+    };
+
+    ConcurrentAllocator<Payload> allocator(64, 16);
+    ConcurrentAllocatorStats stats = allocator.GetStats();
+    REQUIRE(stats.capacity_ == 64);
+    REQUIRE(stats.liveNodes_ == 0);
+
+    Payload* first = allocator.Reserve(1u);
+    Payload* second = allocator.Reserve(2u);
+    REQUIRE(first != second);
+    REQUIRE(first->value_ == 1);
+    REQUIRE(second->value_ == 2);
+    REQUIRE(allocator.GetStats().liveNodes_ == 2);
+    allocator.Free(first);
+    allocator.Free(second);
+    REQUIRE(allocator.GetStats().liveNodes_ == 0);
+
+    // Reserve on worker threads, free half of the objects on another thread
+    const unsigned numThreads = 4;
+    const unsigned numObjects = 2000;
+    PODVector<Payload*> objects[numThreads];
+    std::thread threads[numThreads];
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        threads[t] = std::thread([&allocator, &objects, t, numObjects]()
+        {
+            for (unsigned i = 0; i < numObjects; ++i)
+                objects[t].Push(allocator.Reserve(t * numObjects + i));
+        });
+    }
+    for (unsigned t = 0; t < numThreads; ++t)
+        threads[t].join();
+
+    stats = allocator.GetStats();
+    REQUIRE(stats.liveNodes_ == numThreads * numObjects);
+    REQUIRE(stats.peakNodes_ >= numThreads * numObjects);
+    REQUIRE(stats.capacity_ >= numThreads * numObjects);
+
+    HashSet<Payload*> unique;
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        for (unsigned i = 0; i < numObjects; ++i)
+        {
+            REQUIRE(objects[t][i]->value_ == t * numObjects + i);
+            unique.Insert(objects[t][i]);
+        }
+    }
+    REQUIRE(unique.Size() == numThreads * numObjects);
+
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        threads[t] = std::thread([&allocator, &objects, t, numThreads, numObjects]()
+        {
+            PODVector<Payload*>& own = objects[(t + 1) % numThreads];
+            for (unsigned i = 0; i < numObjects / 2; ++i)
+                allocator.Free(own[i]);
+            allocator.FlushThread();
+        });
+    }
+    for (unsigned t = 0; t < numThreads; ++t)
+        threads[t].join();
+
+    REQUIRE(allocator.GetStats().liveNodes_ == numThreads * numObjects / 2);
+
+    // Freed nodes are reused before growing
+    unsigned capacity = allocator.GetStats().capacity_;
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        for (unsigned i = 0; i < numObjects / 2; ++i)
+            objects[t][i] = allocator.Reserve(i);
+    }
+    REQUIRE(allocator.GetStats().capacity_ == capacity);
+
+    // Blocks are reclaimed once all of their nodes are free
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        for (unsigned i = 0; i < numObjects; ++i)
+            allocator.Free(objects[t][i]);
+    }
+    REQUIRE(allocator.GetStats().liveNodes_ == 0);
+    unsigned blocks = allocator.GetStats().blocks_;
+    REQUIRE(allocator.Reclaim() == blocks);
+    stats = allocator.GetStats();
+    REQUIRE(stats.blocks_ == 0);
+    REQUIRE(stats.capacity_ == 0);
+
+    Payload* last = allocator.Reserve(3u);
+    REQUIRE(last->value_ == 3);
+    REQUIRE(allocator.GetStats().blocks_ == 1);
+    allocator.Free(last);
+}
+
 TEST_CASE("list testing", "[engine]")
 {
     List<int> list;
@@ -108,3 +374,465 @@ TEST_CASE("string testing", "[engine]")
     WString ws(wstr);
     REQUIRE(ws.Length() == 5);
 }
+
+TEST_CASE("short string testing", "[engine]")
+{
+    const unsigned maxInline = String::INLINE_CAPACITY - 1;
+
+    String empty;
+    REQUIRE(empty.Empty());
+    REQUIRE(empty.CString()[0] == 0);
+    REQUIRE(empty.Capacity() == String::INLINE_CAPACITY);
+
+    // Grow from inline to heap storage one character at a time
+    String str;
+    String expected;
+    for (unsigned i = 0; i < maxInline + 8; ++i)
+    {
+        str += (char)('a' + i % 26);
+        REQUIRE(str.Length() == i + 1);
+        REQUIRE(str.CString()[i + 1] == 0);
+        REQUIRE(strlen(str.CString()) == i + 1);
+        if (i < maxInline)
+            REQUIRE(str.Capacity() == String::INLINE_CAPACITY);
+        else
+            REQUIRE(str.Capacity() > String::INLINE_CAPACITY);
+    }
+    REQUIRE(str.Substring(0, 3) == "abc");
+    REQUIRE(str.Front() == 'a');
+
+    // Compact moves a shortened string back inline
+    str.Resize(3);
+    REQUIRE(str == "abc");
+    str.Compact();
+    REQUIRE(str.Capacity() == String::INLINE_CAPACITY);
+    REQUIRE(str == "abc");
+    str.Reserve(64);
+    REQUIRE(str.Capacity() == 64);
+    REQUIRE(str == "abc");
+
+    // Copy, move and swap between inline and heap strings
+    String shortStr("short");
+    String longStr("a string that does not fit the inline buffer");
+    String shortCopy(shortStr);
+    String longCopy(longStr);
+    REQUIRE(shortCopy == shortStr);
+    REQUIRE(longCopy == longStr);
+    REQUIRE(shortCopy.CString() != shortStr.CString());
+
+    shortCopy.Swap(longCopy);
+    REQUIRE(shortCopy == longStr);
+    REQUIRE(longCopy == shortStr);
+
+    String moved(std::move(shortCopy));
+    REQUIRE(moved == longStr);
+    REQUIRE(shortCopy.Empty());
+    moved = std::move(longCopy);
+    REQUIRE(moved == shortStr);
+    moved = longStr;
+    REQUIRE(moved == longStr);
+    moved = "x";
+    REQUIRE(moved == "x");
+
+    // Edits crossing the inline boundary
+    String edit(' ', maxInline);
+    REQUIRE(edit.Length() == maxInline);
+    edit.Insert(0, 'x');
+    REQUIRE(edit.Length() == maxInline + 1);
+    REQUIRE(edit.Front() == 'x');
+    edit = edit.Substring(2);
+    REQUIRE(edit.Length() == maxInline - 1);
+    edit.Clear();
+    REQUIRE(edit.Empty());
+    REQUIRE(edit.CString()[0] == 0);
+
+    // Hashes and comparisons do not depend on where the characters are stored
+    String inlineName("Sprite");
+    String heapName("Sprite");
+    heapName.Reserve(128);
+    REQUIRE(inlineName == heapName);
+    REQUIRE(inlineName.ToHash() == heapName.ToHash());
+}
+
+TEST_CASE("small vector testing", "[engine]")
+{
+    SmallVector<int, 4> vec;
+    REQUIRE(vec.Empty());
+    REQUIRE(vec.IsInline());
+    REQUIRE(vec.Capacity() == 4);
+
+    for (int i = 0; i < 4; ++i)
+        vec.Push(10 - i);
+    REQUIRE(vec.IsInline());
+    REQUIRE(vec.Size() == 4);
+
+    // Growing moves the elements to the heap
+    for (int i = 4; i < 10; ++i)
+        vec.Push(10 - i);
+    REQUIRE(!vec.IsInline());
+    REQUIRE(vec.Size() == 10);
+    REQUIRE(vec.Front() == 10);
+    REQUIRE(vec.Back() == 1);
+
+    // Pushing an element of the vector itself while it grows
+    SmallVector<int, 2> self{7, 8};
+    self.Push(self[0]);
+    REQUIRE(self.Size() == 3);
+    REQUIRE(self[2] == 7);
+
+    // Works with the Sort helpers and range-based for
+    Sort(vec.Begin(), vec.End());
+    int expected = 1;
+    for (int value : vec)
+        REQUIRE(value == expected++);
+
+    vec.Erase(0, 2);
+    REQUIRE(vec.Front() == 3);
+    REQUIRE(vec.Remove(5));
+    REQUIRE(!vec.Contains(5));
+    REQUIRE(vec.IndexOf(6) == 2);
+    vec.Insert(0, 42);
+    REQUIRE(vec[0] == 42);
+    vec.EraseSwap(0);
+    REQUIRE(vec[0] == 10);
+    REQUIRE(vec.Size() == 7);
+
+    PODVector<int> pod{1, 2, 3};
+    SmallVector<int, 4> fromPod(pod);
+    fromPod.Insert(fromPod.End(), pod.Begin() + 1, pod.End());
+    REQUIRE(fromPod == SmallVector<int, 4>{1, 2, 3, 2, 3});
+
+    // Copy, move and swap between inline and heap storage
+    SmallVector<int, 4> small{1, 2};
+    SmallVector<int, 4> large(vec);
+    REQUIRE(large == vec);
+    SmallVector<int, 4> moved(std::move(large));
+    REQUIRE(moved == vec);
+    REQUIRE(large.Empty());
+    REQUIRE(large.IsInline());
+    moved.Swap(small);
+    REQUIRE(small == vec);
+    REQUIRE(moved == SmallVector<int, 4>{1, 2});
+    moved = small;
+    REQUIRE(moved == vec);
+    moved = std::move(fromPod);
+    REQUIRE(moved.Size() == 5);
+
+    vec.Clear();
+    REQUIRE(vec.Empty());
+}
+
+TEST_CASE("radix sort testing", "[engine]")
+{
+    PODVector<unsigned char> scratch;
+    unsigned seed = 12345;
+    auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed; };
+
+    // Signed integers, both above and below the insertion sort threshold
+    for (unsigned count : {10u, 1000u})
+    {
+        PODVector<int> ints;
+        for (unsigned i = 0; i < count; ++i)
+            ints.Push((int)random());
+        RadixSort(ints.Begin(), ints.End(), [](int value) { return value; }, scratch);
+        for (unsigned i = 1; i < ints.Size(); ++i)
+            REQUIRE(ints[i - 1] <= ints[i]);
+    }
+
+    // Floats including negative values, zeros and infinities
+    PODVector<float> floats;
+    for (unsigned i = 0; i < 1000; ++i)
+        floats.Push(((float)(random() % 20001u) - 10000.0f) * 0.37f);
+    floats.Push(0.0f);
+    floats.Push(-0.0f);
+    floats.Push(M_INFINITY);
+    floats.Push(-M_INFINITY);
+    RadixSort(floats.Begin(), floats.End(), [](float value) { return value; }, scratch);
+    REQUIRE(floats.Front() == -M_INFINITY);
+    REQUIRE(floats.Back() == M_INFINITY);
+    for (unsigned i = 1; i < floats.Size(); ++i)
+        REQUIRE(floats[i - 1] <= floats[i]);
+
+    // 64-bit keys through a key function. The sort is stable, so elements with equal keys keep their order
+    struct Element
+    {
+        unsigned long long key_;
+        unsigned index_;
+    };
+    PODVector<Element> elements;
+    for (unsigned i = 0; i < 2000; ++i)
+        elements.Push({((unsigned long long)(random() % 8u) << 40u) | (random() % 4u), i});
+    RadixSort(elements.Begin(), elements.End(), [](const Element& element) { return element.key_; }, scratch);
+    for (unsigned i = 1; i < elements.Size(); ++i)
+    {
+        REQUIRE(elements[i - 1].key_ <= elements[i].key_);
+        if (elements[i - 1].key_ == elements[i].key_)
+            REQUIRE(elements[i - 1].index_ < elements[i].index_);
+    }
+
+    // Sorting by a secondary and then a primary key gives lexicographic order
+    PODVector<Element> pairs;
+    for (unsigned i = 0; i < 500; ++i)
+        pairs.Push({random() % 16u, random() % 100u});
+    RadixSort(pairs.Begin(), pairs.End(), [](const Element& element) { return element.index_; });
+    RadixSort(pairs.Begin(), pairs.End(), [](const Element& element) { return element.key_; });
+    for (unsigned i = 1; i < pairs.Size(); ++i)
+    {
+        REQUIRE(pairs[i - 1].key_ <= pairs[i].key_);
+        if (pairs[i - 1].key_ == pairs[i].key_)
+            REQUIRE(pairs[i - 1].index_ <= pairs[i].index_);
+    }
+}
+
+namespace
+{
+    /// Value that counts how many times it is copied and moved.
+    struct CopyCounter
+    {
+        CopyCounter() = default;
+        explicit CopyCounter(int value) : value_(value) { }
+        CopyCounter(int a, int b) : value_(a + b) { }
+        CopyCounter(const CopyCounter& rhs) : value_(rhs.value_) { ++copies_; }
+        CopyCounter(CopyCounter&& rhs) noexcept : value_(rhs.value_) { ++moves_; }
+        CopyCounter& operator =(const CopyCounter& rhs) { value_ = rhs.value_; ++copies_; return *this; }
+        CopyCounter& operator =(CopyCounter&& rhs) noexcept { value_ = rhs.value_; ++moves_; return *this; }
+        bool operator ==(const CopyCounter& rhs) const { return value_ == rhs.value_; }
+        bool operator !=(const CopyCounter& rhs) const { return value_ != rhs.value_; }
+        unsigned ToHash() const { return (unsigned)value_; }
+
+        int value_{};
+        static unsigned copies_;
+        static unsigned moves_;
+    };
+
+    unsigned CopyCounter::copies_ = 0;
+    unsigned CopyCounter::moves_ = 0;
+}
+
+TEST_CASE("move semantics testing", "[engine]")
+{
+    CopyCounter::copies_ = 0;
+
+    Vector<CopyCounter> vector;
+    vector.Reserve(2);
+    REQUIRE(vector.EmplaceBack(1, 2).value_ == 3);
+    vector.Push(CopyCounter(4));
+    vector.EmplaceBack(5);
+    vector.Emplace(0, 6);
+    vector.Insert(1, CopyCounter(7));
+    REQUIRE(vector.Size() == 5);
+    REQUIRE(vector[0].value_ == 6);
+    REQUIRE(vector[1].value_ == 7);
+    REQUIRE(vector[4].value_ == 5);
+    Vector<CopyCounter> movedVector;
+    movedVector = std::move(vector);
+    REQUIRE(movedVector.Size() == 5);
+    REQUIRE(CopyCounter::copies_ == 0);
+
+    List<CopyCounter> list;
+    list.Push(CopyCounter(1));
+    list.PushFront(CopyCounter(2));
+    REQUIRE(list.EmplaceBack(3, 4).value_ == 7);
+    list.EmplaceFront(5);
+    list.Emplace(list.End(), 6);
+    REQUIRE(list.Size() == 5);
+    REQUIRE(list.Front().value_ == 5);
+    REQUIRE(list.Back().value_ == 6);
+    {
+        // The moved-from list must still destruct cleanly
+        List<CopyCounter> movedList(std::move(list));
+        REQUIRE(movedList.Size() == 5);
+    }
+    REQUIRE(CopyCounter::copies_ == 0);
+
+    // Emplacing without arguments value-initializes, also in a reused node
+    List<int> numbers;
+    numbers.Push(5);
+    numbers.Pop();
+    REQUIRE(numbers.EmplaceBack() == 0);
+    REQUIRE(numbers.EmplaceFront() == 0);
+
+    HashMap<int, CopyCounter> map;
+    map.Insert(Pair<int, CopyCounter>(1, CopyCounter(1)));
+    map[2] = CopyCounter(2);
+    auto result = map.TryEmplace(3, 1, 2);
+    REQUIRE(result.second_);
+    REQUIRE(result.first_->second_.value_ == 3);
+    CopyCounter untouched(10);
+    unsigned moves = CopyCounter::moves_;
+    result = map.TryEmplace(3, std::move(untouched));
+    REQUIRE(!result.second_);
+    REQUIRE(result.first_->second_.value_ == 3);
+    REQUIRE(CopyCounter::moves_ == moves);
+    REQUIRE(map.Emplace(3, 20)->second_.value_ == 20);
+    REQUIRE(map.Emplace(4, 2, 2)->second_.value_ == 4);
+    REQUIRE(map.Size() == 4);
+    REQUIRE(CopyCounter::copies_ == 0);
+
+    // Range insert copies each pair once
+    const HashMap<int, CopyCounter>& constMap = map;
+    HashMap<int, CopyCounter> mapCopy;
+    mapCopy.Insert(constMap.Begin(), constMap.End());
+    REQUIRE(mapCopy == map);
+    REQUIRE(CopyCounter::copies_ == 4);
+    CopyCounter::copies_ = 0;
+
+    HashMap<String, CopyCounter> stringMap;
+    String longKey("a key that does not fit in the inline buffer");
+    const char* keyBuffer = longKey.CString();
+    stringMap[std::move(longKey)] = CopyCounter(1);
+    REQUIRE(stringMap.Front().first_.CString() == keyBuffer);
+
+    HashSet<CopyCounter> set;
+    set.Insert(CopyCounter(1));
+    set.Emplace(2);
+    set.Emplace(1, 1);
+    bool exists = false;
+    set.Insert(CopyCounter(1), exists);
+    REQUIRE(exists);
+    REQUIRE(set.Size() == 2);
+    REQUIRE(CopyCounter::copies_ == 0);
+
+    // PODVector copies, moves and removal
+    PODVector<int> podVector{1, 2, 3};
+    PODVector<int> podCopy(podVector);
+    REQUIRE(podCopy == podVector);
+    const int* podBuffer = podCopy.Buffer();
+    PODVector<int> podMoved(std::move(podCopy));
+    REQUIRE(podMoved.Buffer() == podBuffer);
+    REQUIRE(podMoved.Remove(2));
+    REQUIRE(!podMoved.Remove(2));
+    REQUIRE(podMoved.RemoveSwap(1));
+    REQUIRE(podMoved.Size() == 1);
+    REQUIRE(podMoved[0] == 3);
+}
+
+namespace
+{
+    /// Reference-counted object that records its destruction.
+    class Counted : public RefCounted
+    {
+    public:
+        explicit Counted(bool& destroyed) : destroyed_(destroyed) { destroyed_ = false; }
+        ~Counted() override { destroyed_ = true; }
+
+        bool& destroyed_;
+    };
+}
+
+TEST_CASE("ref counted testing", "[engine]")
+{
+    bool destroyed = false;
+    SharedPtr<Counted> object(new Counted(destroyed));
+    REQUIRE(object.Refs() == 1);
+    REQUIRE(object.WeakRefs() == 0);
+
+    {
+        SharedPtr<Counted> copy(object);
+        REQUIRE(object.Refs() == 2);
+    }
+    REQUIRE(object.Refs() == 1);
+
+    // The weak reference block is created by the first weak pointer and outlives the object
+    WeakPtr<Counted> weak(object);
+    REQUIRE(object.WeakRefs() == 1);
+    REQUIRE(weak.Refs() == 1);
+    REQUIRE(weak.Lock() == object);
+    WeakPtr<Counted> weakCopy(weak);
+    REQUIRE(object.WeakRefs() == 2);
+
+    object.Reset();
+    REQUIRE(destroyed);
+    REQUIRE(weak.Expired());
+    REQUIRE(weakCopy.Expired());
+    REQUIRE(weak.Refs() == 0);
+    REQUIRE(weak.Lock().Null());
+
+    // Detaching leaves the object alive with no references
+    SharedPtr<Counted> detached(new Counted(destroyed));
+    Counted* raw = detached.Detach();
+    REQUIRE(!destroyed);
+    REQUIRE(raw->Refs() == 0);
+    delete raw;
+    REQUIRE(destroyed);
+
+    // Strong references can be taken and released concurrently
+    SharedPtr<Counted> shared(new Counted(destroyed));
+    Vector<std::thread> threads;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        threads.Push(std::thread([&shared]() {
+            for (unsigned j = 0; j < 100000; ++j)
+            {
+                SharedPtr<Counted> copy(shared);
+                SharedPtr<Counted> other(std::move(copy));
+            }
+        }));
+    }
+    for (unsigned i = 0; i < threads.Size(); ++i)
+        threads[i].join();
+    REQUIRE(shared.Refs() == 1);
+    shared.Reset();
+    REQUIRE(destroyed);
+}
+
+TEST_CASE("slot map testing", "[engine]")
+{
+    SlotMap<String> map;
+    REQUIRE(map.Empty());
+    REQUIRE_FALSE(map.Contains(SlotHandle()));
+
+    SlotHandle a = map.Insert("a");
+    SlotHandle b = map.Insert("b");
+    SlotHandle c = map.Emplace("c");
+    REQUIRE(map.Size() == 3);
+    REQUIRE(a.index_ == 0);
+    REQUIRE(c.index_ == 2);
+    REQUIRE(*map.Get(b) == "b");
+
+    // Erasing moves the last value into the hole and invalidates the handle
+    REQUIRE(map.Erase(a));
+    REQUIRE_FALSE(map.Erase(a));
+    REQUIRE(map.Get(a) == nullptr);
+    REQUIRE(map.Size() == 2);
+    REQUIRE(*map.Get(b) == "b");
+    REQUIRE(*map.Get(c) == "c");
+
+    // The freed slot is reused with a new version
+    SlotHandle d = map.Insert("d");
+    REQUIRE(d.index_ == a.index_);
+    REQUIRE(d != a);
+    REQUIRE(map.Get(a) == nullptr);
+    REQUIRE(*map.Get(d) == "d");
+
+    // Addressing by index grows the slot array and keeps the skipped slots free
+    SlotHandle e = map.EmplaceAt(6, "e");
+    REQUIRE(map.NumSlots() == 7);
+    REQUIRE(*map.GetAt(6) == "e");
+    REQUIRE(map.GetAt(4) == nullptr);
+    REQUIRE(map.GetHandle(6) == e);
+    REQUIRE(map.GetFreeIndex() == 3);
+    REQUIRE(map.Insert("f").index_ == 3);
+    REQUIRE(map.Insert("g").index_ == 4);
+    map.EmplaceAt(6, "h");
+    REQUIRE(*map.Get(e) == "h");
+    REQUIRE(map.Size() == 6);
+
+    unsigned count = 0;
+    for (unsigned i = 0; i < map.GetValues().Size(); ++i)
+    {
+        REQUIRE(*map.GetAt(map.GetSlotIndex(i)) == map.GetValues()[i]);
+        ++count;
+    }
+    REQUIRE(count == map.Size());
+
+    map.EraseAt(0);
+    map.EraseAt(4);
+    map.ResetFreeList();
+    REQUIRE(map.Insert("i").index_ == 0);
+
+    map.Clear();
+    REQUIRE(map.Empty());
+    REQUIRE(map.Get(c) == nullptr);
+    REQUIRE(map.Insert("j").index_ == 0);
+}
@@ -0,0 +1,543 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "catch.hpp"
+
+#include "Core/Context.h"
+#include "Core/CoreEvents.h"
+#include "Core/FramePipeline.h"
+#include "Core/ParallelSort.h"
+#include "Core/Profiler.h"
+#include "Core/TaskGraph.h"
+#include "Core/Timer.h"
+#include "Core/WorkQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+using namespace My3D;
+
+TEST_CASE("Sort vs ParallelSort", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+    unsigned numThreads = std::thread::hardware_concurrency();
+    queue->CreateThreads(numThreads > 1 ? numThreads - 1 : 1);
+
+    auto compare = [](float lhs, float rhs) { return lhs < rhs; };
+
+    for (unsigned count : {4096u, 65536u, 1048576u})
+    {
+        PODVector<float> source(count);
+        unsigned seed = count;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            source[i] = (float)(seed >> 8u) * 0.001f;
+        }
+        PODVector<float> sorted(count);
+        PODVector<float> scratch;
+
+        BENCHMARK(String("Sort ").Append(String(count)).CString())
+        {
+            memcpy(sorted.Buffer(), source.Buffer(), count * sizeof(float));
+            Sort(sorted.Begin(), sorted.End(), compare);
+            return sorted.Front();
+        };
+
+        BENCHMARK(String("ParallelSort ").Append(String(count)).CString())
+        {
+            memcpy(sorted.Buffer(), source.Buffer(), count * sizeof(float));
+            ParallelSort(queue, sorted.Begin(), sorted.End(), compare, scratch);
+            return sorted.Front();
+        };
+    }
+}
+
+static void TinyWork(const WorkItem* item, unsigned threadIndex)
+{
+    reinterpret_cast<std::atomic<unsigned>*>(item->start_)->fetch_add(1, std::memory_order_relaxed);
+}
+
+static void LargeWork(const WorkItem* item, unsigned threadIndex)
+{
+    float* values = reinterpret_cast<float*>(item->start_);
+    float* end = reinterpret_cast<float*>(item->end_);
+    for (; values < end; ++values)
+        *values = *values * 0.5f + 1.0f;
+}
+
+TEST_CASE("WorkQueue throughput", "[.][benchmark]")
+{
+    unsigned numThreads = std::thread::hardware_concurrency();
+    numThreads = numThreads > 1 ? numThreads - 1 : 1;
+    PODVector<float> data(1024 * 1024);
+    memset(data.Buffer(), 0, data.Size() * sizeof(float));
+
+    for (bool workStealing : {false, true})
+    {
+        SharedPtr<Context> context(new Context());
+        auto* queue = context->RegisterSubsystem<WorkQueue>();
+        queue->SetWorkStealing(workStealing);
+        queue->CreateThreads(numThreads);
+        String mode = workStealing ? " (work stealing)" : " (shared queue)";
+        std::atomic<unsigned> counter(0);
+
+        BENCHMARK(("10000 tiny items" + mode).CString())
+        {
+            for (unsigned i = 0; i < 10000; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = M_MAX_UNSIGNED;
+                item->workFunction_ = TinyWork;
+                item->start_ = &counter;
+                queue->AddWorkItem(item);
+            }
+            queue->Complete(M_MAX_UNSIGNED);
+            return counter.load();
+        };
+
+        BENCHMARK(("8 large items" + mode).CString())
+        {
+            unsigned chunk = data.Size() / 8;
+            for (unsigned i = 0; i < 8; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = M_MAX_UNSIGNED;
+                item->workFunction_ = LargeWork;
+                item->start_ = data.Buffer() + i * chunk;
+                item->end_ = data.Buffer() + (i + 1) * chunk;
+                queue->AddWorkItem(item);
+            }
+            queue->Complete(M_MAX_UNSIGNED);
+            return data[0];
+        };
+    }
+}
+
+/// Return CPU time used by the calling thread in microseconds.
+static long long GetThreadCPUTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    auto toUSec = [](const FILETIME& time) { return (((long long)time.dwHighDateTime << 32) | time.dwLowDateTime) / 10; };
+    return toUSec(kernel) + toUSec(user);
+#else
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return (long long)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+#endif
+}
+
+static void SleepWork(const WorkItem* item, unsigned threadIndex)
+{
+    Time::Sleep(2);
+}
+
+TEST_CASE("WorkQueue Complete main thread CPU time", "[.][benchmark]")
+{
+    for (bool busyWait : {true, false})
+    {
+        SharedPtr<Context> context(new Context());
+        auto* queue = context->RegisterSubsystem<WorkQueue>();
+        queue->CreateThreads(3);
+
+        // The worker threads sleep, so all CPU time the main thread uses while completing is spent waiting. The busy wait
+        // polls for completion like Complete() did before it blocked on the priority counters
+        long long cpuTime = 0;
+        auto wallStart = std::chrono::steady_clock::now();
+        for (unsigned round = 0; round < 50; ++round)
+        {
+            for (unsigned i = 0; i < 6; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = M_MAX_UNSIGNED;
+                item->workFunction_ = SleepWork;
+                queue->AddWorkItem(item);
+            }
+
+            long long start = GetThreadCPUTime();
+            if (busyWait)
+            {
+                while (!queue->IsCompleted(M_MAX_UNSIGNED))
+                {
+                }
+            }
+            queue->Complete(M_MAX_UNSIGNED);
+            cpuTime += GetThreadCPUTime() - start;
+        }
+
+        auto wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wallStart);
+        WARN((busyWait ? "Busy wait: " : "Complete: ") << cpuTime / 1000 << " ms main thread CPU time in "
+            << wallTime.count() << " ms");
+    }
+}
+
+/// Simulated work of one chunk of a frame stage. The cost varies between chunks like culling cost varies between octants.
+static void StageChunk(float* values, unsigned chunk, unsigned stage)
+{
+    unsigned count = 2048 + ((chunk * 7919u + stage * 104729u) % 8) * 2048;
+    for (unsigned i = 0; i < count; ++i)
+        values[i] = values[i] * 0.5f + (float)stage;
+}
+
+static void StageChunkWork(const WorkItem* item, unsigned threadIndex)
+{
+    StageChunk(reinterpret_cast<float*>(item->start_), (unsigned)(size_t)item->aux_, (unsigned)(size_t)item->end_);
+}
+
+TEST_CASE("Stage barriers vs TaskGraph", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+    unsigned numThreads = std::thread::hardware_concurrency();
+    queue->CreateThreads(numThreads > 1 ? numThreads - 1 : 1);
+
+    // Cull, light processing and batch building stages, where each chunk only depends on the same chunk of the previous stage
+    const unsigned numStages = 3;
+    const unsigned numChunks = 16;
+    PODVector<float> data(numChunks * 16384);
+    memset(data.Buffer(), 0, data.Size() * sizeof(float));
+
+    BENCHMARK("Three stages with Complete barriers")
+    {
+        for (unsigned stage = 0; stage < numStages; ++stage)
+        {
+            for (unsigned chunk = 0; chunk < numChunks; ++chunk)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = M_MAX_UNSIGNED;
+                item->workFunction_ = StageChunkWork;
+                item->start_ = data.Buffer() + chunk * 16384;
+                item->end_ = (void*)(size_t)stage;
+                item->aux_ = (void*)(size_t)chunk;
+                queue->AddWorkItem(item);
+            }
+            queue->Complete(M_MAX_UNSIGNED);
+        }
+        return data[0];
+    };
+
+    TaskGraph graph(queue);
+    BENCHMARK("Three stages as a task graph")
+    {
+        graph.Clear();
+        for (unsigned chunk = 0; chunk < numChunks; ++chunk)
+        {
+            Task* previous = nullptr;
+            for (unsigned stage = 0; stage < numStages; ++stage)
+            {
+                float* values = data.Buffer() + chunk * 16384;
+                Task* task = graph.AddTask([values, chunk, stage](Task*, unsigned) { StageChunk(values, chunk, stage); });
+                if (previous)
+                    graph.AddDependency(task, previous);
+                previous = task;
+            }
+        }
+        graph.Run();
+        return data[0];
+    };
+}
+
+TEST_CASE("Profiler block overhead", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem<Time>();
+    auto* profiler = context->RegisterSubsystem<Profiler>();
+
+    BENCHMARK("1000 profiled blocks")
+    {
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            AutoProfileBlock outer("Outer");
+            AutoProfileBlock inner("Inner");
+        }
+        return profiler->GetNumThreads();
+    };
+
+    profiler->EndFrame();
+}
+
+namespace
+{
+    class BenchReceiver : public Object
+    {
+        MY3D_OBJECT(BenchReceiver, Object)
+
+    public:
+        explicit BenchReceiver(Context* context)
+            : Object(context)
+        {
+        }
+
+        void HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+        {
+            time_ += eventData[RenderUpdate::P_TIMESTEP].GetFloat();
+        }
+
+        void HandleTypedRenderUpdate(const RenderUpdate::Payload& data)
+        {
+            time_ += data.timeStep_;
+        }
+
+        float time_{};
+    };
+}
+
+TEST_CASE("VariantMap vs typed event dispatch", "[.][benchmark]")
+{
+    static const unsigned NUM_RECEIVERS = 10000;
+
+    SharedPtr<Context> context(new Context());
+    SharedPtr<BenchReceiver> sender(new BenchReceiver(context));
+    Vector<SharedPtr<BenchReceiver> > receivers;
+    for (unsigned i = 0; i < NUM_RECEIVERS; ++i)
+        receivers.Push(SharedPtr<BenchReceiver>(new BenchReceiver(context)));
+
+    for (unsigned i = 0; i < NUM_RECEIVERS; ++i)
+        receivers[i]->SubscribeToEvent(E_RENDERUPDATE, new EventHandlerImpl<BenchReceiver>(receivers[i],
+            &BenchReceiver::HandleRenderUpdate));
+    BENCHMARK("VariantMap event, 10000 receivers")
+    {
+        VariantMap& eventData = sender->GetEventDataMap();
+        eventData[RenderUpdate::P_TIMESTEP] = 0.016f;
+        sender->SendEvent(E_RENDERUPDATE, eventData);
+        return receivers[0]->time_;
+    };
+    for (unsigned i = 0; i < NUM_RECEIVERS; ++i)
+        receivers[i]->UnsubscribeFromAllEvents();
+
+    for (unsigned i = 0; i < NUM_RECEIVERS; ++i)
+        receivers[i]->SubscribeToEvent(&BenchReceiver::HandleTypedRenderUpdate);
+    BENCHMARK("Typed event, 10000 receivers")
+    {
+        sender->SendEvent(RenderUpdate::Payload{0.016f});
+        return receivers[0]->time_;
+    };
+}
+
+MY3D_EVENT(E_BENCHPARAMS, BenchParams)
+{
+    MY3D_PARAM(P_INDEX, Index);
+    MY3D_PARAM(P_SCALE, Scale);
+    MY3D_PARAM(P_POSITION, Position);
+    MY3D_PARAM(P_NAME, Name);
+}
+
+namespace
+{
+    class BenchParamReceiver : public Object
+    {
+        MY3D_OBJECT(BenchParamReceiver, Object)
+
+    public:
+        explicit BenchParamReceiver(Context* context)
+            : Object(context)
+        {
+        }
+
+        void HandleParams(StringHash eventType, VariantMap& eventData)
+        {
+            using namespace BenchParams;
+            sum_ += eventData[P_INDEX].GetInt() + eventData[P_POSITION].GetVector3().x_ * eventData[P_SCALE].GetFloat() +
+                (float)eventData[P_NAME].GetString().Length();
+        }
+
+        float sum_{};
+    };
+}
+
+TEST_CASE("Event send with parameters", "[.][benchmark]")
+{
+    using namespace BenchParams;
+    static const unsigned NUM_RECEIVERS = 8;
+    static const unsigned NUM_SENDS = 10000;
+
+    SharedPtr<Context> context(new Context());
+    SharedPtr<BenchParamReceiver> sender(new BenchParamReceiver(context));
+    Vector<SharedPtr<BenchParamReceiver> > receivers;
+    for (unsigned i = 0; i < NUM_RECEIVERS; ++i)
+    {
+        receivers.Push(SharedPtr<BenchParamReceiver>(new BenchParamReceiver(context)));
+        receivers[i]->SubscribeToEvent(sender, E_BENCHPARAMS, new EventHandlerImpl<BenchParamReceiver>(receivers[i],
+            &BenchParamReceiver::HandleParams));
+    }
+
+    BENCHMARK("10000 sends with 4 parameters, 8 receivers")
+    {
+        for (unsigned i = 0; i < NUM_SENDS; ++i)
+        {
+            VariantMap& eventData = sender->GetEventDataMap();
+            eventData[P_INDEX] = (int)i;
+            eventData[P_SCALE] = 0.5f;
+            eventData[P_POSITION] = Vector3(1.0f, 2.0f, 3.0f);
+            eventData[P_NAME] = "BenchNode";
+            sender->SendEvent(E_BENCHPARAMS, eventData);
+        }
+        return receivers[0]->sum_;
+    };
+
+    BENCHMARK("10000 sends with 4 parameters in a local map, 8 receivers")
+    {
+        for (unsigned i = 0; i < NUM_SENDS; ++i)
+        {
+            VariantMap eventData;
+            eventData[P_INDEX] = (int)i;
+            eventData[P_SCALE] = 0.5f;
+            eventData[P_POSITION] = Vector3(1.0f, 2.0f, 3.0f);
+            eventData[P_NAME] = "BenchNode";
+            sender->SendEvent(E_BENCHPARAMS, eventData);
+        }
+        return receivers[0]->sum_;
+    };
+}
+
+/// Return CPU time used by the whole process in microseconds.
+static long long GetProcessCPUTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    auto toUSec = [](const FILETIME& time) { return (((long long)time.dwHighDateTime << 32) | time.dwLowDateTime) / 10; };
+    return toUSec(kernel) + toUSec(user);
+#else
+    timespec time{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return (long long)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+#endif
+}
+
+/// Time when the wakeup test item was queued.
+static std::chrono::steady_clock::time_point wakeupQueued;
+/// Total wakeup latency in nanoseconds.
+static std::atomic<long long> wakeupLatency;
+/// Set by the wakeup test item when it has run.
+static std::atomic<bool> wakeupDone;
+
+static void WakeupWork(const WorkItem* item, unsigned threadIndex)
+{
+    wakeupLatency += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wakeupQueued).count();
+    wakeupDone = true;
+}
+
+TEST_CASE("Idle worker CPU time and wakeup latency", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+    queue->CreateThreads(3);
+
+    // Run one item so that the queue is not paused, then measure the CPU time the idle worker threads use
+    wakeupDone = false;
+    SharedPtr<WorkItem> item = queue->GetFreeItem();
+    item->workFunction_ = WakeupWork;
+    queue->AddWorkItem(item);
+    while (!wakeupDone)
+        std::this_thread::yield();
+
+    long long cpuStart = GetProcessCPUTime();
+    Time::Sleep(500);
+    WARN("Shared queue: " << (GetProcessCPUTime() - cpuStart) / 1000 << " ms CPU time in 500 ms idle");
+
+    // Queue single items to idle workers and measure the time until one starts running it
+    static const unsigned NUM_WAKEUPS = 200;
+    wakeupLatency = 0;
+    for (unsigned i = 0; i < NUM_WAKEUPS; ++i)
+    {
+        Time::Sleep(1);
+        wakeupDone = false;
+        item = queue->GetFreeItem();
+        item->workFunction_ = WakeupWork;
+        wakeupQueued = std::chrono::steady_clock::now();
+        queue->AddWorkItem(item);
+        while (!wakeupDone)
+            std::this_thread::yield();
+    }
+    WARN("Shared queue: " << wakeupLatency / NUM_WAKEUPS / 1000 << " us average wakeup latency");
+}
+
+TEST_CASE("Frame time statistics overhead", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* time = context->RegisterSubsystem<Time>();
+
+    BENCHMARK("1000 frames with phase marks")
+    {
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            time->BeginFrame(0.016f);
+            time->MarkFramePhase(FRAME_PHASE_UPDATE);
+            time->MarkFramePhase(FRAME_PHASE_RENDER);
+            time->MarkFramePhase(FRAME_PHASE_SLEEP);
+            time->EndFrame();
+        }
+        return time->GetFrameNumber();
+    };
+
+    BENCHMARK("Stats over the last 1024 frames")
+    {
+        return time->GetFrameTimeStats().p99_;
+    };
+}
+
+/// Spin for a CPU-bound amount of work.
+static unsigned SpinWork(long long uSec, unsigned seed)
+{
+    HiresTimer timer;
+    while (timer.GetUSec(false) < uSec)
+        seed = seed * 1664525u + 1013904223u;
+    return seed;
+}
+
+TEST_CASE("Sequential vs pipelined frames", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem<Time>();
+    auto* pipeline = context->RegisterSubsystem<FramePipeline>();
+
+    // CPU-bound scene: 1 ms of update and 1 ms of render work per frame, with render state double-buffered per packet
+    const unsigned NUM_FRAMES = 100;
+    const long long UPDATE_USEC = 1000;
+    const long long RENDER_USEC = 1000;
+    unsigned states[NUM_FRAME_PACKETS] = {};
+    std::atomic<unsigned> rendered(0);
+    unsigned frameNumber = 0;
+
+    auto runFrames = [&]()
+    {
+        for (unsigned i = 0; i < NUM_FRAMES; ++i)
+        {
+            pipeline->BeginFrame(++frameNumber);
+            FramePacket& packet = pipeline->GetPacket();
+            states[packet.GetIndex()] = SpinWork(UPDATE_USEC, frameNumber);
+            packet.AddCommand([&](const FramePacket& p)
+            {
+                rendered.fetch_add(SpinWork(RENDER_USEC, states[p.GetIndex()]) & 1u, std::memory_order_relaxed);
+            });
+            pipeline->Submit();
+        }
+        pipeline->Flush();
+        return rendered.load();
+    };
+
+    BENCHMARK("100 frames sequential")
+    {
+        return runFrames();
+    };
+
+    pipeline->SetPipelined(true);
+    BENCHMARK("100 frames pipelined")
+    {
+        return runFrames();
+    };
+    pipeline->SetPipelined(false);
+
+    WARN(std::thread::hardware_concurrency() << " hardware threads; pipelining needs at least 2 to overlap");
+}
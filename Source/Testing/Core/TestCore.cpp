@@ -0,0 +1,1618 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "Container/Sort.h"
+#include "Core/ConditionVariable.h"
+#include "Core/Context.h"
+#include "Core/CoreEvents.h"
+#include "Core/FrameAllocator.h"
+#include "Core/FramePipeline.h"
+#include "Core/ParallelSort.h"
+#include "Core/ProcessUtils.h"
+#include "Core/Profiler.h"
+#include "Core/StringHashRegister.h"
+#include "Core/TaskGraph.h"
+#include "Core/Timer.h"
+#include "Core/TraceRecorder.h"
+#include "Core/Variant.h"
+#include "Core/WorkQueue.h"
+#include "IO/Log.h"
+
+#include <cstdio>
+#include <thread>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace My3D;
+
+TEST_CASE("frame allocator testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* time = context->RegisterSubsystem<Time>();
+    auto* allocator = context->RegisterSubsystem<FrameAllocator>();
+    allocator->SetChunkSize(1024);
+
+    time->BeginFrame(0.016f);
+    void* first = allocator->Allocate(24);
+    void* second = allocator->Allocate(8, 8);
+    REQUIRE(((size_t)first & (FrameAllocator::DEFAULT_ALIGNMENT - 1)) == 0);
+    REQUIRE(((size_t)second & 7) == 0);
+    REQUIRE(second != first);
+    REQUIRE(allocator->Extend(second, 8, 64));
+    REQUIRE_FALSE(allocator->Extend(first, 24, 64));
+
+    // Overflow into more chunks than one
+    for (unsigned i = 0; i < 10; ++i)
+        allocator->Allocate(512);
+    REQUIRE(allocator->GetReservedBytes() > 1024);
+    time->EndFrame();
+
+    unsigned long long highWaterMark = allocator->GetHighWaterMark();
+    REQUIRE(highWaterMark >= 24 + 64 + 10 * 512);
+    REQUIRE(allocator->GetLastFrameBytes() == highWaterMark);
+    // The chunks have been merged so that the same amount fits in one chunk
+    REQUIRE(allocator->GetReservedBytes() >= highWaterMark);
+    unsigned long long reserved = allocator->GetReservedBytes();
+
+    time->BeginFrame(0.016f);
+    void* rewound = allocator->Allocate(24);
+    REQUIRE(rewound != nullptr);
+    for (unsigned i = 0; i < 10; ++i)
+        allocator->Allocate(512);
+    REQUIRE(allocator->GetReservedBytes() == reserved);
+    time->EndFrame();
+    REQUIRE(allocator->GetHighWaterMark() == highWaterMark);
+
+    // Each thread allocates from its own arena
+    time->BeginFrame(0.016f);
+    const unsigned numThreads = 4;
+    std::thread threads[numThreads];
+    unsigned* results[numThreads];
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        threads[t] = std::thread([allocator, &results, t]()
+        {
+            auto* values = static_cast<unsigned*>(allocator->Allocate(1000 * sizeof(unsigned)));
+            for (unsigned i = 0; i < 1000; ++i)
+                values[i] = t;
+            results[t] = values;
+        });
+    }
+    for (unsigned t = 0; t < numThreads; ++t)
+        threads[t].join();
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        for (unsigned i = 0; i < 1000; ++i)
+            REQUIRE(results[t][i] == t);
+    }
+    REQUIRE(allocator->GetNumArenas() == numThreads + 1);
+    time->EndFrame();
+    REQUIRE(allocator->GetThreadHighWaterMark() >= 1000 * sizeof(unsigned));
+}
+
+TEST_CASE("frame vector testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* time = context->RegisterSubsystem<Time>();
+    auto* allocator = context->RegisterSubsystem<FrameAllocator>();
+
+    FramePODVector<int> heapVector;
+    for (int i = 0; i < 100; ++i)
+        heapVector.Push(i);
+    REQUIRE(heapVector.Size() == 100);
+    REQUIRE(heapVector[99] == 99);
+
+    time->BeginFrame(0.016f);
+    FramePODVector<int> numbers(allocator);
+    for (int i = 0; i < 1000; ++i)
+        numbers.Push(i);
+    REQUIRE(numbers.Size() == 1000);
+    int sum = 0;
+    for (int value : numbers)
+        sum += value;
+    REQUIRE(sum == 999 * 1000 / 2);
+
+    FramePODVector<int> copy(numbers);
+    REQUIRE(copy.GetAllocator() == allocator);
+    REQUIRE(copy.Size() == 1000);
+    REQUIRE(copy[500] == 500);
+
+    FrameVector<Vector3> positions(allocator);
+    for (int i = 0; i < 100; ++i)
+        positions.Push(Vector3((float)i, 0.0f, 0.0f));
+    positions.Pop();
+    REQUIRE(positions.Size() == 99);
+    REQUIRE(positions.Back() == Vector3(98.0f, 0.0f, 0.0f));
+    positions.Resize(10);
+    REQUIRE(positions[9] == Vector3(9.0f, 0.0f, 0.0f));
+    positions.Resize(12);
+    REQUIRE(positions[11] == Vector3::ZERO);
+    time->EndFrame();
+
+    // After the frame has ended the contents are gone and clearing starts a fresh buffer
+    time->BeginFrame(0.016f);
+    numbers.Clear();
+    REQUIRE(numbers.Capacity() == 0);
+    numbers.Push(5);
+    REQUIRE(numbers.Size() == 1);
+    REQUIRE(numbers[0] == 5);
+    FramePODVector<int> staleCopy(copy);
+    REQUIRE(staleCopy.Empty());
+    positions.Clear();
+    REQUIRE(positions.Capacity() == 0);
+    positions.EmplaceBack(1.0f, 2.0f, 3.0f);
+    REQUIRE(positions.Front() == Vector3(1.0f, 2.0f, 3.0f));
+    time->EndFrame();
+    positions.Clear();
+}
+
+TEST_CASE("string hash testing", "[engine]")
+{
+    // Hashes of literals are constant expressions
+    constexpr StringHash hash("BeginFrame");
+    static_assert(hash.Value() == StringHash::Calculate("BeginFrame"), "Hash must be computed at compile time");
+    static_assert(StringHash("").Value() == 0, "Empty string must hash to zero");
+    static_assert(FrameAllocator::GetTypeStatic() == StringHash("FrameAllocator"), "Type hash must be computed at compile time");
+    REQUIRE(hash == E_BEGINFRAME);
+    REQUIRE(hash == StringHash(String("BeginFrame")));
+    REQUIRE(StringHash(static_cast<const char*>(nullptr)) == StringHash::ZERO);
+    REQUIRE(FrameAllocator::GetTypeStatic() == FrameAllocator::GetTypeInfoStatic()->GetType());
+
+    StringHashRegister hashRegister(true);
+    REQUIRE(hashRegister.RegisterString("Position") == StringHash("Position"));
+    hashRegister.RegisterString(StringHash("Rotation"), "Rotation");
+    hashRegister.RegisterString("Position");
+    REQUIRE(hashRegister.GetNumStrings() == 2);
+    REQUIRE(hashRegister.Contains(StringHash("Rotation")));
+    REQUIRE(!hashRegister.Contains(StringHash("Scale")));
+    REQUIRE(hashRegister.GetString(StringHash("Position")) == "Position");
+    REQUIRE(hashRegister.GetStringCopy(StringHash("Scale")).Empty());
+    REQUIRE(hashRegister.GetNumCollisions() == 0);
+
+    // "ZsS8kg" and "0fo7so" have the same SDBM hash. The first registered string is kept
+    REQUIRE(StringHash("ZsS8kg") == StringHash("0fo7so"));
+    hashRegister.RegisterString("ZsS8kg");
+    hashRegister.RegisterString("0fo7so");
+    REQUIRE(hashRegister.GetNumCollisions() == 1);
+    REQUIRE(hashRegister.GetString(StringHash("0fo7so")) == "ZsS8kg");
+
+    // Concurrent registration of the same names
+    hashRegister.Clear();
+    std::thread threads[4];
+    for (auto& thread : threads)
+    {
+        thread = std::thread([&hashRegister]() {
+            for (unsigned i = 0; i < 500; ++i)
+                hashRegister.RegisterString(("Name" + String(i)).CString());
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    REQUIRE(hashRegister.GetNumStrings() == 500);
+    REQUIRE(hashRegister.GetNumCollisions() == 0);
+
+#ifdef MY3D_HASH_DEBUG
+    REQUIRE(StringHash::GetGlobalStringHashRegister());
+    REQUIRE(E_BEGINFRAME.Reverse() == "BeginFrame");
+#else
+    REQUIRE(!StringHash::GetGlobalStringHashRegister());
+    REQUIRE(E_BEGINFRAME.Reverse().Empty());
+#endif
+}
+
+TEST_CASE("parallel sort testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+
+    unsigned seed = 54321;
+    PODVector<unsigned> source;
+    for (unsigned i = 0; i < 100000; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        source.Push(seed >> 8u);
+    }
+    auto compare = [](unsigned lhs, unsigned rhs) { return lhs < rhs; };
+
+    PODVector<unsigned> expected(source.Buffer(), source.Size());
+    Sort(expected.Begin(), expected.End(), compare);
+
+    // Without worker threads the sort runs in the calling thread
+    PODVector<unsigned> sorted(source.Buffer(), source.Size());
+    ParallelSort(queue, sorted.Begin(), sorted.End(), compare);
+    REQUIRE(sorted == expected);
+
+    // Odd thread counts leave an unpaired chunk at some merge levels
+    PODVector<unsigned> scratch;
+    queue->CreateThreads(4);
+    for (unsigned count : {100u, 5000u, 20000u, 100000u})
+    {
+        PODVector<unsigned> part(source.Buffer(), count);
+        PODVector<unsigned> partExpected(source.Buffer(), count);
+        Sort(partExpected.Begin(), partExpected.End(), compare);
+        ParallelSort(queue, part.Begin(), part.End(), compare, scratch);
+        REQUIRE(part == partExpected);
+    }
+}
+
+TEST_CASE("variant move testing", "[engine]")
+{
+    // Moving a string keeps its heap buffer
+    String name("a string that does not fit in the inline buffer");
+    const char* nameBuffer = name.CString();
+    Variant stringValue(std::move(name));
+    REQUIRE(stringValue.GetString().CString() == nameBuffer);
+
+    Variant moved(std::move(stringValue));
+    REQUIRE(stringValue.IsEmpty());
+    REQUIRE(moved.GetString().CString() == nameBuffer);
+
+    // Moving maps and vectors does not copy their elements
+    VariantMap map;
+    map[StringHash("name")] = std::move(moved);
+    map[StringHash("matrix")] = Matrix3(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f);
+    Variant mapValue(std::move(map));
+    REQUIRE(mapValue.GetVariantMap().Size() == 2);
+    REQUIRE((*mapValue.GetVariantMap()[StringHash("name")]).GetString().CString() == nameBuffer);
+
+    VariantVector vector;
+    vector.Push(std::move(mapValue));
+    vector.EmplaceBack(ResourceRef("Texture2D", "Textures/A long texture resource name.png"));
+    Variant vectorValue;
+    vectorValue = std::move(vector);
+    REQUIRE(mapValue.IsEmpty());
+
+    Variant matrixValue(*vectorValue.GetVariantVector()[0].GetVariantMap()[StringHash("matrix")]);
+    Variant movedMatrix;
+    movedMatrix = std::move(matrixValue);
+    REQUIRE(matrixValue.IsEmpty());
+    REQUIRE(movedMatrix.GetMatrix3().m22_ == 9.0f);
+
+    // Copies of resource references own their names
+    Variant refCopy = vectorValue.GetVariantVector()[1];
+    vectorValue.Clear();
+    REQUIRE(refCopy.GetResourceRef().name_ == "Textures/A long texture resource name.png");
+}
+
+static void CountWork(const WorkItem* item, unsigned threadIndex)
+{
+    reinterpret_cast<std::atomic<unsigned>*>(item->start_)->fetch_add(1);
+}
+
+static void GateWork(const WorkItem* item, unsigned threadIndex)
+{
+    reinterpret_cast<std::atomic<unsigned>*>(item->start_)->fetch_add(1);
+    while (!reinterpret_cast<std::atomic<bool>*>(item->aux_)->load())
+        std::this_thread::yield();
+}
+
+TEST_CASE("variant map testing", "[engine]")
+{
+    // The value holds a String with its inline buffer, while resource references and matrices are on the heap
+    REQUIRE(sizeof(VariantValue) == VARIANT_VALUE_SIZE);
+    REQUIRE(sizeof(Variant) <= VARIANT_VALUE_SIZE + sizeof(void*));
+
+    ResourceRef ref("Model", "Models/Box.mdl");
+    Variant refValue(ref);
+    Variant refCopy(refValue);
+    REQUIRE(refCopy == ref);
+    Variant refMoved(std::move(refValue));
+    REQUIRE(refValue.IsEmpty());
+    REQUIRE(refMoved.GetResourceRef() == ref);
+    refMoved = 1;
+    REQUIRE(refCopy.GetResourceRef().name_ == "Models/Box.mdl");
+
+    // Pairs are kept in insertion order, while maps with the same contents compare equal regardless of it
+    VariantMap first;
+    first[StringHash("Health")] = 100;
+    first[StringHash("Speed")] = 2.5f;
+    first[StringHash("Name")] = "Player";
+    VariantMap second;
+    second[StringHash("Name")] = "Player";
+    second[StringHash("Speed")] = 2.5f;
+    second[StringHash("Health")] = 100;
+    REQUIRE(first == second);
+    REQUIRE(first.Front().first_ == StringHash("Health"));
+    REQUIRE(second.Front().first_ == StringHash("Name"));
+
+    Variant mapValue(first);
+    REQUIRE(mapValue == second);
+    REQUIRE(mapValue.GetVariantMap()[StringHash("Speed")]->GetFloat() == 2.5f);
+    REQUIRE(mapValue.GetVariantMap()[StringHash("Missing")] == nullptr);
+
+    // Event data maps are cleared for reuse and keep their buffer
+    SharedPtr<Context> context(new Context());
+    VariantMap& eventData = context->GetEventDataMap();
+    eventData = first;
+    unsigned capacity = eventData.Capacity();
+    VariantMap& reused = context->GetEventDataMap();
+    REQUIRE(&reused == &eventData);
+    REQUIRE(reused.Empty());
+    REQUIRE(reused.Capacity() == capacity);
+}
+
+TEST_CASE("work stealing testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+    queue->SetWorkStealing(true);
+    queue->CreateThreads(3);
+    REQUIRE(queue->GetWorkStealing());
+    queue->SetWorkStealing(false);
+    REQUIRE(queue->GetWorkStealing());
+
+    for (unsigned round = 0; round < 20; ++round)
+    {
+        std::atomic<unsigned> high(0);
+        std::atomic<unsigned> low(0);
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = i % 10 ? M_MAX_UNSIGNED : 0;
+            item->workFunction_ = CountWork;
+            item->start_ = i % 10 ? &high : &low;
+            queue->AddWorkItem(item);
+        }
+
+        queue->Complete(M_MAX_UNSIGNED);
+        REQUIRE(high == 900);
+        REQUIRE(queue->IsCompleted(M_MAX_UNSIGNED));
+        queue->Complete(0);
+        REQUIRE(low == 100);
+        REQUIRE(queue->IsCompleted(0));
+    }
+
+    // Occupy all worker threads so that a new item stays queued and can be removed
+    std::atomic<unsigned> started(0);
+    std::atomic<bool> open(false);
+    for (unsigned i = 0; i < queue->GetNumThreads(); ++i)
+    {
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = GateWork;
+        item->start_ = &started;
+        item->aux_ = &open;
+        queue->AddWorkItem(item);
+    }
+    while (started < queue->GetNumThreads())
+        std::this_thread::yield();
+
+    std::atomic<unsigned> counter(0);
+    SharedPtr<WorkItem> item = queue->GetFreeItem();
+    item->workFunction_ = CountWork;
+    item->start_ = &counter;
+    queue->AddWorkItem(item);
+    REQUIRE(queue->RemoveWorkItem(item));
+    REQUIRE_FALSE(queue->RemoveWorkItem(item));
+
+    open = true;
+    queue->Complete(0);
+    REQUIRE(counter == 0);
+}
+
+TEST_CASE("work group testing", "[engine]")
+{
+    for (bool workStealing : {false, true})
+    {
+        SharedPtr<Context> context(new Context());
+        auto* queue = context->RegisterSubsystem<WorkQueue>();
+        queue->SetWorkStealing(workStealing);
+        queue->CreateThreads(3);
+
+        // Keep a low-priority item running in a worker thread, which completing the group must not wait for
+        std::atomic<unsigned> started(0);
+        std::atomic<bool> open(false);
+        SharedPtr<WorkItem> gate = queue->GetFreeItem();
+        gate->priority_ = 0;
+        gate->workFunction_ = GateWork;
+        gate->start_ = &started;
+        gate->aux_ = &open;
+        queue->AddWorkItem(gate);
+        while (!started)
+            std::this_thread::yield();
+
+        WorkGroup group;
+        std::atomic<unsigned> counter(0);
+        for (unsigned round = 0; round < 10; ++round)
+        {
+            for (unsigned i = 0; i < 100; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = M_MAX_UNSIGNED;
+                item->workFunction_ = CountWork;
+                item->start_ = &counter;
+                queue->AddWorkItem(item, &group);
+            }
+            REQUIRE(group.GetNumPending() + counter == 100 * (round + 1));
+
+            queue->Complete(group);
+            REQUIRE(group.IsCompleted());
+            REQUIRE(counter == 100 * (round + 1));
+            REQUIRE(queue->IsCompleted(M_MAX_UNSIGNED));
+            REQUIRE_FALSE(queue->IsCompleted(0));
+        }
+
+        // Removed items no longer count as pending. Occupy the other worker threads too, so that the item stays queued
+        for (unsigned i = 1; i < queue->GetNumThreads(); ++i)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = 0;
+            item->workFunction_ = GateWork;
+            item->start_ = &started;
+            item->aux_ = &open;
+            queue->AddWorkItem(item);
+        }
+        while (started < queue->GetNumThreads())
+            std::this_thread::yield();
+
+        SharedPtr<WorkItem> removed = queue->GetFreeItem();
+        removed->priority_ = 0;
+        removed->workFunction_ = CountWork;
+        removed->start_ = &counter;
+        queue->AddWorkItem(removed, &group);
+        REQUIRE(group.GetNumPending() == 1);
+        REQUIRE(queue->RemoveWorkItem(removed));
+        REQUIRE(group.IsCompleted());
+        queue->Complete(group);
+
+        open = true;
+        queue->Complete(0);
+        REQUIRE(queue->IsCompleted(0));
+        REQUIRE(counter == 1000);
+
+        // Counters of finished priorities are reused for new ones without mixing up their counts
+        for (unsigned priority = 1; priority <= 100; ++priority)
+        {
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = i % 2 ? priority : priority + 1000;
+                item->workFunction_ = CountWork;
+                item->start_ = &counter;
+                queue->AddWorkItem(item, &group);
+            }
+            queue->Complete(group);
+            REQUIRE(queue->IsCompleted(0));
+        }
+        REQUIRE(counter == 1400);
+    }
+}
+
+TEST_CASE("task graph testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+
+    for (unsigned numThreads : {0u, 3u})
+    {
+        if (numThreads)
+            queue->CreateThreads(numThreads);
+
+        TaskGraph graph(queue);
+        for (unsigned round = 0; round < 10; ++round)
+        {
+            // Diamond: a before b and c, which are before d
+            std::atomic<unsigned> clock(0);
+            unsigned a = 0, b = 0, c = 0, d = 0;
+            Task* taskA = graph.AddTask([&](Task*, unsigned) { a = ++clock; });
+            Task* taskB = graph.AddTask([&](Task*, unsigned) { b = ++clock; });
+            Task* taskC = graph.AddTask([&](Task*, unsigned) { c = ++clock; });
+            Task* taskD = graph.AddTask([&](Task*, unsigned) { d = ++clock; });
+            graph.AddDependency(taskB, taskA);
+            graph.AddDependency(taskC, taskA);
+            graph.AddDependency(taskD, taskB);
+            graph.AddDependency(taskD, taskC);
+
+            // Children and a continuation that combines their results before the successor runs
+            std::atomic<unsigned> sum(0);
+            unsigned combined = 0;
+            unsigned checked = 0;
+            Task* parent = graph.AddTask([&](Task* task, unsigned)
+            {
+                for (unsigned i = 1; i <= 100; ++i)
+                {
+                    graph.Spawn(task, [&sum](Task* child, unsigned)
+                    {
+                        sum += (unsigned)(size_t)child->data_;
+                    }, (void*)(size_t)i);
+                }
+                graph.AddContinuation(task, [&](Task*, unsigned) { combined = sum; });
+                graph.AddContinuation(task, [&](Task*, unsigned) { combined *= 2; });
+            });
+            Task* after = graph.AddTask([&](Task*, unsigned) { checked = combined; });
+            graph.AddDependency(after, parent);
+            graph.AddDependency(after, taskD);
+
+            graph.Run();
+            REQUIRE(a == 1);
+            REQUIRE(b > a);
+            REQUIRE(c > a);
+            REQUIRE(d > b);
+            REQUIRE(d > c);
+            REQUIRE(combined == 10100);
+            REQUIRE(checked == 10100);
+            REQUIRE(graph.GetNumTasks() == 108);
+            REQUIRE(taskD->IsFinished());
+            REQUIRE(after->IsFinished());
+
+            // Running again without clearing is refused instead of waiting forever
+            graph.Run();
+            REQUIRE(a == 1);
+            REQUIRE(combined == 10100);
+            REQUIRE_FALSE(graph.IsRunning());
+            graph.Clear();
+            REQUIRE(graph.GetNumTasks() == 0);
+        }
+
+        // Tasks that complete a parallel for, which may take queued runners in the main thread, do not wait for themselves
+        std::atomic<unsigned> total(0);
+        for (unsigned i = 0; i < 8; ++i)
+        {
+            graph.AddTask([&](Task*, unsigned)
+            {
+                queue->ParallelFor(0, 1000, 10, [&](unsigned begin, unsigned end, unsigned)
+                {
+                    total += end - begin;
+                });
+            });
+        }
+        graph.Run();
+        REQUIRE(total == 8000);
+        graph.Clear();
+    }
+}
+
+TEST_CASE("parallel for testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+
+    for (unsigned numThreads : {0u, 3u})
+    {
+        if (numThreads)
+            queue->CreateThreads(numThreads);
+
+        PODVector<unsigned> values(10000);
+        PODVector<unsigned> visits(10000);
+        for (unsigned i = 0; i < values.Size(); ++i)
+        {
+            values[i] = i;
+            visits[i] = 0;
+        }
+
+        std::atomic<unsigned> numChunks(0);
+        std::atomic<unsigned> maxThreadIndex(0);
+        queue->ParallelFor(100, 9900, 64, [&](unsigned begin, unsigned end, unsigned threadIndex)
+        {
+            for (unsigned i = begin; i < end; ++i)
+                ++visits[i];
+            ++numChunks;
+            unsigned current = maxThreadIndex;
+            while (threadIndex > current && !maxThreadIndex.compare_exchange_weak(current, threadIndex))
+                ;
+        });
+        REQUIRE(numChunks == numThreads + 1);
+        REQUIRE(maxThreadIndex <= numThreads);
+        for (unsigned i = 0; i < visits.Size(); ++i)
+            REQUIRE(visits[i] == (i >= 100 && i < 9900 ? 1u : 0u));
+
+        // Small ranges run as one chunk, empty ranges not at all
+        numChunks = 0;
+        queue->ParallelFor(0, 64, 64, [&](unsigned begin, unsigned end, unsigned threadIndex)
+        {
+            REQUIRE(begin == 0);
+            REQUIRE(end == 64);
+            REQUIRE(threadIndex == 0);
+            ++numChunks;
+        });
+        queue->ParallelFor(5, 5, 1, [&](unsigned, unsigned, unsigned) { ++numChunks; });
+        REQUIRE(numChunks == 1);
+
+        unsigned sum = queue->ParallelReduce(0, values.Size(), 1, 0u, [&](unsigned begin, unsigned end, unsigned)
+        {
+            unsigned chunkSum = 0;
+            for (unsigned i = begin; i < end; ++i)
+                chunkSum += values[i];
+            return chunkSum;
+        }, [](unsigned lhs, unsigned rhs) { return lhs + rhs; });
+        REQUIRE(sum == 10000 * 9999 / 2);
+
+        // The chunk results are combined in range order
+        String joined = queue->ParallelReduce(0, 8, 1, String(), [](unsigned begin, unsigned end, unsigned)
+        {
+            String chunk;
+            for (unsigned i = begin; i < end; ++i)
+                chunk += String(i);
+            return chunk;
+        }, [](const String& lhs, const String& rhs) { return lhs + rhs; });
+        REQUIRE(joined == "01234567");
+        REQUIRE(queue->ParallelReduce(3, 3, 1, 7, [](unsigned, unsigned, unsigned) { return 1; },
+            [](int lhs, int rhs) { return lhs + rhs; }) == 7);
+    }
+}
+
+static void ProfiledWork(const WorkItem* item, unsigned threadIndex)
+{
+    AutoProfileBlock block("ProfiledWork");
+    Time::Sleep(1);
+}
+
+TEST_CASE("profiler testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem<Time>();
+    auto* profiler = context->RegisterSubsystem<Profiler>();
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+    queue->CreateThreads(2);
+    REQUIRE(Profiler::GetActive() == profiler);
+
+    for (unsigned frame = 0; frame < 3; ++frame)
+    {
+        profiler->BeginFrame();
+        {
+            AutoProfileBlock outer("Outer");
+            for (unsigned i = 0; i <= frame; ++i)
+            {
+                AutoProfileBlock inner("Inner");
+                Time::Sleep(1);
+            }
+        }
+        if (frame == 2)
+        {
+            // Names are matched by contents, not only by pointer
+            String name("Outer");
+            profiler->BeginBlock(name.CString());
+            profiler->EndBlock();
+        }
+
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = 0;
+            item->workFunction_ = ProfiledWork;
+            queue->AddWorkItem(item);
+        }
+        queue->Complete(0);
+
+        // An unmatched end is ignored
+        profiler->EndBlock();
+        profiler->EndFrame();
+    }
+
+    REQUIRE(profiler->GetIntervalFrames() == 3);
+    REQUIRE(profiler->GetNumThreads() >= 2);
+    REQUIRE(profiler->GetThreadName(0) == "Main thread");
+    REQUIRE(profiler->GetRootBlock(profiler->GetNumThreads()) == nullptr);
+
+    const ProfilerBlock* root = profiler->GetRootBlock(0);
+    const ProfilerBlock* outer = root->FindChild("Outer");
+    REQUIRE(outer);
+    REQUIRE(outer->GetIntervalCount() == 4);
+    REQUIRE(outer->GetIntervalFrames() == 3);
+    const ProfilerBlock* inner = outer->FindChild("Inner");
+    REQUIRE(inner);
+    REQUIRE(inner->GetParent() == outer);
+    REQUIRE(inner->GetIntervalCount() == 6);
+    REQUIRE(inner->GetFrameCount() == 3);
+    REQUIRE(inner->GetIntervalMinTime() >= 1000);
+    REQUIRE(inner->GetIntervalMaxTime() >= 3000);
+    REQUIRE(inner->GetIntervalAverageTime() >= inner->GetIntervalMinTime());
+    REQUIRE(inner->GetIntervalAverageTime() <= inner->GetIntervalMaxTime());
+    REQUIRE(outer->GetIntervalTime() >= inner->GetIntervalTime());
+
+    // The work items ran in their own threads' trees or in the main thread while completing
+    unsigned workCount = 0;
+    for (unsigned i = 0; i < profiler->GetNumThreads(); ++i)
+    {
+        const ProfilerBlock* work = profiler->GetRootBlock(i)->FindChild("ProfiledWork");
+        if (!work)
+            work = profiler->GetRootBlock(i)->FindChild("WorkItem") ?
+                profiler->GetRootBlock(i)->FindChild("WorkItem")->FindChild("ProfiledWork") : nullptr;
+        if (work)
+            workCount += work->GetIntervalCount();
+    }
+    REQUIRE(workCount == 12);
+
+    String report = profiler->PrintData();
+    REQUIRE(report.Contains("Main thread"));
+    REQUIRE(report.Contains("  Outer"));
+    REQUIRE(report.Contains("    Inner"));
+    REQUIRE(report.Contains("ProfiledWork"));
+    REQUIRE_FALSE(profiler->PrintData(false, 1).Contains("Inner"));
+
+    profiler->BeginInterval();
+    REQUIRE(profiler->GetIntervalFrames() == 0);
+    REQUIRE(outer->GetIntervalCount() == 0);
+    REQUIRE_FALSE(profiler->PrintData().Contains("Outer"));
+    REQUIRE(profiler->PrintData(true).Contains("Outer"));
+}
+
+static unsigned CountOccurrences(const String& str, const String& pattern)
+{
+    unsigned count = 0;
+    for (unsigned pos = str.Find(pattern); pos != String::NPOS; pos = str.Find(pattern, pos + 1))
+        ++count;
+    return count;
+}
+
+TEST_CASE("trace recorder testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem<Time>();
+    auto* recorder = context->RegisterSubsystem<TraceRecorder>();
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+    queue->CreateThreads(2);
+    REQUIRE(TraceRecorder::GetActive() == recorder);
+
+    for (unsigned frame = 0; frame < 4; ++frame)
+    {
+        recorder->BeginFrame();
+        {
+            AutoTraceEvent outer(frame ? "Outer" : "FirstFrame");
+            AutoTraceEvent event("Event", StringHash("Update").Value());
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = 0;
+                item->workFunction_ = ProfiledWork;
+                queue->AddWorkItem(item);
+            }
+            queue->Complete(0);
+        }
+        recorder->EndFrame();
+    }
+
+    REQUIRE(recorder->GetNumFrames() == 4);
+    REQUIRE(recorder->GetNumThreads() >= 1);
+
+    String json = recorder->ToJSON();
+    REQUIRE(json.StartsWith("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    REQUIRE(json.Contains("\"args\":{\"name\":\"Main thread\"}"));
+    REQUIRE(json.Contains("\"name\":\"FirstFrame\""));
+    REQUIRE(json.Contains("\"name\":\"Frame\""));
+    REQUIRE(json.Contains("\"name\":\"Event\",\"args\":{\"arg\":"));
+    REQUIRE(CountOccurrences(json, "\"name\":\"ProfiledWork\"") == 16);
+    REQUIRE(CountOccurrences(json, "\"ph\":\"B\"") == CountOccurrences(json, "\"ph\":\"E\""));
+    if (recorder->GetNumThreads() > 1)
+        REQUIRE(json.Contains("\"args\":{\"name\":\"Worker thread"));
+
+    // Only the last frames are included, and events of earlier frames are left out
+    String lastFrames = recorder->ToJSON(2);
+    REQUIRE_FALSE(lastFrames.Contains("FirstFrame"));
+    REQUIRE(CountOccurrences(lastFrames, "\"name\":\"Frame\"") == 2);
+    REQUIRE(CountOccurrences(lastFrames, "\"name\":\"Outer\"") == 2);
+
+    // Disabled recording leaves no events
+    recorder->SetEnabled(false);
+    {
+        AutoTraceEvent event("Disabled");
+    }
+    recorder->SetEnabled(true);
+    REQUIRE_FALSE(recorder->ToJSON().Contains("Disabled"));
+
+    // Names are escaped
+    {
+        AutoTraceEvent event("Quote\"Name");
+    }
+    REQUIRE(recorder->ToJSON().Contains("\"Quote\\\"Name\""));
+
+    // A slow frame saves the last frames, and the next frames are not checked until as many have passed
+    recorder->SetAutoDump(1000, 2, "TestTrace.json");
+    for (unsigned frame = 0; frame < 3; ++frame)
+    {
+        recorder->BeginFrame();
+        Time::Sleep(3);
+        recorder->EndFrame();
+    }
+    REQUIRE(recorder->GetNumAutoDumps() == 2);
+    FILE* file = fopen("TestTrace_5.json", "rb");
+    REQUIRE(file);
+    fclose(file);
+    remove("TestTrace_5.json");
+    remove("TestTrace_7.json");
+}
+
+TEST_CASE("trace recorder buffer testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem<Time>();
+    auto* recorder = context->RegisterSubsystem<TraceRecorder>();
+    recorder->SetBufferSize(6);
+    REQUIRE(recorder->GetBufferSize() == 8);
+
+    // Only the latest events are kept, minus the oldest slot, which the recording thread may be overwriting. End events
+    // whose begin was dropped are left out
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        AutoTraceEvent event("Event");
+    }
+    String json = recorder->ToJSON();
+    REQUIRE(CountOccurrences(json, "\"ph\":\"B\"") == 3);
+    REQUIRE(CountOccurrences(json, "\"ph\":\"E\"") == 3);
+}
+
+MY3D_EVENT(E_TESTTYPED, TestTyped)
+{
+    MY3D_PARAM(P_VALUE, Value);
+
+    struct Payload
+    {
+        MY3D_TYPED_EVENT(E_TESTTYPED)
+
+        void ToVariantMap(VariantMap& eventData) const { eventData[P_VALUE] = value_; }
+
+        int value_;
+    };
+}
+
+class TypedReceiver : public Object
+{
+    MY3D_OBJECT(TypedReceiver, Object)
+
+public:
+    explicit TypedReceiver(Context* context)
+        : Object(context)
+    {
+    }
+
+    void HandleTyped(const TestTyped::Payload& data)
+    {
+        sum_ += data.value_;
+        sender_ = GetEventSender();
+        if (calls_)
+            ++*calls_;
+        if (victim_)
+            victim_.Reset();
+    }
+
+    void HandleTypedTwice(const TestTyped::Payload& data)
+    {
+        sum_ += data.value_ * 2;
+    }
+
+    int sum_{};
+    Object* sender_{};
+    int* calls_{};
+    SharedPtr<TypedReceiver> victim_;
+};
+
+TEST_CASE("typed event testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    SharedPtr<TypedReceiver> sender(new TypedReceiver(context));
+    SharedPtr<TypedReceiver> first(new TypedReceiver(context));
+    SharedPtr<TypedReceiver> second(new TypedReceiver(context));
+
+    first->SubscribeToEvent(&TypedReceiver::HandleTyped);
+    second->SubscribeToEvent(&TypedReceiver::HandleTyped);
+    REQUIRE(first->HasSubscribedToEvent(E_TESTTYPED));
+
+    sender->SendEvent(TestTyped::Payload{3});
+    REQUIRE(first->sum_ == 3);
+    REQUIRE(second->sum_ == 3);
+    REQUIRE(first->sender_ == sender);
+
+    // Subscribing again replaces the handler
+    first->SubscribeToEvent(&TypedReceiver::HandleTypedTwice);
+    sender->SendEvent(TestTyped::Payload{1});
+    REQUIRE(first->sum_ == 5);
+    REQUIRE(context->GetTypedEventReceivers(E_TESTTYPED)->handlers_.Size() == 2);
+
+    // VariantMap handlers get the payload converted
+    int converted = 0;
+    SharedPtr<TypedReceiver> legacy(new TypedReceiver(context));
+    legacy->SubscribeToEvent(E_TESTTYPED, [&](StringHash eventType, VariantMap& eventData)
+    {
+        converted += eventData[TestTyped::P_VALUE].GetInt();
+    });
+    sender->SendEvent(TestTyped::Payload{4});
+    REQUIRE(converted == 4);
+    REQUIRE(second->sum_ == 8);
+    legacy->UnsubscribeFromAllEvents();
+    sender->SendEvent(TestTyped::Payload{1});
+    REQUIRE(converted == 4);
+
+    // A receiver destroyed during the send is not invoked
+    int victimCalls = 0;
+    first->SubscribeToEvent(&TypedReceiver::HandleTyped);
+    first->victim_ = second;
+    second->calls_ = &victimCalls;
+    second.Reset();
+    sender->SendEvent(TestTyped::Payload{1});
+    REQUIRE(!first->victim_);
+    REQUIRE(victimCalls == 0);
+    REQUIRE(context->GetTypedEventReceivers(E_TESTTYPED)->handlers_.Size() == 1);
+
+    // Unsubscribing by event type removes the typed handler
+    first->UnsubscribeFromEvent(E_TESTTYPED);
+    REQUIRE_FALSE(first->HasSubscribedToEvent(E_TESTTYPED));
+    int firstSum = first->sum_;
+    sender->SendEvent(TestTyped::Payload{10});
+    REQUIRE(first->sum_ == firstSum);
+    REQUIRE(context->GetTypedEventReceivers(E_TESTTYPED)->handlers_.Empty());
+}
+
+MY3D_EVENT(E_TESTPOSTED, TestPosted)
+{
+    MY3D_PARAM(P_THREAD, Thread);
+    MY3D_PARAM(P_VALUE, Value);
+}
+
+TEST_CASE("posted event testing", "[engine]")
+{
+    static const unsigned NUM_THREADS = 4;
+    static const unsigned NUM_EVENTS = 1000;
+
+    SharedPtr<Context> context(new Context());
+    auto* time = context->RegisterSubsystem<Time>();
+    SharedPtr<TypedReceiver> sender(new TypedReceiver(context));
+    SharedPtr<TypedReceiver> receiver(new TypedReceiver(context));
+
+    PODVector<unsigned> received[NUM_THREADS];
+    receiver->SubscribeToEvent(E_TESTPOSTED, [&](StringHash eventType, VariantMap& eventData)
+    {
+        using namespace TestPosted;
+        received[eventData[P_THREAD].GetUInt()].Push(eventData[P_VALUE].GetUInt());
+    });
+
+    // Events posted from several threads are sent in the main thread, in posting order per thread
+    std::thread threads[NUM_THREADS];
+    for (unsigned i = 0; i < NUM_THREADS; ++i)
+    {
+        threads[i] = std::thread([&, i]()
+        {
+            using namespace TestPosted;
+            VariantMap eventData;
+            for (unsigned j = 0; j < NUM_EVENTS; ++j)
+            {
+                eventData[P_THREAD] = i;
+                eventData[P_VALUE] = j;
+                sender->PostEvent(E_TESTPOSTED, eventData);
+            }
+        });
+    }
+    for (unsigned i = 0; i < NUM_THREADS; ++i)
+        threads[i].join();
+
+    REQUIRE(context->HasPostedEvents());
+    REQUIRE(received[0].Empty());
+    context->SendPostedEvents();
+    REQUIRE_FALSE(context->HasPostedEvents());
+    for (unsigned i = 0; i < NUM_THREADS; ++i)
+    {
+        REQUIRE(received[i].Size() == NUM_EVENTS);
+        for (unsigned j = 0; j < NUM_EVENTS; ++j)
+            REQUIRE(received[i][j] == j);
+        received[i].Clear();
+    }
+
+    // Only the newest coalescing event of a sender is sent
+    std::thread progress([&]()
+    {
+        using namespace TestPosted;
+        VariantMap eventData;
+        for (unsigned j = 0; j < 100; ++j)
+        {
+            eventData[P_THREAD] = 0;
+            eventData[P_VALUE] = j;
+            sender->PostEvent(E_TESTPOSTED, eventData, true);
+            eventData[P_THREAD] = 1;
+            receiver->PostEvent(E_TESTPOSTED, eventData, j % 10 != 0);
+        }
+    });
+    progress.join();
+    context->SendPostedEvents();
+    REQUIRE(received[0].Size() == 1);
+    REQUIRE(received[0][0] == 99);
+    REQUIRE(received[1].Size() == 11);
+    REQUIRE(received[1][9] == 90);
+    REQUIRE(received[1][10] == 99);
+    received[0].Clear();
+    received[1].Clear();
+
+    // Events of destroyed senders are dropped
+    {
+        SharedPtr<TypedReceiver> temporary(new TypedReceiver(context));
+        VariantMap eventData;
+        eventData[TestPosted::P_THREAD] = 0;
+        temporary->PostEvent(E_TESTPOSTED, eventData);
+    }
+    context->SendPostedEvents();
+    REQUIRE(received[0].Empty());
+
+    // Posted events are sent before the flush event, and log messages of other threads are written in the main thread
+    auto* log = context->RegisterSubsystem<Log>();
+    log->SetQuiet(true);
+    VariantMap flushData;
+    flushData[TestPosted::P_THREAD] = 2;
+    std::thread logger([&]()
+    {
+        sender->PostEvent(E_TESTPOSTED, flushData);
+        MY3D_LOGINFO("Message from another thread");
+    });
+    logger.join();
+    REQUIRE(log->GetLastMessage().Empty());
+    time->BeginFrame(0.016f);
+    time->EndFrame();
+    REQUIRE(received[2].Size() == 1);
+    REQUIRE(log->GetLastMessage() == "Message from another thread");
+
+    context->SetPostedEventsFlush(StringHash());
+    sender->PostEvent(E_TESTPOSTED, flushData);
+    time->BeginFrame(0.016f);
+    time->EndFrame();
+    REQUIRE(received[2].Size() == 1);
+    REQUIRE(context->HasPostedEvents());
+}
+
+TEST_CASE("specific event receivers testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    SharedPtr<TypedReceiver> sender(new TypedReceiver(context));
+
+    // Receivers subscribed both to the sender and to all senders are called once, also beyond the inline receiver list
+    for (unsigned numReceivers : {4u, 40u})
+    {
+        Vector<SharedPtr<TypedReceiver> > receivers;
+        PODVector<unsigned> calls(numReceivers);
+        for (unsigned i = 0; i < numReceivers; ++i)
+        {
+            calls[i] = 0;
+            SharedPtr<TypedReceiver> receiver(new TypedReceiver(context));
+            auto handler = [&calls, i](StringHash, VariantMap&) { ++calls[i]; };
+            receiver->SubscribeToEvent(sender, E_TESTPOSTED, new EventHandler11Impl(handler));
+            receiver->SubscribeToEvent(E_TESTPOSTED, handler);
+            receivers.Push(receiver);
+        }
+        SharedPtr<TypedReceiver> general(new TypedReceiver(context));
+        unsigned generalCalls = 0;
+        general->SubscribeToEvent(E_TESTPOSTED, [&](StringHash, VariantMap&) { ++generalCalls; });
+
+        sender->SendEvent(E_TESTPOSTED);
+        for (unsigned i = 0; i < numReceivers; ++i)
+            REQUIRE(calls[i] == 1);
+        REQUIRE(generalCalls == 1);
+    }
+}
+
+TEST_CASE("pooled factory testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterFactory<TypedReceiver>();
+    ObjectFactory* factory = context->GetObjectFactory(TypedReceiver::GetTypeStatic());
+    REQUIRE(factory);
+    REQUIRE_FALSE(factory->IsPooled());
+    REQUIRE(factory->GetPoolStats().capacity_ == 0);
+
+    context->RegisterFactory<TypedReceiver>(true);
+    factory = context->GetObjectFactory(TypedReceiver::GetTypeStatic());
+    REQUIRE(factory->IsPooled());
+
+    // The pool is shared by all contexts, so compare against the starting statistics
+    unsigned live = factory->GetPoolStats().liveNodes_;
+    Vector<SharedPtr<TypedReceiver> > objects;
+    for (unsigned i = 0; i < 100; ++i)
+        objects.Push(context->CreateObject<TypedReceiver>());
+    REQUIRE(objects.Back()->GetType() == TypedReceiver::GetTypeStatic());
+    REQUIRE(factory->GetPoolStats().liveNodes_ == live + 100);
+
+    // Releasing the last reference returns the memory to the pool, and the next object reuses it
+    TypedReceiver* released = objects.Back();
+    WeakPtr<TypedReceiver> weak(released);
+    objects.Pop();
+    REQUIRE(weak.Expired());
+    REQUIRE(factory->GetPoolStats().liveNodes_ == live + 99);
+    objects.Push(context->CreateObject<TypedReceiver>());
+    REQUIRE(objects.Back().Get() == released);
+
+    unsigned capacity = factory->GetPoolStats().capacity_;
+    objects.Clear();
+    REQUIRE(factory->GetPoolStats().liveNodes_ == live);
+    for (unsigned i = 0; i < 100; ++i)
+        objects.Push(context->CreateObject<TypedReceiver>());
+    REQUIRE(factory->GetPoolStats().capacity_ == capacity);
+    objects.Clear();
+
+    // Reserving for a burst grows the pool once
+    factory->ReservePool(1000);
+    capacity = factory->GetPoolStats().capacity_;
+    REQUIRE(capacity >= live + 1000);
+    for (unsigned i = 0; i < 1000; ++i)
+        objects.Push(context->CreateObject<TypedReceiver>());
+    REQUIRE(factory->GetPoolStats().capacity_ == capacity);
+    REQUIRE(factory->GetPoolStats().liveNodes_ == live + 1000);
+}
+
+TEST_CASE("synchronization primitives testing", "[engine]")
+{
+    // Condition variable hands values over between threads without loss
+    {
+        Mutex mutex;
+        ConditionVariable condition;
+        unsigned value = 0;
+        bool ready = false;
+        unsigned sum = 0;
+        std::thread consumer([&]()
+        {
+            for (unsigned i = 1; i <= 100; ++i)
+            {
+                MutexLock lock(mutex);
+                condition.Wait(mutex, [&]() { return ready; });
+                sum += value;
+                ready = false;
+                condition.NotifyAll();
+            }
+        });
+        for (unsigned i = 1; i <= 100; ++i)
+        {
+            MutexLock lock(mutex);
+            condition.Wait(mutex, [&]() { return !ready; });
+            value = i;
+            ready = true;
+            condition.NotifyAll();
+        }
+        consumer.join();
+        REQUIRE(sum == 5050);
+
+        // A timed wait without notification times out
+        MutexLock lock(mutex);
+        HiresTimer timer;
+        REQUIRE_FALSE(condition.WaitFor(mutex, 10));
+        REQUIRE(timer.GetUSec(false) >= 9000);
+    }
+
+    // Readers share the reader-writer mutex, a writer excludes them
+    {
+        ReadWriteMutex mutex;
+        mutex.AcquireShared();
+        REQUIRE(mutex.TryAcquireShared());
+        REQUIRE_FALSE(mutex.TryAcquire());
+        mutex.ReleaseShared();
+        mutex.ReleaseShared();
+        {
+            WriteLock lock(mutex);
+            bool sharedAcquired = true;
+            std::thread reader([&]()
+            {
+                sharedAcquired = mutex.TryAcquireShared();
+                if (sharedAcquired)
+                    mutex.ReleaseShared();
+            });
+            reader.join();
+            REQUIRE_FALSE(sharedAcquired);
+        }
+
+        unsigned values[2] = {};
+        bool consistent = true;
+        std::thread writer([&]()
+        {
+            for (unsigned i = 0; i < 10000; ++i)
+            {
+                WriteLock lock(mutex);
+                ++values[0];
+                ++values[1];
+            }
+        });
+        std::thread readers[2];
+        for (auto& reader : readers)
+        {
+            reader = std::thread([&]()
+            {
+                for (unsigned i = 0; i < 10000; ++i)
+                {
+                    ReadLock lock(mutex);
+                    if (values[0] != values[1])
+                        consistent = false;
+                }
+            });
+        }
+        writer.join();
+        for (auto& reader : readers)
+            reader.join();
+        REQUIRE(consistent);
+        REQUIRE(values[0] == 10000);
+    }
+
+    // Semaphore counts releases and times out when none are available
+    {
+        Semaphore semaphore(2);
+        REQUIRE(semaphore.TryAcquire());
+        REQUIRE(semaphore.TryAcquire());
+        REQUIRE_FALSE(semaphore.TryAcquire());
+        REQUIRE_FALSE(semaphore.TryAcquire(10));
+
+        std::thread producer([&]() { semaphore.Release(3); });
+        semaphore.Acquire();
+        semaphore.Acquire();
+        producer.join();
+        REQUIRE(semaphore.GetCount() == 1);
+        REQUIRE(semaphore.TryAcquire(10));
+    }
+
+    // Spin lock protects a counter incremented from several threads
+    {
+        SpinLock lock;
+        unsigned counter = 0;
+        std::thread threads[4];
+        for (auto& thread : threads)
+        {
+            thread = std::thread([&]()
+            {
+                for (unsigned i = 0; i < 10000; ++i)
+                {
+                    SpinLockGuard guard(lock);
+                    ++counter;
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        REQUIRE(counter == 40000);
+        REQUIRE(lock.TryAcquire());
+        REQUIRE_FALSE(lock.TryAcquire());
+        lock.Release();
+    }
+
+    // Manual reset event stays set, automatic reset event wakes one waiter and resets
+    {
+        Event manual;
+        REQUIRE_FALSE(manual.IsSet());
+        REQUIRE_FALSE(manual.Wait(10));
+        std::thread setter([&]() { manual.Set(); });
+        manual.Wait();
+        setter.join();
+        REQUIRE(manual.IsSet());
+        REQUIRE(manual.Wait(0));
+        manual.Reset();
+        REQUIRE_FALSE(manual.IsSet());
+
+        Event automatic(false);
+        automatic.Set();
+        REQUIRE(automatic.Wait(0));
+        REQUIRE_FALSE(automatic.IsSet());
+        REQUIRE_FALSE(automatic.Wait(10));
+    }
+}
+
+TEST_CASE("cpu topology testing", "[engine]")
+{
+    const CPUTopology& topology = GetCPUTopology();
+    REQUIRE_FALSE(topology.cpus_.Empty());
+    REQUIRE(topology.numCores_ >= 1);
+    REQUIRE(topology.numCores_ <= topology.cpus_.Size());
+    REQUIRE(GetNumPhysicalCPUs() == topology.numCores_);
+    REQUIRE(GetNumLogicalCPUs() == topology.cpus_.Size());
+    for (const CPUInfo& cpu : topology.cpus_)
+    {
+        REQUIRE(cpu.core_ < topology.numCores_);
+        REQUIRE(cpu.cacheGroup_ < topology.numCacheGroups_);
+        REQUIRE(cpu.numaNode_ < topology.numNumaNodes_);
+        REQUIRE(cpu.package_ < topology.numPackages_);
+    }
+
+    // Worker threads are named and pinned to one core each
+    SharedPtr<Context> context(new Context());
+    auto* queue = context->RegisterSubsystem<WorkQueue>();
+    queue->SetWorkerAffinity(WORKER_AFFINITY_CORE);
+    queue->CreateThreads(2);
+    REQUIRE(queue->GetWorkerAffinity() == WORKER_AFFINITY_CORE);
+
+    struct WorkerState
+    {
+        String name_;
+        String systemName_;
+        unsigned numCPUs_{};
+    };
+    WorkerState states[3];
+    std::atomic<unsigned> numRun(0);
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->start_ = states;
+        item->aux_ = &numRun;
+        item->workFunction_ = [](const WorkItem* item, unsigned threadIndex)
+        {
+            WorkerState& state = static_cast<WorkerState*>(item->start_)[threadIndex];
+            state.name_ = Thread::GetCurrentThreadName();
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            pthread_getaffinity_np(pthread_self(), sizeof set, &set);
+            state.numCPUs_ = CPU_COUNT(&set);
+            char systemName[16];
+            pthread_getname_np(pthread_self(), systemName, sizeof systemName);
+            state.systemName_ = systemName;
+#endif
+            // Keep the worker busy so that the other item goes to the other worker
+            auto* numRun = static_cast<std::atomic<unsigned>*>(item->aux_);
+            ++*numRun;
+            HiresTimer timer;
+            while (*numRun < 2 && timer.GetUSec(false) < 100000)
+                std::this_thread::yield();
+        };
+        queue->AddWorkItem(item);
+    }
+    while (numRun < 2)
+        std::this_thread::yield();
+    queue->Complete(M_MAX_UNSIGNED);
+
+    for (unsigned i = 1; i <= 2; ++i)
+    {
+        if (states[i].name_.Empty())
+            continue;
+        REQUIRE(states[i].name_ == "Worker thread " + String(i));
+#ifdef __linux__
+        REQUIRE(states[i].systemName_ == "Worker thread " + String(i));
+        if (topology.numCores_ > 1)
+        {
+            REQUIRE(states[i].numCPUs_ >= 1);
+            REQUIRE(states[i].numCPUs_ < topology.cpus_.Size());
+        }
+#endif
+    }
+}
+
+/// Run a frame that spends about the given microseconds in the update phase.
+static void RunTimedFrame(Time* time, long long uSec)
+{
+    time->BeginFrame(0.016f);
+    HiresTimer timer;
+    while (timer.GetUSec(false) < uSec)
+    {
+    }
+    time->MarkFramePhase(FRAME_PHASE_UPDATE);
+    time->EndFrame();
+}
+
+TEST_CASE("frame time statistics testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    auto* time = context->RegisterSubsystem<Time>();
+    SharedPtr<TypedReceiver> receiver(new TypedReceiver(context));
+
+    REQUIRE(time->GetFrameTimeStats().numFrames_ == 0);
+    REQUIRE(time->GetFrameTimePercentile(99.0f) == 0);
+
+    // Short frames with a few hitches
+    time->SetHitchThreshold(10000);
+    for (unsigned i = 0; i < 100; ++i)
+        RunTimedFrame(time, i % 25 == 24 ? 20000 : 500);
+
+    FrameTimeStats stats = time->GetFrameTimeStats();
+    REQUIRE(stats.numFrames_ == 100);
+    REQUIRE(stats.numHitches_ >= 4);
+    REQUIRE(stats.p50_ >= 500);
+    REQUIRE(stats.p50_ < 10000);
+    REQUIRE(stats.p99_ >= 20000);
+    REQUIRE(stats.max_ >= stats.p99_);
+    REQUIRE(stats.p95_ <= stats.p99_);
+    REQUIRE(stats.mean_ >= stats.phaseMeans_[FRAME_PHASE_UPDATE]);
+    REQUIRE(stats.phaseMeans_[FRAME_PHASE_UPDATE] >= 500);
+    REQUIRE(stats.phaseMeans_[FRAME_PHASE_SLEEP] == 0);
+    REQUIRE(time->GetFrameTimePercentile(99.0f) == stats.p99_);
+    REQUIRE(time->GetFrameTimeStats(20).numFrames_ == 20);
+
+    // The ring keeps the newest frames in order
+    for (unsigned i = 0; i < Time::FRAME_SAMPLES; ++i)
+    {
+        time->BeginFrame(0.016f);
+        time->EndFrame();
+    }
+    PODVector<FrameTimeSample> samples;
+    time->GetFrameTimeSamples(samples);
+    REQUIRE(samples.Size() == Time::FRAME_SAMPLES);
+    REQUIRE(samples.Back().frameNumber_ == time->GetFrameNumber());
+    for (unsigned i = 1; i < samples.Size(); ++i)
+        REQUIRE(samples[i].frameNumber_ == samples[i - 1].frameNumber_ + 1);
+    REQUIRE(time->GetFrameTimeStats().numHitches_ == 0);
+
+    // Samples read from another thread while frames are stored are never torn or out of order
+    std::atomic<bool> done(false);
+    bool ordered = true;
+    std::thread reader([&]()
+    {
+        PODVector<FrameTimeSample> copy;
+        while (!done)
+        {
+            time->GetFrameTimeSamples(copy, 64);
+            for (unsigned i = 1; i < copy.Size(); ++i)
+            {
+                if (copy[i].frameNumber_ <= copy[i - 1].frameNumber_)
+                    ordered = false;
+            }
+        }
+    });
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        time->BeginFrame(0.016f);
+        time->EndFrame();
+    }
+    done = true;
+    reader.join();
+    REQUIRE(ordered);
+
+    // The summary event is sent periodically only while it has receivers
+    unsigned numSummaries = 0;
+    unsigned summaryFrames = 0;
+    time->SetFrameStatsInterval(10);
+    receiver->SubscribeToEvent(E_FRAMESTATS, [&](StringHash eventType, VariantMap& eventData)
+    {
+        ++numSummaries;
+        summaryFrames = eventData[FrameStats::P_NUMFRAMES].GetUInt();
+    });
+    unsigned frameNumber = time->GetFrameNumber();
+    while ((frameNumber + 1) % 10)
+    {
+        time->BeginFrame(0.016f);
+        time->EndFrame();
+        frameNumber = time->GetFrameNumber();
+    }
+    numSummaries = 0;
+    for (unsigned i = 0; i < 30; ++i)
+        RunTimedFrame(time, 100);
+    REQUIRE(numSummaries == 3);
+    REQUIRE(summaryFrames == 10);
+
+    time->SetFrameStatsInterval(0);
+    for (unsigned i = 0; i < 30; ++i)
+        RunTimedFrame(time, 100);
+    REQUIRE(numSummaries == 3);
+}
+
+/// Return the CPU time the process has used in microseconds.
+static long long GetProcessCPUTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    auto toUSec = [](const FILETIME& time) { return (((long long)time.dwHighDateTime << 32) | time.dwLowDateTime) / 10; };
+    return toUSec(kernel) + toUSec(user);
+#else
+    timespec time{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return (long long)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+#endif
+}
+
+TEST_CASE("frame pacing testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem<Time>();
+
+    for (unsigned fps : {60u, 120u, 240u})
+    {
+        FramePacer pacer;
+        HiresTimer frameTimer;
+        HiresTimer wallTimer;
+        long long target = 1000000LL / fps;
+        unsigned numFrames = fps / 2;
+        PODVector<long long> errors;
+        long long cpuStart = GetProcessCPUTime();
+
+        // Half a second of frames with a little work each, like a headless engine with the frame limiter on
+        for (unsigned i = 0; i < numFrames; ++i)
+        {
+            HiresTimer work;
+            while (work.GetUSec(false) < 300)
+            {
+            }
+            long long elapsed = pacer.Wait(frameTimer, target);
+            frameTimer.GetUSec(true);
+            errors.Push(Abs(elapsed - target));
+        }
+
+        float cpuUsage = (float)(GetProcessCPUTime() - cpuStart) / wallTimer.GetUSec(false);
+        FramePacingStats stats = pacer.GetStats();
+        Sort(errors.Begin(), errors.End());
+        INFO(fps << " fps: median error " << errors[numFrames / 2] << " us, 75th " << errors[numFrames * 3 / 4]
+            << " us, jitter " << stats.jitter_ << " us, spin " << stats.meanSpin_ << " us, overshoot "
+            << stats.sleepOvershoot_ << " us, CPU " << cpuUsage * 100.0f << "%");
+        REQUIRE(stats.numFrames_ + stats.numOverruns_ == numFrames);
+        REQUIRE(stats.maxError_ <= (float)errors.Back());
+        REQUIRE(stats.meanSpin_ <= pacer.GetMaxSpin());
+        REQUIRE(stats.meanSleep_ > 0.0f);
+        // Scheduler preemption makes single frames late, so judge the typical frame
+        REQUIRE(errors[numFrames / 2] < 100);
+        REQUIRE(errors[numFrames * 3 / 4] < 1000);
+        REQUIRE(cpuUsage < 0.5f);
+
+        pacer.ResetStats();
+        REQUIRE(pacer.GetStats().numFrames_ == 0);
+    }
+}
+
+TEST_CASE("frame pipeline testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem<Time>();
+    auto* pipeline = context->RegisterSubsystem<FramePipeline>();
+    const std::thread::id mainThreadId = std::this_thread::get_id();
+
+    // Double-buffered state that the update writes and the commands read
+    unsigned states[NUM_FRAME_PACKETS] = {};
+    PODVector<unsigned> executed;
+    bool stateMatched = true;
+    bool onMainThread = true;
+    auto recordFrame = [&](unsigned frameNumber)
+    {
+        pipeline->BeginFrame(frameNumber);
+        FramePacket& packet = pipeline->GetPacket();
+        REQUIRE(packet.GetFrameNumber() == frameNumber);
+        REQUIRE(packet.GetIndex() == frameNumber % NUM_FRAME_PACKETS);
+        REQUIRE(packet.GetNumCommands() == 0);
+        states[packet.GetIndex()] = frameNumber;
+        packet.AddCommand([&](const FramePacket& p)
+        {
+            stateMatched &= states[p.GetIndex()] == p.GetFrameNumber();
+            onMainThread &= std::this_thread::get_id() == mainThreadId;
+            executed.Push(p.GetFrameNumber());
+        });
+    };
+
+    SECTION("immediate execution")
+    {
+        REQUIRE_FALSE(pipeline->IsPipelined());
+        for (unsigned i = 0; i < 10; ++i)
+        {
+            recordFrame(i);
+            pipeline->Submit();
+            REQUIRE(executed.Size() == i + 1);
+        }
+        REQUIRE(stateMatched);
+        REQUIRE(onMainThread);
+    }
+
+    SECTION("pipelined execution")
+    {
+        pipeline->SetPipelined(true);
+        REQUIRE(pipeline->IsPipelined());
+
+        SharedPtr<RefCounted> object(new RefCounted());
+        for (unsigned i = 0; i < 100; ++i)
+        {
+            recordFrame(i);
+            if (i == 10)
+                pipeline->GetPacket().AddReference(object);
+            // Slow down the render side now and then, so that the update catches up with it
+            if (i % 7 == 0)
+                pipeline->GetPacket().AddCommand([](const FramePacket&) { Time::Sleep(2); });
+            pipeline->Submit();
+
+            // The reference is kept until the packet is reclaimed for frame 12
+            if (i >= 10 && i < 12)
+                REQUIRE(object->Refs() == 2);
+            else
+                REQUIRE(object->Refs() == 1);
+        }
+        pipeline->Flush();
+        REQUIRE(executed.Size() == 100);
+        for (unsigned i = 0; i < executed.Size(); ++i)
+            REQUIRE(executed[i] == i);
+        REQUIRE(stateMatched);
+        REQUIRE_FALSE(onMainThread);
+
+        // The render side of a frame runs while the main thread updates the next one
+        Event nextFrameUpdated(true);
+        bool overlapped = false;
+        pipeline->BeginFrame(100);
+        pipeline->GetPacket().AddCommand([&](const FramePacket&) { overlapped = nextFrameUpdated.Wait(5000); });
+        pipeline->Submit();
+        pipeline->BeginFrame(101);
+        nextFrameUpdated.Set();
+        pipeline->Submit();
+        pipeline->SetPipelined(false);
+        REQUIRE(overlapped);
+        REQUIRE_FALSE(pipeline->IsPipelined());
+    }
+}
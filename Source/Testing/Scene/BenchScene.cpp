@@ -0,0 +1,153 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#include "catch.hpp"
+
+#include "Core/Context.h"
+#include "IO/VectorBuffer.h"
+#include "Scene/Node.h"
+#include "Scene/Scene.h"
+
+using namespace My3D;
+
+// Benchmarks are hidden from the default test run. Run them with: TestScene [benchmark]
+// Build with MY3D_SCENE_SLOTMAP to compare the scene ID registries.
+
+TEST_CASE("Node creation and destruction", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    const unsigned numNodes = 1000;
+
+    BENCHMARK("Create and destroy 1000 nodes")
+    {
+        Vector<SharedPtr<Node> > nodes;
+        nodes.Reserve(numNodes);
+        for (unsigned i = 0; i < numNodes; ++i)
+            nodes.Push(SharedPtr<Node>(new Node(context)));
+        return nodes.Size();
+    };
+
+    BENCHMARK("Create and destroy a hierarchy of 1000 nodes")
+    {
+        SharedPtr<Node> root(new Node(context));
+        for (unsigned i = 0; i < numNodes; ++i)
+            root->AddChild(new Node(context));
+        return root->GetNumChildren();
+    };
+
+    BENCHMARK("Create and destroy 1000 nodes with weak references")
+    {
+        Vector<WeakPtr<Node> > weakNodes;
+        weakNodes.Reserve(numNodes);
+        {
+            Vector<SharedPtr<Node> > nodes;
+            nodes.Reserve(numNodes);
+            for (unsigned i = 0; i < numNodes; ++i)
+            {
+                nodes.Push(SharedPtr<Node>(new Node(context)));
+                weakNodes.Push(WeakPtr<Node>(nodes.Back()));
+            }
+        }
+        return weakNodes.Back().Expired();
+    };
+}
+
+TEST_CASE("Scene node lookup by ID", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Scene> scene(new Scene(context));
+    const unsigned numNodes = 10000;
+    PODVector<unsigned> ids;
+    for (unsigned i = 0; i < numNodes; ++i)
+        ids.Push(scene->CreateChild(0, i & 1u ? LOCAL : REPLICATED)->GetID());
+
+    BENCHMARK("Look up 10000 nodes")
+    {
+        unsigned found = 0;
+        for (unsigned i = 0; i < ids.Size(); ++i)
+            found += scene->GetNode(ids[i]) != nullptr;
+        return found;
+    };
+
+    BENCHMARK("Create and remove 1000 child nodes")
+    {
+        SharedPtr<Node> parent(scene->CreateChild(0, REPLICATED));
+        for (unsigned i = 0; i < 1000; ++i)
+            parent->CreateChild(0, REPLICATED);
+        scene->RemoveChild(parent);
+        return parent->GetNumChildren();
+    };
+}
+
+TEST_CASE("Pooled node creation", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Scene> scene(new Scene(context));
+    const unsigned numNodes = 1000;
+
+    BENCHMARK("Spawn and remove 1000 child nodes")
+    {
+        SharedPtr<Node> parent(scene->CreateChild(0, LOCAL));
+        for (unsigned i = 0; i < numNodes; ++i)
+            parent->CreateChild(0, LOCAL);
+        scene->RemoveChild(parent);
+        return parent->GetNumChildren();
+    };
+
+    context->RegisterFactory<Node>(true);
+    context->GetObjectFactory(Node::GetTypeStatic())->ReservePool(numNodes + 1);
+
+    BENCHMARK("Spawn and remove 1000 pooled child nodes")
+    {
+        SharedPtr<Node> parent(scene->CreateChild(0, LOCAL));
+        for (unsigned i = 0; i < numNodes; ++i)
+            parent->CreateChild(0, LOCAL);
+        scene->RemoveChild(parent);
+        return parent->GetNumChildren();
+    };
+}
+
+TEST_CASE("Serializable load throughput", "[.][benchmark]")
+{
+    SharedPtr<Context> context(new Context());
+    Node::RegisterObject(context);
+    const unsigned numNodes = 1000;
+
+    SharedPtr<Node> source(new Node(context));
+    source->SetName("BenchNode");
+    source->SetPosition(Vector3(1.0f, 2.0f, 3.0f));
+    source->SetRotation(Quaternion(45.0f, Vector3::UP));
+    VectorBuffer nodeData;
+    source->Save(nodeData);
+
+    BENCHMARK("Load attributes of 1000 nodes")
+    {
+        SharedPtr<Node> node(new Node(context));
+        for (unsigned i = 0; i < numNodes; ++i)
+        {
+            nodeData.Seek(0);
+            node->Load(nodeData);
+        }
+        return node->GetPosition().x_;
+    };
+
+    VariantMap vars;
+    vars[StringHash("Health")] = 100;
+    vars[StringHash("Speed")] = 2.5f;
+    vars[StringHash("Target")] = Vector3(1.0f, 0.0f, 1.0f);
+    vars[StringHash("Faction")] = "Neutral";
+    VectorBuffer mapData;
+    mapData.WriteVariantMap(vars);
+
+    BENCHMARK("Read 1000 variant maps with 4 keys")
+    {
+        unsigned numKeys = 0;
+        for (unsigned i = 0; i < numNodes; ++i)
+        {
+            mapData.Seek(0);
+            numKeys += mapData.ReadVariantMap().Size();
+        }
+        return numKeys;
+    };
+}
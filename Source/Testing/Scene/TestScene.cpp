@@ -0,0 +1,134 @@
+//
+// Created by luchu on 2026/10/17.
+//
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "Core/Context.h"
+#include "Core/Thread.h"
+#include "IO/FileSystem.h"
+#include "IO/IOEvents.h"
+#include "IO/Log.h"
+#include "Resource/ResourceCache.h"
+#include "Resource/ResourceEvents.h"
+#include "Scene/Node.h"
+#include "Scene/Scene.h"
+
+using namespace My3D;
+
+TEST_CASE("node reference testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Node> parent(new Node(context));
+    REQUIRE(parent.Refs() == 1);
+    REQUIRE(parent.WeakRefs() == 0);
+
+    SharedPtr<Node> child(new Node(context));
+    parent->AddChild(child);
+    REQUIRE(child.Refs() == 2);
+    REQUIRE(child->GetParent() == parent);
+
+    WeakPtr<Node> weakChild(child);
+    REQUIRE(child.WeakRefs() == 1);
+    child.Reset();
+    REQUIRE(!weakChild.Expired());
+    REQUIRE(weakChild.Refs() == 1);
+
+    parent->RemoveAllChildren();
+    REQUIRE(weakChild.Expired());
+    REQUIRE(parent->GetNumChildren() == 0);
+}
+
+TEST_CASE("scene ID testing", "[engine]")
+{
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Scene> scene(new Scene(context));
+    REQUIRE(scene->GetID() == FIRST_REPLICATED_ID);
+    REQUIRE(scene->GetNode(FIRST_REPLICATED_ID) == scene);
+
+    Node* replicated = scene->CreateChild(0, REPLICATED);
+    Node* local = scene->CreateChild(0, LOCAL);
+    REQUIRE(Scene::IsReplicatedID(replicated->GetID()));
+    REQUIRE_FALSE(Scene::IsReplicatedID(local->GetID()));
+    REQUIRE(scene->GetNode(replicated->GetID()) == replicated);
+    REQUIRE(scene->GetNode(local->GetID()) == local);
+
+    // Taken IDs are reassigned
+    Node* duplicate = scene->CreateChild(replicated->GetID(), REPLICATED);
+    REQUIRE(duplicate->GetID() != replicated->GetID());
+    REQUIRE(scene->GetNode(duplicate->GetID()) == duplicate);
+
+    unsigned id = local->GetID();
+    scene->RemoveChild(local);
+    REQUIRE(scene->GetNode(id) == nullptr);
+    REQUIRE(scene->GetNode(LAST_LOCAL_ID) == nullptr);
+
+    scene->Clear();
+    REQUIRE(scene->GetNumChildren() == 0);
+    REQUIRE(scene->GetNode(FIRST_REPLICATED_ID) == scene);
+    REQUIRE(scene->CreateChild(0, REPLICATED)->GetID() == FIRST_REPLICATED_ID + 1);
+    REQUIRE(scene->CreateChild(0, LOCAL)->GetID() == FIRST_LOCAL_ID);
+}
+
+/// Router that looks up files from the cache while routing.
+class LookupRouter : public ResourceRouter
+{
+    MY3D_OBJECT(LookupRouter, Object)
+
+public:
+    explicit LookupRouter(Context* context)
+        : ResourceRouter(context)
+    {
+    }
+
+    void Route(String& name, ResourceRequest requestType) override
+    {
+        lookups_ += GetSubsystem<ResourceCache>()->Exists("Other.xml") ? 0 : 1;
+    }
+
+    unsigned lookups_{};
+};
+
+TEST_CASE("resource cache reentrancy testing", "[engine]")
+{
+    Thread::SetMainThread();
+    SharedPtr<Context> context(new Context());
+    auto* fileSystem = context->RegisterSubsystem<FileSystem>();
+    auto* cache = context->RegisterSubsystem<ResourceCache>();
+
+    // A router may call back into the cache
+    SharedPtr<LookupRouter> router(new LookupRouter(context));
+    cache->AddResourceRouter(router);
+    REQUIRE_FALSE(cache->Exists("Missing.xml"));
+    REQUIRE(cache->GetFile("Missing.xml", false).Null());
+    REQUIRE(router->lookups_ == 2);
+    cache->RemoveResourceRouter(router);
+
+    // A resource not found handler may add resource paths
+    unsigned numNotFound = 0;
+    router->SubscribeToEvent(E_RESOURCENOTFOUND, [&](StringHash, VariantMap&)
+    {
+        ++numNotFound;
+        cache->AddResourceDir(fileSystem->GetCurrentDir());
+    });
+    REQUIRE(cache->GetFile("Missing.xml").Null());
+    REQUIRE(numNotFound == 1);
+    REQUIRE(cache->GetResourceDirs().Size() == 1);
+    router->UnsubscribeFromEvent(E_RESOURCENOTFOUND);
+
+    // A log message handler may look up files while resource paths change
+    auto* log = context->RegisterSubsystem<Log>();
+    log->SetQuiet(true);
+    log->SetLevel(LOG_DEBUG);
+    unsigned numMessages = 0;
+    router->SubscribeToEvent(E_LOGMESSAGE, [&](StringHash, VariantMap&)
+    {
+        ++numMessages;
+        cache->Exists("Missing.xml");
+    });
+    cache->RemoveResourceDir(fileSystem->GetCurrentDir());
+    REQUIRE(cache->GetResourceDirs().Empty());
+    REQUIRE(cache->AddResourceDir(fileSystem->GetCurrentDir()));
+    REQUIRE(numMessages >= 2);
+}